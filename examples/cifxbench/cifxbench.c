@@ -0,0 +1,842 @@
+// SPDX-License-Identifier: MIT
+/**************************************************************************************
+ *
+ * Copyright (c) 2025, Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserved.
+ *
+ * Description: cifX driver benchmark. Measures IO and mailbox latencies, IO throughput,
+ *              notification latency and download rate of a board/channel and reports
+ *              them human readable and as JSON.
+ *
+ **************************************************************************************/
+
+#include "cifxlinux.h"
+#include "cifXEndianess.h"
+
+#include "Hil_Packet.h"
+#include "Hil_SystemCmd.h"
+
+#include <errno.h>
+#include <libgen.h>
+#include <semaphore.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/utsname.h>
+
+#define BENCH_VERSION       "1.0.0"
+#define CIFX_DEV            "cifX0"
+
+#define DEFAULT_ITERATIONS  1000
+#define DEFAULT_IO_SIZE     64
+#define IO_TIMEOUT          100   /* ms */
+#define MBX_TIMEOUT         1000  /* ms */
+
+#define TEST_IO_LATENCY     0x01
+#define TEST_IO_THROUGHPUT  0x02
+#define TEST_MAILBOX        0x04
+#define TEST_NOTIFICATION   0x08
+#define TEST_DOWNLOAD       0x10
+#define TEST_DEFAULT        (TEST_IO_LATENCY | TEST_IO_THROUGHPUT | TEST_MAILBOX | TEST_NOTIFICATION)
+
+#define MAX_SIZE_STEPS      32
+
+/* latency distribution of a single measurement */
+typedef struct BENCH_STATS_Ttag
+{
+  uint32_t ulCount;    /* successful samples */
+  uint32_t ulErrors;   /* failed calls       */
+  int32_t  lError;     /* first error        */
+  double   dMin;
+  double   dAvg;
+  double   dP50;
+  double   dP90;
+  double   dP99;
+  double   dMax;
+} BENCH_STATS_T;
+
+typedef struct BENCH_THROUGHPUT_Ttag
+{
+  uint32_t ulSize;
+  double   dWriteMBps;
+  double   dReadMBps;
+  int32_t  lError;
+} BENCH_THROUGHPUT_T;
+
+typedef struct BENCH_RESULTS_Ttag
+{
+  uint32_t           ulTests;           /* executed tests (TEST_XXX) */
+
+  uint32_t           ulIOSize;
+  BENCH_STATS_T      tIOWrite;
+  BENCH_STATS_T      tIORead;
+  BENCH_STATS_T      tIORoundTrip;
+
+  uint32_t           ulSizeSteps;
+  BENCH_THROUGHPUT_T atThroughput[MAX_SIZE_STEPS];
+
+  BENCH_STATS_T      tMbxRoundTrip;
+  double             dPacketsPerSec;
+
+  int                fIrqMode;          /* notifications could be registered */
+  BENCH_STATS_T      tNotification;
+
+  const char*        szDownloadFile;
+  uint32_t           ulDownloadSize;
+  double             dDownloadSec;
+  int32_t            lDownloadError;
+} BENCH_RESULTS_T;
+
+static char            s_szBoard[CIFx_MAX_INFO_NAME_LENTH] = CIFX_DEV;
+static uint32_t        s_ulChannel    = 0;
+static uint32_t        s_ulArea       = 0;
+static uint32_t        s_ulIterations = DEFAULT_ITERATIONS;
+static uint32_t        s_ulIOSize     = DEFAULT_IO_SIZE;
+static int             s_fBusOn       = 0;
+static FILE*           s_ptOut        = NULL; /* human readable output */
+static BENCH_RESULTS_T s_tResults;
+
+/* notification test state, written by the callback */
+static sem_t           s_tNotifySem;
+static struct timespec s_tNotifyTime;
+
+/*****************************************************************************/
+/*! Returns monotonic time in us                                            */
+/*****************************************************************************/
+static double GetTimeUs(void)
+{
+  struct timespec tNow;
+
+  clock_gettime(CLOCK_MONOTONIC, &tNow);
+  return (double)tNow.tv_sec * 1e6 + (double)tNow.tv_nsec / 1e3;
+}
+
+static int CompareDouble(const void* pvA, const void* pvB)
+{
+  double dA = *(const double*)pvA;
+  double dB = *(const double*)pvB;
+
+  return (dA > dB) - (dA < dB);
+}
+
+/*****************************************************************************/
+/*! Calculates the latency distribution of the collected samples (sorts them)
+*   \param ptStats   Statistics to fill (ulErrors/lError are kept)
+*   \param pdSamples Samples in us
+*   \param ulCount   Number of samples                                       */
+/*****************************************************************************/
+static void CalcStats(BENCH_STATS_T* ptStats, double* pdSamples, uint32_t ulCount)
+{
+  double   dSum = 0;
+  uint32_t ulIdx;
+
+  ptStats->ulCount = ulCount;
+  if(0 == ulCount)
+    return;
+
+  qsort(pdSamples, ulCount, sizeof(*pdSamples), CompareDouble);
+  for(ulIdx = 0; ulIdx < ulCount; ++ulIdx)
+    dSum += pdSamples[ulIdx];
+
+  ptStats->dMin = pdSamples[0];
+  ptStats->dMax = pdSamples[ulCount - 1];
+  ptStats->dAvg = dSum / ulCount;
+  ptStats->dP50 = pdSamples[(ulCount - 1) * 50 / 100];
+  ptStats->dP90 = pdSamples[(ulCount - 1) * 90 / 100];
+  ptStats->dP99 = pdSamples[(ulCount - 1) * 99 / 100];
+}
+
+static void RecordError(BENCH_STATS_T* ptStats, int32_t lError)
+{
+  if(0 == ptStats->ulErrors++)
+    ptStats->lError = lError;
+}
+
+/* IO functions report a missing COM flag, but the data was exchanged anyway */
+static int IOSucceeded(int32_t lRet)
+{
+  return (CIFX_NO_ERROR == lRet) || (CIFX_DEV_NO_COM_FLAG == lRet);
+}
+
+static void PrintStatsHeader(void)
+{
+  fprintf(s_ptOut, "  %-12s %8s %6s %9s %9s %9s %9s %9s %9s\n",
+          "", "count", "errors", "min", "avg", "p50", "p90", "p99", "max");
+}
+
+static void PrintStats(const char* szName, const BENCH_STATS_T* ptStats)
+{
+  fprintf(s_ptOut, "  %-12s %8u %6u", szName, ptStats->ulCount, ptStats->ulErrors);
+  if(ptStats->ulCount > 0)
+    fprintf(s_ptOut, " %9.1f %9.1f %9.1f %9.1f %9.1f %9.1f",
+            ptStats->dMin, ptStats->dAvg, ptStats->dP50, ptStats->dP90, ptStats->dP99, ptStats->dMax);
+  if(ptStats->ulErrors > 0)
+    fprintf(s_ptOut, "  (first error 0x%08X)", (unsigned int)ptStats->lError);
+  fprintf(s_ptOut, "\n");
+}
+
+/*****************************************************************************/
+/*! Measures the latency of xChannelIOWrite()/xChannelIORead() and of a
+*   complete write/read cycle
+*   \param hChannel  Channel handle
+*   \param ulMaxSize Size of the smaller of both IO areas                   */
+/*****************************************************************************/
+static void BenchIOLatency(CIFXHANDLE hChannel, uint32_t ulMaxSize)
+{
+  uint32_t ulSize      = (s_ulIOSize < ulMaxSize) ? s_ulIOSize : ulMaxSize;
+  double*  pdWrite     = calloc(s_ulIterations, sizeof(double));
+  double*  pdRead      = calloc(s_ulIterations, sizeof(double));
+  double*  pdRoundTrip = calloc(s_ulIterations, sizeof(double));
+  uint8_t* pbData      = calloc(1, ulSize);
+  uint32_t ulWrites    = 0;
+  uint32_t ulReads     = 0;
+  uint32_t ulCycles    = 0;
+  uint32_t ulIdx;
+
+  s_tResults.ulIOSize = ulSize;
+
+  for(ulIdx = 0; ulIdx < s_ulIterations; ++ulIdx)
+  {
+    double  dStart, dWritten, dEnd;
+    int32_t lRet;
+    int     fOk = 1;
+
+    memset(pbData, (int)ulIdx, ulSize);
+
+    dStart   = GetTimeUs();
+    lRet     = xChannelIOWrite(hChannel, s_ulArea, 0, ulSize, pbData, IO_TIMEOUT);
+    dWritten = GetTimeUs();
+    if(IOSucceeded(lRet))
+    {
+      pdWrite[ulWrites++] = dWritten - dStart;
+    } else
+    {
+      RecordError(&s_tResults.tIOWrite, lRet);
+      fOk = 0;
+    }
+
+    lRet = xChannelIORead(hChannel, s_ulArea, 0, ulSize, pbData, IO_TIMEOUT);
+    dEnd = GetTimeUs();
+    if(IOSucceeded(lRet))
+    {
+      pdRead[ulReads++] = dEnd - dWritten;
+    } else
+    {
+      RecordError(&s_tResults.tIORead, lRet);
+      fOk = 0;
+    }
+
+    if(fOk)
+      pdRoundTrip[ulCycles++] = dEnd - dStart;
+    else
+      RecordError(&s_tResults.tIORoundTrip, lRet);
+  }
+
+  CalcStats(&s_tResults.tIOWrite,     pdWrite,     ulWrites);
+  CalcStats(&s_tResults.tIORead,      pdRead,      ulReads);
+  CalcStats(&s_tResults.tIORoundTrip, pdRoundTrip, ulCycles);
+
+  fprintf(s_ptOut, "\nIO latency, area %u, %u bytes [us]\n", s_ulArea, ulSize);
+  PrintStatsHeader();
+  PrintStats("write",     &s_tResults.tIOWrite);
+  PrintStats("read",      &s_tResults.tIORead);
+  PrintStats("write+read", &s_tResults.tIORoundTrip);
+
+  free(pbData);
+  free(pdRoundTrip);
+  free(pdRead);
+  free(pdWrite);
+}
+
+/*****************************************************************************/
+/*! Measures IO throughput for increasing transfer sizes (powers of two up to
+*   the IO area size)
+*   \param hChannel  Channel handle
+*   \param ulMaxSize Size of the smaller of both IO areas                   */
+/*****************************************************************************/
+static void BenchIOThroughput(CIFXHANDLE hChannel, uint32_t ulMaxSize)
+{
+  uint8_t* pbData = calloc(1, ulMaxSize);
+  uint32_t ulSize = 1;
+
+  fprintf(s_ptOut, "\nIO throughput, area %u, %u iterations per size\n", s_ulArea, s_ulIterations);
+  fprintf(s_ptOut, "  %8s %12s %12s\n", "size", "write MB/s", "read MB/s");
+
+  while(s_tResults.ulSizeSteps < MAX_SIZE_STEPS)
+  {
+    BENCH_THROUGHPUT_T* ptStep = &s_tResults.atThroughput[s_tResults.ulSizeSteps++];
+    double              dStart;
+    uint32_t            ulIdx;
+    int32_t             lRet   = CIFX_NO_ERROR;
+
+    ptStep->ulSize = ulSize;
+
+    dStart = GetTimeUs();
+    for(ulIdx = 0; (ulIdx < s_ulIterations) && IOSucceeded(lRet); ++ulIdx)
+      lRet = xChannelIOWrite(hChannel, s_ulArea, 0, ulSize, pbData, IO_TIMEOUT);
+    ptStep->dWriteMBps = (double)ulSize * s_ulIterations / (GetTimeUs() - dStart);
+
+    dStart = GetTimeUs();
+    for(ulIdx = 0; (ulIdx < s_ulIterations) && IOSucceeded(lRet); ++ulIdx)
+      lRet = xChannelIORead(hChannel, s_ulArea, 0, ulSize, pbData, IO_TIMEOUT);
+    ptStep->dReadMBps = (double)ulSize * s_ulIterations / (GetTimeUs() - dStart);
+
+    if(!IOSucceeded(lRet))
+    {
+      ptStep->lError = lRet;
+      fprintf(s_ptOut, "  %8u failed (0x%08X)\n", ulSize, (unsigned int)lRet);
+      break;
+    }
+    fprintf(s_ptOut, "  %8u %12.2f %12.2f\n", ulSize, ptStep->dWriteMBps, ptStep->dReadMBps);
+
+    if(ulSize == ulMaxSize)
+      break;
+    ulSize = (2 * ulSize < ulMaxSize) ? 2 * ulSize : ulMaxSize;
+  }
+
+  free(pbData);
+}
+
+/* builds a firmware identify request, answered by every firmware */
+static void BuildRequest(CIFX_PACKET* ptPacket, uint32_t ulId)
+{
+  HIL_FIRMWARE_IDENTIFY_REQ_T* ptReq = (HIL_FIRMWARE_IDENTIFY_REQ_T*)ptPacket;
+
+  memset(ptPacket, 0, sizeof(*ptPacket));
+  ptReq->tHead.ulDest      = HOST_TO_LE32(HIL_PACKET_DEST_DEFAULT_CHANNEL);
+  ptReq->tHead.ulCmd       = HOST_TO_LE32(HIL_FIRMWARE_IDENTIFY_REQ);
+  ptReq->tHead.ulLen       = HOST_TO_LE32(sizeof(ptReq->tData));
+  ptReq->tHead.ulId        = HOST_TO_LE32(ulId);
+  ptReq->tData.ulChannelId = HOST_TO_LE32(0);
+}
+
+/*****************************************************************************/
+/*! Measures mailbox packet round trips (put request, get confirmation)
+*   \param hChannel  Channel handle                                         */
+/*****************************************************************************/
+static void BenchMailbox(CIFXHANDLE hChannel)
+{
+  double*     pdRoundTrip = calloc(s_ulIterations, sizeof(double));
+  uint32_t    ulCount     = 0;
+  double      dStart      = GetTimeUs();
+  double      dTotal;
+  CIFX_PACKET tReq;
+  CIFX_PACKET tCnf;
+  uint32_t    ulIdx;
+
+  for(ulIdx = 0; ulIdx < s_ulIterations; ++ulIdx)
+  {
+    double  dSend = GetTimeUs();
+    int32_t lRet;
+
+    BuildRequest(&tReq, ulIdx);
+    if(CIFX_NO_ERROR == (lRet = xChannelPutPacket(hChannel, &tReq, MBX_TIMEOUT)))
+      lRet = xChannelGetPacket(hChannel, sizeof(tCnf), &tCnf, MBX_TIMEOUT);
+
+    if(CIFX_NO_ERROR == lRet)
+      pdRoundTrip[ulCount++] = GetTimeUs() - dSend;
+    else
+      RecordError(&s_tResults.tMbxRoundTrip, lRet);
+  }
+  dTotal = GetTimeUs() - dStart;
+
+  CalcStats(&s_tResults.tMbxRoundTrip, pdRoundTrip, ulCount);
+  s_tResults.dPacketsPerSec = (dTotal > 0) ? (2.0 * ulCount * 1e6 / dTotal) : 0;
+
+  fprintf(s_ptOut, "\nMailbox round trip (firmware identify request/confirmation) [us]\n");
+  PrintStatsHeader();
+  PrintStats("round trip", &s_tResults.tMbxRoundTrip);
+  fprintf(s_ptOut, "  %.0f packets/s (requests and confirmations)\n", s_tResults.dPacketsPerSec);
+
+  free(pdRoundTrip);
+}
+
+static void APIENTRY NotifyCallback(uint32_t ulNotification, uint32_t ulDataLen, void* pvData, void* pvUser)
+{
+  (void)ulNotification;
+  (void)ulDataLen;
+  (void)pvData;
+  (void)pvUser;
+
+  clock_gettime(CLOCK_MONOTONIC, &s_tNotifyTime);
+  sem_post(&s_tNotifySem);
+}
+
+/*****************************************************************************/
+/*! Measures the time from sending a request until the RX mailbox
+*   notification is delivered (only available in interrupt mode)
+*   \param hChannel  Channel handle                                         */
+/*****************************************************************************/
+static void BenchNotification(CIFXHANDLE hChannel)
+{
+  double*     pdLatency = NULL;
+  uint32_t    ulCount   = 0;
+  CIFX_PACKET tReq;
+  CIFX_PACKET tCnf;
+  uint32_t    ulIdx;
+  int32_t     lRet;
+
+  fprintf(s_ptOut, "\nNotification latency (request sent -> CIFX_NOTIFY_RX_MBX_FULL callback) [us]\n");
+
+  sem_init(&s_tNotifySem, 0, 0);
+  if(CIFX_NO_ERROR != (lRet = xChannelRegisterNotification(hChannel, CIFX_NOTIFY_RX_MBX_FULL, NotifyCallback, NULL)))
+  {
+    /* notifications require interrupt mode */
+    fprintf(s_ptOut, "  skipped, notifications not available (0x%08X), device is probably in polling mode\n", (unsigned int)lRet);
+    sem_destroy(&s_tNotifySem);
+    return;
+  }
+  s_tResults.fIrqMode = 1;
+
+  pdLatency = calloc(s_ulIterations, sizeof(double));
+  for(ulIdx = 0; ulIdx < s_ulIterations; ++ulIdx)
+  {
+    struct timespec tTimeout;
+    double          dSend;
+
+    BuildRequest(&tReq, ulIdx);
+    clock_gettime(CLOCK_REALTIME, &tTimeout);
+    tTimeout.tv_sec += MBX_TIMEOUT / 1000;
+
+    dSend = GetTimeUs();
+    if(CIFX_NO_ERROR != (lRet = xChannelPutPacket(hChannel, &tReq, MBX_TIMEOUT)))
+    {
+      RecordError(&s_tResults.tNotification, lRet);
+      continue;
+    }
+
+    while((0 != sem_timedwait(&s_tNotifySem, &tTimeout)) && (EINTR == errno))
+      ;
+
+    /* the callback only signals, the confirmation is fetched here */
+    if(CIFX_NO_ERROR != (lRet = xChannelGetPacket(hChannel, sizeof(tCnf), &tCnf, MBX_TIMEOUT)))
+    {
+      RecordError(&s_tResults.tNotification, lRet);
+      continue;
+    }
+    pdLatency[ulCount++] = (double)s_tNotifyTime.tv_sec * 1e6 + (double)s_tNotifyTime.tv_nsec / 1e3 - dSend;
+  }
+  xChannelUnregisterNotification(hChannel, CIFX_NOTIFY_RX_MBX_FULL);
+  sem_destroy(&s_tNotifySem);
+
+  CalcStats(&s_tResults.tNotification, pdLatency, ulCount);
+  PrintStatsHeader();
+  PrintStats("notification", &s_tResults.tNotification);
+
+  free(pdLatency);
+}
+
+/*****************************************************************************/
+/*! Measures the download rate of a file to the channel's file system
+*   \param hDriver  Driver handle                                           */
+/*****************************************************************************/
+static void BenchDownload(CIFXHANDLE hDriver)
+{
+  CIFXHANDLE  hSys     = NULL;
+  FILE*       ptFile   = NULL;
+  uint8_t*    pbData   = NULL;
+  char*       szCopy   = strdup(s_tResults.szDownloadFile);
+  struct stat tStat;
+  double      dStart;
+  int32_t     lRet;
+
+  fprintf(s_ptOut, "\nDownload of %s\n", s_tResults.szDownloadFile);
+
+  if( (0 != stat(s_tResults.szDownloadFile, &tStat)) ||
+      (NULL == (ptFile = fopen(s_tResults.szDownloadFile, "rb"))) )
+  {
+    fprintf(s_ptOut, "  failed to open file (%s)\n", strerror(errno));
+    s_tResults.lDownloadError = CIFX_FILE_OPEN_FAILED;
+  } else
+  {
+    s_tResults.ulDownloadSize = (uint32_t)tStat.st_size;
+    pbData = malloc(s_tResults.ulDownloadSize + 1);
+    if(s_tResults.ulDownloadSize != fread(pbData, 1, s_tResults.ulDownloadSize, ptFile))
+    {
+      fprintf(s_ptOut, "  failed to read file\n");
+      s_tResults.lDownloadError = CIFX_FILE_READ_ERROR;
+
+    } else if(CIFX_NO_ERROR != (lRet = xSysdeviceOpen(hDriver, s_szBoard, &hSys)))
+    {
+      fprintf(s_ptOut, "  failed to open system device (0x%08X)\n", (unsigned int)lRet);
+      s_tResults.lDownloadError = lRet;
+
+    } else
+    {
+      dStart = GetTimeUs();
+      lRet   = xSysdeviceDownload(hSys, s_ulChannel, DOWNLOAD_MODE_FILE, basename(szCopy),
+                                  pbData, s_tResults.ulDownloadSize, NULL, NULL, NULL);
+      s_tResults.dDownloadSec   = (GetTimeUs() - dStart) / 1e6;
+      s_tResults.lDownloadError = lRet;
+
+      if(CIFX_NO_ERROR != lRet)
+        fprintf(s_ptOut, "  failed (0x%08X)\n", (unsigned int)lRet);
+      else
+        fprintf(s_ptOut, "  %u bytes in %.3f s, %.3f MB/s\n", s_tResults.ulDownloadSize, s_tResults.dDownloadSec,
+                s_tResults.ulDownloadSize / s_tResults.dDownloadSec / 1e6);
+
+      xSysdeviceClose(hSys);
+    }
+    fclose(ptFile);
+  }
+
+  free(pbData);
+  free(szCopy);
+}
+
+static void WriteJsonStats(FILE* ptJson, const char* szName, const BENCH_STATS_T* ptStats, const char* szSep)
+{
+  fprintf(ptJson, "    \"%s\": {\"count\": %u, \"errors\": %u", szName, ptStats->ulCount, ptStats->ulErrors);
+  if(ptStats->ulCount > 0)
+    fprintf(ptJson, ", \"min\": %.2f, \"avg\": %.2f, \"p50\": %.2f, \"p90\": %.2f, \"p99\": %.2f, \"max\": %.2f",
+            ptStats->dMin, ptStats->dAvg, ptStats->dP50, ptStats->dP90, ptStats->dP99, ptStats->dMax);
+  if(ptStats->ulErrors > 0)
+    fprintf(ptJson, ", \"error\": \"0x%08X\"", (unsigned int)ptStats->lError);
+  fprintf(ptJson, "}%s\n", szSep);
+}
+
+/*****************************************************************************/
+/*! Writes all results as JSON document
+*   \param ptJson       Output stream
+*   \param ptBoardInfo  Board information of the benchmarked board
+*   \param ptChannelInfo Channel information of the benchmarked channel      */
+/*****************************************************************************/
+static void WriteJson(FILE* ptJson, const BOARD_INFORMATION* ptBoardInfo, const CHANNEL_INFORMATION* ptChannelInfo)
+{
+  char           szDrvVersion[32] = "";
+  struct utsname tUname;
+  uint32_t       ulIdx;
+
+  cifXGetDriverVersion(sizeof(szDrvVersion), szDrvVersion);
+  if(0 != uname(&tUname))
+    strcpy(tUname.release, "unknown");
+
+  fprintf(ptJson, "{\n");
+  fprintf(ptJson, "  \"tool\": \"cifxbench\",\n");
+  fprintf(ptJson, "  \"version\": \"%s\",\n", BENCH_VERSION);
+  fprintf(ptJson, "  \"driver\": \"%s\",\n", szDrvVersion);
+  fprintf(ptJson, "  \"kernel\": \"%s\",\n", tUname.release);
+  fprintf(ptJson, "  \"board\": \"%s\",\n", ptBoardInfo->abBoardName);
+  fprintf(ptJson, "  \"device_number\": %u,\n", ptBoardInfo->tSystemInfo.ulDeviceNumber);
+  fprintf(ptJson, "  \"serial_number\": %u,\n", ptBoardInfo->tSystemInfo.ulSerialNumber);
+  fprintf(ptJson, "  \"channel\": %u,\n", s_ulChannel);
+  fprintf(ptJson, "  \"firmware\": \"%s %u.%u.%u.%u\",\n", ptChannelInfo->abFWName,
+          ptChannelInfo->usFWMajor, ptChannelInfo->usFWMinor, ptChannelInfo->usFWBuild, ptChannelInfo->usFWRevision);
+  fprintf(ptJson, "  \"iterations\": %u,\n", s_ulIterations);
+  fprintf(ptJson, "  \"mode\": \"%s\"",
+          (s_tResults.ulTests & TEST_NOTIFICATION) ? (s_tResults.fIrqMode ? "irq" : "polling") : "unknown");
+
+  if(s_tResults.ulTests & TEST_IO_LATENCY)
+  {
+    fprintf(ptJson, ",\n  \"io_latency_us\": {\n");
+    fprintf(ptJson, "    \"area\": %u,\n", s_ulArea);
+    fprintf(ptJson, "    \"size\": %u,\n", s_tResults.ulIOSize);
+    WriteJsonStats(ptJson, "write",      &s_tResults.tIOWrite,     ",");
+    WriteJsonStats(ptJson, "read",       &s_tResults.tIORead,      ",");
+    WriteJsonStats(ptJson, "write_read", &s_tResults.tIORoundTrip, "");
+    fprintf(ptJson, "  }");
+  }
+
+  if(s_tResults.ulTests & TEST_IO_THROUGHPUT)
+  {
+    fprintf(ptJson, ",\n  \"io_throughput\": [");
+    for(ulIdx = 0; ulIdx < s_tResults.ulSizeSteps; ++ulIdx)
+    {
+      const BENCH_THROUGHPUT_T* ptStep = &s_tResults.atThroughput[ulIdx];
+
+      fprintf(ptJson, "%s\n    {\"size\": %u", (ulIdx > 0) ? "," : "", ptStep->ulSize);
+      if(CIFX_NO_ERROR != ptStep->lError)
+        fprintf(ptJson, ", \"error\": \"0x%08X\"}", (unsigned int)ptStep->lError);
+      else
+        fprintf(ptJson, ", \"write_MBps\": %.3f, \"read_MBps\": %.3f}", ptStep->dWriteMBps, ptStep->dReadMBps);
+    }
+    fprintf(ptJson, "\n  ]");
+  }
+
+  if(s_tResults.ulTests & TEST_MAILBOX)
+  {
+    fprintf(ptJson, ",\n  \"mailbox\": {\n");
+    fprintf(ptJson, "    \"packets_per_s\": %.1f,\n", s_tResults.dPacketsPerSec);
+    WriteJsonStats(ptJson, "round_trip_us", &s_tResults.tMbxRoundTrip, "");
+    fprintf(ptJson, "  }");
+  }
+
+  if(s_tResults.ulTests & TEST_NOTIFICATION)
+  {
+    if(s_tResults.fIrqMode)
+    {
+      fprintf(ptJson, ",\n  \"notification\": {\n");
+      WriteJsonStats(ptJson, "latency_us", &s_tResults.tNotification, "");
+      fprintf(ptJson, "  }");
+    } else
+    {
+      fprintf(ptJson, ",\n  \"notification\": null");
+    }
+  }
+
+  if(s_tResults.ulTests & TEST_DOWNLOAD)
+  {
+    fprintf(ptJson, ",\n  \"download\": {\"size\": %u", s_tResults.ulDownloadSize);
+    if(CIFX_NO_ERROR != s_tResults.lDownloadError)
+      fprintf(ptJson, ", \"error\": \"0x%08X\"}", (unsigned int)s_tResults.lDownloadError);
+    else
+      fprintf(ptJson, ", \"seconds\": %.6f, \"MBps\": %.3f}", s_tResults.dDownloadSec,
+              s_tResults.ulDownloadSize / s_tResults.dDownloadSec / 1e6);
+  }
+
+  fprintf(ptJson, "\n}\n");
+}
+
+/*****************************************************************************/
+/*! Opens the channel and runs the selected tests
+*   \param szJsonFile  JSON output file ("-" for stdout, NULL for none)
+*   \return CIFX_NO_ERROR on success                                         */
+/*****************************************************************************/
+static int32_t RunBenchmark(const char* szJsonFile)
+{
+  CIFXHANDLE          hDriver      = NULL;
+  CIFXHANDLE          hChannel     = NULL;
+  BOARD_INFORMATION   tBoardInfo   = {0};
+  CHANNEL_INFORMATION tChannelInfo = {0};
+  uint32_t            ulBoard      = 0;
+  int32_t             lRet;
+
+  if(CIFX_NO_ERROR != (lRet = xDriverOpen(&hDriver)))
+  {
+    fprintf(stderr, "Error opening driver (0x%08X)\n", (unsigned int)lRet);
+    return lRet;
+  }
+
+  /* look up the board to report its identity */
+  while(CIFX_NO_ERROR == (lRet = xDriverEnumBoards(hDriver, ulBoard, sizeof(tBoardInfo), &tBoardInfo)))
+  {
+    if( (0 == strcmp((char*)tBoardInfo.abBoardName,  s_szBoard)) ||
+        (0 == strcmp((char*)tBoardInfo.abBoardAlias, s_szBoard)) )
+      break;
+    ++ulBoard;
+  }
+
+  if(CIFX_NO_ERROR != lRet)
+  {
+    fprintf(stderr, "Board %s not found\n", s_szBoard);
+
+  } else if(CIFX_NO_ERROR != (lRet = xDriverEnumChannels(hDriver, ulBoard, s_ulChannel, sizeof(tChannelInfo), &tChannelInfo)))
+  {
+    fprintf(stderr, "Channel %u not found on board %s (0x%08X)\n", s_ulChannel, s_szBoard, (unsigned int)lRet);
+
+  } else if(CIFX_NO_ERROR != (lRet = xChannelOpen(hDriver, s_szBoard, s_ulChannel, &hChannel)))
+  {
+    fprintf(stderr, "Error opening channel %u of %s (0x%08X)\n", s_ulChannel, s_szBoard, (unsigned int)lRet);
+
+  } else
+  {
+    CHANNEL_IO_INFORMATION tInput  = {0};
+    CHANNEL_IO_INFORMATION tOutput = {0};
+    uint32_t               ulIOSize;
+
+    fprintf(s_ptOut, "cifxbench %s - %s (device %u, serial %u), channel %u: %s %u.%u.%u.%u\n",
+            BENCH_VERSION, tBoardInfo.abBoardName, tBoardInfo.tSystemInfo.ulDeviceNumber,
+            tBoardInfo.tSystemInfo.ulSerialNumber, s_ulChannel, tChannelInfo.abFWName,
+            tChannelInfo.usFWMajor, tChannelInfo.usFWMinor, tChannelInfo.usFWBuild, tChannelInfo.usFWRevision);
+
+    if(s_fBusOn)
+    {
+      uint32_t ulState = 0;
+
+      xChannelHostState(hChannel, CIFX_HOST_STATE_READY, &ulState, 1000);
+      if(CIFX_NO_ERROR != (lRet = xChannelBusState(hChannel, CIFX_BUS_STATE_ON, &ulState, 5000)))
+        fprintf(s_ptOut, "Warning: switching bus on failed (0x%08X)\n", (unsigned int)lRet);
+    }
+
+    xChannelIOInfo(hChannel, CIFX_IO_INPUT_AREA,  s_ulArea, sizeof(tInput),  &tInput);
+    xChannelIOInfo(hChannel, CIFX_IO_OUTPUT_AREA, s_ulArea, sizeof(tOutput), &tOutput);
+    ulIOSize = (tInput.ulTotalSize < tOutput.ulTotalSize) ? tInput.ulTotalSize : tOutput.ulTotalSize;
+
+    if( (s_tResults.ulTests & (TEST_IO_LATENCY | TEST_IO_THROUGHPUT)) && (0 == ulIOSize) )
+    {
+      fprintf(s_ptOut, "\nIO tests skipped, channel provides no IO area %u\n", s_ulArea);
+      s_tResults.ulTests &= ~(TEST_IO_LATENCY | TEST_IO_THROUGHPUT);
+    }
+
+    if(s_tResults.ulTests & TEST_IO_LATENCY)
+      BenchIOLatency(hChannel, ulIOSize);
+    if(s_tResults.ulTests & TEST_IO_THROUGHPUT)
+      BenchIOThroughput(hChannel, ulIOSize);
+    if(s_tResults.ulTests & TEST_MAILBOX)
+      BenchMailbox(hChannel);
+    if(s_tResults.ulTests & TEST_NOTIFICATION)
+      BenchNotification(hChannel);
+
+    xChannelClose(hChannel);
+
+    /* download last, the file may affect the firmware */
+    if(s_tResults.ulTests & TEST_DOWNLOAD)
+      BenchDownload(hDriver);
+
+    if(NULL != szJsonFile)
+    {
+      FILE* ptJson = (0 == strcmp(szJsonFile, "-")) ? stdout : fopen(szJsonFile, "w");
+
+      if(NULL == ptJson)
+      {
+        fprintf(stderr, "Error creating %s (%s)\n", szJsonFile, strerror(errno));
+      } else
+      {
+        WriteJson(ptJson, &tBoardInfo, &tChannelInfo);
+        if(stdout != ptJson)
+          fclose(ptJson);
+      }
+    }
+    lRet = CIFX_NO_ERROR;
+  }
+
+  xDriverClose(hDriver);
+  return lRet;
+}
+
+static int ParseTests(char* szTests)
+{
+  char* szTest = strtok(szTests, ",");
+
+  s_tResults.ulTests = 0;
+  while(NULL != szTest)
+  {
+    if(0 == strcmp(szTest, "io"))
+      s_tResults.ulTests |= TEST_IO_LATENCY;
+    else if(0 == strcmp(szTest, "throughput"))
+      s_tResults.ulTests |= TEST_IO_THROUGHPUT;
+    else if(0 == strcmp(szTest, "mailbox"))
+      s_tResults.ulTests |= TEST_MAILBOX;
+    else if(0 == strcmp(szTest, "notify"))
+      s_tResults.ulTests |= TEST_NOTIFICATION;
+    else if(0 == strcmp(szTest, "download"))
+      s_tResults.ulTests |= TEST_DOWNLOAD;
+    else
+      return 0;
+    szTest = strtok(NULL, ",");
+  }
+  return 1;
+}
+
+static void help(void)
+{
+  printf("Usage: cifxbench [OPTION]...\n");
+  printf("Measures the performance of a cifX board/channel.\n\n");
+  printf("  -c <name>    board name or alias (default %s)\n", CIFX_DEV);
+  printf("  -n <card>    only use the given card number (default: all devices are scanned)\n");
+  printf("  -C <channel> communication channel (default 0)\n");
+  printf("  -a <area>    IO area (default 0)\n");
+  printf("  -i <count>   iterations per measurement (default %d)\n", DEFAULT_ITERATIONS);
+  printf("  -s <bytes>   transfer size of the IO latency test (default %d)\n", DEFAULT_IO_SIZE);
+  printf("  -T <tests>   comma separated list of io,throughput,mailbox,notify,download\n");
+  printf("               (default io,throughput,mailbox,notify)\n");
+  printf("  -f <file>    file to download to the channel (enables the download test)\n");
+  printf("  -B           set host state ready and bus on before measuring\n");
+  printf("  -j <file>    write results as JSON to <file> (\"-\" for stdout)\n");
+  printf("  -N <threads> execute notification callbacks in <threads> callback threads\n");
+  printf("               (default 0 = in the interrupt thread)\n");
+  printf("  -b <dir>     driver base directory (default /opt/cifx)\n");
+  printf("  -t <level>   trace level (default 0)\n");
+  printf("  -h           print this help\n");
+}
+
+int main(int argc, char* argv[])
+{
+  int                    opt;
+  int                    card_no   = -1;
+  const char*            json_file = NULL;
+  int32_t                ret;
+  struct CIFX_DEVICE_T*  device    = NULL;
+  struct CIFX_LINUX_INIT init;
+
+  memset(&init, 0, sizeof(init));
+  init.init_options  = CIFX_DRIVER_INIT_AUTOSCAN;
+  init.trace_level   = 0;
+  s_tResults.ulTests = TEST_DEFAULT;
+
+  while((opt = getopt(argc, argv, "c:n:C:a:i:s:T:f:Bj:N:b:t:h")) != -1) {
+    switch(opt)
+    {
+      case 'c':
+        snprintf(s_szBoard, sizeof(s_szBoard), "%s", optarg);
+        break;
+      case 'n':
+        card_no = atoi(optarg);
+        break;
+      case 'C':
+        s_ulChannel = strtoul(optarg, NULL, 0);
+        break;
+      case 'a':
+        s_ulArea = strtoul(optarg, NULL, 0);
+        break;
+      case 'i':
+        s_ulIterations = strtoul(optarg, NULL, 0);
+        break;
+      case 's':
+        s_ulIOSize = strtoul(optarg, NULL, 0);
+        break;
+      case 'T':
+        if(!ParseTests(optarg)) {
+          help();
+          return -1;
+        }
+        break;
+      case 'f':
+        s_tResults.szDownloadFile = optarg;
+        s_tResults.ulTests |= TEST_DOWNLOAD;
+        break;
+      case 'B':
+        s_fBusOn = 1;
+        break;
+      case 'j':
+        json_file = optarg;
+        break;
+      case 'N':
+        init.notify_threads = atoi(optarg);
+        break;
+      case 'b':
+        init.base_dir = optarg;
+        break;
+      case 't':
+        init.trace_level = strtoul(optarg, NULL, 0);
+        break;
+      default:
+        help();
+        return -1;
+    }
+  }
+
+  if( (0 == s_ulIterations) || (0 == s_ulIOSize) ||
+      ((s_tResults.ulTests & TEST_DOWNLOAD) && (NULL == s_tResults.szDownloadFile)) ) {
+    help();
+    return -1;
+  }
+
+  /* keep stdout clean for the JSON document */
+  s_ptOut = ((NULL != json_file) && (0 == strcmp(json_file, "-"))) ? stderr : stdout;
+
+  if (card_no >= 0) {
+    if ((device = cifXFindDevice( card_no, 0)) != NULL) {
+      init.init_options  = CIFX_DRIVER_INIT_NOSCAN;
+      init.user_cards    = device;
+      init.user_card_cnt = 1;
+    } else {
+      fprintf(stderr, "Error - given card %d not found!\n", card_no);
+      return -1;
+    }
+  }
+
+  if ((ret = cifXDriverInit(&init)) != CIFX_NO_ERROR) {
+    fprintf(stderr, "Error while initializing the driver (ret=0x%08X)\n", (unsigned int)ret);
+  } else {
+    ret = RunBenchmark(json_file);
+    cifXDriverDeinit();
+  }
+
+  if (device != NULL)
+    cifXDeleteDevice( device);
+
+  return (CIFX_NO_ERROR == ret) ? 0 : -1;
+}
@@ -0,0 +1,1164 @@
+// SPDX-License-Identifier: MIT
+/**************************************************************************************
+ *
+ * Copyright (c) 2025, Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserved.
+ *
+ * Description: cifX broker daemon. Owns the toolkit and serves requests of client
+ *              processes (libcifxbroker) received via a shared memory segment.
+ *
+ **************************************************************************************/
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "cifxlinux.h"
+#include "cifXEndianess.h"
+#include "cifx_broker.h"
+
+#define BROKER_MAX_DEVICES        32     /*!< Maximum number of opened sysdevices/channels */
+#define BROKER_MBX_QUEUE_DEPTH    16     /*!< Received packets buffered per handle */
+#define BROKER_RECV_TIMEOUT       100    /*!< Timeout [ms] of the mailbox receiver threads */
+#define BROKER_SLOT_CHECK_PERIOD  1      /*!< Period [s] a slot thread checks its client */
+
+/*****************************************************************************/
+/*! Sysdevice or channel opened by the broker. Shared by all client handles
+*   referencing the same device, the receiver thread distributes incoming
+*   packets to the client handles.                                           */
+/*****************************************************************************/
+typedef struct BROKER_DEVICE_Ttag
+{
+  CIFXHANDLE hDevice;         /*!< Toolkit handle */
+  uint32_t   ulChannel;       /*!< Channel number or CIFX_SYSTEM_DEVICE */
+  uint32_t   ulRefCount;      /*!< Number of client handles */
+  int        fRunning;        /*!< Receiver thread running */
+  pthread_t  tRecvThread;     /*!< Receiver thread */
+  uint32_t   ulDropped;       /*!< Packets which could not be delivered */
+
+} BROKER_DEVICE_T;
+
+/*****************************************************************************/
+/*! Handle given to a client                                                 */
+/*****************************************************************************/
+typedef struct BROKER_HANDLE_Ttag
+{
+  pid_t            tOwner;        /*!< Owning process, 0 if unused */
+  uint64_t         ullOpenSeq;    /*!< Open sequence, lowest one receives indications */
+  BROKER_DEVICE_T* ptDevice;      /*!< Device referenced by the handle */
+  uint32_t         ulOrigSrc;     /*!< ulSrc of the last packet sent by the client */
+  uint32_t         ulRead;        /*!< Read index of the receive queue */
+  uint32_t         ulWrite;       /*!< Write index of the receive queue */
+  CIFX_PACKET*     ptQueue;       /*!< Receive queue (BROKER_MBX_QUEUE_DEPTH packets) */
+
+} BROKER_HANDLE_T;
+
+typedef struct INIT_PARAM_Ttag
+{
+  int   fUseSingleCard;
+  int   iCardNumber;
+  char* szShmName;
+
+} INIT_PARAM_T;
+
+static INIT_PARAM_T       s_tInitParam = {0, 0, CIFX_BROKER_SHM_NAME};
+static CIFX_BROKER_SHM_T* s_ptShm      = NULL;
+static CIFXHANDLE         s_hDriver    = NULL;
+
+static volatile sig_atomic_t s_fRunning = 0;
+
+static pthread_mutex_t    s_tLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t     s_tPacketCond;
+static BROKER_HANDLE_T    s_atHandle[CIFX_BROKER_MAX_HANDLES];
+static BROKER_DEVICE_T*   s_aptDevice[BROKER_MAX_DEVICES];
+static uint64_t           s_ullOpenSeq = 0;
+static pthread_t          s_atSlotThread[CIFX_BROKER_MAX_SLOTS];
+
+/*****************************************************************************/
+/*! Calculates an absolute timeout for the given clock
+*   \param tClock     Clock id
+*   \param ulTimeout  Timeout in ms
+*   \param ptAbs      Returned absolute time                                 */
+/*****************************************************************************/
+static void BrokerAbsTimeout(clockid_t tClock, uint32_t ulTimeout, struct timespec* ptAbs)
+{
+  clock_gettime(tClock, ptAbs);
+  ptAbs->tv_sec  += ulTimeout / 1000;
+  ptAbs->tv_nsec += (long)(ulTimeout % 1000) * 1000000;
+  if (ptAbs->tv_nsec >= 1000000000)
+  {
+    ptAbs->tv_sec++;
+    ptAbs->tv_nsec -= 1000000000;
+  }
+}
+
+/*****************************************************************************/
+/*! Delivers a packet received from the device to a client handle. Packets
+*   carrying the broker tag in ulSrc are confirmations and go back to the
+*   handle which sent the request, all other packets go to the oldest handle
+*   of the device. Must be called with s_tLock held.
+*   \param ptDevice  Device the packet was received from
+*   \param ptPacket  Received packet                                         */
+/*****************************************************************************/
+static void BrokerRoutePacket(BROKER_DEVICE_T* ptDevice, CIFX_PACKET* ptPacket)
+{
+  BROKER_HANDLE_T* ptTarget = NULL;
+  uint32_t         ulSrc    = LE32_TO_HOST(ptPacket->tHeader.ulSrc);
+  uint32_t         ulIdx;
+
+  if (CIFX_BROKER_SRC_TAG == (ulSrc & CIFX_BROKER_SRC_TAG_MASK))
+  {
+    ulIdx = ulSrc & CIFX_BROKER_SRC_INDEX_MASK;
+    if ( (ulIdx < CIFX_BROKER_MAX_HANDLES) &&
+         (s_atHandle[ulIdx].tOwner != 0)   &&
+         (s_atHandle[ulIdx].ptDevice == ptDevice) )
+    {
+      ptTarget = &s_atHandle[ulIdx];
+      ptPacket->tHeader.ulSrc = HOST_TO_LE32(ptTarget->ulOrigSrc);
+    }
+  }
+
+  if (NULL == ptTarget)
+  {
+    /* indication or unmatched confirmation, deliver to the oldest handle */
+    for (ulIdx = 0; ulIdx < CIFX_BROKER_MAX_HANDLES; ulIdx++)
+    {
+      BROKER_HANDLE_T* ptHandle = &s_atHandle[ulIdx];
+
+      if ( (ptHandle->tOwner != 0) && (ptHandle->ptDevice == ptDevice) &&
+           ((NULL == ptTarget) || (ptHandle->ullOpenSeq < ptTarget->ullOpenSeq)) )
+        ptTarget = ptHandle;
+    }
+  }
+
+  if (NULL == ptTarget)
+  {
+    ptDevice->ulDropped++;
+    return;
+  }
+
+  if ((ptTarget->ulWrite - ptTarget->ulRead) >= BROKER_MBX_QUEUE_DEPTH)
+  {
+    /* client does not fetch its packets, drop the oldest one */
+    ptTarget->ulRead++;
+    ptDevice->ulDropped++;
+    fprintf(stderr, "cifx_broker: receive queue of process %d full, packet dropped!\n", (int)ptTarget->tOwner);
+  }
+
+  memcpy(&ptTarget->ptQueue[ptTarget->ulWrite % BROKER_MBX_QUEUE_DEPTH], ptPacket, sizeof(*ptPacket));
+  ptTarget->ulWrite++;
+
+  pthread_cond_broadcast(&s_tPacketCond);
+}
+
+/*****************************************************************************/
+/*! Receiver thread of a device. Fetches all packets from the device mailbox
+*   and distributes them to the client handles.
+*   \param pvArg  Device (BROKER_DEVICE_T)
+*   \return NULL                                                             */
+/*****************************************************************************/
+static void* BrokerRecvThread(void* pvArg)
+{
+  BROKER_DEVICE_T* ptDevice = (BROKER_DEVICE_T*)pvArg;
+  CIFX_PACKET      tPacket;
+  int32_t          lRet;
+
+  while (__atomic_load_n(&ptDevice->fRunning, __ATOMIC_ACQUIRE))
+  {
+    if (CIFX_SYSTEM_DEVICE == ptDevice->ulChannel)
+      lRet = xSysdeviceGetPacket(ptDevice->hDevice, sizeof(tPacket), &tPacket, BROKER_RECV_TIMEOUT);
+    else
+      lRet = xChannelGetPacket(ptDevice->hDevice, sizeof(tPacket), &tPacket, BROKER_RECV_TIMEOUT);
+
+    if (CIFX_NO_ERROR == lRet)
+    {
+      pthread_mutex_lock(&s_tLock);
+      BrokerRoutePacket(ptDevice, &tPacket);
+      pthread_mutex_unlock(&s_tLock);
+
+    } else if ( (CIFX_DEV_GET_TIMEOUT != lRet) && (CIFX_DEV_GET_NO_PACKET != lRet) )
+    {
+      /* device not ready (e.g. during reset), do not spin */
+      usleep(BROKER_RECV_TIMEOUT * 1000);
+    }
+  }
+
+  return NULL;
+}
+
+/*****************************************************************************/
+/*! Returns the device object for an opened toolkit handle. If the device is
+*   already known, the additional toolkit handle is closed and the existing
+*   object is referenced. Must be called with s_tLock held.
+*   \param hDevice    Toolkit handle returned by xSysdeviceOpen/xChannelOpen
+*   \param ulChannel  Channel number or CIFX_SYSTEM_DEVICE
+*   \param pptDevice  Returned device
+*   \return CIFX_NO_ERROR on success                                         */
+/*****************************************************************************/
+static int32_t BrokerDeviceAttach(CIFXHANDLE hDevice, uint32_t ulChannel, BROKER_DEVICE_T** pptDevice)
+{
+  BROKER_DEVICE_T* ptDevice = NULL;
+  int              iFree    = -1;
+  int              iIdx;
+
+  for (iIdx = 0; iIdx < BROKER_MAX_DEVICES; iIdx++)
+  {
+    if (NULL == s_aptDevice[iIdx])
+    {
+      if (iFree < 0)
+        iFree = iIdx;
+
+    } else if (s_aptDevice[iIdx]->hDevice == hDevice)
+    {
+      ptDevice = s_aptDevice[iIdx];
+      break;
+    }
+  }
+
+  if (NULL != ptDevice)
+  {
+    /* toolkit handles are reference counted, drop the additional one */
+    if (CIFX_SYSTEM_DEVICE == ulChannel)
+      xSysdeviceClose(hDevice);
+    else
+      xChannelClose(hDevice);
+
+    ptDevice->ulRefCount++;
+    *pptDevice = ptDevice;
+    return CIFX_NO_ERROR;
+  }
+
+  if ( (iFree < 0) ||
+       (NULL == (ptDevice = calloc(1, sizeof(*ptDevice)))) )
+  {
+    if (CIFX_SYSTEM_DEVICE == ulChannel)
+      xSysdeviceClose(hDevice);
+    else
+      xChannelClose(hDevice);
+    return CIFX_FUNCTION_FAILED;
+  }
+
+  ptDevice->hDevice    = hDevice;
+  ptDevice->ulChannel  = ulChannel;
+  ptDevice->ulRefCount = 1;
+  ptDevice->fRunning   = 1;
+
+  if (0 != pthread_create(&ptDevice->tRecvThread, NULL, BrokerRecvThread, ptDevice))
+  {
+    if (CIFX_SYSTEM_DEVICE == ulChannel)
+      xSysdeviceClose(hDevice);
+    else
+      xChannelClose(hDevice);
+    free(ptDevice);
+    return CIFX_FUNCTION_FAILED;
+  }
+
+  s_aptDevice[iFree] = ptDevice;
+  *pptDevice         = ptDevice;
+
+  return CIFX_NO_ERROR;
+}
+
+/*****************************************************************************/
+/*! Drops a reference of a device. Must be called with s_tLock held.
+*   \param ptDevice  Device
+*   \return Device which has to be destroyed by BrokerDeviceDestroy() after
+*           releasing the lock, NULL if still referenced                     */
+/*****************************************************************************/
+static BROKER_DEVICE_T* BrokerDeviceRelease(BROKER_DEVICE_T* ptDevice)
+{
+  int iIdx;
+
+  if (--ptDevice->ulRefCount > 0)
+    return NULL;
+
+  for (iIdx = 0; iIdx < BROKER_MAX_DEVICES; iIdx++)
+  {
+    if (s_aptDevice[iIdx] == ptDevice)
+      s_aptDevice[iIdx] = NULL;
+  }
+  __atomic_store_n(&ptDevice->fRunning, 0, __ATOMIC_RELEASE);
+
+  return ptDevice;
+}
+
+/*****************************************************************************/
+/*! Stops the receiver thread and closes the toolkit handle of a device
+*   released by BrokerDeviceRelease()
+*   \param ptDevice  Device                                                  */
+/*****************************************************************************/
+static void BrokerDeviceDestroy(BROKER_DEVICE_T* ptDevice)
+{
+  if (NULL == ptDevice)
+    return;
+
+  pthread_join(ptDevice->tRecvThread, NULL);
+
+  if (CIFX_SYSTEM_DEVICE == ptDevice->ulChannel)
+    xSysdeviceClose(ptDevice->hDevice);
+  else
+    xChannelClose(ptDevice->hDevice);
+
+  if (ptDevice->ulDropped > 0)
+    fprintf(stderr, "cifx_broker: %u packet(s) of channel 0x%X could not be delivered\n",
+            ptDevice->ulDropped, ptDevice->ulChannel);
+
+  free(ptDevice);
+}
+
+/*****************************************************************************/
+/*! Opens a sysdevice or channel on behalf of a client
+*   \param tPid       Client process
+*   \param szBoard    Board name or alias
+*   \param ulChannel  Channel number or CIFX_SYSTEM_DEVICE
+*   \param pulHandle  Returned broker handle
+*   \return CIFX_NO_ERROR on success                                         */
+/*****************************************************************************/
+static int32_t BrokerHandleOpen(pid_t tPid, char* szBoard, uint32_t ulChannel, uint32_t* pulHandle)
+{
+  BROKER_HANDLE_T* ptHandle = NULL;
+  CIFX_PACKET*     ptQueue  = NULL;
+  CIFXHANDLE       hDevice  = NULL;
+  int32_t          lRet;
+  uint32_t         ulIdx;
+
+  if (CIFX_SYSTEM_DEVICE == ulChannel)
+    lRet = xSysdeviceOpen(s_hDriver, szBoard, &hDevice);
+  else
+    lRet = xChannelOpen(s_hDriver, szBoard, ulChannel, &hDevice);
+
+  if (CIFX_NO_ERROR != lRet)
+    return lRet;
+
+  if (NULL == (ptQueue = malloc(BROKER_MBX_QUEUE_DEPTH * sizeof(*ptQueue))))
+    lRet = CIFX_FUNCTION_FAILED;
+
+  pthread_mutex_lock(&s_tLock);
+
+  for (ulIdx = 0; (CIFX_NO_ERROR == lRet) && (ulIdx < CIFX_BROKER_MAX_HANDLES); ulIdx++)
+  {
+    if (0 == s_atHandle[ulIdx].tOwner)
+    {
+      ptHandle = &s_atHandle[ulIdx];
+      break;
+    }
+  }
+
+  if (CIFX_NO_ERROR != lRet)
+  {
+    /* keep error */
+  } else if (NULL == ptHandle)
+  {
+    lRet = CIFX_FUNCTION_FAILED;
+  } else
+  {
+    BROKER_DEVICE_T* ptDevice = NULL;
+
+    /* toolkit handle is either taken over or closed by BrokerDeviceAttach */
+    lRet    = BrokerDeviceAttach(hDevice, ulChannel, &ptDevice);
+    hDevice = NULL;
+
+    if (CIFX_NO_ERROR == lRet)
+    {
+      memset(ptHandle, 0, sizeof(*ptHandle));
+      ptHandle->tOwner     = tPid;
+      ptHandle->ullOpenSeq = ++s_ullOpenSeq;
+      ptHandle->ptDevice   = ptDevice;
+      ptHandle->ptQueue    = ptQueue;
+      ptQueue              = NULL;
+
+      *pulHandle = ulIdx + 1;
+    }
+  }
+
+  pthread_mutex_unlock(&s_tLock);
+
+  if (NULL != hDevice)
+  {
+    if (CIFX_SYSTEM_DEVICE == ulChannel)
+      xSysdeviceClose(hDevice);
+    else
+      xChannelClose(hDevice);
+  }
+  free(ptQueue);
+
+  return lRet;
+}
+
+/*****************************************************************************/
+/*! Closes a client handle. Must be called with s_tLock held.
+*   \param ptHandle  Handle
+*   \return Device to be destroyed after releasing the lock or NULL          */
+/*****************************************************************************/
+static BROKER_DEVICE_T* BrokerHandleClose(BROKER_HANDLE_T* ptHandle)
+{
+  BROKER_DEVICE_T* ptDevice = ptHandle->ptDevice;
+
+  free(ptHandle->ptQueue);
+  memset(ptHandle, 0, sizeof(*ptHandle));
+
+  /* wake up a pending xChannelGetPacket of the handle */
+  pthread_cond_broadcast(&s_tPacketCond);
+
+  return BrokerDeviceRelease(ptDevice);
+}
+
+/*****************************************************************************/
+/*! Closes all handles of a client process
+*   \param tPid  Client process                                              */
+/*****************************************************************************/
+static void BrokerCloseProcessHandles(pid_t tPid)
+{
+  uint32_t ulIdx;
+
+  for (ulIdx = 0; ulIdx < CIFX_BROKER_MAX_HANDLES; ulIdx++)
+  {
+    BROKER_DEVICE_T* ptDestroy = NULL;
+
+    pthread_mutex_lock(&s_tLock);
+    if ( (s_atHandle[ulIdx].tOwner != 0) &&
+         ((0 == tPid) || (s_atHandle[ulIdx].tOwner == tPid)) )
+      ptDestroy = BrokerHandleClose(&s_atHandle[ulIdx]);
+    pthread_mutex_unlock(&s_tLock);
+
+    BrokerDeviceDestroy(ptDestroy);
+  }
+}
+
+/*****************************************************************************/
+/*! Waits for a packet in the receive queue of a handle
+*   \param tPid       Client process
+*   \param ulHandle   Broker handle
+*   \param ulSize     Size of the client buffer
+*   \param ulTimeout  Timeout in ms
+*   \param ptRsp      Response receiving the packet
+*   \return CIFX_NO_ERROR on success                                         */
+/*****************************************************************************/
+static int32_t BrokerGetPacket(pid_t tPid, uint32_t ulHandle, uint32_t ulSize, uint32_t ulTimeout, CIFX_BROKER_MSG_T* ptRsp)
+{
+  BROKER_HANDLE_T* ptHandle   = &s_atHandle[ulHandle - 1];
+  uint64_t         ullOpenSeq = 0;
+  int32_t          lRet       = CIFX_NO_ERROR;
+  struct timespec  tAbs;
+
+  BrokerAbsTimeout(CLOCK_MONOTONIC, ulTimeout, &tAbs);
+
+  pthread_mutex_lock(&s_tLock);
+
+  ullOpenSeq = ptHandle->ullOpenSeq;
+
+  while (ptHandle->ulRead == ptHandle->ulWrite)
+  {
+    if ( (0 == ulTimeout) || !s_fRunning )
+    {
+      lRet = (0 == ulTimeout) ? CIFX_DEV_GET_NO_PACKET : CIFX_DEV_GET_TIMEOUT;
+      break;
+    }
+
+    if (ETIMEDOUT == pthread_cond_timedwait(&s_tPacketCond, &s_tLock, &tAbs))
+    {
+      if (ptHandle->ulRead == ptHandle->ulWrite)
+        lRet = CIFX_DEV_GET_TIMEOUT;
+      break;
+    }
+
+    if ( (ptHandle->tOwner != tPid) || (ptHandle->ullOpenSeq != ullOpenSeq) )
+    {
+      /* handle closed while waiting */
+      lRet = CIFX_INVALID_HANDLE;
+      break;
+    }
+  }
+
+  if ( (CIFX_NO_ERROR == lRet) && (ptHandle->ulRead != ptHandle->ulWrite) )
+  {
+    CIFX_PACKET* ptPacket = &ptHandle->ptQueue[ptHandle->ulRead % BROKER_MBX_QUEUE_DEPTH];
+    uint32_t     ulLen    = (uint32_t)sizeof(ptPacket->tHeader) + LE32_TO_HOST(ptPacket->tHeader.ulLen);
+
+    if (ulLen > sizeof(*ptPacket))
+      ulLen = sizeof(*ptPacket);
+
+    if (ulLen > ulSize)
+    {
+      ulLen = ulSize;
+      lRet  = CIFX_BUFFER_TOO_SHORT;
+    }
+
+    memcpy(ptRsp->abData, ptPacket, ulLen);
+    ptRsp->ulDataLen = ulLen;
+    ptHandle->ulRead++;
+  }
+
+  pthread_mutex_unlock(&s_tLock);
+
+  return lRet;
+}
+
+/*****************************************************************************/
+/*! Sends a packet on behalf of a client. ulSrc is replaced by the broker tag
+*   so the confirmation can be routed back to the handle.
+*   \param tPid       Client process
+*   \param ulHandle   Broker handle
+*   \param hDevice    Toolkit handle
+*   \param ulChannel  Channel number or CIFX_SYSTEM_DEVICE
+*   \param ptReq      Request containing the packet
+*   \return CIFX_NO_ERROR on success                                         */
+/*****************************************************************************/
+static int32_t BrokerPutPacket(pid_t tPid, uint32_t ulHandle, CIFXHANDLE hDevice, uint32_t ulChannel, const CIFX_BROKER_MSG_T* ptReq)
+{
+  BROKER_HANDLE_T* ptHandle = &s_atHandle[ulHandle - 1];
+  CIFX_PACKET      tPacket;
+
+  if ( (ptReq->ulDataLen < sizeof(tPacket.tHeader)) || (ptReq->ulDataLen > sizeof(tPacket)) )
+    return CIFX_INVALID_BUFFERSIZE;
+
+  memcpy(&tPacket, ptReq->abData, ptReq->ulDataLen);
+
+  pthread_mutex_lock(&s_tLock);
+  if (ptHandle->tOwner == tPid)
+    ptHandle->ulOrigSrc = LE32_TO_HOST(tPacket.tHeader.ulSrc);
+  pthread_mutex_unlock(&s_tLock);
+
+  tPacket.tHeader.ulSrc = HOST_TO_LE32(CIFX_BROKER_SRC_TAG | (ulHandle - 1));
+
+  if (CIFX_SYSTEM_DEVICE == ulChannel)
+    return xSysdevicePutPacket(hDevice, &tPacket, ptReq->aulParam[0]);
+  else
+    return xChannelPutPacket(hDevice, &tPacket, ptReq->aulParam[0]);
+}
+
+/*****************************************************************************/
+/*! Returns the number of packets waiting in the receive queue of a handle
+*   \param ulHandle  Broker handle
+*   \return Number of packets                                                */
+/*****************************************************************************/
+static uint32_t BrokerPendingPackets(uint32_t ulHandle)
+{
+  uint32_t ulCount;
+
+  pthread_mutex_lock(&s_tLock);
+  ulCount = s_atHandle[ulHandle - 1].ulWrite - s_atHandle[ulHandle - 1].ulRead;
+  pthread_mutex_unlock(&s_tLock);
+
+  return ulCount;
+}
+
+/*****************************************************************************/
+/*! Executes a client request
+*   \param tPid   Client process
+*   \param ptReq  Request
+*   \param ptRsp  Response to fill                                           */
+/*****************************************************************************/
+static void BrokerHandleRequest(pid_t tPid, const CIFX_BROKER_MSG_T* ptReq, CIFX_BROKER_MSG_T* ptRsp)
+{
+  const uint32_t* pulParam  = ptReq->aulParam;
+  uint32_t*       pulOut    = ptRsp->aulParam;
+  CIFXHANDLE      hDevice   = NULL;
+  uint32_t        ulChannel = 0;
+  uint32_t        ulLen;
+  int32_t         lRet      = CIFX_NO_ERROR;
+  int             fSysdeviceFunc;
+  int             fChannelFunc;
+
+  ptRsp->ulSequence = ptReq->ulSequence;
+  ptRsp->ulFunction = ptReq->ulFunction;
+  ptRsp->ulHandle   = ptReq->ulHandle;
+  ptRsp->ulDataLen  = 0;
+  memcpy(ptRsp->aulParam, ptReq->aulParam, sizeof(ptRsp->aulParam));
+
+  if (ptReq->ulDataLen > CIFX_BROKER_MAX_DATA)
+  {
+    ptRsp->lResult = CIFX_INVALID_BUFFERSIZE;
+    return;
+  }
+
+  /* functions working on a handle are grouped in CIFX_BROKER_FUNC_E */
+  fSysdeviceFunc = (ptReq->ulFunction >= eBROKER_FUNC_SYSDEVICE_CLOSE) && (ptReq->ulFunction <= eBROKER_FUNC_SYSDEVICE_BOOTSTART);
+  fChannelFunc   = (ptReq->ulFunction >= eBROKER_FUNC_CHANNEL_CLOSE)   && (ptReq->ulFunction <= eBROKER_FUNC_CHANNEL_SYNCSTATE);
+
+  if ( fSysdeviceFunc || fChannelFunc ||
+       ((ptReq->ulFunction >= eBROKER_FUNC_MBX_GETMBXSTATE) && (ptReq->ulFunction <= eBROKER_FUNC_MBX_GETSENDPACKET)) )
+  {
+    pthread_mutex_lock(&s_tLock);
+    if ( (ptReq->ulHandle > 0) && (ptReq->ulHandle <= CIFX_BROKER_MAX_HANDLES) &&
+         (s_atHandle[ptReq->ulHandle - 1].tOwner == tPid) )
+    {
+      hDevice   = s_atHandle[ptReq->ulHandle - 1].ptDevice->hDevice;
+      ulChannel = s_atHandle[ptReq->ulHandle - 1].ptDevice->ulChannel;
+    }
+    pthread_mutex_unlock(&s_tLock);
+
+    if ( (NULL == hDevice) ||
+         (fSysdeviceFunc && (CIFX_SYSTEM_DEVICE != ulChannel)) ||
+         (fChannelFunc   && (CIFX_SYSTEM_DEVICE == ulChannel)) )
+    {
+      ptRsp->lResult = CIFX_INVALID_HANDLE;
+      return;
+    }
+  }
+
+  /* lengths passed by the client must fit into the response buffer, checked before the call */
+  ulLen = 0;
+  switch (ptReq->ulFunction)
+  {
+    case eBROKER_FUNC_DRIVER_GETINFORMATION:
+    case eBROKER_FUNC_CHANNEL_INFO:
+      ulLen = pulParam[0];
+    break;
+
+    case eBROKER_FUNC_DRIVER_GETERRORDESCRIPTION:
+    case eBROKER_FUNC_DRIVER_ENUMBOARDS:
+    case eBROKER_FUNC_SYSDEVICE_INFO:
+      ulLen = pulParam[1];
+    break;
+
+    case eBROKER_FUNC_DRIVER_ENUMCHANNELS:
+    case eBROKER_FUNC_CHANNEL_IOINFO:
+    case eBROKER_FUNC_CHANNEL_IOREAD:
+    case eBROKER_FUNC_CHANNEL_IOREADSENDDATA:
+    case eBROKER_FUNC_CHANNEL_CONTROLBLOCK:
+    case eBROKER_FUNC_CHANNEL_COMMONSTATUSBLOCK:
+    case eBROKER_FUNC_CHANNEL_EXTENDEDSTATUSBLOCK:
+      ulLen = pulParam[2];
+    break;
+
+    case eBROKER_FUNC_CHANNEL_USERBLOCK:
+      ulLen = pulParam[3];
+    break;
+
+    case eBROKER_FUNC_CHANNEL_IOWRITE:
+      /* only the data sent with the request is written */
+      if (pulParam[2] > ptReq->ulDataLen)
+      {
+        ptRsp->lResult = CIFX_INVALID_BUFFERSIZE;
+        return;
+      }
+    break;
+
+    default:
+    break;
+  }
+
+  if (ulLen > CIFX_BROKER_MAX_DATA)
+  {
+    ptRsp->lResult = CIFX_INVALID_BUFFERSIZE;
+    return;
+  }
+
+  /* in/out data is exchanged via the response buffer */
+  memcpy(ptRsp->abData, ptReq->abData, ptReq->ulDataLen);
+
+  switch (ptReq->ulFunction)
+  {
+    case eBROKER_FUNC_DRIVER_OPEN:
+      if (CIFX_BROKER_VERSION != pulParam[0])
+        lRet = CIFX_DRV_WRONG_DRIVER_VERSION;
+    break;
+
+    case eBROKER_FUNC_DRIVER_CLOSE:
+      BrokerCloseProcessHandles(tPid);
+    break;
+
+    case eBROKER_FUNC_SLOT_DETACH:
+      /* slot is released by the client after receiving the response */
+    break;
+
+    case eBROKER_FUNC_DRIVER_GETINFORMATION:
+      if (CIFX_NO_ERROR == (lRet = xDriverGetInformation(s_hDriver, pulParam[0], ptRsp->abData)))
+        ptRsp->ulDataLen = pulParam[0];
+    break;
+
+    case eBROKER_FUNC_DRIVER_GETERRORDESCRIPTION:
+      if (CIFX_NO_ERROR == (lRet = xDriverGetErrorDescription((int32_t)pulParam[0], (char*)ptRsp->abData, pulParam[1])))
+        ptRsp->ulDataLen = pulParam[1];
+    break;
+
+    case eBROKER_FUNC_DRIVER_ENUMBOARDS:
+      if (CIFX_NO_ERROR == (lRet = xDriverEnumBoards(s_hDriver, pulParam[0], pulParam[1], ptRsp->abData)))
+        ptRsp->ulDataLen = pulParam[1];
+    break;
+
+    case eBROKER_FUNC_DRIVER_ENUMCHANNELS:
+      if (CIFX_NO_ERROR == (lRet = xDriverEnumChannels(s_hDriver, pulParam[0], pulParam[1], pulParam[2], ptRsp->abData)))
+        ptRsp->ulDataLen = pulParam[2];
+    break;
+
+    case eBROKER_FUNC_DRIVER_RESTARTDEVICE:
+      ptRsp->abData[CIFX_BROKER_MAX_DATA - 1] = 0;
+      lRet = xDriverRestartDevice(s_hDriver, (char*)ptRsp->abData, NULL);
+    break;
+
+    case eBROKER_FUNC_SYSDEVICE_OPEN:
+    case eBROKER_FUNC_CHANNEL_OPEN:
+      ptRsp->abData[CIFX_BROKER_MAX_DATA - 1] = 0;
+      lRet = BrokerHandleOpen(tPid, (char*)ptRsp->abData,
+                              (eBROKER_FUNC_SYSDEVICE_OPEN == ptReq->ulFunction) ? CIFX_SYSTEM_DEVICE : pulParam[0],
+                              &pulOut[0]);
+    break;
+
+    case eBROKER_FUNC_SYSDEVICE_CLOSE:
+    case eBROKER_FUNC_CHANNEL_CLOSE:
+    {
+      BROKER_DEVICE_T* ptDestroy = NULL;
+
+      pthread_mutex_lock(&s_tLock);
+      if (s_atHandle[ptReq->ulHandle - 1].tOwner == tPid)
+        ptDestroy = BrokerHandleClose(&s_atHandle[ptReq->ulHandle - 1]);
+      pthread_mutex_unlock(&s_tLock);
+
+      BrokerDeviceDestroy(ptDestroy);
+    }
+    break;
+
+    case eBROKER_FUNC_SYSDEVICE_INFO:
+      if (CIFX_NO_ERROR == (lRet = xSysdeviceInfo(hDevice, pulParam[0], pulParam[1], ptRsp->abData)))
+        ptRsp->ulDataLen = pulParam[1];
+    break;
+
+    case eBROKER_FUNC_SYSDEVICE_RESET:
+      lRet = xSysdeviceReset(hDevice, pulParam[0]);
+    break;
+
+    case eBROKER_FUNC_SYSDEVICE_RESETEX:
+      lRet = xSysdeviceResetEx(hDevice, pulParam[0], pulParam[1]);
+    break;
+
+    case eBROKER_FUNC_SYSDEVICE_BOOTSTART:
+      lRet = xSysdeviceBootstart(hDevice, pulParam[0]);
+    break;
+
+    case eBROKER_FUNC_CHANNEL_CONFIGLOCK:
+      lRet = xChannelConfigLock(hDevice, pulParam[0], &pulOut[1], pulParam[2]);
+    break;
+
+    case eBROKER_FUNC_CHANNEL_RESET:
+      lRet = xChannelReset(hDevice, pulParam[0], pulParam[1]);
+    break;
+
+    case eBROKER_FUNC_CHANNEL_INFO:
+      if (CIFX_NO_ERROR == (lRet = xChannelInfo(hDevice, pulParam[0], ptRsp->abData)))
+        ptRsp->ulDataLen = pulParam[0];
+    break;
+
+    case eBROKER_FUNC_CHANNEL_WATCHDOG:
+      lRet = xChannelWatchdog(hDevice, pulParam[0], &pulOut[1]);
+    break;
+
+    case eBROKER_FUNC_CHANNEL_HOSTSTATE:
+      lRet = xChannelHostState(hDevice, pulParam[0], &pulOut[1], pulParam[2]);
+    break;
+
+    case eBROKER_FUNC_CHANNEL_BUSSTATE:
+      lRet = xChannelBusState(hDevice, pulParam[0], &pulOut[1], pulParam[2]);
+    break;
+
+    case eBROKER_FUNC_CHANNEL_IOINFO:
+      if (CIFX_NO_ERROR == (lRet = xChannelIOInfo(hDevice, pulParam[0], pulParam[1], pulParam[2], ptRsp->abData)))
+        ptRsp->ulDataLen = pulParam[2];
+    break;
+
+    case eBROKER_FUNC_CHANNEL_IOREAD:
+      if (CIFX_NO_ERROR == (lRet = xChannelIORead(hDevice, pulParam[0], pulParam[1], pulParam[2], ptRsp->abData, pulParam[3])))
+        ptRsp->ulDataLen = pulParam[2];
+    break;
+
+    case eBROKER_FUNC_CHANNEL_IOWRITE:
+      lRet = xChannelIOWrite(hDevice, pulParam[0], pulParam[1], pulParam[2], ptRsp->abData, pulParam[3]);
+    break;
+
+    case eBROKER_FUNC_CHANNEL_IOREADSENDDATA:
+      if (CIFX_NO_ERROR == (lRet = xChannelIOReadSendData(hDevice, pulParam[0], pulParam[1], pulParam[2], ptRsp->abData)))
+        ptRsp->ulDataLen = pulParam[2];
+    break;
+
+    case eBROKER_FUNC_CHANNEL_CONTROLBLOCK:
+      if (CIFX_NO_ERROR == (lRet = xChannelControlBlock(hDevice, pulParam[0], pulParam[1], pulParam[2], ptRsp->abData)))
+        ptRsp->ulDataLen = pulParam[2];
+    break;
+
+    case eBROKER_FUNC_CHANNEL_COMMONSTATUSBLOCK:
+      if (CIFX_NO_ERROR == (lRet = xChannelCommonStatusBlock(hDevice, pulParam[0], pulParam[1], pulParam[2], ptRsp->abData)))
+        ptRsp->ulDataLen = pulParam[2];
+    break;
+
+    case eBROKER_FUNC_CHANNEL_EXTENDEDSTATUSBLOCK:
+      if (CIFX_NO_ERROR == (lRet = xChannelExtendedStatusBlock(hDevice, pulParam[0], pulParam[1], pulParam[2], ptRsp->abData)))
+        ptRsp->ulDataLen = pulParam[2];
+    break;
+
+    case eBROKER_FUNC_CHANNEL_USERBLOCK:
+      if (CIFX_NO_ERROR == (lRet = xChannelUserBlock(hDevice, pulParam[0], pulParam[1], pulParam[2], pulParam[3], ptRsp->abData)))
+        ptRsp->ulDataLen = pulParam[3];
+    break;
+
+    case eBROKER_FUNC_CHANNEL_PLCISREADREADY:
+      lRet = xChannelPLCIsReadReady(hDevice, pulParam[0], &pulOut[1]);
+    break;
+
+    case eBROKER_FUNC_CHANNEL_PLCISWRITEREADY:
+      lRet = xChannelPLCIsWriteReady(hDevice, pulParam[0], &pulOut[1]);
+    break;
+
+    case eBROKER_FUNC_CHANNEL_PLCACTIVATEWRITE:
+      lRet = xChannelPLCActivateWrite(hDevice, pulParam[0]);
+    break;
+
+    case eBROKER_FUNC_CHANNEL_PLCACTIVATEREAD:
+      lRet = xChannelPLCActivateRead(hDevice, pulParam[0]);
+    break;
+
+    case eBROKER_FUNC_CHANNEL_SYNCSTATE:
+      lRet = xChannelSyncState(hDevice, pulParam[0], pulParam[1], &pulOut[2]);
+    break;
+
+    case eBROKER_FUNC_MBX_GETMBXSTATE:
+      if (CIFX_SYSTEM_DEVICE == ulChannel)
+        lRet = xSysdeviceGetMBXState(hDevice, &pulOut[0], &pulOut[1]);
+      else
+        lRet = xChannelGetMBXState(hDevice, &pulOut[0], &pulOut[1]);
+
+      /* device mailbox is emptied by the receiver thread, report own queue */
+      pulOut[0] = BrokerPendingPackets(ptReq->ulHandle);
+    break;
+
+    case eBROKER_FUNC_MBX_PUTPACKET:
+      lRet = BrokerPutPacket(tPid, ptReq->ulHandle, hDevice, ulChannel, ptReq);
+    break;
+
+    case eBROKER_FUNC_MBX_GETPACKET:
+      ulLen = (pulParam[0] > CIFX_BROKER_MAX_DATA) ? CIFX_BROKER_MAX_DATA : pulParam[0];
+      lRet  = BrokerGetPacket(tPid, ptReq->ulHandle, ulLen, pulParam[1], ptRsp);
+    break;
+
+    case eBROKER_FUNC_MBX_GETSENDPACKET:
+      if (CIFX_SYSTEM_DEVICE == ulChannel)
+      {
+        lRet = CIFX_FUNCTION_NOT_AVAILABLE;
+      } else
+      {
+        ulLen = (pulParam[0] > CIFX_BROKER_MAX_DATA) ? CIFX_BROKER_MAX_DATA : pulParam[0];
+        if (CIFX_NO_ERROR == (lRet = xChannelGetSendPacket(hDevice, ulLen, (CIFX_PACKET*)ptRsp->abData)))
+          ptRsp->ulDataLen = ulLen;
+      }
+    break;
+
+    default:
+      lRet = CIFX_FUNCTION_NOT_AVAILABLE;
+    break;
+  }
+
+  /* functions returning data must not exceed the response buffer */
+  if (ptRsp->ulDataLen > CIFX_BROKER_MAX_DATA)
+    ptRsp->ulDataLen = CIFX_BROKER_MAX_DATA;
+
+  ptRsp->lResult = lRet;
+}
+
+/*****************************************************************************/
+/*! Releases the slot of a terminated client and closes its handles
+*   \param ptSlot  Slot
+*   \param tPid    Terminated client process                                 */
+/*****************************************************************************/
+static void BrokerReleaseSlot(CIFX_BROKER_SLOT_T* ptSlot, pid_t tPid)
+{
+  BrokerCloseProcessHandles(tPid);
+
+  /* drop all pending requests and unread responses */
+  while (NULL != CifXBrokerRingPeek(&ptSlot->tRequest))
+    CifXBrokerRingPop(&ptSlot->tRequest);
+  while (0 == sem_trywait(&ptSlot->tRequest.tSignal))
+    ;
+  while (NULL != CifXBrokerRingPeek(&ptSlot->tResponse))
+    CifXBrokerRingPop(&ptSlot->tResponse);
+  while (0 == sem_trywait(&ptSlot->tResponse.tSignal))
+    ;
+
+  __atomic_store_n(&ptSlot->tOwner, 0, __ATOMIC_RELEASE);
+}
+
+/*****************************************************************************/
+/*! Service thread of a client slot
+*   \param pvArg  Slot (CIFX_BROKER_SLOT_T)
+*   \return NULL                                                             */
+/*****************************************************************************/
+static void* BrokerSlotThread(void* pvArg)
+{
+  CIFX_BROKER_SLOT_T* ptSlot = (CIFX_BROKER_SLOT_T*)pvArg;
+
+  while (s_fRunning)
+  {
+    struct timespec tAbs;
+    pid_t           tPid;
+
+    BrokerAbsTimeout(CLOCK_REALTIME, BROKER_SLOT_CHECK_PERIOD * 1000, &tAbs);
+
+    if (0 == sem_timedwait(&ptSlot->tRequest.tSignal, &tAbs))
+    {
+      CIFX_BROKER_MSG_T* ptReq = CifXBrokerRingPeek(&ptSlot->tRequest);
+      CIFX_BROKER_MSG_T* ptRsp = CifXBrokerRingReserve(&ptSlot->tResponse);
+
+      tPid = __atomic_load_n(&ptSlot->tOwner, __ATOMIC_ACQUIRE);
+
+      if (NULL == ptReq)
+        continue;
+
+      if ( (NULL != ptRsp) && (0 != tPid) )
+      {
+        BrokerHandleRequest(tPid, ptReq, ptRsp);
+        CifXBrokerRingPop(&ptSlot->tRequest);
+        CifXBrokerRingPush(&ptSlot->tResponse);
+      } else
+      {
+        /* client does not consume its responses, drop request */
+        CifXBrokerRingPop(&ptSlot->tRequest);
+      }
+
+    } else if (0 != (tPid = __atomic_load_n(&ptSlot->tOwner, __ATOMIC_ACQUIRE)))
+    {
+      if ( (0 != kill(tPid, 0)) && (ESRCH == errno) )
+      {
+        printf("Client process %d terminated, releasing its resources\n", (int)tPid);
+        BrokerReleaseSlot(ptSlot, tPid);
+      }
+    }
+  }
+
+  return NULL;
+}
+
+/*****************************************************************************/
+/*! Creates the shared memory segment. Fails if another broker is using it.
+*   \param szName  Name of the shared memory object
+*   \return CIFX_NO_ERROR on success                                         */
+/*****************************************************************************/
+static int32_t BrokerCreateShm(const char* szName)
+{
+  CIFX_BROKER_SHM_T* ptShm = NULL;
+  int                iFd;
+  int                iSlot;
+
+  /* check for a running broker */
+  if (-1 != (iFd = shm_open(szName, O_RDONLY, 0)))
+  {
+    struct stat tStat;
+    int         fActive = 0;
+
+    if ( (0 == fstat(iFd, &tStat)) && ((size_t)tStat.st_size >= sizeof(*ptShm)) )
+    {
+      ptShm = mmap(NULL, sizeof(*ptShm), PROT_READ, MAP_SHARED, iFd, 0);
+      if (MAP_FAILED != ptShm)
+      {
+        fActive = (CIFX_BROKER_MAGIC == ptShm->ulMagic) && (0 == kill(ptShm->tBrokerPid, 0));
+        munmap(ptShm, sizeof(*ptShm));
+      }
+    }
+    close(iFd);
+
+    if (fActive)
+    {
+      fprintf(stderr, "Another broker is already serving \"%s\"!\n", szName);
+      return CIFX_DRV_INIT_STATE_ERROR;
+    }
+    shm_unlink(szName);
+  }
+
+  if (-1 == (iFd = shm_open(szName, O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP)))
+  {
+    perror("shm_open");
+    return CIFX_DRV_INIT_ERROR;
+  }
+
+  if (0 != ftruncate(iFd, sizeof(*ptShm)))
+  {
+    perror("ftruncate");
+    close(iFd);
+    shm_unlink(szName);
+    return CIFX_DRV_INIT_ERROR;
+  }
+
+  ptShm = mmap(NULL, sizeof(*ptShm), PROT_READ | PROT_WRITE, MAP_SHARED, iFd, 0);
+  close(iFd);
+
+  if (MAP_FAILED == ptShm)
+  {
+    perror("mmap");
+    shm_unlink(szName);
+    return CIFX_DRV_INIT_ERROR;
+  }
+
+  memset(ptShm, 0, sizeof(*ptShm));
+  for (iSlot = 0; iSlot < CIFX_BROKER_MAX_SLOTS; iSlot++)
+  {
+    sem_init(&ptShm->atSlot[iSlot].tRequest.tSignal,  1, 0);
+    sem_init(&ptShm->atSlot[iSlot].tResponse.tSignal, 1, 0);
+  }
+  ptShm->ulVersion  = CIFX_BROKER_VERSION;
+  ptShm->tBrokerPid = getpid();
+
+  /* magic is written last, clients check it before attaching */
+  __atomic_store_n(&ptShm->ulMagic, CIFX_BROKER_MAGIC, __ATOMIC_RELEASE);
+
+  s_ptShm = ptShm;
+
+  return CIFX_NO_ERROR;
+}
+
+/*****************************************************************************/
+/*! Removes the shared memory segment
+*   \param szName  Name of the shared memory object                          */
+/*****************************************************************************/
+static void BrokerDestroyShm(const char* szName)
+{
+  int iSlot;
+
+  if (NULL == s_ptShm)
+    return;
+
+  __atomic_store_n(&s_ptShm->ulMagic, 0, __ATOMIC_RELEASE);
+  for (iSlot = 0; iSlot < CIFX_BROKER_MAX_SLOTS; iSlot++)
+  {
+    sem_destroy(&s_ptShm->atSlot[iSlot].tRequest.tSignal);
+    sem_destroy(&s_ptShm->atSlot[iSlot].tResponse.tSignal);
+  }
+  munmap(s_ptShm, sizeof(*s_ptShm));
+  shm_unlink(szName);
+  s_ptShm = NULL;
+}
+
+/*****************************************************************************/
+/*! Signal handler stopping the broker                                       */
+/*****************************************************************************/
+static void BrokerStop(int iSignal)
+{
+  (void)iSignal;
+  s_fRunning = 0;
+}
+
+/*****************************************************************************/
+/*! Function display optional arguments                                      */
+/*****************************************************************************/
+static void DisplayHelp(void)
+{
+  printf("The cifx_broker application gives several processes access to the same cifX device.\n");
+  printf("Client applications link against libcifxbroker instead of libcifx.\n");
+  printf("Available options:\n");
+  printf("[-n <n>] initialize only a specific card specified by 'n'.\n");
+  printf("[-s <name>] name of the shared memory object (default \"%s\").\n", CIFX_BROKER_SHM_NAME);
+  printf("[-h] display this help.\n");
+
+  printf("Example:\n");
+  printf("cifx_broker -n 0\n");
+}
+
+/*****************************************************************************/
+/*! Function evaluates input arguments                                       */
+/*****************************************************************************/
+static int ValidateArgs(int argc, char* argv[])
+{
+  int iArgCnt;
+
+  for (iArgCnt = 1; iArgCnt < argc; iArgCnt++)
+  {
+    if ( (0 == strcasecmp("-n", argv[iArgCnt])) && ((iArgCnt + 1) < argc) )
+    {
+      s_tInitParam.fUseSingleCard = 1;
+      s_tInitParam.iCardNumber    = atoi(argv[++iArgCnt]);
+    } else if ( (0 == strcasecmp("-s", argv[iArgCnt])) && ((iArgCnt + 1) < argc) )
+    {
+      s_tInitParam.szShmName = argv[++iArgCnt];
+    } else
+    {
+      if (0 != strcasecmp("-h", argv[iArgCnt]))
+        printf("Invalid argument!\n");
+      DisplayHelp();
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+int main(int argc, char* argv[])
+{
+  struct CIFX_LINUX_INIT tInit = {0};
+  struct sigaction       tSigTerm;
+  pthread_condattr_t     tCondAttr;
+  int32_t                lRet;
+  int                    iSlot;
+
+  if (0 == ValidateArgs(argc, argv))
+    return 0;
+
+  pthread_condattr_init(&tCondAttr);
+  pthread_condattr_setclock(&tCondAttr, CLOCK_MONOTONIC);
+  pthread_cond_init(&s_tPacketCond, &tCondAttr);
+  pthread_condattr_destroy(&tCondAttr);
+
+  memset(&tSigTerm, 0, sizeof(tSigTerm));
+  sigemptyset(&tSigTerm.sa_mask);
+  tSigTerm.sa_handler = BrokerStop;
+  sigaction(SIGINT,  &tSigTerm, NULL);
+  sigaction(SIGTERM, &tSigTerm, NULL);
+
+  tInit.init_options       = CIFX_DRIVER_INIT_AUTOSCAN;
+  tInit.trace_level        = 255;
+  /* the broker is the only process accessing the card */
+  tInit.fEnableCardLocking = 1;
+
+  if (s_tInitParam.fUseSingleCard)
+  {
+    tInit.init_options = CIFX_DRIVER_INIT_CARDNUMBER;
+    tInit.iCardNumber  = s_tInitParam.iCardNumber;
+  }
+
+  printf("cifXDriverInit...\n");
+  if (CIFX_NO_ERROR != (lRet = cifXDriverInit(&tInit)))
+  {
+    printf("CifXDriver initialization failed (0x%08X)!\n", (unsigned int)lRet);
+    return -1;
+  }
+
+  if (CIFX_NO_ERROR != (lRet = xDriverOpen(&s_hDriver)))
+  {
+    printf("Error opening driver (0x%08X)!\n", (unsigned int)lRet);
+  } else if (CIFX_NO_ERROR == (lRet = BrokerCreateShm(s_tInitParam.szShmName)))
+  {
+    s_fRunning = 1;
+
+    for (iSlot = 0; iSlot < CIFX_BROKER_MAX_SLOTS; iSlot++)
+      pthread_create(&s_atSlotThread[iSlot], NULL, BrokerSlotThread, &s_ptShm->atSlot[iSlot]);
+
+    printf("Broker serving \"%s\", press ctrl+'c' to quit!\n", s_tInitParam.szShmName);
+
+    while (s_fRunning)
+      sleep(1);
+
+    /* wake up pending xChannelGetPacket calls */
+    pthread_mutex_lock(&s_tLock);
+    pthread_cond_broadcast(&s_tPacketCond);
+    pthread_mutex_unlock(&s_tLock);
+
+    for (iSlot = 0; iSlot < CIFX_BROKER_MAX_SLOTS; iSlot++)
+      pthread_join(s_atSlotThread[iSlot], NULL);
+
+    BrokerCloseProcessHandles(0);
+    BrokerDestroyShm(s_tInitParam.szShmName);
+  }
+
+  if (NULL != s_hDriver)
+    xDriverClose(s_hDriver);
+
+  cifXDriverDeinit();
+
+  return (CIFX_NO_ERROR == lRet) ? 0 : -1;
+}
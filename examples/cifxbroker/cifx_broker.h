@@ -0,0 +1,210 @@
+// SPDX-License-Identifier: MIT
+/**************************************************************************************
+ *
+ * Copyright (c) 2025, Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserved.
+ *
+ * Description: Shared memory layout and protocol of the cifX broker, which gives
+ *              several processes access to the same cifX device.
+ *
+ **************************************************************************************/
+
+#ifndef __CIFX_BROKER__H
+#define __CIFX_BROKER__H
+
+#include <stdint.h>
+#include <semaphore.h>
+#include <sys/types.h>
+
+#include "cifXUser.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CIFX_BROKER_SHM_NAME          "/cifx_broker"    /*!< Default name of the shared memory object */
+#define CIFX_BROKER_SHM_ENV           "CIFX_BROKER_SHM" /*!< Environment variable overriding the shared memory name */
+
+#define CIFX_BROKER_MAGIC             0x4B524243UL      /*!< "CBRK" */
+#define CIFX_BROKER_VERSION           1
+
+#define CIFX_BROKER_MAX_SLOTS         32                /*!< Number of client slots (one per client thread) */
+#define CIFX_BROKER_RING_ENTRIES      4                 /*!< Entries per ring, must be a power of 2 */
+#define CIFX_BROKER_MAX_DATA          8192              /*!< Maximum payload of a single request/response */
+
+#define CIFX_BROKER_MAX_HANDLES       256               /*!< Maximum number of open sysdevice/channel handles */
+#define CIFX_BROKER_SRC_TAG           0xCB000000UL      /*!< Tag placed in ulSrc of packets sent via the broker */
+#define CIFX_BROKER_SRC_TAG_MASK      0xFFFF0000UL
+#define CIFX_BROKER_SRC_INDEX_MASK    0x0000FFFFUL
+
+#define CIFX_BROKER_RESPONSE_MARGIN   2000              /*!< Additional time [ms] a client waits for a response */
+
+/*****************************************************************************/
+/*! Functions which can be requested from the broker                         */
+/*****************************************************************************/
+typedef enum CIFX_BROKER_FUNC_Etag
+{
+  eBROKER_FUNC_DRIVER_OPEN = 1,
+  eBROKER_FUNC_DRIVER_CLOSE,
+  eBROKER_FUNC_DRIVER_GETINFORMATION,
+  eBROKER_FUNC_DRIVER_GETERRORDESCRIPTION,
+  eBROKER_FUNC_DRIVER_ENUMBOARDS,
+  eBROKER_FUNC_DRIVER_ENUMCHANNELS,
+  eBROKER_FUNC_DRIVER_RESTARTDEVICE,
+  eBROKER_FUNC_SLOT_DETACH,
+
+  eBROKER_FUNC_SYSDEVICE_OPEN,
+  eBROKER_FUNC_SYSDEVICE_CLOSE,
+  eBROKER_FUNC_SYSDEVICE_INFO,
+  eBROKER_FUNC_SYSDEVICE_RESET,
+  eBROKER_FUNC_SYSDEVICE_RESETEX,
+  eBROKER_FUNC_SYSDEVICE_BOOTSTART,
+
+  eBROKER_FUNC_CHANNEL_OPEN,
+  eBROKER_FUNC_CHANNEL_CLOSE,
+  eBROKER_FUNC_CHANNEL_CONFIGLOCK,
+  eBROKER_FUNC_CHANNEL_RESET,
+  eBROKER_FUNC_CHANNEL_INFO,
+  eBROKER_FUNC_CHANNEL_WATCHDOG,
+  eBROKER_FUNC_CHANNEL_HOSTSTATE,
+  eBROKER_FUNC_CHANNEL_BUSSTATE,
+  eBROKER_FUNC_CHANNEL_IOINFO,
+  eBROKER_FUNC_CHANNEL_IOREAD,
+  eBROKER_FUNC_CHANNEL_IOWRITE,
+  eBROKER_FUNC_CHANNEL_IOREADSENDDATA,
+  eBROKER_FUNC_CHANNEL_CONTROLBLOCK,
+  eBROKER_FUNC_CHANNEL_COMMONSTATUSBLOCK,
+  eBROKER_FUNC_CHANNEL_EXTENDEDSTATUSBLOCK,
+  eBROKER_FUNC_CHANNEL_USERBLOCK,
+  eBROKER_FUNC_CHANNEL_PLCISREADREADY,
+  eBROKER_FUNC_CHANNEL_PLCISWRITEREADY,
+  eBROKER_FUNC_CHANNEL_PLCACTIVATEWRITE,
+  eBROKER_FUNC_CHANNEL_PLCACTIVATEREAD,
+  eBROKER_FUNC_CHANNEL_SYNCSTATE,
+
+  /* mailbox functions, valid for sysdevice and channel handles */
+  eBROKER_FUNC_MBX_GETMBXSTATE,
+  eBROKER_FUNC_MBX_PUTPACKET,
+  eBROKER_FUNC_MBX_GETPACKET,
+  eBROKER_FUNC_MBX_GETSENDPACKET,
+
+} CIFX_BROKER_FUNC_E;
+
+/*****************************************************************************/
+/*! Request/response exchanged between a client and the broker               */
+/*****************************************************************************/
+typedef struct CIFX_BROKER_MSG_Ttag
+{
+  uint32_t ulSequence;                     /*!< Sequence number, echoed in the response */
+  uint32_t ulFunction;                     /*!< Requested function (see CIFX_BROKER_FUNC_E) */
+  uint32_t ulHandle;                       /*!< Broker handle (index + 1), 0 if not required */
+  int32_t  lResult;                        /*!< Result of the function (response only) */
+  uint32_t aulParam[4];                    /*!< Function specific parameters */
+  uint32_t ulDataLen;                      /*!< Valid bytes in abData */
+  uint8_t  abData[CIFX_BROKER_MAX_DATA];   /*!< Function specific data */
+
+} CIFX_BROKER_MSG_T;
+
+/*****************************************************************************/
+/*! Lock-free single producer / single consumer ring. ulHead is written by
+*   the producer only, ulTail by the consumer only. tSignal is posted once
+*   per published entry.                                                     */
+/*****************************************************************************/
+typedef struct CIFX_BROKER_RING_Ttag
+{
+  uint32_t          ulHead;
+  uint8_t           abPadHead[60];
+  uint32_t          ulTail;
+  uint8_t           abPadTail[60];
+  sem_t             tSignal;
+  CIFX_BROKER_MSG_T atEntry[CIFX_BROKER_RING_ENTRIES];
+
+} CIFX_BROKER_RING_T;
+
+/*****************************************************************************/
+/*! Client slot. A client claims a free slot by changing tOwner from 0 to
+*   its process id (atomic compare and swap).                                */
+/*****************************************************************************/
+typedef struct CIFX_BROKER_SLOT_Ttag
+{
+  pid_t              tOwner;     /*!< Process id of the client, 0 if free */
+  CIFX_BROKER_RING_T tRequest;   /*!< client -> broker */
+  CIFX_BROKER_RING_T tResponse;  /*!< broker -> client */
+
+} CIFX_BROKER_SLOT_T;
+
+/*****************************************************************************/
+/*! Shared memory object created by the broker                               */
+/*****************************************************************************/
+typedef struct CIFX_BROKER_SHM_Ttag
+{
+  uint32_t           ulMagic;
+  uint32_t           ulVersion;
+  pid_t              tBrokerPid;
+  uint32_t           ulReserved;
+  CIFX_BROKER_SLOT_T atSlot[CIFX_BROKER_MAX_SLOTS];
+
+} CIFX_BROKER_SHM_T;
+
+/*****************************************************************************/
+/*! Returns the next free ring entry of the producer or NULL if the ring is
+*   full. The entry is published by CifXBrokerRingPush().
+*   \param ptRing  Ring
+*   \return Pointer to entry or NULL                                         */
+/*****************************************************************************/
+static inline CIFX_BROKER_MSG_T* CifXBrokerRingReserve(CIFX_BROKER_RING_T* ptRing)
+{
+  uint32_t ulHead = __atomic_load_n(&ptRing->ulHead, __ATOMIC_RELAXED);
+  uint32_t ulTail = __atomic_load_n(&ptRing->ulTail, __ATOMIC_ACQUIRE);
+
+  if ((ulHead - ulTail) >= CIFX_BROKER_RING_ENTRIES)
+    return NULL;
+
+  return &ptRing->atEntry[ulHead & (CIFX_BROKER_RING_ENTRIES - 1)];
+}
+
+/*****************************************************************************/
+/*! Publishes the entry returned by CifXBrokerRingReserve() and wakes up the
+*   consumer.
+*   \param ptRing  Ring                                                      */
+/*****************************************************************************/
+static inline void CifXBrokerRingPush(CIFX_BROKER_RING_T* ptRing)
+{
+  uint32_t ulHead = __atomic_load_n(&ptRing->ulHead, __ATOMIC_RELAXED);
+
+  __atomic_store_n(&ptRing->ulHead, ulHead + 1, __ATOMIC_RELEASE);
+  sem_post(&ptRing->tSignal);
+}
+
+/*****************************************************************************/
+/*! Returns the oldest published entry of the consumer or NULL if the ring
+*   is empty. The entry is released by CifXBrokerRingPop().
+*   \param ptRing  Ring
+*   \return Pointer to entry or NULL                                         */
+/*****************************************************************************/
+static inline CIFX_BROKER_MSG_T* CifXBrokerRingPeek(CIFX_BROKER_RING_T* ptRing)
+{
+  uint32_t ulTail = __atomic_load_n(&ptRing->ulTail, __ATOMIC_RELAXED);
+  uint32_t ulHead = __atomic_load_n(&ptRing->ulHead, __ATOMIC_ACQUIRE);
+
+  if (ulHead == ulTail)
+    return NULL;
+
+  return &ptRing->atEntry[ulTail & (CIFX_BROKER_RING_ENTRIES - 1)];
+}
+
+/*****************************************************************************/
+/*! Releases the entry returned by CifXBrokerRingPeek()
+*   \param ptRing  Ring                                                      */
+/*****************************************************************************/
+static inline void CifXBrokerRingPop(CIFX_BROKER_RING_T* ptRing)
+{
+  uint32_t ulTail = __atomic_load_n(&ptRing->ulTail, __ATOMIC_RELAXED);
+
+  __atomic_store_n(&ptRing->ulTail, ulTail + 1, __ATOMIC_RELEASE);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CIFX_BROKER__H */
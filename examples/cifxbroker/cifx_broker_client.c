@@ -0,0 +1,902 @@
+// SPDX-License-Identifier: MIT
+/**************************************************************************************
+ *
+ * Copyright (c) 2025, Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserved.
+ *
+ * Description: cifX API client library (libcifxbroker). Implements the cifX API by
+ *              forwarding all calls to the cifx_broker daemon via shared memory.
+ *
+ **************************************************************************************/
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "cifXErrors.h"
+#include "cifXEndianess.h"
+#include "cifx_broker.h"
+
+/* handle conversion, broker handles are indices starting at 1 */
+#define BROKER_HANDLE(h)     ((uint32_t)(uintptr_t)(h))
+#define CIFX_HANDLE(ul)      ((CIFXHANDLE)(uintptr_t)(ul))
+
+static pthread_mutex_t    s_tLock       = PTHREAD_MUTEX_INITIALIZER;
+static CIFX_BROKER_SHM_T* s_ptShm       = NULL;
+static uint32_t           s_ulOpenCount = 0;
+static pthread_key_t      s_tSlotKey;
+static pthread_once_t     s_tSlotKeyOnce = PTHREAD_ONCE_INIT;
+
+/* driver handle returned by xDriverOpen */
+#define BROKER_DRIVER_HANDLE ((CIFXHANDLE)&s_ulOpenCount)
+
+static __thread uint32_t  s_ulSequence  = 0;
+
+static int32_t BrokerTransfer(uint32_t ulFunction, uint32_t ulHandle, uint32_t* pulParam,
+                              const void* pvSend, uint32_t ulSendLen, void* pvRecv, uint32_t ulRecvLen,
+                              uint32_t ulTimeout);
+
+/*****************************************************************************/
+/*! Thread exit handler, returns the slot of the thread to the broker
+*   \param pvSlot  Slot of the terminating thread                            */
+/*****************************************************************************/
+static void BrokerSlotDestructor(void* pvSlot)
+{
+  CIFX_BROKER_SLOT_T* ptSlot       = (CIFX_BROKER_SLOT_T*)pvSlot;
+  uint32_t            aulParam[4]  = {0};
+
+  if (ptSlot->tOwner != getpid())
+    return;
+
+  /* slot must remain usable by BrokerTransfer */
+  pthread_setspecific(s_tSlotKey, ptSlot);
+
+  if (CIFX_NO_ERROR == BrokerTransfer(eBROKER_FUNC_SLOT_DETACH, 0, aulParam, NULL, 0, NULL, 0, 0))
+  {
+    pthread_setspecific(s_tSlotKey, NULL);
+    __atomic_store_n(&ptSlot->tOwner, 0, __ATOMIC_RELEASE);
+  } else
+  {
+    /* broker releases the slot after process termination */
+    pthread_setspecific(s_tSlotKey, NULL);
+  }
+}
+
+/*****************************************************************************/
+/*! Creates the thread specific slot key                                     */
+/*****************************************************************************/
+static void BrokerCreateSlotKey(void)
+{
+  pthread_key_create(&s_tSlotKey, BrokerSlotDestructor);
+}
+
+/*****************************************************************************/
+/*! Maps the shared memory segment of the broker. The mapping is kept for the
+*   lifetime of the process. Must be called with s_tLock held.
+*   \return CIFX_NO_ERROR on success                                         */
+/*****************************************************************************/
+static int32_t BrokerMap(void)
+{
+  CIFX_BROKER_SHM_T* ptShm;
+  const char*        szName;
+  int                iFd;
+
+  if (NULL != s_ptShm)
+  {
+    if ( (CIFX_BROKER_MAGIC == __atomic_load_n(&s_ptShm->ulMagic, __ATOMIC_ACQUIRE)) &&
+         (0 == kill(s_ptShm->tBrokerPid, 0)) )
+      return CIFX_NO_ERROR;
+
+    /* broker restarted, map the new segment */
+    munmap(s_ptShm, sizeof(*s_ptShm));
+    s_ptShm = NULL;
+  }
+
+  if (NULL == (szName = getenv(CIFX_BROKER_SHM_ENV)))
+    szName = CIFX_BROKER_SHM_NAME;
+
+  if (-1 == (iFd = shm_open(szName, O_RDWR, 0)))
+    return CIFX_DRV_DRIVER_NOT_LOADED;
+
+  ptShm = mmap(NULL, sizeof(*ptShm), PROT_READ | PROT_WRITE, MAP_SHARED, iFd, 0);
+  close(iFd);
+
+  if (MAP_FAILED == ptShm)
+    return CIFX_DRV_DRIVER_NOT_LOADED;
+
+  if (CIFX_BROKER_MAGIC != __atomic_load_n(&ptShm->ulMagic, __ATOMIC_ACQUIRE))
+  {
+    munmap(ptShm, sizeof(*ptShm));
+    return CIFX_DRV_DRIVER_NOT_LOADED;
+  }
+
+  if (CIFX_BROKER_VERSION != ptShm->ulVersion)
+  {
+    munmap(ptShm, sizeof(*ptShm));
+    return CIFX_DRV_WRONG_DRIVER_VERSION;
+  }
+
+  s_ptShm = ptShm;
+
+  return CIFX_NO_ERROR;
+}
+
+/*****************************************************************************/
+/*! Returns the slot of the calling thread, a free slot is claimed on the
+*   first call of a thread
+*   \param pptSlot  Returned slot
+*   \return CIFX_NO_ERROR on success                                         */
+/*****************************************************************************/
+static int32_t BrokerGetSlot(CIFX_BROKER_SLOT_T** pptSlot)
+{
+  CIFX_BROKER_SLOT_T* ptSlot;
+  pid_t               tPid   = getpid();
+  int32_t             lRet   = CIFX_NO_ERROR;
+  int                 iSlot;
+
+  pthread_once(&s_tSlotKeyOnce, BrokerCreateSlotKey);
+
+  ptSlot = (CIFX_BROKER_SLOT_T*)pthread_getspecific(s_tSlotKey);
+
+  /* slot inherited via fork() belongs to the parent */
+  if ( (NULL != ptSlot) && (__atomic_load_n(&ptSlot->tOwner, __ATOMIC_ACQUIRE) == tPid) )
+  {
+    *pptSlot = ptSlot;
+    return CIFX_NO_ERROR;
+  }
+
+  pthread_mutex_lock(&s_tLock);
+
+  if (CIFX_NO_ERROR == (lRet = BrokerMap()))
+  {
+    lRet = CIFX_DRV_NOT_OPENED;
+
+    for (iSlot = 0; iSlot < CIFX_BROKER_MAX_SLOTS; iSlot++)
+    {
+      pid_t tFree = 0;
+
+      ptSlot = &s_ptShm->atSlot[iSlot];
+      if (__atomic_compare_exchange_n(&ptSlot->tOwner, &tFree, tPid, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+      {
+        pthread_setspecific(s_tSlotKey, ptSlot);
+        *pptSlot = ptSlot;
+        lRet     = CIFX_NO_ERROR;
+        break;
+      }
+    }
+  }
+
+  pthread_mutex_unlock(&s_tLock);
+
+  return lRet;
+}
+
+/*****************************************************************************/
+/*! Sends a request to the broker and waits for the response
+*   \param ulFunction  Function (see CIFX_BROKER_FUNC_E)
+*   \param ulHandle    Broker handle
+*   \param pulParam    Function parameters (4 entries), updated by the response
+*   \param pvSend      Data to send
+*   \param ulSendLen   Length of data to send
+*   \param pvRecv      Buffer for returned data
+*   \param ulRecvLen   Size of the buffer for returned data
+*   \param ulTimeout   Timeout of the function, the response is awaited
+*                      CIFX_BROKER_RESPONSE_MARGIN ms longer
+*   \return Result of the function                                           */
+/*****************************************************************************/
+static int32_t BrokerTransfer(uint32_t ulFunction, uint32_t ulHandle, uint32_t* pulParam,
+                              const void* pvSend, uint32_t ulSendLen, void* pvRecv, uint32_t ulRecvLen,
+                              uint32_t ulTimeout)
+{
+  CIFX_BROKER_SLOT_T* ptSlot = NULL;
+  CIFX_BROKER_MSG_T*  ptMsg;
+  uint32_t            ulSequence;
+  uint64_t            ullWait;
+  struct timespec     tAbs;
+  int32_t             lRet;
+
+  if (ulSendLen > CIFX_BROKER_MAX_DATA)
+    return CIFX_INVALID_BUFFERSIZE;
+
+  if (CIFX_NO_ERROR != (lRet = BrokerGetSlot(&ptSlot)))
+    return lRet;
+
+  if (NULL == (ptMsg = CifXBrokerRingReserve(&ptSlot->tRequest)))
+    return CIFX_DRV_CMD_ACTIVE;
+
+  ulSequence        = ++s_ulSequence;
+  ptMsg->ulSequence = ulSequence;
+  ptMsg->ulFunction = ulFunction;
+  ptMsg->ulHandle   = ulHandle;
+  ptMsg->lResult    = CIFX_NO_ERROR;
+  ptMsg->ulDataLen  = ulSendLen;
+  memcpy(ptMsg->aulParam, pulParam, sizeof(ptMsg->aulParam));
+  if (ulSendLen > 0)
+    memcpy(ptMsg->abData, pvSend, ulSendLen);
+
+  CifXBrokerRingPush(&ptSlot->tRequest);
+
+  ullWait = (uint64_t)ulTimeout + CIFX_BROKER_RESPONSE_MARGIN;
+  clock_gettime(CLOCK_REALTIME, &tAbs);
+  tAbs.tv_sec  += (time_t)(ullWait / 1000);
+  tAbs.tv_nsec += (long)(ullWait % 1000) * 1000000;
+  if (tAbs.tv_nsec >= 1000000000)
+  {
+    tAbs.tv_sec++;
+    tAbs.tv_nsec -= 1000000000;
+  }
+
+  for (;;)
+  {
+    if (0 != sem_timedwait(&ptSlot->tResponse.tSignal, &tAbs))
+    {
+      if (EINTR == errno)
+        continue;
+
+      /* broker did not answer, a late response is discarded by its sequence number */
+      return (0 == kill(s_ptShm->tBrokerPid, 0)) ? CIFX_DRV_IO_CONTROL_FAILED : CIFX_DRV_DRIVER_NOT_LOADED;
+    }
+
+    if (NULL == (ptMsg = CifXBrokerRingPeek(&ptSlot->tResponse)))
+      continue;
+
+    if (ptMsg->ulSequence != ulSequence)
+    {
+      /* response of a timed out request */
+      CifXBrokerRingPop(&ptSlot->tResponse);
+      continue;
+    }
+
+    lRet = ptMsg->lResult;
+    memcpy(pulParam, ptMsg->aulParam, sizeof(ptMsg->aulParam));
+    if ( (NULL != pvRecv) && (ptMsg->ulDataLen > 0) )
+      memcpy(pvRecv, ptMsg->abData, (ptMsg->ulDataLen < ulRecvLen) ? ptMsg->ulDataLen : ulRecvLen);
+
+    CifXBrokerRingPop(&ptSlot->tResponse);
+    break;
+  }
+
+  return lRet;
+}
+
+/*****************************************************************************/
+/*! Checks a driver handle
+*   \param hDriver  Driver handle
+*   \return CIFX_NO_ERROR if valid                                           */
+/*****************************************************************************/
+static int32_t BrokerCheckDriver(CIFXHANDLE hDriver)
+{
+  int32_t lRet = CIFX_INVALID_HANDLE;
+
+  pthread_mutex_lock(&s_tLock);
+  if ( (BROKER_DRIVER_HANDLE == hDriver) && (s_ulOpenCount > 0) )
+    lRet = CIFX_NO_ERROR;
+  pthread_mutex_unlock(&s_tLock);
+
+  return lRet;
+}
+
+/*****************************************************************************/
+/*! Transfers a request with the given parameters
+*   \param ulFunction  Function (see CIFX_BROKER_FUNC_E)
+*   \param hHandle     Sysdevice/channel handle
+*   \param ulParam0    Parameter 0
+*   \param ulParam1    Parameter 1
+*   \param ulParam2    Parameter 2
+*   \param ulParam3    Parameter 3
+*   \param pulParam1   Returned parameter 1 (may be NULL)
+*   \param ulTimeout   Timeout of the function
+*   \return Result of the function                                           */
+/*****************************************************************************/
+static int32_t BrokerCall(uint32_t ulFunction, CIFXHANDLE hHandle,
+                          uint32_t ulParam0, uint32_t ulParam1, uint32_t ulParam2, uint32_t ulParam3,
+                          uint32_t* pulParam1, uint32_t ulTimeout)
+{
+  uint32_t aulParam[4] = {ulParam0, ulParam1, ulParam2, ulParam3};
+  int32_t  lRet        = BrokerTransfer(ulFunction, BROKER_HANDLE(hHandle), aulParam, NULL, 0, NULL, 0, ulTimeout);
+
+  if (NULL != pulParam1)
+    *pulParam1 = aulParam[1];
+
+  return lRet;
+}
+
+/*****************************************************************************/
+/*! Reads or writes a DPM block
+*   \param ulFunction  Function (see CIFX_BROKER_FUNC_E)
+*   \param hChannel    Channel handle
+*   \param ulCmd       CIFX_CMD_READ_DATA/CIFX_CMD_WRITE_DATA
+*   \param aulParam    Function parameters
+*   \param ulDataLen   Length of data
+*   \param pvData      Data buffer
+*   \return Result of the function                                           */
+/*****************************************************************************/
+static int32_t BrokerBlock(uint32_t ulFunction, CIFXHANDLE hChannel, uint32_t ulCmd, uint32_t* aulParam,
+                           uint32_t ulDataLen, void* pvData)
+{
+  if (NULL == pvData)
+    return CIFX_INVALID_POINTER;
+
+  if (ulDataLen > CIFX_BROKER_MAX_DATA)
+    return CIFX_INVALID_BUFFERSIZE;
+
+  if (CIFX_CMD_WRITE_DATA == ulCmd)
+    return BrokerTransfer(ulFunction, BROKER_HANDLE(hChannel), aulParam, pvData, ulDataLen, NULL, 0, 0);
+
+  return BrokerTransfer(ulFunction, BROKER_HANDLE(hChannel), aulParam, NULL, 0, pvData, ulDataLen, 0);
+}
+
+/*****************************************************************************/
+/*! Opens a sysdevice or channel
+*   \param ulFunction  eBROKER_FUNC_SYSDEVICE_OPEN/eBROKER_FUNC_CHANNEL_OPEN
+*   \param hDriver     Driver handle
+*   \param szBoard     Board name or alias
+*   \param ulChannel   Channel number
+*   \param phHandle    Returned handle
+*   \return CIFX_NO_ERROR on success                                         */
+/*****************************************************************************/
+static int32_t BrokerOpen(uint32_t ulFunction, CIFXHANDLE hDriver, char* szBoard, uint32_t ulChannel, CIFXHANDLE* phHandle)
+{
+  uint32_t aulParam[4] = {ulChannel, 0, 0, 0};
+  int32_t  lRet;
+
+  if ( (NULL == szBoard) || (NULL == phHandle) )
+    return CIFX_INVALID_POINTER;
+
+  if (CIFX_NO_ERROR != (lRet = BrokerCheckDriver(hDriver)))
+    return lRet;
+
+  if (CIFX_NO_ERROR == (lRet = BrokerTransfer(ulFunction, 0, aulParam, szBoard, (uint32_t)strlen(szBoard) + 1, NULL, 0, 0)))
+    *phHandle = CIFX_HANDLE(aulParam[0]);
+
+  return lRet;
+}
+
+/*****************************************************************************/
+/*! Sends a packet via a sysdevice or channel mailbox
+*   \param hHandle    Sysdevice/channel handle
+*   \param ptSendPkt  Packet to send
+*   \param ulTimeout  Timeout in ms
+*   \return CIFX_NO_ERROR on success                                         */
+/*****************************************************************************/
+static int32_t BrokerPutPacket(CIFXHANDLE hHandle, CIFX_PACKET* ptSendPkt, uint32_t ulTimeout)
+{
+  uint32_t aulParam[4] = {ulTimeout, 0, 0, 0};
+  uint32_t ulLen;
+
+  if (NULL == ptSendPkt)
+    return CIFX_INVALID_POINTER;
+
+  ulLen = (uint32_t)sizeof(ptSendPkt->tHeader) + LE32_TO_HOST(ptSendPkt->tHeader.ulLen);
+  if (ulLen > sizeof(*ptSendPkt))
+    return CIFX_INVALID_BUFFERSIZE;
+
+  return BrokerTransfer(eBROKER_FUNC_MBX_PUTPACKET, BROKER_HANDLE(hHandle), aulParam, ptSendPkt, ulLen, NULL, 0, ulTimeout);
+}
+
+/*****************************************************************************/
+/*! Retrieves a packet from a sysdevice or channel mailbox
+*   \param hHandle    Sysdevice/channel handle
+*   \param ulSize     Size of the buffer
+*   \param ptRecvPkt  Buffer for the packet
+*   \param ulTimeout  Timeout in ms
+*   \return CIFX_NO_ERROR on success                                         */
+/*****************************************************************************/
+static int32_t BrokerGetPacket(CIFXHANDLE hHandle, uint32_t ulSize, CIFX_PACKET* ptRecvPkt, uint32_t ulTimeout)
+{
+  uint32_t aulParam[4] = {ulSize, ulTimeout, 0, 0};
+
+  if (NULL == ptRecvPkt)
+    return CIFX_INVALID_POINTER;
+
+  return BrokerTransfer(eBROKER_FUNC_MBX_GETPACKET, BROKER_HANDLE(hHandle), aulParam, NULL, 0, ptRecvPkt, ulSize, ulTimeout);
+}
+
+/*****************************************************************************/
+/*! Returns the mailbox state of a sysdevice or channel
+*   \param hHandle          Sysdevice/channel handle
+*   \param pulRecvPktCount  Number of packets waiting to be received
+*   \param pulSendPktCount  Number of packets which can be sent
+*   \return CIFX_NO_ERROR on success                                         */
+/*****************************************************************************/
+static int32_t BrokerGetMBXState(CIFXHANDLE hHandle, uint32_t* pulRecvPktCount, uint32_t* pulSendPktCount)
+{
+  uint32_t aulParam[4] = {0};
+  int32_t  lRet;
+
+  if ( (NULL == pulRecvPktCount) || (NULL == pulSendPktCount) )
+    return CIFX_INVALID_POINTER;
+
+  if (CIFX_NO_ERROR == (lRet = BrokerTransfer(eBROKER_FUNC_MBX_GETMBXSTATE, BROKER_HANDLE(hHandle), aulParam, NULL, 0, NULL, 0, 0)))
+  {
+    *pulRecvPktCount = aulParam[0];
+    *pulSendPktCount = aulParam[1];
+  }
+
+  return lRet;
+}
+
+/***************************************************************************
+* Driver functions
+***************************************************************************/
+
+/*****************************************************************************/
+/*! Opens the driver, i.e. connects to the broker
+*   \param phDriver  Returned driver handle
+*   \return CIFX_NO_ERROR on success                                         */
+/*****************************************************************************/
+int32_t APIENTRY xDriverOpen(CIFXHANDLE* phDriver)
+{
+  uint32_t aulParam[4] = {CIFX_BROKER_VERSION, 0, 0, 0};
+  int32_t  lRet;
+
+  if (NULL == phDriver)
+    return CIFX_INVALID_POINTER;
+
+  if (CIFX_NO_ERROR == (lRet = BrokerTransfer(eBROKER_FUNC_DRIVER_OPEN, 0, aulParam, NULL, 0, NULL, 0, 0)))
+  {
+    pthread_mutex_lock(&s_tLock);
+    s_ulOpenCount++;
+    pthread_mutex_unlock(&s_tLock);
+
+    *phDriver = BROKER_DRIVER_HANDLE;
+  }
+
+  return lRet;
+}
+
+/*****************************************************************************/
+/*! Closes the driver. Closing the last driver handle closes all handles of
+*   the process.
+*   \param hDriver  Driver handle
+*   \return CIFX_NO_ERROR on success                                         */
+/*****************************************************************************/
+int32_t APIENTRY xDriverClose(CIFXHANDLE hDriver)
+{
+  uint32_t aulParam[4] = {0};
+  uint32_t ulOpenCount = 0;
+  int32_t  lRet        = CIFX_INVALID_HANDLE;
+
+  pthread_mutex_lock(&s_tLock);
+  if ( (BROKER_DRIVER_HANDLE == hDriver) && (s_ulOpenCount > 0) )
+  {
+    ulOpenCount = --s_ulOpenCount;
+    lRet        = CIFX_NO_ERROR;
+  }
+  pthread_mutex_unlock(&s_tLock);
+
+  if ( (CIFX_NO_ERROR == lRet) && (0 == ulOpenCount) )
+    lRet = BrokerTransfer(eBROKER_FUNC_DRIVER_CLOSE, 0, aulParam, NULL, 0, NULL, 0, 0);
+
+  return lRet;
+}
+
+int32_t APIENTRY xDriverGetInformation(CIFXHANDLE hDriver, uint32_t ulSize, void* pvDriverInfo)
+{
+  uint32_t aulParam[4] = {ulSize, 0, 0, 0};
+  int32_t  lRet;
+
+  if (NULL == pvDriverInfo)
+    return CIFX_INVALID_POINTER;
+
+  if (CIFX_NO_ERROR != (lRet = BrokerCheckDriver(hDriver)))
+    return lRet;
+
+  return BrokerTransfer(eBROKER_FUNC_DRIVER_GETINFORMATION, 0, aulParam, NULL, 0, pvDriverInfo, ulSize, 0);
+}
+
+int32_t APIENTRY xDriverGetErrorDescription(int32_t lError, char* szBuffer, uint32_t ulBufferLen)
+{
+  uint32_t aulParam[4] = {(uint32_t)lError, ulBufferLen, 0, 0};
+
+  if (NULL == szBuffer)
+    return CIFX_INVALID_POINTER;
+
+  return BrokerTransfer(eBROKER_FUNC_DRIVER_GETERRORDESCRIPTION, 0, aulParam, NULL, 0, szBuffer, ulBufferLen, 0);
+}
+
+int32_t APIENTRY xDriverEnumBoards(CIFXHANDLE hDriver, uint32_t ulBoard, uint32_t ulSize, void* pvBoardInfo)
+{
+  uint32_t aulParam[4] = {ulBoard, ulSize, 0, 0};
+  int32_t  lRet;
+
+  if (NULL == pvBoardInfo)
+    return CIFX_INVALID_POINTER;
+
+  if (CIFX_NO_ERROR != (lRet = BrokerCheckDriver(hDriver)))
+    return lRet;
+
+  return BrokerTransfer(eBROKER_FUNC_DRIVER_ENUMBOARDS, 0, aulParam, NULL, 0, pvBoardInfo, ulSize, 0);
+}
+
+int32_t APIENTRY xDriverEnumChannels(CIFXHANDLE hDriver, uint32_t ulBoard, uint32_t ulChannel, uint32_t ulSize, void* pvChannelInfo)
+{
+  uint32_t aulParam[4] = {ulBoard, ulChannel, ulSize, 0};
+  int32_t  lRet;
+
+  if (NULL == pvChannelInfo)
+    return CIFX_INVALID_POINTER;
+
+  if (CIFX_NO_ERROR != (lRet = BrokerCheckDriver(hDriver)))
+    return lRet;
+
+  return BrokerTransfer(eBROKER_FUNC_DRIVER_ENUMCHANNELS, 0, aulParam, NULL, 0, pvChannelInfo, ulSize, 0);
+}
+
+int32_t APIENTRY xDriverMemoryPointer(CIFXHANDLE hDriver, uint32_t ulBoard, uint32_t ulCmd, void* pvMemoryInfo)
+{
+  /* DPM is only mapped into the broker process */
+  (void)hDriver; (void)ulBoard; (void)ulCmd; (void)pvMemoryInfo;
+  return CIFX_FUNCTION_NOT_AVAILABLE;
+}
+
+int32_t APIENTRY xDriverRestartDevice(CIFXHANDLE hDriver, char* szBoardName, void* pvData)
+{
+  uint32_t aulParam[4] = {0};
+  int32_t  lRet;
+
+  (void)pvData;
+
+  if (NULL == szBoardName)
+    return CIFX_INVALID_POINTER;
+
+  if (CIFX_NO_ERROR != (lRet = BrokerCheckDriver(hDriver)))
+    return lRet;
+
+  return BrokerTransfer(eBROKER_FUNC_DRIVER_RESTARTDEVICE, 0, aulParam, szBoardName, (uint32_t)strlen(szBoardName) + 1, NULL, 0, 0);
+}
+
+/***************************************************************************
+* System device functions
+***************************************************************************/
+
+int32_t APIENTRY xSysdeviceOpen(CIFXHANDLE hDriver, char* szBoard, CIFXHANDLE* phSysdevice)
+{
+  return BrokerOpen(eBROKER_FUNC_SYSDEVICE_OPEN, hDriver, szBoard, 0, phSysdevice);
+}
+
+int32_t APIENTRY xSysdeviceClose(CIFXHANDLE hSysdevice)
+{
+  return BrokerCall(eBROKER_FUNC_SYSDEVICE_CLOSE, hSysdevice, 0, 0, 0, 0, NULL, 0);
+}
+
+int32_t APIENTRY xSysdeviceGetMBXState(CIFXHANDLE hSysdevice, uint32_t* pulRecvPktCount, uint32_t* pulSendPktCount)
+{
+  return BrokerGetMBXState(hSysdevice, pulRecvPktCount, pulSendPktCount);
+}
+
+int32_t APIENTRY xSysdevicePutPacket(CIFXHANDLE hSysdevice, CIFX_PACKET* ptSendPkt, uint32_t ulTimeout)
+{
+  return BrokerPutPacket(hSysdevice, ptSendPkt, ulTimeout);
+}
+
+int32_t APIENTRY xSysdeviceGetPacket(CIFXHANDLE hSysdevice, uint32_t ulSize, CIFX_PACKET* ptRecvPkt, uint32_t ulTimeout)
+{
+  return BrokerGetPacket(hSysdevice, ulSize, ptRecvPkt, ulTimeout);
+}
+
+int32_t APIENTRY xSysdeviceInfo(CIFXHANDLE hSysdevice, uint32_t ulCmd, uint32_t ulSize, void* pvInfo)
+{
+  uint32_t aulParam[4] = {ulCmd, ulSize, 0, 0};
+
+  if (NULL == pvInfo)
+    return CIFX_INVALID_POINTER;
+
+  if (ulSize > CIFX_BROKER_MAX_DATA)
+    return CIFX_INVALID_BUFFERSIZE;
+
+  return BrokerTransfer(eBROKER_FUNC_SYSDEVICE_INFO, BROKER_HANDLE(hSysdevice), aulParam, NULL, 0, pvInfo, ulSize, 0);
+}
+
+int32_t APIENTRY xSysdeviceFindFirstFile(CIFXHANDLE hSysdevice, uint32_t ulChannel, CIFX_DIRECTORYENTRY* ptDirectoryInfo, PFN_RECV_PKT_CALLBACK pfnRecvPktCallback, void* pvUser)
+{
+  /* callbacks can not be executed across processes */
+  (void)hSysdevice; (void)ulChannel; (void)ptDirectoryInfo; (void)pfnRecvPktCallback; (void)pvUser;
+  return CIFX_FUNCTION_NOT_AVAILABLE;
+}
+
+int32_t APIENTRY xSysdeviceFindNextFile(CIFXHANDLE hSysdevice, uint32_t ulChannel, CIFX_DIRECTORYENTRY* ptDirectoryInfo, PFN_RECV_PKT_CALLBACK pfnRecvPktCallback, void* pvUser)
+{
+  (void)hSysdevice; (void)ulChannel; (void)ptDirectoryInfo; (void)pfnRecvPktCallback; (void)pvUser;
+  return CIFX_FUNCTION_NOT_AVAILABLE;
+}
+
+int32_t APIENTRY xSysdeviceDownload(CIFXHANDLE hSysdevice, uint32_t ulChannel, uint32_t ulMode, char* pszFileName, uint8_t* pabFileData, uint32_t ulFileSize,
+                                    PFN_PROGRESS_CALLBACK pfnCallback, PFN_RECV_PKT_CALLBACK pfnRecvPktCallback, void* pvUser)
+{
+  (void)hSysdevice; (void)ulChannel; (void)ulMode; (void)pszFileName; (void)pabFileData; (void)ulFileSize;
+  (void)pfnCallback; (void)pfnRecvPktCallback; (void)pvUser;
+  return CIFX_FUNCTION_NOT_AVAILABLE;
+}
+
+int32_t APIENTRY xSysdeviceUpload(CIFXHANDLE hSysdevice, uint32_t ulChannel, uint32_t ulMode, char* pszFileName, uint8_t* pabFileData, uint32_t* pulFileSize,
+                                  PFN_PROGRESS_CALLBACK pfnCallback, PFN_RECV_PKT_CALLBACK pfnRecvPktCallback, void* pvUser)
+{
+  (void)hSysdevice; (void)ulChannel; (void)ulMode; (void)pszFileName; (void)pabFileData; (void)pulFileSize;
+  (void)pfnCallback; (void)pfnRecvPktCallback; (void)pvUser;
+  return CIFX_FUNCTION_NOT_AVAILABLE;
+}
+
+int32_t APIENTRY xSysdeviceReset(CIFXHANDLE hSysdevice, uint32_t ulTimeout)
+{
+  return BrokerCall(eBROKER_FUNC_SYSDEVICE_RESET, hSysdevice, ulTimeout, 0, 0, 0, NULL, ulTimeout);
+}
+
+int32_t APIENTRY xSysdeviceResetEx(CIFXHANDLE hSysdevice, uint32_t ulTimeout, uint32_t ulMode)
+{
+  return BrokerCall(eBROKER_FUNC_SYSDEVICE_RESETEX, hSysdevice, ulTimeout, ulMode, 0, 0, NULL, ulTimeout);
+}
+
+int32_t APIENTRY xSysdeviceBootstart(CIFXHANDLE hSysdevice, uint32_t ulTimeout)
+{
+  return BrokerCall(eBROKER_FUNC_SYSDEVICE_BOOTSTART, hSysdevice, ulTimeout, 0, 0, 0, NULL, ulTimeout);
+}
+
+int32_t APIENTRY xSysdeviceExtendedMemory(CIFXHANDLE hSysdevice, uint32_t ulCmd, CIFX_EXTENDED_MEMORY_INFORMATION* ptExtMemData)
+{
+  (void)hSysdevice; (void)ulCmd; (void)ptExtMemData;
+  return CIFX_FUNCTION_NOT_AVAILABLE;
+}
+
+/***************************************************************************
+* Channel functions
+***************************************************************************/
+
+int32_t APIENTRY xChannelOpen(CIFXHANDLE hDriver, char* szBoard, uint32_t ulChannel, CIFXHANDLE* phChannel)
+{
+  return BrokerOpen(eBROKER_FUNC_CHANNEL_OPEN, hDriver, szBoard, ulChannel, phChannel);
+}
+
+int32_t APIENTRY xChannelClose(CIFXHANDLE hChannel)
+{
+  return BrokerCall(eBROKER_FUNC_CHANNEL_CLOSE, hChannel, 0, 0, 0, 0, NULL, 0);
+}
+
+int32_t APIENTRY xChannelFindFirstFile(CIFXHANDLE hChannel, CIFX_DIRECTORYENTRY* ptDirectoryInfo, PFN_RECV_PKT_CALLBACK pfnRecvPktCallback, void* pvUser)
+{
+  (void)hChannel; (void)ptDirectoryInfo; (void)pfnRecvPktCallback; (void)pvUser;
+  return CIFX_FUNCTION_NOT_AVAILABLE;
+}
+
+int32_t APIENTRY xChannelFindNextFile(CIFXHANDLE hChannel, CIFX_DIRECTORYENTRY* ptDirectoryInfo, PFN_RECV_PKT_CALLBACK pfnRecvPktCallback, void* pvUser)
+{
+  (void)hChannel; (void)ptDirectoryInfo; (void)pfnRecvPktCallback; (void)pvUser;
+  return CIFX_FUNCTION_NOT_AVAILABLE;
+}
+
+int32_t APIENTRY xChannelDownload(CIFXHANDLE hChannel, uint32_t ulMode, char* pszFileName, uint8_t* pabFileData, uint32_t ulFileSize,
+                                  PFN_PROGRESS_CALLBACK pfnCallback, PFN_RECV_PKT_CALLBACK pfnRecvPktCallback, void* pvUser)
+{
+  (void)hChannel; (void)ulMode; (void)pszFileName; (void)pabFileData; (void)ulFileSize;
+  (void)pfnCallback; (void)pfnRecvPktCallback; (void)pvUser;
+  return CIFX_FUNCTION_NOT_AVAILABLE;
+}
+
+int32_t APIENTRY xChannelUpload(CIFXHANDLE hChannel, uint32_t ulMode, char* pszFileName, uint8_t* pabFileData, uint32_t* pulFileSize,
+                                PFN_PROGRESS_CALLBACK pfnCallback, PFN_RECV_PKT_CALLBACK pfnRecvPktCallback, void* pvUser)
+{
+  (void)hChannel; (void)ulMode; (void)pszFileName; (void)pabFileData; (void)pulFileSize;
+  (void)pfnCallback; (void)pfnRecvPktCallback; (void)pvUser;
+  return CIFX_FUNCTION_NOT_AVAILABLE;
+}
+
+int32_t APIENTRY xChannelGetMBXState(CIFXHANDLE hChannel, uint32_t* pulRecvPktCount, uint32_t* pulSendPktCount)
+{
+  return BrokerGetMBXState(hChannel, pulRecvPktCount, pulSendPktCount);
+}
+
+int32_t APIENTRY xChannelPutPacket(CIFXHANDLE hChannel, CIFX_PACKET* ptSendPkt, uint32_t ulTimeout)
+{
+  return BrokerPutPacket(hChannel, ptSendPkt, ulTimeout);
+}
+
+int32_t APIENTRY xChannelGetPacket(CIFXHANDLE hChannel, uint32_t ulSize, CIFX_PACKET* ptRecvPkt, uint32_t ulTimeout)
+{
+  return BrokerGetPacket(hChannel, ulSize, ptRecvPkt, ulTimeout);
+}
+
+int32_t APIENTRY xChannelGetSendPacket(CIFXHANDLE hChannel, uint32_t ulSize, CIFX_PACKET* ptRecvPkt)
+{
+  uint32_t aulParam[4] = {ulSize, 0, 0, 0};
+
+  if (NULL == ptRecvPkt)
+    return CIFX_INVALID_POINTER;
+
+  return BrokerTransfer(eBROKER_FUNC_MBX_GETSENDPACKET, BROKER_HANDLE(hChannel), aulParam, NULL, 0, ptRecvPkt, ulSize, 0);
+}
+
+int32_t APIENTRY xChannelConfigLock(CIFXHANDLE hChannel, uint32_t ulCmd, uint32_t* pulState, uint32_t ulTimeout)
+{
+  if (NULL == pulState)
+    return CIFX_INVALID_POINTER;
+
+  return BrokerCall(eBROKER_FUNC_CHANNEL_CONFIGLOCK, hChannel, ulCmd, *pulState, ulTimeout, 0, pulState, ulTimeout);
+}
+
+int32_t APIENTRY xChannelReset(CIFXHANDLE hChannel, uint32_t ulResetMode, uint32_t ulTimeout)
+{
+  return BrokerCall(eBROKER_FUNC_CHANNEL_RESET, hChannel, ulResetMode, ulTimeout, 0, 0, NULL, ulTimeout);
+}
+
+int32_t APIENTRY xChannelInfo(CIFXHANDLE hChannel, uint32_t ulSize, void* pvChannelInfo)
+{
+  uint32_t aulParam[4] = {ulSize, 0, 0, 0};
+
+  if (NULL == pvChannelInfo)
+    return CIFX_INVALID_POINTER;
+
+  if (ulSize > CIFX_BROKER_MAX_DATA)
+    return CIFX_INVALID_BUFFERSIZE;
+
+  return BrokerTransfer(eBROKER_FUNC_CHANNEL_INFO, BROKER_HANDLE(hChannel), aulParam, NULL, 0, pvChannelInfo, ulSize, 0);
+}
+
+int32_t APIENTRY xChannelWatchdog(CIFXHANDLE hChannel, uint32_t ulCmd, uint32_t* pulTrigger)
+{
+  if (NULL == pulTrigger)
+    return CIFX_INVALID_POINTER;
+
+  return BrokerCall(eBROKER_FUNC_CHANNEL_WATCHDOG, hChannel, ulCmd, *pulTrigger, 0, 0, pulTrigger, 0);
+}
+
+int32_t APIENTRY xChannelHostState(CIFXHANDLE hChannel, uint32_t ulCmd, uint32_t* pulState, uint32_t ulTimeout)
+{
+  if (NULL == pulState)
+    return CIFX_INVALID_POINTER;
+
+  return BrokerCall(eBROKER_FUNC_CHANNEL_HOSTSTATE, hChannel, ulCmd, *pulState, ulTimeout, 0, pulState, ulTimeout);
+}
+
+int32_t APIENTRY xChannelBusState(CIFXHANDLE hChannel, uint32_t ulCmd, uint32_t* pulState, uint32_t ulTimeout)
+{
+  if (NULL == pulState)
+    return CIFX_INVALID_POINTER;
+
+  return BrokerCall(eBROKER_FUNC_CHANNEL_BUSSTATE, hChannel, ulCmd, *pulState, ulTimeout, 0, pulState, ulTimeout);
+}
+
+int32_t APIENTRY xChannelDMAState(CIFXHANDLE hChannel, uint32_t ulCmd, uint32_t* pulState)
+{
+  (void)hChannel; (void)ulCmd; (void)pulState;
+  return CIFX_FUNCTION_NOT_AVAILABLE;
+}
+
+int32_t APIENTRY xChannelIOInfo(CIFXHANDLE hChannel, uint32_t ulCmd, uint32_t ulAreaNumber, uint32_t ulSize, void* pvData)
+{
+  uint32_t aulParam[4] = {ulCmd, ulAreaNumber, ulSize, 0};
+
+  if (NULL == pvData)
+    return CIFX_INVALID_POINTER;
+
+  return BrokerTransfer(eBROKER_FUNC_CHANNEL_IOINFO, BROKER_HANDLE(hChannel), aulParam, NULL, 0, pvData, ulSize, 0);
+}
+
+int32_t APIENTRY xChannelIORead(CIFXHANDLE hChannel, uint32_t ulAreaNumber, uint32_t ulOffset, uint32_t ulDataLen, void* pvData, uint32_t ulTimeout)
+{
+  uint32_t aulParam[4] = {ulAreaNumber, ulOffset, ulDataLen, ulTimeout};
+
+  if (NULL == pvData)
+    return CIFX_INVALID_POINTER;
+
+  if (ulDataLen > CIFX_BROKER_MAX_DATA)
+    return CIFX_INVALID_ACCESS_SIZE;
+
+  return BrokerTransfer(eBROKER_FUNC_CHANNEL_IOREAD, BROKER_HANDLE(hChannel), aulParam, NULL, 0, pvData, ulDataLen, ulTimeout);
+}
+
+int32_t APIENTRY xChannelIOWrite(CIFXHANDLE hChannel, uint32_t ulAreaNumber, uint32_t ulOffset, uint32_t ulDataLen, void* pvData, uint32_t ulTimeout)
+{
+  uint32_t aulParam[4] = {ulAreaNumber, ulOffset, ulDataLen, ulTimeout};
+
+  if (NULL == pvData)
+    return CIFX_INVALID_POINTER;
+
+  if (ulDataLen > CIFX_BROKER_MAX_DATA)
+    return CIFX_INVALID_ACCESS_SIZE;
+
+  return BrokerTransfer(eBROKER_FUNC_CHANNEL_IOWRITE, BROKER_HANDLE(hChannel), aulParam, pvData, ulDataLen, NULL, 0, ulTimeout);
+}
+
+int32_t APIENTRY xChannelIOReadSendData(CIFXHANDLE hChannel, uint32_t ulAreaNumber, uint32_t ulOffset, uint32_t ulDataLen, void* pvData)
+{
+  uint32_t aulParam[4] = {ulAreaNumber, ulOffset, ulDataLen, 0};
+
+  if (NULL == pvData)
+    return CIFX_INVALID_POINTER;
+
+  if (ulDataLen > CIFX_BROKER_MAX_DATA)
+    return CIFX_INVALID_ACCESS_SIZE;
+
+  return BrokerTransfer(eBROKER_FUNC_CHANNEL_IOREADSENDDATA, BROKER_HANDLE(hChannel), aulParam, NULL, 0, pvData, ulDataLen, 0);
+}
+
+int32_t APIENTRY xChannelControlBlock(CIFXHANDLE hChannel, uint32_t ulCmd, uint32_t ulOffset, uint32_t ulDataLen, void* pvData)
+{
+  uint32_t aulParam[4] = {ulCmd, ulOffset, ulDataLen, 0};
+  return BrokerBlock(eBROKER_FUNC_CHANNEL_CONTROLBLOCK, hChannel, ulCmd, aulParam, ulDataLen, pvData);
+}
+
+int32_t APIENTRY xChannelCommonStatusBlock(CIFXHANDLE hChannel, uint32_t ulCmd, uint32_t ulOffset, uint32_t ulDataLen, void* pvData)
+{
+  uint32_t aulParam[4] = {ulCmd, ulOffset, ulDataLen, 0};
+  return BrokerBlock(eBROKER_FUNC_CHANNEL_COMMONSTATUSBLOCK, hChannel, ulCmd, aulParam, ulDataLen, pvData);
+}
+
+int32_t APIENTRY xChannelExtendedStatusBlock(CIFXHANDLE hChannel, uint32_t ulCmd, uint32_t ulOffset, uint32_t ulDataLen, void* pvData)
+{
+  uint32_t aulParam[4] = {ulCmd, ulOffset, ulDataLen, 0};
+  return BrokerBlock(eBROKER_FUNC_CHANNEL_EXTENDEDSTATUSBLOCK, hChannel, ulCmd, aulParam, ulDataLen, pvData);
+}
+
+int32_t APIENTRY xChannelUserBlock(CIFXHANDLE hChannel, uint32_t ulAreaNumber, uint32_t ulCmd, uint32_t ulOffset, uint32_t ulDataLen, void* pvData)
+{
+  uint32_t aulParam[4] = {ulAreaNumber, ulCmd, ulOffset, ulDataLen};
+  return BrokerBlock(eBROKER_FUNC_CHANNEL_USERBLOCK, hChannel, ulCmd, aulParam, ulDataLen, pvData);
+}
+
+int32_t APIENTRY xChannelPLCMemoryPtr(CIFXHANDLE hChannel, uint32_t ulCmd, void* pvMemoryInfo)
+{
+  /* DPM is only mapped into the broker process */
+  (void)hChannel; (void)ulCmd; (void)pvMemoryInfo;
+  return CIFX_FUNCTION_NOT_AVAILABLE;
+}
+
+int32_t APIENTRY xChannelPLCIsReadReady(CIFXHANDLE hChannel, uint32_t ulAreaNumber, uint32_t* pulReadState)
+{
+  if (NULL == pulReadState)
+    return CIFX_INVALID_POINTER;
+
+  return BrokerCall(eBROKER_FUNC_CHANNEL_PLCISREADREADY, hChannel, ulAreaNumber, 0, 0, 0, pulReadState, 0);
+}
+
+int32_t APIENTRY xChannelPLCIsWriteReady(CIFXHANDLE hChannel, uint32_t ulAreaNumber, uint32_t* pulWriteState)
+{
+  if (NULL == pulWriteState)
+    return CIFX_INVALID_POINTER;
+
+  return BrokerCall(eBROKER_FUNC_CHANNEL_PLCISWRITEREADY, hChannel, ulAreaNumber, 0, 0, 0, pulWriteState, 0);
+}
+
+int32_t APIENTRY xChannelPLCActivateWrite(CIFXHANDLE hChannel, uint32_t ulAreaNumber)
+{
+  return BrokerCall(eBROKER_FUNC_CHANNEL_PLCACTIVATEWRITE, hChannel, ulAreaNumber, 0, 0, 0, NULL, 0);
+}
+
+int32_t APIENTRY xChannelPLCActivateRead(CIFXHANDLE hChannel, uint32_t ulAreaNumber)
+{
+  return BrokerCall(eBROKER_FUNC_CHANNEL_PLCACTIVATEREAD, hChannel, ulAreaNumber, 0, 0, 0, NULL, 0);
+}
+
+int32_t APIENTRY xChannelRegisterNotification(CIFXHANDLE hChannel, uint32_t ulNotification, PFN_NOTIFY_CALLBACK pfnCallback, void* pvUser)
+{
+  /* callbacks can not be executed across processes */
+  (void)hChannel; (void)ulNotification; (void)pfnCallback; (void)pvUser;
+  return CIFX_FUNCTION_NOT_AVAILABLE;
+}
+
+int32_t APIENTRY xChannelUnregisterNotification(CIFXHANDLE hChannel, uint32_t ulNotification)
+{
+  (void)hChannel; (void)ulNotification;
+  return CIFX_FUNCTION_NOT_AVAILABLE;
+}
+
+int32_t APIENTRY xChannelSyncState(CIFXHANDLE hChannel, uint32_t ulCmd, uint32_t ulTimeout, uint32_t* pulErrorCount)
+{
+  uint32_t aulParam[4] = {ulCmd, ulTimeout, 0, 0};
+  int32_t  lRet;
+
+  if (NULL == pulErrorCount)
+    return CIFX_INVALID_POINTER;
+
+  if (CIFX_NO_ERROR == (lRet = BrokerTransfer(eBROKER_FUNC_CHANNEL_SYNCSTATE, BROKER_HANDLE(hChannel), aulParam, NULL, 0, NULL, 0, ulTimeout)))
+    *pulErrorCount = aulParam[2];
+
+  return lRet;
+}
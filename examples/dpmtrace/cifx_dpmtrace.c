@@ -0,0 +1,666 @@
+// SPDX-License-Identifier: MIT
+/**************************************************************************************
+ *
+ * Copyright (c) 2025, Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserved.
+ *
+ * Description: Analysis of a DPM access trace (dpm_trace_file of struct CIFX_LINUX_INIT).
+ *              Summarises the accesses per DPM region and thread, dumps the records and
+ *              replays the accesses against a memory backed DPM.
+ *
+ **************************************************************************************/
+
+#include "cifxdpmtrace.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define MAX_CHANNELS     16                  /* communication channels per device in the summary */
+#define MAX_THREADS      64                  /* threads listed in the summary                    */
+#define MAX_REPLAY_SIZE  (256 * 1024 * 1024) /* largest memory backed DPM of the replay          */
+#define SPIN_THRESHOLD   100000              /* ns, shorter waits of the replay are done by spinning */
+
+#define MODE_SUMMARY     0
+#define MODE_DUMP        1
+#define MODE_REPLAY      2
+
+typedef void (*PFN_RECORD)(const struct CIFX_DPM_TRACE_RECORD* ptRecord, const uint8_t* pbData, void* pvUser);
+
+/* access statistic of a region or thread */
+typedef struct TRACE_STATS_Ttag
+{
+  uint64_t ullReads;
+  uint64_t ullReadBytes;
+  uint64_t ullWrites;
+  uint64_t ullWriteBytes;
+  uint64_t ullTimeNs;       /* sum of the access durations */
+  uint32_t ulMaxNs;         /* longest access              */
+} TRACE_STATS_T;
+
+typedef struct TRACE_THREAD_Ttag
+{
+  uint32_t      ulThread;
+  TRACE_STATS_T tStats;
+} TRACE_THREAD_T;
+
+typedef struct TRACE_SUMMARY_Ttag
+{
+  const struct CIFX_DPM_TRACE_HEADER* ptHeader;
+  uint64_t       ullRecords;
+  uint64_t       ullFirstNs;
+  uint64_t       ullLastNs;
+  /* [device][channel + 1 (0 = no channel)][region type] */
+  TRACE_STATS_T  aatStats[CIFX_DPM_TRACE_MAX_DEVICES][MAX_CHANNELS + 1][eCIFX_DPM_REGION_COUNT];
+  TRACE_STATS_T  tUnknown;  /* accesses of devices not in the header */
+  uint32_t       ulThreads;
+  TRACE_THREAD_T atThreads[MAX_THREADS];
+  TRACE_STATS_T  tOtherThreads;
+} TRACE_SUMMARY_T;
+
+typedef struct TRACE_REPLAY_Ttag
+{
+  const struct CIFX_DPM_TRACE_HEADER* ptHeader;
+  int            fFast;        /* don't wait for the recorded start of an access */
+  int            fEmulate;     /* take the recorded duration for every access    */
+  uint8_t*       apbDpm[CIFX_DPM_TRACE_MAX_DEVICES];
+  uint32_t       aulDpmSize[CIFX_DPM_TRACE_MAX_DEVICES];
+  uint8_t*       pbScratch;
+  const struct CIFX_DPM_TRACE_RECORD** pptRecords; /* records sorted by start time */
+  uint64_t       ullRecords;
+  uint64_t       ullStartNs;   /* replay start time                 */
+  uint64_t       ullFirstNs;   /* time_ns of the first record       */
+  uint64_t       ullLastNs;    /* end of the last recorded access   */
+  uint64_t       ullAccesses;
+  uint64_t       ullSkipped;
+  uint64_t       ullRecordedNs;  /* sum of the recorded durations   */
+  uint64_t       ullReplayNs;    /* sum of the replayed durations   */
+  uint64_t       ullMaxLateNs;   /* worst start delay of an access  */
+  uint64_t       ullSumLateNs;
+} TRACE_REPLAY_T;
+
+static const char* s_aszRegion[eCIFX_DPM_REGION_COUNT] =
+{
+  "other", "system", "handshake", "send mbx", "recv mbx", "io input", "io output", "control", "status", "channel"
+};
+
+static uint64_t GetTimeNs(void)
+{
+  struct timespec tNow;
+
+  clock_gettime(CLOCK_MONOTONIC, &tNow);
+  return (uint64_t)tNow.tv_sec * 1000000000ULL + (uint64_t)tNow.tv_nsec;
+}
+
+/*****************************************************************************/
+/*! Returns the smallest region of a device containing the given offset
+*   \param ptHeader  Trace header
+*   \param ulDevice  Device index
+*   \param ulOffset  DPM offset
+*   \return Region, NULL if the offset is not covered                        */
+/*****************************************************************************/
+static const struct CIFX_DPM_TRACE_REGION* FindRegion(const struct CIFX_DPM_TRACE_HEADER* ptHeader, uint32_t ulDevice, uint32_t ulOffset)
+{
+  const struct CIFX_DPM_TRACE_DEVICE* ptDevice = &ptHeader->devices[ulDevice];
+  const struct CIFX_DPM_TRACE_REGION* ptFound  = NULL;
+  uint32_t                            ulRegion;
+
+  for(ulRegion = 0; (ulRegion < ptDevice->region_count) && (ulRegion < CIFX_DPM_TRACE_MAX_REGIONS); ulRegion++)
+  {
+    const struct CIFX_DPM_TRACE_REGION* ptRegion = &ptDevice->regions[ulRegion];
+
+    if((ulOffset >= ptRegion->offset) && (ulOffset - ptRegion->offset < ptRegion->length) &&
+       ((NULL == ptFound) || (ptRegion->length < ptFound->length)))
+      ptFound = ptRegion;
+  }
+
+  return ptFound;
+}
+
+/*****************************************************************************/
+/*! Returns the data recorded with an access
+*   \param ptRecord  Record
+*   \return Data, NULL if not recorded                                      */
+/*****************************************************************************/
+static const uint8_t* RecordData(const struct CIFX_DPM_TRACE_RECORD* ptRecord)
+{
+  if((ptRecord->flags & CIFX_DPM_TRACE_FLAG_DATA) && (ptRecord->size > sizeof(*ptRecord)))
+    return (const uint8_t*)(ptRecord + 1);
+
+  return NULL;
+}
+
+/*****************************************************************************/
+/*! Calls the given function for every record of the ring, oldest first
+*   \param ptHeader     Trace header (followed by the ring)
+*   \param pfnRecord    Function to call
+*   \param pvUser       User parameter of the function
+*   \return 0 on success, -1 if the ring is corrupted                       */
+/*****************************************************************************/
+static int ForEachRecord(const struct CIFX_DPM_TRACE_HEADER* ptHeader, PFN_RECORD pfnRecord, void* pvUser)
+{
+  const uint8_t* pbRing     = (const uint8_t*)ptHeader + ptHeader->header_size;
+  uint32_t       ulRingSize = ptHeader->ring_size;
+  uint64_t       ullPos     = ptHeader->tail;
+
+  while(ullPos < ptHeader->head)
+  {
+    uint32_t                            ulLeft   = ulRingSize - (uint32_t)(ullPos % ulRingSize);
+    const struct CIFX_DPM_TRACE_RECORD* ptRecord = (const struct CIFX_DPM_TRACE_RECORD*)(pbRing + (ullPos % ulRingSize));
+
+    if((ulLeft < sizeof(*ptRecord)) || (ptRecord->flags & CIFX_DPM_TRACE_FLAG_PAD))
+    {
+      ullPos += ulLeft;
+      continue;
+    }
+
+    if((ptRecord->size < sizeof(*ptRecord)) || (ptRecord->size > ulLeft) || (ptRecord->size & 7))
+    {
+      fprintf(stderr, "Corrupted record at position %llu\n", (unsigned long long)ullPos);
+      return -1;
+    }
+
+    pfnRecord(ptRecord, RecordData(ptRecord), pvUser);
+
+    ullPos += ptRecord->size;
+  }
+
+  return 0;
+}
+
+static void AddStats(TRACE_STATS_T* ptStats, const struct CIFX_DPM_TRACE_RECORD* ptRecord)
+{
+  if(ptRecord->flags & CIFX_DPM_TRACE_FLAG_WRITE)
+  {
+    ptStats->ullWrites++;
+    ptStats->ullWriteBytes += ptRecord->length;
+  } else
+  {
+    ptStats->ullReads++;
+    ptStats->ullReadBytes += ptRecord->length;
+  }
+  ptStats->ullTimeNs += ptRecord->duration_ns;
+  if(ptRecord->duration_ns > ptStats->ulMaxNs)
+    ptStats->ulMaxNs = ptRecord->duration_ns;
+}
+
+/*****************************************************************************/
+/*! Adds a record to the summary (PFN_RECORD)                                */
+/*****************************************************************************/
+static void SummaryRecord(const struct CIFX_DPM_TRACE_RECORD* ptRecord, const uint8_t* pbData, void* pvUser)
+{
+  TRACE_SUMMARY_T* ptSummary = (TRACE_SUMMARY_T*)pvUser;
+  TRACE_STATS_T*   ptThread  = &ptSummary->tOtherThreads;
+  uint32_t         ulThread;
+
+  (void)pbData;
+
+  if(0 == ptSummary->ullRecords++)
+    ptSummary->ullFirstNs = ptRecord->time_ns;
+  ptSummary->ullLastNs = ptRecord->time_ns + ptRecord->duration_ns;
+
+  if(ptRecord->device < ptSummary->ptHeader->device_count)
+  {
+    const struct CIFX_DPM_TRACE_REGION* ptRegion = FindRegion(ptSummary->ptHeader, ptRecord->device, ptRecord->offset);
+    uint32_t                            ulChannel = 0;
+    uint32_t                            ulType    = eCIFX_DPM_REGION_OTHER;
+
+    if(NULL != ptRegion)
+    {
+      ulType = (ptRegion->type < eCIFX_DPM_REGION_COUNT) ? ptRegion->type : eCIFX_DPM_REGION_OTHER;
+      if(ptRegion->channel < MAX_CHANNELS)
+        ulChannel = ptRegion->channel + 1;
+    }
+    AddStats(&ptSummary->aatStats[ptRecord->device][ulChannel][ulType], ptRecord);
+  } else
+  {
+    AddStats(&ptSummary->tUnknown, ptRecord);
+  }
+
+  for(ulThread = 0; ulThread < ptSummary->ulThreads; ulThread++)
+  {
+    if(ptSummary->atThreads[ulThread].ulThread == ptRecord->thread)
+      break;
+  }
+  if(ulThread < MAX_THREADS)
+  {
+    if(ulThread == ptSummary->ulThreads)
+      ptSummary->atThreads[ptSummary->ulThreads++].ulThread = ptRecord->thread;
+    ptThread = &ptSummary->atThreads[ulThread].tStats;
+  }
+  AddStats(ptThread, ptRecord);
+}
+
+static void PrintStats(const char* szChannel, const char* szName, const TRACE_STATS_T* ptStats)
+{
+  printf("  %-8s %-10s %10llu %12llu %10llu %12llu %14.1f %10.1f\n",
+         szChannel, szName,
+         (unsigned long long)ptStats->ullReads, (unsigned long long)ptStats->ullReadBytes,
+         (unsigned long long)ptStats->ullWrites, (unsigned long long)ptStats->ullWriteBytes,
+         (double)ptStats->ullTimeNs / 1000.0, (double)ptStats->ulMaxNs / 1000.0);
+}
+
+static void PrintStatsHeader(const char* szFirst, const char* szSecond)
+{
+  printf("  %-8s %-10s %10s %12s %10s %12s %14s %10s\n",
+         szFirst, szSecond, "reads", "read bytes", "writes", "write bytes", "access [us]", "max [us]");
+}
+
+/*****************************************************************************/
+/*! Prints the accesses per device, channel and region and per thread
+*   \param ptHeader  Trace header
+*   \return 0 on success                                                     */
+/*****************************************************************************/
+static int Summary(const struct CIFX_DPM_TRACE_HEADER* ptHeader)
+{
+  TRACE_SUMMARY_T* ptSummary = calloc(1, sizeof(*ptSummary));
+  uint32_t         ulDevice;
+  uint32_t         ulThread;
+
+  if(NULL == ptSummary)
+    return -1;
+
+  ptSummary->ptHeader = ptHeader;
+  if(0 != ForEachRecord(ptHeader, SummaryRecord, ptSummary))
+  {
+    free(ptSummary);
+    return -1;
+  }
+
+  printf("Accesses       : %llu (%llu overwritten)\n", (unsigned long long)ptSummary->ullRecords,
+         (unsigned long long)(ptHeader->records - ptSummary->ullRecords));
+  if(ptSummary->ullRecords > 0)
+  {
+    printf("Time span      : %.3f ms (%.3f ms .. %.3f ms after trace start)\n",
+           (double)(ptSummary->ullLastNs - ptSummary->ullFirstNs) / 1000000.0,
+           (double)ptSummary->ullFirstNs / 1000000.0, (double)ptSummary->ullLastNs / 1000000.0);
+  }
+  printf("Data recorded  : %s\n", (ptHeader->flags & CIFX_DPM_TRACE_HDR_DATA) ? "yes" : "no");
+
+  for(ulDevice = 0; ulDevice < ptHeader->device_count; ulDevice++)
+  {
+    const struct CIFX_DPM_TRACE_DEVICE* ptDevice = &ptHeader->devices[ulDevice];
+    uint32_t                            ulChannel;
+
+    printf("\nDevice %.16s (DPM %u bytes)\n", ptDevice->name, ptDevice->dpm_size);
+    PrintStatsHeader("channel", "region");
+
+    for(ulChannel = 0; ulChannel <= MAX_CHANNELS; ulChannel++)
+    {
+      char     szChannel[8] = "-";
+      uint32_t ulType;
+
+      if(ulChannel > 0)
+        snprintf(szChannel, sizeof(szChannel), "%u", ulChannel - 1);
+
+      for(ulType = 0; ulType < eCIFX_DPM_REGION_COUNT; ulType++)
+      {
+        const TRACE_STATS_T* ptStats = &ptSummary->aatStats[ulDevice][ulChannel][ulType];
+
+        if(ptStats->ullReads + ptStats->ullWrites > 0)
+          PrintStats(szChannel, s_aszRegion[ulType], ptStats);
+      }
+    }
+  }
+
+  if(ptSummary->tUnknown.ullReads + ptSummary->tUnknown.ullWrites > 0)
+  {
+    printf("\nAccesses of unknown devices\n");
+    PrintStatsHeader("", "");
+    PrintStats("", "", &ptSummary->tUnknown);
+  }
+
+  printf("\nThreads\n");
+  PrintStatsHeader("thread", "");
+  for(ulThread = 0; ulThread < ptSummary->ulThreads; ulThread++)
+  {
+    char szThread[12];
+
+    snprintf(szThread, sizeof(szThread), "%u", ptSummary->atThreads[ulThread].ulThread);
+    PrintStats(szThread, "", &ptSummary->atThreads[ulThread].tStats);
+  }
+  if(ptSummary->tOtherThreads.ullReads + ptSummary->tOtherThreads.ullWrites > 0)
+    PrintStats("others", "", &ptSummary->tOtherThreads);
+
+  free(ptSummary);
+  return 0;
+}
+
+/*****************************************************************************/
+/*! Prints a record (PFN_RECORD)                                             */
+/*****************************************************************************/
+static void DumpRecord(const struct CIFX_DPM_TRACE_RECORD* ptRecord, const uint8_t* pbData, void* pvUser)
+{
+  const struct CIFX_DPM_TRACE_HEADER* ptHeader = (const struct CIFX_DPM_TRACE_HEADER*)pvUser;
+  const struct CIFX_DPM_TRACE_REGION* ptRegion = NULL;
+  char                                szChannel[8] = "-";
+
+  if(ptRecord->device < ptHeader->device_count)
+    ptRegion = FindRegion(ptHeader, ptRecord->device, ptRecord->offset);
+  if((NULL != ptRegion) && (ptRegion->channel != CIFX_DPM_TRACE_CHANNEL_NONE))
+    snprintf(szChannel, sizeof(szChannel), "%u", ptRegion->channel);
+
+  printf("%14.3f %8u %3d %c%c 0x%08X %6u %8u  %-3s %-10s",
+         (double)ptRecord->time_ns / 1000.0, ptRecord->thread,
+         (ptRecord->device < ptHeader->device_count) ? (int)ptRecord->device : -1,
+         (ptRecord->flags & CIFX_DPM_TRACE_FLAG_WRITE) ? 'W' : 'R',
+         (ptRecord->flags & CIFX_DPM_TRACE_FLAG_SINGLE) ? 's' : ' ',
+         ptRecord->offset, ptRecord->length, ptRecord->duration_ns, szChannel,
+         (NULL != ptRegion) && (ptRegion->type < eCIFX_DPM_REGION_COUNT) ? s_aszRegion[ptRegion->type] : s_aszRegion[0]);
+
+  if(NULL != pbData)
+  {
+    uint32_t ulIdx;
+    uint32_t ulLen = (ptRecord->length > 16) ? 16 : ptRecord->length;
+
+    for(ulIdx = 0; ulIdx < ulLen; ulIdx++)
+      printf(" %02X", pbData[ulIdx]);
+    if(ulLen < ptRecord->length)
+      printf(" ...");
+  }
+  printf("\n");
+}
+
+static int Dump(const struct CIFX_DPM_TRACE_HEADER* ptHeader)
+{
+  printf("%14s %8s %3s %2s %10s %6s %8s  %-3s %-10s %s\n",
+         "time [us]", "thread", "dev", "rw", "offset", "length", "dur [ns]", "ch", "region", "data");
+  return ForEachRecord(ptHeader, DumpRecord, (void*)ptHeader);
+}
+
+/*****************************************************************************/
+/*! Determines the size of the memory backed DPMs and collects the records
+*   (PFN_RECORD)                                                             */
+/*****************************************************************************/
+static void ReplaySize(const struct CIFX_DPM_TRACE_RECORD* ptRecord, const uint8_t* pbData, void* pvUser)
+{
+  TRACE_REPLAY_T* ptReplay = (TRACE_REPLAY_T*)pvUser;
+  uint64_t        ullEnd   = (uint64_t)ptRecord->offset + ptRecord->length;
+
+  (void)pbData;
+
+  if((ptRecord->device < ptReplay->ptHeader->device_count) &&
+     (ullEnd <= MAX_REPLAY_SIZE) && (ullEnd > ptReplay->aulDpmSize[ptRecord->device]))
+    ptReplay->aulDpmSize[ptRecord->device] = (uint32_t)ullEnd;
+
+  if(NULL != ptReplay->pptRecords)
+    ptReplay->pptRecords[ptReplay->ullRecords] = ptRecord;
+  ptReplay->ullRecords++;
+}
+
+/*****************************************************************************/
+/*! Compares the start time of two records (qsort()). The records are stored
+*   after the access, so concurrent accesses may be stored out of order.    */
+/*****************************************************************************/
+static int CompareRecords(const void* pvLeft, const void* pvRight)
+{
+  const struct CIFX_DPM_TRACE_RECORD* ptLeft  = *(const struct CIFX_DPM_TRACE_RECORD* const*)pvLeft;
+  const struct CIFX_DPM_TRACE_RECORD* ptRight = *(const struct CIFX_DPM_TRACE_RECORD* const*)pvRight;
+
+  if(ptLeft->time_ns != ptRight->time_ns)
+    return (ptLeft->time_ns < ptRight->time_ns) ? -1 : 1;
+
+  /* same start time, keep the recorded order */
+  return (ptLeft < ptRight) ? -1 : (ptLeft > ptRight) ? 1 : 0;
+}
+
+/*****************************************************************************/
+/*! Replays a record against the memory backed DPM (PFN_RECORD)              */
+/*****************************************************************************/
+static void ReplayRecord(const struct CIFX_DPM_TRACE_RECORD* ptRecord, const uint8_t* pbData, void* pvUser)
+{
+  TRACE_REPLAY_T* ptReplay = (TRACE_REPLAY_T*)pvUser;
+  uint8_t*        pbDpm;
+  uint64_t        ullStart;
+  uint64_t        ullEnd;
+
+  if((ptRecord->device >= ptReplay->ptHeader->device_count) ||
+     (NULL == (pbDpm = ptReplay->apbDpm[ptRecord->device])) ||
+     ((uint64_t)ptRecord->offset + ptRecord->length > ptReplay->aulDpmSize[ptRecord->device]))
+  {
+    ptReplay->ullSkipped++;
+    return;
+  }
+  pbDpm += ptRecord->offset;
+
+  /* wait for the recorded start of the access */
+  ullStart = GetTimeNs();
+  if(!ptReplay->fFast)
+  {
+    uint64_t ullTarget = ptReplay->ullStartNs + (ptRecord->time_ns - ptReplay->ullFirstNs);
+
+    if(ullTarget > ullStart + SPIN_THRESHOLD)
+    {
+      struct timespec tWakeup;
+      uint64_t        ullWakeup = ullTarget - SPIN_THRESHOLD;
+
+      tWakeup.tv_sec  = (time_t)(ullWakeup / 1000000000ULL);
+      tWakeup.tv_nsec = (long)(ullWakeup % 1000000000ULL);
+      while(EINTR == clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &tWakeup, NULL))
+        ;
+    }
+    while((ullStart = GetTimeNs()) < ullTarget)
+      ;
+
+    ptReplay->ullSumLateNs += ullStart - ullTarget;
+    if(ullStart - ullTarget > ptReplay->ullMaxLateNs)
+      ptReplay->ullMaxLateNs = ullStart - ullTarget;
+  }
+
+  if(ptRecord->flags & CIFX_DPM_TRACE_FLAG_WRITE)
+  {
+    uint32_t ulData = (NULL != pbData) ? ptRecord->length : 0;
+
+    if(ulData > CIFX_DPM_TRACE_MAX_DATA)
+      ulData = CIFX_DPM_TRACE_MAX_DATA;
+    memcpy(pbDpm, (NULL != pbData) ? pbData : ptReplay->pbScratch, ulData);
+    if(ulData < ptRecord->length)
+      memcpy(pbDpm + ulData, ptReplay->pbScratch, ptRecord->length - ulData);
+  } else
+  {
+    /* the device provided the recorded data */
+    if(NULL != pbData)
+      memcpy(pbDpm, pbData, (ptRecord->length > CIFX_DPM_TRACE_MAX_DATA) ? CIFX_DPM_TRACE_MAX_DATA : ptRecord->length);
+    memcpy(ptReplay->pbScratch, pbDpm, ptRecord->length);
+  }
+
+  /* take as long as the recorded access (e.g. SPI transfer) */
+  if(ptReplay->fEmulate)
+  {
+    while(GetTimeNs() < ullStart + ptRecord->duration_ns)
+      ;
+  }
+  ullEnd = GetTimeNs();
+
+  ptReplay->ullAccesses++;
+  ptReplay->ullRecordedNs += ptRecord->duration_ns;
+  ptReplay->ullReplayNs   += ullEnd - ullStart;
+}
+
+/*****************************************************************************/
+/*! Replays the trace against a memory backed DPM per device
+*   \param ptHeader  Trace header
+*   \param fFast     Replay without waiting for the recorded access times
+*   \param fEmulate  Every access takes the recorded duration
+*   \return 0 on success                                                     */
+/*****************************************************************************/
+static int Replay(const struct CIFX_DPM_TRACE_HEADER* ptHeader, int fFast, int fEmulate)
+{
+  TRACE_REPLAY_T tReplay;
+  uint32_t       ulDevice;
+  uint32_t       ulScratch = 1;
+  uint64_t       ullRecord;
+  uint64_t       ullDuration;
+  int            iRet      = -1;
+
+  memset(&tReplay, 0, sizeof(tReplay));
+  tReplay.ptHeader = ptHeader;
+  tReplay.fFast    = fFast;
+  tReplay.fEmulate = fEmulate;
+
+  for(ulDevice = 0; ulDevice < ptHeader->device_count; ulDevice++)
+    tReplay.aulDpmSize[ulDevice] = (ptHeader->devices[ulDevice].dpm_size <= MAX_REPLAY_SIZE) ? ptHeader->devices[ulDevice].dpm_size : 0;
+
+  if(0 != ForEachRecord(ptHeader, ReplaySize, &tReplay))
+    return -1;
+
+  if(0 == tReplay.ullRecords)
+  {
+    printf("Trace contains no accesses\n");
+    return 0;
+  }
+
+  if(NULL == (tReplay.pptRecords = calloc(tReplay.ullRecords, sizeof(*tReplay.pptRecords))))
+    goto out;
+
+  tReplay.ullRecords = 0;
+  ForEachRecord(ptHeader, ReplaySize, &tReplay);
+  qsort(tReplay.pptRecords, tReplay.ullRecords, sizeof(*tReplay.pptRecords), CompareRecords);
+
+  tReplay.ullFirstNs = tReplay.pptRecords[0]->time_ns;
+  for(ullRecord = 0; ullRecord < tReplay.ullRecords; ullRecord++)
+  {
+    const struct CIFX_DPM_TRACE_RECORD* ptRecord = tReplay.pptRecords[ullRecord];
+
+    if(ptRecord->time_ns + ptRecord->duration_ns > tReplay.ullLastNs)
+      tReplay.ullLastNs = ptRecord->time_ns + ptRecord->duration_ns;
+  }
+
+  for(ulDevice = 0; ulDevice < ptHeader->device_count; ulDevice++)
+  {
+    if(tReplay.aulDpmSize[ulDevice] > ulScratch)
+      ulScratch = tReplay.aulDpmSize[ulDevice];
+    if((tReplay.aulDpmSize[ulDevice] > 0) && (NULL == (tReplay.apbDpm[ulDevice] = calloc(1, tReplay.aulDpmSize[ulDevice]))))
+      goto out;
+  }
+
+  /* source of writes without data / destination of reads */
+  if(NULL == (tReplay.pbScratch = calloc(1, ulScratch)))
+    goto out;
+
+  tReplay.ullStartNs = GetTimeNs();
+  for(ullRecord = 0; ullRecord < tReplay.ullRecords; ullRecord++)
+    ReplayRecord(tReplay.pptRecords[ullRecord], RecordData(tReplay.pptRecords[ullRecord]), &tReplay);
+  ullDuration = GetTimeNs() - tReplay.ullStartNs;
+
+  printf("Accesses replayed   : %llu (%llu skipped)\n", (unsigned long long)tReplay.ullAccesses, (unsigned long long)tReplay.ullSkipped);
+  printf("Recorded time span  : %.3f ms\n", (double)(tReplay.ullLastNs - tReplay.ullFirstNs) / 1000000.0);
+  printf("Replay time span    : %.3f ms%s\n", (double)ullDuration / 1000000.0, fFast ? " (no waits)" : "");
+  printf("Recorded access time: %.3f ms\n", (double)tReplay.ullRecordedNs / 1000000.0);
+  printf("Replay access time  : %.3f ms%s\n", (double)tReplay.ullReplayNs / 1000000.0, fEmulate ? " (recorded durations)" : " (memory)");
+  if(!fFast && (tReplay.ullAccesses > 0))
+  {
+    printf("Start delay         : avg %.3f us, max %.3f us\n",
+           (double)tReplay.ullSumLateNs / (double)tReplay.ullAccesses / 1000.0, (double)tReplay.ullMaxLateNs / 1000.0);
+  }
+  if(!(ptHeader->flags & CIFX_DPM_TRACE_HDR_DATA))
+    printf("Note: data not recorded, accesses replayed with zero data\n");
+  iRet = 0;
+
+out:
+  if(0 != iRet)
+    fprintf(stderr, "Failed to allocate the replay memory\n");
+  for(ulDevice = 0; ulDevice < ptHeader->device_count; ulDevice++)
+    free(tReplay.apbDpm[ulDevice]);
+  free(tReplay.pbScratch);
+  free(tReplay.pptRecords);
+  return iRet;
+}
+
+static void help(void)
+{
+  printf("Usage: cifx_dpmtrace [OPTION]... <trace file>\n");
+  printf("Analyses a DPM access trace (dpm_trace_file of struct CIFX_LINUX_INIT).\n\n");
+  printf("  -s           summary of the accesses per device, channel, region and thread (default)\n");
+  printf("  -d           dump all accesses\n");
+  printf("  -r           replay the accesses against a memory backed DPM with the recorded timing\n");
+  printf("  -f           replay without waiting for the recorded start of the accesses\n");
+  printf("  -e           replay every access with its recorded duration (e.g. SPI)\n");
+  printf("  -h           print this help\n");
+}
+
+int main(int argc, char* argv[])
+{
+  int                           opt;
+  int                           iMode    = MODE_SUMMARY;
+  int                           fFast    = 0;
+  int                           fEmulate = 0;
+  int                           iFd;
+  int                           iRet     = -1;
+  struct stat                   tStat;
+  struct CIFX_DPM_TRACE_HEADER* ptHeader;
+
+  while((opt = getopt(argc, argv, "sdrfeh")) != -1) {
+    switch(opt)
+    {
+      case 's':
+        iMode = MODE_SUMMARY;
+        break;
+      case 'd':
+        iMode = MODE_DUMP;
+        break;
+      case 'r':
+        iMode = MODE_REPLAY;
+        break;
+      case 'f':
+        fFast = 1;
+        break;
+      case 'e':
+        fEmulate = 1;
+        break;
+      case 'h':
+      default:
+        help();
+        return (opt == 'h') ? 0 : -1;
+    }
+  }
+
+  if(optind >= argc) {
+    help();
+    return -1;
+  }
+
+  if(0 > (iFd = open(argv[optind], O_RDONLY)) || (0 != fstat(iFd, &tStat))) {
+    fprintf(stderr, "Failed to open %s (%s)\n", argv[optind], strerror(errno));
+    return -1;
+  }
+
+  if(((size_t)tStat.st_size < sizeof(*ptHeader)) ||
+     (MAP_FAILED == (ptHeader = mmap(NULL, (size_t)tStat.st_size, PROT_READ, MAP_PRIVATE, iFd, 0)))) {
+    fprintf(stderr, "Failed to read %s\n", argv[optind]);
+    close(iFd);
+    return -1;
+  }
+
+  if((ptHeader->magic != CIFX_DPM_TRACE_MAGIC) || (ptHeader->version != CIFX_DPM_TRACE_VERSION) ||
+     (ptHeader->header_size < sizeof(*ptHeader)) || (ptHeader->ring_size == 0) ||
+     ((uint64_t)ptHeader->header_size + ptHeader->ring_size > (uint64_t)tStat.st_size) ||
+     (ptHeader->device_count > CIFX_DPM_TRACE_MAX_DEVICES) || (ptHeader->tail > ptHeader->head) ||
+     (ptHeader->head - ptHeader->tail > ptHeader->ring_size)) {
+    fprintf(stderr, "%s is no valid DPM trace file\n", argv[optind]);
+  } else
+  {
+    switch(iMode)
+    {
+      case MODE_DUMP:
+        iRet = Dump(ptHeader);
+        break;
+      case MODE_REPLAY:
+        iRet = Replay(ptHeader, fFast, fEmulate);
+        break;
+      default:
+        iRet = Summary(ptHeader);
+        break;
+    }
+  }
+
+  munmap(ptHeader, (size_t)tStat.st_size);
+  close(iFd);
+
+  return iRet;
+}
@@ -23,6 +23,8 @@
 
      Version   Date        Author   Description
      ----------------------------------------------------------------------------------
+     14        18.10.2026           Added HilMarshallerGetRequestKey() to handle requests
+                                    for different channels/sysdevices in parallel
      13        12.11.2020  RMA      Changing general functions to OS_* implementation
      12        12.12.2019  LCO      Restructure handling for devices without Communication Channels
                                     in cifXTransportInit()
@@ -133,6 +135,7 @@ static PMARSH_CIFX_DEVICE_DATA_T FindDevice(char* szBoard, void* pvUser);
 
 static void HilMarshallerDeInitModul(void* pvUser);
 static void HilMarshallerHandlePacket(void* pvMarshaller, HIL_MARSHALLER_BUFFER_T* ptBuffer, void* pvUser);
+static uint32_t HilMarshallerGetRequestKey(HIL_MARSHALLER_BUFFER_T* ptBuffer, void* pvUser);
 
 /*****************************************************************************/
 /*! Initialize cifX API transport layer
@@ -165,6 +168,7 @@ uint32_t cifXTransportInit(void* pvMarshaller, void* pvConfig)
     tLayerData.pfnDeinit  = HilMarshallerDeInitModul;
     tLayerData.pvUser     = ptInstance;
     tLayerData.pfnPoll    = NULL;
+    tLayerData.pfnGetKey  = HilMarshallerGetRequestKey;
 
     ptInstance->tDRVFunctions = ptConfig->tDRVFunctions;
 
@@ -352,6 +356,45 @@ void HilMarshallerHandlePacket( void* pvMarshaller, HIL_MARSHALLER_BUFFER_T* ptB
   HilMarshallerConnTxData(pvMarshaller, ptBuffer->tMgmt.ulConnectorIdx , ptBuffer);
 }
 
+/*****************************************************************************/
+/*! Returns the key a request is serialized on. Requests to sysdevice and
+*   channel objects are keyed by their handle, so requests to different
+*   objects may be handled in parallel. Requests changing the object tables
+*   (class factory, driver object, close) are exclusive.
+*   \param ptBuffer     Pointer receive buffer
+*   \param pvUser       Pointer to cifX Internal instance data
+*   \return Key of the request or HIL_MARSHALLER_KEY_EXCLUSIVE               */
+/*****************************************************************************/
+static uint32_t HilMarshallerGetRequestKey( HIL_MARSHALLER_BUFFER_T* ptBuffer, void* pvUser )
+{
+  PMARSHALLER_DATA_FRAME_HEADER_T ptMarshallerHeader  = (PMARSHALLER_DATA_FRAME_HEADER_T) &ptBuffer->abData[0];
+  uint32_t                        ulKey               = HIL_MARSHALLER_KEY_EXCLUSIVE;
+
+  UNREFERENCED_PARAMETER(pvUser);
+
+  if( (ptBuffer->tMgmt.ulUsedDataBufferLen >= sizeof(*ptMarshallerHeader)) &&
+      HANDLE_IS_VALID(ptMarshallerHeader->ulHandle) )
+  {
+    switch(HANDLE_GET_OBJTYPE(ptMarshallerHeader->ulHandle))
+    {
+      case MARSHALLER_OBJECT_TYPE_SYSDEVICE:
+        if(MARSHALLER_SYSDEV_METHODID_CLOSE != ptMarshallerHeader->ulMethodID)
+          ulKey = ptMarshallerHeader->ulHandle;
+        break;
+
+      case MARSHALLER_OBJECT_TYPE_CHANNEL:
+        if(MARSHALLER_CHANNEL_METHODID_CLOSE != ptMarshallerHeader->ulMethodID)
+          ulKey = ptMarshallerHeader->ulHandle;
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  return ulKey;
+}
+
 /*****************************************************************************/
 /*! Handle  packets which includes a class factory command
 *   \param ptBuffer  Reference to the give marshaller packet
@@ -9,6 +9,8 @@ Description:
   Changes:
     Date        Description
     -----------------------------------------------------------------------------------
+    2026-10-18  HilMarshallerMain() may be called in parallel (ulMaxParallelRequests),
+                requests with the same key (see pfnGetKey) are handled in order
     2022-06-27  Fix handling in HilMarshallerSetMode() to change mode of a single connector
     2020-11-12  Moved OS functions to separate implementation module
     2019-01-23  Bugfix:
@@ -379,6 +381,90 @@ static TRANSPORT_LAYER_DATA_T* FindTransportLayer(const HIL_MARSHALLER_DATA_T* p
   return ptRet;
 }
 
+/*****************************************************************************/
+/*! Takes the next pending request which may be handled now. A request is
+*   skipped while another request with the same key is handled. Exclusive
+*   requests wait until no other request is active and block all following
+*   requests. Must be called with OS_Lock() held.
+*    \param ptMarshaller Marshaller handle
+*    \param pptTransport Returned transport layer of the request
+*    \param pulKey       Returned key of the request
+*    \return NULL if no request can be handled now                          */
+/*****************************************************************************/
+static HIL_MARSHALLER_BUFFER_T* TakePendingRequest(HIL_MARSHALLER_DATA_T* ptMarshaller, TRANSPORT_LAYER_DATA_T** pptTransport, uint32_t* pulKey)
+{
+  HIL_MARSHALLER_BUFFER_T* ptBuffer;
+  uint32_t                 ulIdx;
+
+  if(ptMarshaller->ulActiveCnt >= ptMarshaller->ulMaxActive)
+    return NULL;
+
+  for(ulIdx = 0; ulIdx < ptMarshaller->ulActiveCnt; ++ulIdx)
+  {
+    if(HIL_MARSHALLER_KEY_EXCLUSIVE == ptMarshaller->aulActiveKeys[ulIdx])
+      return NULL;
+  }
+
+  STAILQ_FOREACH(ptBuffer, &ptMarshaller->tPendingRequests, tList)
+  {
+    TRANSPORT_LAYER_DATA_T* ptTransport = FindTransportLayer(ptMarshaller, ptBuffer->tTransport.usDataType);
+    uint32_t                ulKey       = ptBuffer->tTransport.usDataType;
+    bool                    fActive     = false;
+
+    if( (NULL != ptTransport) && (NULL != ptTransport->pfnGetKey) )
+      ulKey = ptTransport->pfnGetKey(ptBuffer, ptTransport->pvUser);
+
+    if(HIL_MARSHALLER_KEY_EXCLUSIVE == ulKey)
+    {
+      /* Do not let following requests overtake an exclusive one */
+      if(0 != ptMarshaller->ulActiveCnt)
+        break;
+    } else
+    {
+      for(ulIdx = 0; ulIdx < ptMarshaller->ulActiveCnt; ++ulIdx)
+      {
+        if(ulKey == ptMarshaller->aulActiveKeys[ulIdx])
+        {
+          fActive = true;
+          break;
+        }
+      }
+    }
+
+    if(!fActive)
+    {
+      STAILQ_REMOVE(&ptMarshaller->tPendingRequests, ptBuffer, HIL_MARSHALLER_BUFFER_Ttag, tList);
+      ptMarshaller->aulActiveKeys[ptMarshaller->ulActiveCnt++] = ulKey;
+
+      *pptTransport = ptTransport;
+      *pulKey       = ulKey;
+      return ptBuffer;
+    }
+  }
+
+  return NULL;
+}
+
+/*****************************************************************************/
+/*! Removes the key of a finished request from the active list.
+*   Must be called with OS_Lock() held.
+*    \param ptMarshaller Marshaller handle
+*    \param ulKey        Key of the finished request                         */
+/*****************************************************************************/
+static void ReleaseRequestKey(HIL_MARSHALLER_DATA_T* ptMarshaller, uint32_t ulKey)
+{
+  uint32_t ulIdx;
+
+  for(ulIdx = 0; ulIdx < ptMarshaller->ulActiveCnt; ++ulIdx)
+  {
+    if(ulKey == ptMarshaller->aulActiveKeys[ulIdx])
+    {
+      ptMarshaller->aulActiveKeys[ulIdx] = ptMarshaller->aulActiveKeys[--ptMarshaller->ulActiveCnt];
+      break;
+    }
+  }
+}
+
 /*****************************************************************************/
 /*! Send an HIL Transport acknowledge
 *    \param ptMarshaller Marshaller handle
@@ -464,8 +550,11 @@ uint32_t HilMarshallerStart(const HIL_MARSHALLER_PARAMS_T* ptParams, void** ppvM
       ptMarshaller->pvUser          = pvUser;
       ptMarshaller->ulMaxConnectors = ptParams->ulMaxConnectors;
       ptMarshaller->ulTransports    = ptParams->ulTransportCnt;
+      ptMarshaller->ulMaxActive     = (0 == ptParams->ulMaxParallelRequests) ? 1 : ptParams->ulMaxParallelRequests;
       OS_Memcpy(ptMarshaller->szServerName, (void*)ptParams->szServerName, sizeof(ptMarshaller->szServerName));
-      if(NULL == (ptMarshaller->atConnectors = OS_Malloc(ptParams->ulMaxConnectors * (uint32_t)sizeof(CONNECTOR_DATA_T))))
+      if(NULL == (ptMarshaller->aulActiveKeys = OS_Malloc(ptMarshaller->ulMaxActive * (uint32_t)sizeof(uint32_t))))
+        eRet = HIL_MARSHALLER_E_OUTOFMEMORY;
+      else if(NULL == (ptMarshaller->atConnectors = OS_Malloc(ptParams->ulMaxConnectors * (uint32_t)sizeof(CONNECTOR_DATA_T))))
         eRet = HIL_MARSHALLER_E_OUTOFMEMORY;
       else
       {
@@ -544,6 +633,7 @@ void HilMarshallerStop(void* pvMarshHandle)
       ptMarshaller->atConnectors = NULL;
     }
 
+    OS_Free(ptMarshaller->aulActiveKeys);
     OS_Free(ptMarshaller);
   }
 }
@@ -1168,7 +1258,10 @@ void HilMarshallerTimer(void* pvMarshaller)
 
 /*****************************************************************************/
 /*! Main marshaller module. This must be called by user, every time it receives
-*   the pfnRequest callback.
+*   the pfnRequest callback. It may be called from several threads in parallel
+*   (see ulMaxParallelRequests), requests with the same key are handled in the
+*   order they were received. If requests are still pending when a request is
+*   finished, pfnRequest is called again.
 *    \param pvMarshaller     Marshaller handle
 *    \return HIL_MARSHALLER_E_SUCCESS on success
 *    \and HIL_MARSHALLER_E_FAIL if no message retrieved from the pending requests list  */
@@ -1180,31 +1273,39 @@ uint32_t HilMarshallerMain(void* pvMarshaller)
   int                      iLock           = 0;
   HIL_MARSHALLER_BUFFER_T* ptBuffer        = NULL;
   TRANSPORT_LAYER_DATA_T*  ptTransport     = NULL;
-  CONNECTOR_DATA_T*        ptConn          = NULL;
+  uint32_t                 ulKey           = 0;
 
   if (ptMarshaller == NULL)
     eRet = HIL_MARSHALLER_E_FAIL;
   else
   {
     iLock    = OS_Lock();
-    ptBuffer = STAILQ_FIRST(&ptMarshaller->tPendingRequests);
+    ptBuffer = TakePendingRequest(ptMarshaller, &ptTransport, &ulKey);
     OS_Unlock(iLock);
     if (ptBuffer == NULL)
       eRet = HIL_MARSHALLER_E_FAIL;
     else
     {
-      ptTransport = FindTransportLayer(ptMarshaller, ptBuffer->tTransport.usDataType);
-      ptConn      = &ptMarshaller->atConnectors[ptBuffer->tMgmt.ulConnectorIdx];
-      if (ptTransport == NULL || ptConn == NULL)
+      bool fPending;
+
+      if (ptTransport == NULL)
+      {
+        /* Transport has been unregistered in the meantime */
+        HilMarshallerFreeBuffer(ptBuffer);
         eRet = HIL_MARSHALLER_E_FAIL;
-      else
+      } else
       {
-        iLock = OS_Lock();
-        STAILQ_REMOVE(&ptMarshaller->tPendingRequests, ptBuffer, HIL_MARSHALLER_BUFFER_Ttag, tList);
-        OS_Unlock(iLock);
-
         ptTransport->pfnHandler(ptMarshaller, ptBuffer, ptTransport->pvUser);
       }
+
+      iLock = OS_Lock();
+      ReleaseRequestKey(ptMarshaller, ulKey);
+      fPending = !STAILQ_EMPTY(&ptMarshaller->tPendingRequests);
+      OS_Unlock(iLock);
+
+      /* Requests may have been deferred while this one was handled */
+      if (fPending)
+        ptMarshaller->pfnRequest(ptMarshaller, ptMarshaller->pvUser);
     }
   }
   return eRet;
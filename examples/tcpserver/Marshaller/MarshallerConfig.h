@@ -118,6 +118,11 @@ typedef struct HIL_MARSHALLER_PARAMS_Ttag
   uint32_t      ulTransportCnt;                /*!< Number of transports to automatically load at startup */
   const TRANSPORT_LAYER_CONFIG_T* atTransports;  /*!< Array of function pointer to initialize Transports    */
 
+  /* NOTE: Added to the end of the structure to be old compatible.
+           When using the previous structure initializations this field will be 0 */
+  uint32_t      ulMaxParallelRequests;         /*!< Number of requests HilMarshallerMain() may handle in parallel
+                                                    (requests with the same key are always serialized, 0 = 1) */
+
 } HIL_MARSHALLER_PARAMS_T;
 
 
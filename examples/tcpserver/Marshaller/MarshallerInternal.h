@@ -125,6 +125,10 @@ typedef struct HIL_MARSHALLER_CONNECTOR_Ttag
 typedef void(*PFN_TRANSPORT_HANDLER)(void* pvMarshaller, HIL_MARSHALLER_BUFFER_T* ptBuffer, void* pvUser);
 typedef void(*PFN_TRANSPORT_DEINIT)(void* pvUser);
 typedef void(*PFN_TRANSPORT_POLL)(void* pvUser);
+typedef uint32_t(*PFN_TRANSPORT_GET_KEY)(HIL_MARSHALLER_BUFFER_T* ptBuffer, void* pvUser);
+
+/*! Request key of requests which must not run in parallel to any other request */
+#define HIL_MARSHALLER_KEY_EXCLUSIVE  0xFFFFFFFF
 
 /*****************************************************************************/
 /*! Transport layer registration information                                 */
@@ -137,6 +141,10 @@ typedef struct TRANSPORT_LAYER_DATA_Ttag
   PFN_TRANSPORT_DEINIT  pfnDeinit;
   PFN_TRANSPORT_POLL    pfnPoll;
   void*                 pvUser;
+
+  /* NOTE: Added to the end of the structure to be old compatible.
+           If not set, all requests of this transport are handled one after another */
+  PFN_TRANSPORT_GET_KEY pfnGetKey;   /*!< Returns the key a request is serialized on (e.g. the target handle) */
 } TRANSPORT_LAYER_DATA_T;
 
 /* This function is called by a connector when it receives data from the line */
@@ -220,6 +228,11 @@ typedef struct HIL_MARSHALLER_DATA_Ttag
 
   struct MARSHALLER_BUFFER_HEAD tPendingRequests;
 
+  /* Parallel request handling */
+  uint32_t                      ulMaxActive;      /*!< Maximum number of requests handled in parallel (size of aulActiveKeys[]) */
+  uint32_t                      ulActiveCnt;      /*!< Number of requests currently handled      */
+  uint32_t*                     aulActiveKeys;    /*!< Keys of the requests currently handled    */
+
   PFN_MARSHALLER_REQUEST        pfnRequest;
   void*                         pvUser;
 
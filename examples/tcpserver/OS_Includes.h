@@ -56,6 +56,7 @@ extern "C"
 void*            OS_Memalloc(uint32_t ulSize);
 void             OS_Memfree(void* pvMem);
 void             OS_Sleep       (uint32_t ulSleepTimeMs);
+uint32_t         CreateCRC32    (uint32_t ulCRC, uint8_t* pabBuffer, uint32_t ulLength);
 /* impl. in OS_Specific.c */
 uint32_t         OS_GetTickCount(void);
 
@@ -3,17 +3,23 @@
  *
  * Copyright (c) 2025, Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserved.
  *
- * Description: Extension module for file download and storage support
+ * Description: Extension module for file download and storage support. The captured
+ *              file data is streamed block by block through a write-behind buffer to
+ *              the file storage callbacks, so the memory use does not depend on the
+ *              file size.
  *
  **************************************************************************************/
 
 #include <OS_Includes.h>
+#include <pthread.h>
 #include "HilFileHeaderV3.h"
 #include "cifXUser.h"
 #include "cifXErrors.h"
 #include "rcX_Public.h"
 #include "cifx_download_hook.h"
 
+#define TXN_WRITE_BUFFER_SIZE 0x10000 /*!< Size of the write-behind buffer of a transaction */
+
 /*****************************************************************************/
 /*! Structure holding resources for download transaction                     */
 /*****************************************************************************/
@@ -30,13 +36,18 @@ typedef struct TXN_RSRC_Ttag
   char          szFilename[CIFx_MAX_INFO_NAME_LENTH]; /*!< File name. */
   uint32_t      ulDownloadMode; /*!< Download mode (firmware, config, module or file download) */
   uint32_t      ulFilesize;     /*!< File size. */
-  uint8_t*      pbFileBuf;      /*!< Buffer to store file data */
-  uint8_t*      pabActData;     /*!< Pointer storing current buffer location */
+  uint32_t      ulReceived;     /*!< Number of file bytes received so far */
+  uint32_t      ulCrc32;        /*!< Cumulative CRC-32 of the received file data */
+  void*         pvFile;         /*!< Handle of the file storage callbacks, NULL if not open */
+  uint32_t      ulWriteBufLen;  /*!< Number of bytes waiting in abWriteBuf */
 
-  CIFX_PACKET*  ptConfPkt;      /*!< Confirmation packet for capture mode */
+  int           fConfPending;   /*!< tConfPkt holds a confirmation, which has not been read by the host */
+  CIFX_PACKET   tConfPkt;       /*!< Confirmation packet for capture mode */
   
   struct TXN_RSRC_Ttag* pNext;  /*!< Next transaction resource */
 
+  uint8_t       abWriteBuf[TXN_WRITE_BUFFER_SIZE]; /*!< Write-behind buffer for the file storage */
+
 } TXN_RSRC_T, *PTXN_RSRC_T;
 
 /*****************************************************************************/
@@ -57,12 +68,14 @@ static PFN_xDriverEnumBoards s_pfnDriverEnumBoards = NULL;
 static DRVFNC_T s_tDRVFncSysdevice = {0};
 static DRVFNC_T s_tDRVFncChannel   = {0};
 
-/*!< List pointer for download transaction */
-static PTXN_RSRC_T s_ptTxnList = NULL;
+/*!< List pointer for download transaction (requests to different devices are
+     handled in parallel by the marshaller workers) */
+static PTXN_RSRC_T     s_ptTxnList = NULL;
+static pthread_mutex_t s_tTxnLock  = PTHREAD_MUTEX_INITIALIZER;
 
-/*!< Files storage callback function */
-static PFN_FILESTORAGE_CBK s_pfnFileStorageCbk = NULL;
-static void*               s_pvUser            = NULL;
+/*!< Files storage callback functions */
+static FILESTORAGE_FUNCTIONS_T s_tFileStorage = {0};
+static void*                   s_pvUser       = NULL;
 
 /* Download transaction modes */
 #define TXN_MODE_PACKET_MONITOR 0x00
@@ -74,6 +87,11 @@ static void*               s_pvUser            = NULL;
 #define TXN_STATE_FINISHED         0x02
 #define TXN_STATE_ERROR            0x03
 
+/* Download requests are answered by the hook instead of the device (firmware download
+   to a ram based device) */
+#define TXN_IS_CAPTURED(ptTxnRsrc) ( (TXN_MODE_PACKET_CAPTURE == (ptTxnRsrc)->bTxnMode) && \
+                                     (DOWNLOAD_MODE_FIRMWARE  == (ptTxnRsrc)->ulDownloadMode) )
+
 
 /*****************************************************************************/
 /*! Transfer packet function from the DLL
@@ -247,7 +265,9 @@ static int32_t GetDeviceInfo(CIFXHANDLE hDevice, BOARD_INFORMATION* ptBoardInfo,
 }
 
 /*****************************************************************************/
-/*! Create Download confirmation packet for current transaction
+/*! Create Download confirmation packet for current transaction. The protocol
+*   has at most one outstanding confirmation per transaction, so the packet
+*   is kept in the transaction resource.
 *   \param hTxnRsrc      Transaction resource
 *   \param ptReqPkt      Request packet
 *   \return CIFX_NO_ERROR on success                                         */
@@ -266,7 +286,7 @@ static int32_t CreateTxnCnf(void* hTxnRsrc, CIFX_PACKET* ptReqPkt)
     case RCX_FILE_DOWNLOAD_REQ:
     {
       RCX_FILE_DOWNLOAD_REQ_T* ptDownloadReq  = (RCX_FILE_DOWNLOAD_REQ_T*)ptReqPkt;
-      RCX_FILE_DOWNLOAD_CNF_T* ptDownloadConf = (RCX_FILE_DOWNLOAD_CNF_T*)OS_Malloc(sizeof(RCX_FILE_DOWNLOAD_CNF_T));
+      RCX_FILE_DOWNLOAD_CNF_T* ptDownloadConf = (RCX_FILE_DOWNLOAD_CNF_T*)&ptTxnRsrc->tConfPkt;
 
       ptDownloadConf->tHead            = ptDownloadReq->tHead;
       ptDownloadConf->tHead.ulCmd      = ptDownloadReq->tHead.ulCmd|RCX_MSK_PACKET_ANSWER;
@@ -275,8 +295,7 @@ static int32_t CreateTxnCnf(void* hTxnRsrc, CIFX_PACKET* ptReqPkt)
       ptDownloadConf->tHead.ulSta      = ptTxnRsrc->lError;
       ptDownloadConf->tData.ulMaxBlockSize = ptDownloadReq->tData.ulMaxBlockSize;
 
-      /* Store confirmation packet in transaction resource */
-      ptTxnRsrc->ptConfPkt = (CIFX_PACKET*)ptDownloadConf;
+      ptTxnRsrc->fConfPending = 1;
       break;
     }
 
@@ -284,17 +303,16 @@ static int32_t CreateTxnCnf(void* hTxnRsrc, CIFX_PACKET* ptReqPkt)
     case RCX_FILE_DOWNLOAD_DATA_REQ:
     {
       RCX_FILE_DOWNLOAD_DATA_REQ_T* ptDownloadDataReq  = (RCX_FILE_DOWNLOAD_DATA_REQ_T*)ptReqPkt;
-      RCX_FILE_DOWNLOAD_DATA_CNF_T* ptDownloadDataConf = (RCX_FILE_DOWNLOAD_DATA_CNF_T*)OS_Malloc(sizeof(RCX_FILE_DOWNLOAD_DATA_CNF_T));
+      RCX_FILE_DOWNLOAD_DATA_CNF_T* ptDownloadDataConf = (RCX_FILE_DOWNLOAD_DATA_CNF_T*)&ptTxnRsrc->tConfPkt;
       
       ptDownloadDataConf->tHead            = ptDownloadDataReq->tHead;
       ptDownloadDataConf->tHead.ulCmd      = ptDownloadDataReq->tHead.ulCmd|RCX_MSK_PACKET_ANSWER;
       ptDownloadDataConf->tHead.ulExt      = 0;
       ptDownloadDataConf->tHead.ulLen      = (ptTxnRsrc->lError != 0)?0:sizeof(ptDownloadDataConf->tData);
       ptDownloadDataConf->tHead.ulSta      = ptTxnRsrc->lError;
-      ptDownloadDataConf->tData.ulExpectedCrc32 = ptDownloadDataReq->tData.ulChksum;
+      ptDownloadDataConf->tData.ulExpectedCrc32 = ptTxnRsrc->ulCrc32;
 
-      /* Store confirmation packet in transaction resource */
-      ptTxnRsrc->ptConfPkt = (CIFX_PACKET*)ptDownloadDataConf;
+      ptTxnRsrc->fConfPending = 1;
       break;
     }
 
@@ -302,7 +320,7 @@ static int32_t CreateTxnCnf(void* hTxnRsrc, CIFX_PACKET* ptReqPkt)
     case RCX_FILE_DOWNLOAD_ABORT_REQ:
     {
       RCX_FILE_DOWNLOAD_ABORT_REQ_T* ptDownloadAbortReq  = (RCX_FILE_DOWNLOAD_ABORT_REQ_T*)ptReqPkt;
-      RCX_FILE_DOWNLOAD_ABORT_CNF_T* ptDownloadAbortConf = (RCX_FILE_DOWNLOAD_ABORT_CNF_T*)OS_Malloc(sizeof(RCX_FILE_DOWNLOAD_ABORT_CNF_T));
+      RCX_FILE_DOWNLOAD_ABORT_CNF_T* ptDownloadAbortConf = (RCX_FILE_DOWNLOAD_ABORT_CNF_T*)&ptTxnRsrc->tConfPkt;
       
       ptDownloadAbortConf->tHead            = ptDownloadAbortReq->tHead;
       ptDownloadAbortConf->tHead.ulCmd      = ptDownloadAbortReq->tHead.ulCmd|RCX_MSK_PACKET_ANSWER;
@@ -310,8 +328,7 @@ static int32_t CreateTxnCnf(void* hTxnRsrc, CIFX_PACKET* ptReqPkt)
       ptDownloadAbortConf->tHead.ulLen      = 0;
       ptDownloadAbortConf->tHead.ulSta      = ptTxnRsrc->lError;
 
-      /* Store confirmation packet in transaction resource */
-      ptTxnRsrc->ptConfPkt = (CIFX_PACKET*)ptDownloadAbortConf;
+      ptTxnRsrc->fConfPending = 1;
       break;
     }
   }
@@ -320,13 +337,84 @@ static int32_t CreateTxnCnf(void* hTxnRsrc, CIFX_PACKET* ptReqPkt)
 }
 
 /*****************************************************************************/
-/*! Remove Transaction resource
+/*! Pass the data of the write-behind buffer to the file storage
+*   \param ptTxnRsrc     Transaction resource
+*   \return CIFX_NO_ERROR on success                                         */
+/*****************************************************************************/
+static int32_t FlushTxnData(PTXN_RSRC_T ptTxnRsrc)
+{
+  int32_t lRet = CIFX_NO_ERROR;
+
+  if (ptTxnRsrc->ulWriteBufLen > 0)
+  {
+    lRet = s_tFileStorage.pfnWrite(ptTxnRsrc->pvFile, ptTxnRsrc->abWriteBuf, ptTxnRsrc->ulWriteBufLen, s_pvUser);
+    ptTxnRsrc->ulWriteBufLen = 0;
+  }
+
+  return lRet;
+}
+
+/*****************************************************************************/
+/*! Append a received data block to the file. The block is collected in the
+*   write-behind buffer, which is passed to the file storage when full.
+*   \param ptTxnRsrc     Transaction resource
+*   \param pbData        Data block
+*   \param ulDataLen     Length of data block
+*   \return CIFX_NO_ERROR on success                                         */
+/*****************************************************************************/
+static int32_t StoreTxnData(PTXN_RSRC_T ptTxnRsrc, uint8_t* pbData, uint32_t ulDataLen)
+{
+  int32_t lRet = CIFX_NO_ERROR;
+
+  while ( (ulDataLen > 0) && (CIFX_NO_ERROR == lRet) )
+  {
+    uint32_t ulCopyLen = TXN_WRITE_BUFFER_SIZE - ptTxnRsrc->ulWriteBufLen;
+
+    if (ulCopyLen > ulDataLen)
+      ulCopyLen = ulDataLen;
+
+    OS_MEMCPY( &ptTxnRsrc->abWriteBuf[ptTxnRsrc->ulWriteBufLen], pbData, ulCopyLen);
+    ptTxnRsrc->ulWriteBufLen += ulCopyLen;
+    pbData                   += ulCopyLen;
+    ulDataLen                -= ulCopyLen;
+
+    if (TXN_WRITE_BUFFER_SIZE == ptTxnRsrc->ulWriteBufLen)
+      lRet = FlushTxnData(ptTxnRsrc);
+  }
+
+  return lRet;
+}
+
+/*****************************************************************************/
+/*! Close the file of a transaction
+*   \param ptTxnRsrc     Transaction resource
+*   \param fCommit       !=0 to keep the file, 0 to discard it
+*   \return CIFX_NO_ERROR on success                                         */
+/*****************************************************************************/
+static int32_t CloseTxnFile(PTXN_RSRC_T ptTxnRsrc, int fCommit)
+{
+  int32_t lRet = CIFX_NO_ERROR;
+
+  if (NULL != ptTxnRsrc->pvFile)
+  {
+    lRet = s_tFileStorage.pfnClose(ptTxnRsrc->pvFile, fCommit, s_pvUser);
+    ptTxnRsrc->pvFile = NULL;
+  }
+
+  return lRet;
+}
+
+/*****************************************************************************/
+/*! Remove Transaction resource. A file, which is still open, is discarded.
 *   \param hDevice      Device handle                                        */
 /*****************************************************************************/
 static void RemoveTxnRsrc(CIFXHANDLE hDevice)
 {
-  PTXN_RSRC_T ptTxnRsrcCur = s_ptTxnList;
+  PTXN_RSRC_T ptTxnRsrcCur;
   PTXN_RSRC_T ptTxnRsrcOld = NULL;
+
+  pthread_mutex_lock(&s_tTxnLock);
+  ptTxnRsrcCur = s_ptTxnList;
   
   /* Iterate the transaction resource list */
   while (ptTxnRsrcCur)
@@ -349,13 +437,12 @@ static void RemoveTxnRsrc(CIFXHANDLE hDevice)
       s_ptTxnList = ptTxnRsrcCur->pNext;
     else
       ptTxnRsrcOld->pNext = ptTxnRsrcCur->pNext;
+  }
+  pthread_mutex_unlock(&s_tTxnLock);
 
-    if (ptTxnRsrcCur->pbFileBuf)
-      OS_Free(ptTxnRsrcCur->pbFileBuf);
-
-    if (ptTxnRsrcCur->ptConfPkt)
-      OS_Free(ptTxnRsrcCur->ptConfPkt);
-
+  if (NULL != ptTxnRsrcCur)
+  {
+    (void)CloseTxnFile(ptTxnRsrcCur, 0);
     OS_Free(ptTxnRsrcCur);
   }
 }
@@ -370,7 +457,8 @@ static void RemoveTxnRsrc(CIFXHANDLE hDevice)
 *   \param ulDownloadMode    Download mode (firmware, config, module or file download)
 *   \param ulChannel         Download destination channel
 *   \param ulMaxBlockSize    Maximal block size per packet
-*   \return Pointer to download transaction resource, NULL if failed         */
+*   \return Pointer to download transaction resource, NULL if failed. If the
+*           file could not be opened, the resource is returned in error state. */
 /*****************************************************************************/
 static void* CreateTxnRsrc(CIFXHANDLE hDevice, BOARD_INFORMATION* ptBoardInfo,
                            uint8_t bTxnMode, char* pszFileName, uint32_t ulFileLength, 
@@ -382,16 +470,14 @@ static void* CreateTxnRsrc(CIFXHANDLE hDevice, BOARD_INFORMATION* ptBoardInfo,
   {
     ptTxnRsrc = NULL;
 
-  } else if (NULL == (ptTxnRsrc->pbFileBuf = (uint8_t*)OS_Malloc(ulFileLength)))
-  {
-    OS_Free(ptTxnRsrc);
-    ptTxnRsrc = NULL;
-
   } else
   {
     ptTxnRsrc->ulState        = TXN_STATE_DOWNLOAD_REQUEST; /* Initial transaction state */
-    ptTxnRsrc->pabActData     = ptTxnRsrc->pbFileBuf;
     ptTxnRsrc->ulFilesize     = ulFileLength;
+    ptTxnRsrc->ulReceived     = 0;
+    ptTxnRsrc->ulCrc32        = 0;
+    ptTxnRsrc->pvFile         = NULL;
+    ptTxnRsrc->ulWriteBufLen  = 0;
     ptTxnRsrc->ulDownloadMode = ulDownloadMode;
     ptTxnRsrc->ulMaxBlockSize = ulMaxBlockSize; /* Maximum block size the host can handle. This could be
                                                    replaced by smaller value from the devices capability. */
@@ -399,14 +485,24 @@ static void* CreateTxnRsrc(CIFXHANDLE hDevice, BOARD_INFORMATION* ptBoardInfo,
     ptTxnRsrc->bTxnMode       = bTxnMode;
     ptTxnRsrc->ulChannel      = ulChannel;
     ptTxnRsrc->hDevice        = hDevice;
-    ptTxnRsrc->ptConfPkt      = NULL;
+    ptTxnRsrc->fConfPending   = 0;
     ptTxnRsrc->tBoardInfo     = *ptBoardInfo;
 
     OS_STRNCPY(ptTxnRsrc->szFilename, pszFileName, sizeof(ptTxnRsrc->szFilename)/sizeof(ptTxnRsrc->szFilename[0]));
+
+    /* Open the file now, so an error is reported with the download confirmation */
+    if (CIFX_NO_ERROR != (ptTxnRsrc->lError = s_tFileStorage.pfnOpen(&ptTxnRsrc->tBoardInfo, pszFileName, ulFileLength,
+                                                                      ulChannel, ulDownloadMode, s_pvUser, &ptTxnRsrc->pvFile)))
+    {
+      ptTxnRsrc->pvFile  = NULL;
+      ptTxnRsrc->ulState = TXN_STATE_ERROR;
+    }
     
     /* Join the transaction resource list */
+    pthread_mutex_lock(&s_tTxnLock);
     ptTxnRsrc->pNext = s_ptTxnList;
     s_ptTxnList      = ptTxnRsrc;
+    pthread_mutex_unlock(&s_tTxnLock);
   }
   return (void*)ptTxnRsrc;
 }
@@ -418,7 +514,10 @@ static void* CreateTxnRsrc(CIFXHANDLE hDevice, BOARD_INFORMATION* ptBoardInfo,
 /*****************************************************************************/
 static void* GetTxnRsrc(CIFXHANDLE hDevice)
 {
-  PTXN_RSRC_T ptTxnRsrc = s_ptTxnList;
+  PTXN_RSRC_T ptTxnRsrc;
+
+  pthread_mutex_lock(&s_tTxnLock);
+  ptTxnRsrc = s_ptTxnList;
   
   /* Iterate the transaction resource list */
   while (ptTxnRsrc)
@@ -432,6 +531,7 @@ static void* GetTxnRsrc(CIFXHANDLE hDevice)
     
     ptTxnRsrc = ptTxnRsrc->pNext;
   }
+  pthread_mutex_unlock(&s_tTxnLock);
   
   return ptTxnRsrc;
 }
@@ -460,9 +560,9 @@ static int32_t xDownloadHook_GetMBXState(CIFXHANDLE hDevice, uint32_t* pulRecvPk
           the capture mode, there might be a confirmation packet. We add
           this packet to our receive packet counter. */
       if ( (ptTxnRsrc->bTxnMode == TXN_MODE_PACKET_CAPTURE) &&
-           (ptTxnRsrc->ptConfPkt)                             )
+           (ptTxnRsrc->fConfPending)                          )
       {
-        (void)*pulRecvPktCount++;
+        (*pulRecvPktCount)++;
       }
     }
   }  
@@ -498,9 +598,9 @@ static int32_t xDownloadHook_GetPacket(CIFXHANDLE hDevice, uint32_t ulRecvBuffer
        the capture mode, there might be a confirmation packet, which 
        has to be transmitted to the host */
     if ( (ptTxnRsrc->bTxnMode == TXN_MODE_PACKET_CAPTURE) &&
-         (ptTxnRsrc->ptConfPkt)                             )
+         (ptTxnRsrc->fConfPending)                          )
     {
-      uint32_t ulCopySize = ptTxnRsrc->ptConfPkt->tHeader.ulLen + RCX_PACKET_HEADER_SIZE;
+      uint32_t ulCopySize = ptTxnRsrc->tConfPkt.tHeader.ulLen + RCX_PACKET_HEADER_SIZE;
       if(ulCopySize > ulRecvBufferSize)
       {
         /* We have to free the mailbox, read as much as possible */
@@ -508,12 +608,10 @@ static int32_t xDownloadHook_GetPacket(CIFXHANDLE hDevice, uint32_t ulRecvBuffer
         lRet = CIFX_BUFFER_TOO_SHORT;
       }
       
-      OS_MEMCPY(ptRecvPkt, ptTxnRsrc->ptConfPkt, ulCopySize);
+      OS_MEMCPY(ptRecvPkt, &ptTxnRsrc->tConfPkt, ulCopySize);
       
-      /* The packet is copied to the receive buffer. So free the packet from
-         the transaction resource */
-      OS_Free(ptTxnRsrc->ptConfPkt);
-      ptTxnRsrc->ptConfPkt = NULL;
+      /* The packet is copied to the receive buffer, so the slot is free again */
+      ptTxnRsrc->fConfPending = 0;
     } else
     {
       /* We have a active download transaction, but no confirmation packet waiting.
@@ -524,7 +622,8 @@ static int32_t xDownloadHook_GetPacket(CIFXHANDLE hDevice, uint32_t ulRecvBuffer
     switch (ptTxnRsrc->ulState)
     {
       case TXN_STATE_DOWNLOAD_REQUEST:
-        if ( (RCX_FILE_DOWNLOAD_CNF == ptRecvPkt->tHeader.ulCmd) &&
+        if ( (CIFX_NO_ERROR         == lRet)                       &&
+             (RCX_FILE_DOWNLOAD_CNF == ptRecvPkt->tHeader.ulCmd) &&
              (CIFX_NO_ERROR         == ptRecvPkt->tHeader.ulState) )
         {
           RCX_FILE_DOWNLOAD_CNF_T* ptDownloadConf = (RCX_FILE_DOWNLOAD_CNF_T*)ptRecvPkt;
@@ -543,10 +642,25 @@ static int32_t xDownloadHook_GetPacket(CIFXHANDLE hDevice, uint32_t ulRecvBuffer
         break;
 
       case TXN_STATE_FINISHED:
-          /* We captured the whole file now. Execute callback to handle the file storage */
-          lRet = s_pfnFileStorageCbk(&ptTxnRsrc->tBoardInfo, ptTxnRsrc->szFilename, ptTxnRsrc->ulFilesize, 
-                                     ptTxnRsrc->pbFileBuf, ptTxnRsrc->ulChannel, ptTxnRsrc->ulDownloadMode, s_pvUser);
-          /* No break here. Download transaction ressource can be removed now */
+        if (TXN_IS_CAPTURED(ptTxnRsrc))
+        {
+          /* The file was kept with the last data block. The transaction resource
+             can be removed, as soon as the confirmation was passed to the host. */
+          if (!ptTxnRsrc->fConfPending)
+            RemoveTxnRsrc(hDevice);
+
+        } else if ( (CIFX_NO_ERROR              == lRet) &&
+                    (RCX_FILE_DOWNLOAD_DATA_CNF == ptRecvPkt->tHeader.ulCmd) )
+        {
+          /* This is the confirmation of the last data block. Keep the file,
+             if the device accepted the download. */
+          if (CIFX_NO_ERROR == ptRecvPkt->tHeader.ulState)
+            (void)CloseTxnFile(ptTxnRsrc, 1);
+
+          RemoveTxnRsrc(hDevice);
+        }
+        /* Otherwise the final confirmation is still outstanding */
+        break;
 
       case TXN_STATE_ERROR:
         /* Remove the transaction resource if the download has finished or failed */
@@ -597,6 +711,7 @@ static int32_t xDownloadHook_PutPacket(CIFXHANDLE hDevice, CIFX_PACKET* ptSendPk
          We are now removing old transaction ressource as we
          dont need it anymore */
       RemoveTxnRsrc(hDevice);
+      ptTxnRsrc = NULL;
       /* No break here as we are now handle the new download request */
 
     case TXN_STATE_DOWNLOAD_REQUEST:
@@ -618,6 +733,13 @@ static int32_t xDownloadHook_PutPacket(CIFXHANDLE hDevice, CIFX_PACKET* ptSendPk
           uint8_t  bTxnMode            = TXN_MODE_PACKET_CAPTURE;
           BOARD_INFORMATION tBoardInfo = {0};
 
+          /* A previous download request, which was rejected by the device */
+          if (NULL != ptTxnRsrc)
+          {
+            RemoveTxnRsrc(hDevice);
+            ptTxnRsrc = NULL;
+          }
+
           /* Set mode on the basis of device type:
              ram based device   = capture mode 
              flash based device = monitore mode */
@@ -649,26 +771,54 @@ static int32_t xDownloadHook_PutPacket(CIFXHANDLE hDevice, CIFX_PACKET* ptSendPk
       if (RCX_FILE_DOWNLOAD_DATA_REQ == ptSendPkt->tHeader.ulCmd)
       {
         RCX_FILE_DOWNLOAD_DATA_REQ_T* ptDownloadDataReq = (RCX_FILE_DOWNLOAD_DATA_REQ_T*)ptSendPkt;
+        uint8_t*                      pbBlock           = (uint8_t*)(&ptDownloadDataReq->tData + 1);
+        uint32_t                      ulBlockSize       = 0;
+
+        /* The data block size is calculated from the packet length, as the
+           last block might be smaller than the maximum block size */
+        if (ptDownloadDataReq->tHead.ulLen >= sizeof(RCX_FILE_DOWNLOAD_DATA_REQ_DATA_T))
+          ulBlockSize = ptDownloadDataReq->tHead.ulLen - sizeof(RCX_FILE_DOWNLOAD_DATA_REQ_DATA_T);
 
-        if( (RCX_PACKET_SEQ_FIRST  == ptDownloadDataReq->tHead.ulExt) ||
-            (RCX_PACKET_SEQ_MIDDLE == ptDownloadDataReq->tHead.ulExt)   )
+        if (ulBlockSize > ptTxnRsrc->ulFilesize - ptTxnRsrc->ulReceived)
         {
-          /* This is a first or middle data packet of a transaction sequence. 
-            So the maximum block size will be copied to the file buffer */
-          OS_MEMCPY( ptTxnRsrc->pabActData, &ptDownloadDataReq->tData + 1, ptTxnRsrc->ulMaxBlockSize);
-          ptTxnRsrc->pabActData += ptTxnRsrc->ulMaxBlockSize;
+          /* More data than announced by the download request */
+          ptTxnRsrc->lError   = RCX_E_INVALID_FILE_LENGTH;
+          ptTxnRsrc->ulState  = TXN_STATE_ERROR;
 
-        } else if( (RCX_PACKET_SEQ_LAST == ptDownloadDataReq->tHead.ulExt) ||
-                   (RCX_PACKET_SEQ_NONE == ptDownloadDataReq->tHead.ulExt) )
+        } else if (ptDownloadDataReq->tData.ulChksum != 
+                   (ptTxnRsrc->ulCrc32 = CreateCRC32(ptTxnRsrc->ulCrc32, pbBlock, ulBlockSize)))
         {
-          /* This is the last data packet of a transaction sequence or a 
-             non sequenced packet. We have to calculate the data block size
-             as it might be smaller than the maximum block size */
-          uint32_t ulBlockSize = ptDownloadDataReq->tHead.ulLen - sizeof(RCX_FILE_DOWNLOAD_DATA_REQ_DATA_T);
-          OS_MEMCPY( ptTxnRsrc->pabActData, &ptDownloadDataReq->tData + 1, ulBlockSize);
-
-          /* Download finished, so set state respectively */
-          ptTxnRsrc->ulState  = TXN_STATE_FINISHED;
+          /* The checksum is cumulative, so the file is corrupted from this block on */
+          ptTxnRsrc->lError   = CIFX_FILE_CHECKSUM_ERROR;
+          ptTxnRsrc->ulState  = TXN_STATE_ERROR;
+
+        } else if (CIFX_NO_ERROR != (ptTxnRsrc->lError = StoreTxnData(ptTxnRsrc, pbBlock, ulBlockSize)))
+        {
+          ptTxnRsrc->ulState  = TXN_STATE_ERROR;
+
+        } else 
+        {
+          ptTxnRsrc->ulReceived += ulBlockSize;
+
+          if( (RCX_PACKET_SEQ_LAST == ptDownloadDataReq->tHead.ulExt) ||
+              (RCX_PACKET_SEQ_NONE == ptDownloadDataReq->tHead.ulExt) )
+          {
+            /* This is the last data packet of a transaction sequence or a 
+               non sequenced packet. Pass the rest of the file to the file storage. */
+            if (ptTxnRsrc->ulReceived != ptTxnRsrc->ulFilesize)
+              ptTxnRsrc->lError = RCX_E_INVALID_FILE_LENGTH;
+            else
+              ptTxnRsrc->lError = FlushTxnData(ptTxnRsrc);
+
+            /* A captured download is complete now, so keep the file. Otherwise the
+               file is kept when the device confirms the last data block. */
+            if ( (CIFX_NO_ERROR == ptTxnRsrc->lError) &&
+                 (TXN_IS_CAPTURED(ptTxnRsrc))            )
+              ptTxnRsrc->lError = CloseTxnFile(ptTxnRsrc, 1);
+
+            /* Download finished, so set state respectively */
+            ptTxnRsrc->ulState  = (CIFX_NO_ERROR == ptTxnRsrc->lError) ? TXN_STATE_FINISHED : TXN_STATE_ERROR;
+          }
         }
 
       } else if (RCX_FILE_DOWNLOAD_ABORT_REQ == ptSendPkt->tHeader.ulCmd)
@@ -682,9 +832,8 @@ static int32_t xDownloadHook_PutPacket(CIFXHANDLE hDevice, CIFX_PACKET* ptSendPk
       break;
   }
   
-  if ( (NULL                    != ptTxnRsrc)                  &&
-       (TXN_MODE_PACKET_CAPTURE == ptTxnRsrc->bTxnMode )       &&
-       (DOWNLOAD_MODE_FIRMWARE  == ptTxnRsrc->ulDownloadMode )    )
+  if ( (NULL != ptTxnRsrc)         &&
+       (TXN_IS_CAPTURED(ptTxnRsrc))   )
   {
     /* On ram based devices (packet capture mode) firmware downloads
        are not possible. Hence we need to capture the download request
@@ -780,14 +929,17 @@ static int32_t APIENTRY xChannelGetPacketWrapper( CIFXHANDLE  hChannel, uint32_t
 /*****************************************************************************/
 /*! Initialize download hook
 *   \param ptDRVFunctions    Driver function table
-*   \param pfnFileStorageCbk File storage callback
-*   \param pvUser            User pointer for callback function
+*   \param ptFileStorage     File storage callbacks
+*   \param pvUser            User pointer for callback functions
 *   \return CIFX_NO_ERROR on success                                         */
 /*****************************************************************************/
-int32_t xDownloadHook_Install( PDRIVER_FUNCTIONS ptDRVFunctions, PFN_FILESTORAGE_CBK pfnFileStorageCbk, void* pvUser) 
+int32_t xDownloadHook_Install( PDRIVER_FUNCTIONS ptDRVFunctions, const FILESTORAGE_FUNCTIONS_T* ptFileStorage, void* pvUser) 
 {
-  /* There must be an file storage callback */
-  if (NULL == pfnFileStorageCbk)
+  /* There must be file storage callbacks */
+  if ( (NULL == ptFileStorage)           ||
+       (NULL == ptFileStorage->pfnOpen)  ||
+       (NULL == ptFileStorage->pfnWrite) ||
+       (NULL == ptFileStorage->pfnClose)   )
     return CIFX_INVALID_POINTER;
 
   /* To hook the file download we need at least the following driver functions */
@@ -821,9 +973,9 @@ int32_t xDownloadHook_Install( PDRIVER_FUNCTIONS ptDRVFunctions, PFN_FILESTORAGE
   ptDRVFunctions->pfnxChannelGetPacket   = xChannelGetPacketWrapper;
   ptDRVFunctions->pfnxChannelGetMBXState = xChannelGetMBXStateWrapper;
 
-  /* Set file storage callback */
-  s_pfnFileStorageCbk = pfnFileStorageCbk;
-  s_pvUser            = pvUser;
+  /* Set file storage callbacks */
+  s_tFileStorage = *ptFileStorage;
+  s_pvUser       = pvUser;
 
   return CIFX_NO_ERROR;
 }
@@ -20,26 +20,64 @@
 #include "cifXAPI_Wrapper.h"
 
 /*****************************************************************************/
-/*! Definition of the file storage callback
+/*! Definition of the file storage open callback. Called once per download,
+*   before the first data block is passed to the write callback.
 *   \param ptBoardInfo       Board information
 *   \param pszFileName       Name of file to download
-*   \param ulFileSize        Size of file buffer (pabFileData)
-*   \param pabFileData       File buffer
+*   \param ulFileSize        Size of the complete file
 *   \param ulChannel         Destination channel
 *   \param ulDownloadMode    Download mode (DOWNLOAD_MODE_FIRMWARE, 
                              DOWNLOAD_MODE_MODULE, DOWNLOAD_MODE_CONFIG)
 *   \param pvUser            User pointer
+*   \param ppvFile           Returned file handle, passed to write and close
 *   \return CIFX_NO_ERROR on success                                         */
 /*****************************************************************************/
-typedef int32_t(*PFN_FILESTORAGE_CBK) ( BOARD_INFORMATION* ptBoardInfo, 
-                                        char* pszFileName, uint32_t ulFileSize, uint8_t* pabFileData, 
-                                        uint32_t ulChannel, uint32_t ulDownloadMode, void* pvUser);
+typedef int32_t(*PFN_FILESTORAGE_OPEN)  ( BOARD_INFORMATION* ptBoardInfo, 
+                                          char* pszFileName, uint32_t ulFileSize,
+                                          uint32_t ulChannel, uint32_t ulDownloadMode,
+                                          void* pvUser, void** ppvFile);
+
+/*****************************************************************************/
+/*! Definition of the file storage write callback. Called with the file data
+*   in order, each call appends to the file.
+*   \param pvFile            File handle (see PFN_FILESTORAGE_OPEN)
+*   \param pabData           File data
+*   \param ulDataLen         Length of file data
+*   \param pvUser            User pointer
+*   \return CIFX_NO_ERROR on success                                         */
+/*****************************************************************************/
+typedef int32_t(*PFN_FILESTORAGE_WRITE) ( void* pvFile, uint8_t* pabData, uint32_t ulDataLen, 
+                                          void* pvUser);
+
+/*****************************************************************************/
+/*! Definition of the file storage close callback. Called once for every
+*   opened file.
+*   \param pvFile            File handle (see PFN_FILESTORAGE_OPEN)
+*   \param fCommit           !=0 if the file was received completely and the
+*                            checksum matched, 0 if the download failed or was
+*                            aborted and the file has to be discarded
+*   \param pvUser            User pointer
+*   \return CIFX_NO_ERROR on success                                         */
+/*****************************************************************************/
+typedef int32_t(*PFN_FILESTORAGE_CLOSE) ( void* pvFile, int fCommit, void* pvUser);
+
+/*****************************************************************************/
+/*! File storage callbacks. The download hook streams the captured file
+*   through them instead of buffering the complete file.                     */
+/*****************************************************************************/
+typedef struct FILESTORAGE_FUNCTIONS_Ttag
+{
+  PFN_FILESTORAGE_OPEN  pfnOpen;
+  PFN_FILESTORAGE_WRITE pfnWrite;
+  PFN_FILESTORAGE_CLOSE pfnClose;
+
+} FILESTORAGE_FUNCTIONS_T;
 
 /***************************************************************************
 * Functions to install and remove download hook
 ***************************************************************************/
 int32_t xDownloadHook_Install ( PDRIVER_FUNCTIONS ptDRVFunctions, 
-                                PFN_FILESTORAGE_CBK pfnFileStorageCbk, void* pvUser);
+                                const FILESTORAGE_FUNCTIONS_T* ptFileStorage, void* pvUser);
 
 int32_t xDownloadHook_Remove  ( void);
 
@@ -0,0 +1,143 @@
+// SPDX-License-Identifier: MIT
+/**************************************************************************************
+ *
+ * Copyright (c) 2025, Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserved.
+ *
+ * Description: Worker threads handling marshaller requests in parallel. Every
+ *              pfnRequest callback of the marshaller wakes up one worker, which calls
+ *              HilMarshallerMain(). The marshaller itself keeps requests to the same
+ *              channel/sysdevice in order.
+ *
+ **************************************************************************************/
+
+#include <stdio.h>
+#include <pthread.h>
+#include <signal.h>
+
+#include "marshaller_worker.h"
+#include "MarshallerConfig.h"
+
+typedef struct MARSHALLER_WORKER_POOL_Ttag
+{
+  pthread_mutex_t tLock;
+  pthread_cond_t  tSignal;
+  int             fRunning;
+  uint32_t        ulRequests;     /*!< Number of pfnRequest calls not yet served */
+  void*           pvMarshaller;
+  uint32_t        ulThreadCnt;
+  pthread_t       ahThread[MARSHALLER_WORKER_MAX_CNT];
+
+} MARSHALLER_WORKER_POOL_T;
+
+static MARSHALLER_WORKER_POOL_T s_tPool = { .tLock   = PTHREAD_MUTEX_INITIALIZER,
+                                            .tSignal = PTHREAD_COND_INITIALIZER };
+
+/*****************************************************************************/
+/*! Worker thread
+*   \param pvParam  unused
+*   \return Always NULL                                                      */
+/*****************************************************************************/
+static void* MarshallerWorkerThread(void* pvParam)
+{
+  (void)pvParam;
+
+  pthread_mutex_lock(&s_tPool.tLock);
+
+  while(1)
+  {
+    void* pvMarshaller;
+
+    while(s_tPool.fRunning && (0 == s_tPool.ulRequests))
+      pthread_cond_wait(&s_tPool.tSignal, &s_tPool.tLock);
+
+    if(!s_tPool.fRunning)
+      break;
+
+    --s_tPool.ulRequests;
+    pvMarshaller = s_tPool.pvMarshaller;
+
+    pthread_mutex_unlock(&s_tPool.tLock);
+
+    HilMarshallerMain(pvMarshaller);
+
+    pthread_mutex_lock(&s_tPool.tLock);
+  }
+
+  pthread_mutex_unlock(&s_tPool.tLock);
+
+  return NULL;
+}
+
+/*****************************************************************************/
+/*! Starts the worker threads
+*   \param ulWorkerCnt  Number of workers (1..MARSHALLER_WORKER_MAX_CNT)
+*   \return 0 on success                                                     */
+/*****************************************************************************/
+int MarshallerWorkerStart(uint32_t ulWorkerCnt)
+{
+  sigset_t tBlock;
+  sigset_t tOld;
+  int      iRet = 0;
+
+  if( (0 == ulWorkerCnt) || (ulWorkerCnt > MARSHALLER_WORKER_MAX_CNT) )
+    return -1;
+
+  s_tPool.fRunning    = 1;
+  s_tPool.ulRequests  = 0;
+  s_tPool.ulThreadCnt = 0;
+
+  /* Workers must not handle the timer / termination signals, as these may
+     interrupt a worker while it holds the pool lock */
+  sigfillset(&tBlock);
+  pthread_sigmask(SIG_BLOCK, &tBlock, &tOld);
+
+  while(s_tPool.ulThreadCnt < ulWorkerCnt)
+  {
+    if(0 != pthread_create(&s_tPool.ahThread[s_tPool.ulThreadCnt], NULL, MarshallerWorkerThread, NULL))
+    {
+      printf("Failed to create marshaller worker thread!\n");
+      iRet = -1;
+      break;
+    }
+    ++s_tPool.ulThreadCnt;
+  }
+
+  pthread_sigmask(SIG_SETMASK, &tOld, NULL);
+
+  if(0 != iRet)
+    MarshallerWorkerStop();
+
+  return iRet;
+}
+
+/*****************************************************************************/
+/*! Stops all worker threads. Requests currently handled are finished,
+*   requests not yet started are not handled anymore.                        */
+/*****************************************************************************/
+void MarshallerWorkerStop(void)
+{
+  uint32_t ulIdx;
+
+  pthread_mutex_lock(&s_tPool.tLock);
+  s_tPool.fRunning = 0;
+  pthread_cond_broadcast(&s_tPool.tSignal);
+  pthread_mutex_unlock(&s_tPool.tLock);
+
+  for(ulIdx = 0; ulIdx < s_tPool.ulThreadCnt; ++ulIdx)
+    pthread_join(s_tPool.ahThread[ulIdx], NULL);
+
+  s_tPool.ulThreadCnt = 0;
+}
+
+/*****************************************************************************/
+/*! Wakes up a worker to call HilMarshallerMain() (pfnRequest callback)
+*   \param pvMarshaller  Marshaller handle                                   */
+/*****************************************************************************/
+void MarshallerWorkerRequest(void* pvMarshaller)
+{
+  pthread_mutex_lock(&s_tPool.tLock);
+  s_tPool.pvMarshaller = pvMarshaller;
+  ++s_tPool.ulRequests;
+  pthread_cond_signal(&s_tPool.tSignal);
+  pthread_mutex_unlock(&s_tPool.tLock);
+}
@@ -0,0 +1,31 @@
+/* SPDX-License-Identifier: MIT */
+/**************************************************************************************
+ *
+ * Copyright (c) 2025, Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserved.
+ *
+ * Description: Worker threads handling marshaller requests in parallel
+ *
+ **************************************************************************************/
+
+#ifndef __MARSHALLER_WORKER__H
+#define __MARSHALLER_WORKER__H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+  extern "C" {
+#endif
+
+#define MARSHALLER_WORKER_DEFAULT_CNT   4   /*!< Default number of worker threads            */
+#define MARSHALLER_WORKER_MAX_CNT       32  /*!< Maximum number of worker threads            */
+#define MARSHALLER_QUEUE_DEFAULT_DEPTH  8   /*!< Default number of pending requests per connector */
+
+int  MarshallerWorkerStart  (uint32_t ulWorkerCnt);
+void MarshallerWorkerStop   (void);
+void MarshallerWorkerRequest(void* pvMarshaller);
+
+#ifdef __cplusplus
+  }
+#endif
+
+#endif /* __MARSHALLER_WORKER__H */
@@ -0,0 +1,518 @@
+// SPDX-License-Identifier: MIT
+/**************************************************************************************
+ *
+ * Copyright (c) 2025, Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserved.
+ *
+ * Description: Shared memory connector for Hilscher marshaller. Frames are exchanged
+ *              via two lock-free byte rings in a memfd, which is passed to the client
+ *              over a unix domain socket together with two eventfds for wake up.
+ *
+ **************************************************************************************/
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+
+#include "shm_connector.h"
+#include "MarshallerErrors.h"
+
+/* path of the listening socket */
+extern char* g_szShmSocketPath;
+
+/*****************************************************************************/
+/*! Copies data into a ring (handles wrap around)
+*   \param ptRing   Ring
+*   \param ulPos    Free running write position
+*   \param pvData   Data to copy
+*   \param ulLen    Length of data                                           */
+/*****************************************************************************/
+static void ShmRingCopyIn(SHM_CONN_RING_T* ptRing, uint32_t ulPos, const void* pvData, uint32_t ulLen)
+{
+  uint32_t ulOffset = ulPos & (SHM_CONNECTOR_RING_SIZE - 1);
+  uint32_t ulFirst  = SHM_CONNECTOR_RING_SIZE - ulOffset;
+
+  if(ulFirst > ulLen)
+    ulFirst = ulLen;
+
+  memcpy(&ptRing->abData[ulOffset], pvData, ulFirst);
+  memcpy(ptRing->abData, (const uint8_t*)pvData + ulFirst, ulLen - ulFirst);
+}
+
+/*****************************************************************************/
+/*! Copies data out of a ring (handles wrap around)
+*   \param ptRing   Ring
+*   \param ulPos    Free running read position
+*   \param pvData   Destination buffer
+*   \param ulLen    Length of data                                           */
+/*****************************************************************************/
+static void ShmRingCopyOut(SHM_CONN_RING_T* ptRing, uint32_t ulPos, void* pvData, uint32_t ulLen)
+{
+  uint32_t ulOffset = ulPos & (SHM_CONNECTOR_RING_SIZE - 1);
+  uint32_t ulFirst  = SHM_CONNECTOR_RING_SIZE - ulOffset;
+
+  if(ulFirst > ulLen)
+    ulFirst = ulLen;
+
+  memcpy(pvData, &ptRing->abData[ulOffset], ulFirst);
+  memcpy((uint8_t*)pvData + ulFirst, ptRing->abData, ulLen - ulFirst);
+}
+
+/*****************************************************************************/
+/*! Appends a frame to a ring
+*   \param ptRing   Ring
+*   \param pvData   Frame
+*   \param ulLen    Length of frame
+*   \return 0 if the ring has not enough free space                          */
+/*****************************************************************************/
+static int ShmRingWrite(SHM_CONN_RING_T* ptRing, const void* pvData, uint32_t ulLen)
+{
+  uint32_t ulHead = __atomic_load_n(&ptRing->ulHead, __ATOMIC_RELAXED);
+  uint32_t ulTail = __atomic_load_n(&ptRing->ulTail, __ATOMIC_ACQUIRE);
+
+  if((SHM_CONNECTOR_RING_SIZE - (ulHead - ulTail)) < (sizeof(ulLen) + ulLen))
+    return 0;
+
+  ShmRingCopyIn(ptRing, ulHead, &ulLen, sizeof(ulLen));
+  ShmRingCopyIn(ptRing, ulHead + sizeof(ulLen), pvData, ulLen);
+
+  __atomic_store_n(&ptRing->ulHead, ulHead + (uint32_t)sizeof(ulLen) + ulLen, __ATOMIC_RELEASE);
+
+  return 1;
+}
+
+/*****************************************************************************/
+/*! Removes the oldest frame from a ring
+*   \param ptRing     Ring
+*   \param pvBuffer   Buffer for the frame
+*   \param ulBufSize  Size of the buffer
+*   \param pulLen     Returned length of the frame (frame is discarded if
+*                     it exceeds ulBufSize)
+*   \return 0 if the ring is empty                                           */
+/*****************************************************************************/
+static int ShmRingRead(SHM_CONN_RING_T* ptRing, void* pvBuffer, uint32_t ulBufSize, uint32_t* pulLen)
+{
+  uint32_t ulTail = __atomic_load_n(&ptRing->ulTail, __ATOMIC_RELAXED);
+  uint32_t ulHead = __atomic_load_n(&ptRing->ulHead, __ATOMIC_ACQUIRE);
+  uint32_t ulLen  = 0;
+
+  if((ulHead - ulTail) < sizeof(ulLen))
+    return 0;
+
+  ShmRingCopyOut(ptRing, ulTail, &ulLen, sizeof(ulLen));
+
+  if(ulLen > (ulHead - ulTail - sizeof(ulLen)))
+  {
+    /* inconsistent length, skip everything */
+    __atomic_store_n(&ptRing->ulTail, ulHead, __ATOMIC_RELEASE);
+    return 0;
+  }
+
+  if(ulLen <= ulBufSize)
+    ShmRingCopyOut(ptRing, ulTail + sizeof(ulLen), pvBuffer, ulLen);
+
+  __atomic_store_n(&ptRing->ulTail, ulTail + (uint32_t)sizeof(ulLen) + ulLen, __ATOMIC_RELEASE);
+
+  *pulLen = ulLen;
+
+  return 1;
+}
+
+/*****************************************************************************/
+/*! Function called from marshaller when data is to be sent to interface
+*   \param ptBuffer   Buffer to send
+*   \param pvUser     Shared memory connector internal data                  */
+/*****************************************************************************/
+static uint32_t ShmConnectorSend(HIL_MARSHALLER_BUFFER_T* ptBuffer, void* pvUser)
+{
+  SHM_CONN_INTERNAL_T* ptShmData = (SHM_CONN_INTERNAL_T*)pvUser;
+  uint32_t             ulDataLen = sizeof(ptBuffer->tTransport) +
+                                   ptBuffer->tMgmt.ulUsedDataBufferLen;
+
+  pthread_mutex_lock(&ptShmData->tLock);
+
+  if(NULL != ptShmData->ptLayout)
+  {
+    uint32_t ulStart = OS_GetTickCount();
+    int      fSent;
+
+    /* wait for the client to free enough space */
+    while( !(fSent = ShmRingWrite(&ptShmData->ptLayout->tToClient, &ptBuffer->tTransport, ulDataLen)) &&
+           ((OS_GetTickCount() - ulStart) < ptShmData->ulTimeout) )
+      usleep(100);
+
+    if(fSent)
+    {
+      uint64_t ullEvent = 1;
+
+      ptShmData->ulTxCount += ulDataLen;
+      if(sizeof(ullEvent) != write(ptShmData->iEvtToClient, &ullEvent, sizeof(ullEvent)))
+        printf("Shared memory connector: failed to signal client!\n");
+    } else
+    {
+      printf("Shared memory connector: client does not read, frame discarded!\n");
+    }
+  }
+
+  pthread_mutex_unlock(&ptShmData->tLock);
+
+  HilMarshallerConnTxComplete(ptBuffer->tMgmt.pvMarshaller,
+                              ptShmData->ulConnectorIdx,
+                              ptBuffer);
+
+  return MARSHALLER_NO_ERROR;
+}
+
+/*****************************************************************************/
+/*! Closes the client connection and releases the shared memory
+*   \param ptShmData Shared memory connector internal data                   */
+/*****************************************************************************/
+static void ShmConnectorCloseClient(SHM_CONN_INTERNAL_T* ptShmData)
+{
+  pthread_mutex_lock(&ptShmData->tLock);
+
+  if(NULL != ptShmData->ptLayout)
+  {
+    munmap(ptShmData->ptLayout, sizeof(*ptShmData->ptLayout));
+    ptShmData->ptLayout = NULL;
+  }
+  if(-1 != ptShmData->iEvtToServer)
+  {
+    close(ptShmData->iEvtToServer);
+    ptShmData->iEvtToServer = -1;
+  }
+  if(-1 != ptShmData->iEvtToClient)
+  {
+    close(ptShmData->iEvtToClient);
+    ptShmData->iEvtToClient = -1;
+  }
+  if(INVALID_SOCKET != ptShmData->hClient)
+  {
+    close(ptShmData->hClient);
+    ptShmData->hClient = INVALID_SOCKET;
+    printf("Shared memory connection closed!\n");
+  }
+
+  pthread_mutex_unlock(&ptShmData->tLock);
+}
+
+/*****************************************************************************/
+/*! Sets up the shared memory for a new client and passes the memfd and
+*   eventfds to it
+*   \param ptShmData Shared memory connector internal data
+*   \param hClient   Accepted control connection
+*   \return 0 on success                                                     */
+/*****************************************************************************/
+static int ShmConnectorOpenClient(SHM_CONN_INTERNAL_T* ptShmData, SOCKET hClient)
+{
+  SHM_CONN_LAYOUT_T* ptLayout  = MAP_FAILED;
+  int                iMemFd    = -1;
+  int                iRet      = -1;
+  uint32_t           ulSize    = sizeof(*ptLayout);
+  union
+  {
+    char           abBuf[CMSG_SPACE(3 * sizeof(int))];
+    struct cmsghdr tAlign;
+  } uCtrl;
+
+  pthread_mutex_lock(&ptShmData->tLock);
+
+  ptShmData->iEvtToServer = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  ptShmData->iEvtToClient = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+  if( (-1 == ptShmData->iEvtToServer) || (-1 == ptShmData->iEvtToClient) )
+  {
+    printf("Shared memory connector: eventfd failed (%d)!\n", errno);
+
+  } else if(-1 == (iMemFd = memfd_create("cifx_marshaller", MFD_CLOEXEC)))
+  {
+    printf("Shared memory connector: memfd_create failed (%d)!\n", errno);
+
+  } else if(0 != ftruncate(iMemFd, ulSize))
+  {
+    printf("Shared memory connector: ftruncate failed (%d)!\n", errno);
+
+  } else if(MAP_FAILED == (ptLayout = mmap(NULL, ulSize, PROT_READ | PROT_WRITE, MAP_SHARED, iMemFd, 0)))
+  {
+    printf("Shared memory connector: mmap failed (%d)!\n", errno);
+
+  } else
+  {
+    struct iovec    tIov = {&ulSize, sizeof(ulSize)};
+    struct msghdr   tMsg = {0};
+    struct cmsghdr* ptCmsg;
+    int             aiFds[3];
+
+    ptLayout->ulMagic    = SHM_CONNECTOR_MAGIC;
+    ptLayout->ulRingSize = SHM_CONNECTOR_RING_SIZE;
+
+    aiFds[0] = iMemFd;
+    aiFds[1] = ptShmData->iEvtToServer;
+    aiFds[2] = ptShmData->iEvtToClient;
+
+    memset(&uCtrl, 0, sizeof(uCtrl));
+    tMsg.msg_iov        = &tIov;
+    tMsg.msg_iovlen     = 1;
+    tMsg.msg_control    = uCtrl.abBuf;
+    tMsg.msg_controllen = sizeof(uCtrl.abBuf);
+
+    ptCmsg             = CMSG_FIRSTHDR(&tMsg);
+    ptCmsg->cmsg_level = SOL_SOCKET;
+    ptCmsg->cmsg_type  = SCM_RIGHTS;
+    ptCmsg->cmsg_len   = CMSG_LEN(sizeof(aiFds));
+    memcpy(CMSG_DATA(ptCmsg), aiFds, sizeof(aiFds));
+
+    if(0 > sendmsg(hClient, &tMsg, MSG_NOSIGNAL))
+    {
+      printf("Shared memory connector: passing shared memory failed (%d)!\n", errno);
+    } else
+    {
+      ptShmData->ptLayout = ptLayout;
+      ptShmData->hClient  = hClient;
+      ptLayout            = MAP_FAILED;
+      iRet                = 0;
+    }
+  }
+
+  /* client holds its own reference to the memfd */
+  if(-1 != iMemFd)
+    close(iMemFd);
+
+  if(MAP_FAILED != ptLayout)
+    munmap(ptLayout, ulSize);
+
+  pthread_mutex_unlock(&ptShmData->tLock);
+
+  if(0 != iRet)
+  {
+    close(hClient);
+    ShmConnectorCloseClient(ptShmData);
+  }
+
+  return iRet;
+}
+
+/*****************************************************************************/
+/*! Passes all frames written by the client to the marshaller
+*   \param ptShmData Shared memory connector internal data                   */
+/*****************************************************************************/
+static void ShmConnectorReceive(SHM_CONN_INTERNAL_T* ptShmData)
+{
+  uint64_t ullEvent;
+  uint32_t ulLen;
+
+  /* reset eventfd before draining the ring, so no wake up is lost */
+  if(sizeof(ullEvent) != read(ptShmData->iEvtToServer, &ullEvent, sizeof(ullEvent)))
+  {
+    /* spurious wake up */
+  }
+
+  while(ShmRingRead(&ptShmData->ptLayout->tToServer, ptShmData->pbRxBuffer, ptShmData->ulRxBufferSize, &ulLen))
+  {
+    if(ulLen > ptShmData->ulRxBufferSize)
+    {
+      printf("Shared memory connector: frame exceeds buffer size, discarded!\n");
+      continue;
+    }
+
+    ptShmData->ulRxCount += ulLen;
+
+    HilMarshallerConnRxData(ptShmData->pvMarshaller,
+                            ptShmData->ulConnectorIdx,
+                            ptShmData->pbRxBuffer,
+                            ulLen);
+  }
+}
+
+/*****************************************************************************/
+/*! Shared memory connector uninitialization
+*   \param pvUser Pointer to internal connector data                         */
+/*****************************************************************************/
+static void ShmConnectorDeinit(void* pvUser)
+{
+  SHM_CONN_INTERNAL_T* ptShmData = (SHM_CONN_INTERNAL_T*)pvUser;
+
+  /* Check if data is valid */
+  if(NULL != ptShmData)
+  {
+    ptShmData->fRunning = 0;
+
+    if(0 != ptShmData->hThread)
+      pthread_join(ptShmData->hThread, NULL);
+
+    ShmConnectorCloseClient(ptShmData);
+
+    if(INVALID_SOCKET != ptShmData->hListen)
+    {
+      close(ptShmData->hListen);
+      unlink(ptShmData->szPath);
+    }
+
+    /* Unregister from Marshaller */
+    if(ptShmData->ulConnectorIdx != (uint32_t)~0)
+    {
+      HilMarshallerUnregisterConnector(ptShmData->pvMarshaller, ptShmData->ulConnectorIdx);
+    }
+
+    pthread_mutex_destroy(&ptShmData->tLock);
+    free(ptShmData->pbRxBuffer);
+    free(ptShmData);
+  }
+}
+
+/*****************************************************************************/
+/*! Thread serving the listening socket and the client connection
+*   \param pvParam Pointer reference to shared memory connector structure
+*   \return        Always 0                                                  */
+/*****************************************************************************/
+static void* ShmConnectorThread(void* pvParam)
+{
+  SHM_CONN_INTERNAL_T* ptShmData = (SHM_CONN_INTERNAL_T*)pvParam;
+
+  while(ptShmData->fRunning)
+  {
+    struct pollfd atPoll[3] = {{0}};
+    nfds_t        tCnt      = 1;
+
+    atPoll[0].fd     = ptShmData->hListen;
+    atPoll[0].events = POLLIN;
+
+    if(INVALID_SOCKET != ptShmData->hClient)
+    {
+      atPoll[1].fd     = ptShmData->hClient;
+      atPoll[1].events = POLLIN;
+      atPoll[2].fd     = ptShmData->iEvtToServer;
+      atPoll[2].events = POLLIN;
+      tCnt             = 3;
+    }
+
+    if(0 >= poll(atPoll, tCnt, 1000))
+      continue;
+
+    if(atPoll[0].revents & POLLIN)
+    {
+      SOCKET hClient = accept4(ptShmData->hListen, NULL, NULL, SOCK_CLOEXEC);
+
+      if(INVALID_SOCKET == hClient)
+      {
+        /* nothing to do */
+      } else if(INVALID_SOCKET != ptShmData->hClient)
+      {
+        /* We already have a client, so reject this one */
+        close(hClient);
+      } else
+      {
+        ptShmData->ulRxCount = 0;
+        ptShmData->ulTxCount = 0;
+        if(0 == ShmConnectorOpenClient(ptShmData, hClient))
+          printf("Connected with shared memory client (%s)\n", ptShmData->szPath);
+      }
+    }
+
+    if(tCnt > 1)
+    {
+      if(atPoll[2].revents & POLLIN)
+        ShmConnectorReceive(ptShmData);
+
+      if(atPoll[1].revents & (POLLIN | POLLHUP | POLLERR))
+      {
+        /* control connection carries no data, any event means closed */
+        ShmConnectorCloseClient(ptShmData);
+      }
+    }
+  }
+
+  return 0;
+}
+
+/*****************************************************************************/
+/*! Shared memory connector initialization
+*   \param ptParams     Marshaller specific parameters (e.g. timeout)
+*   \param pvMarshaller Handle to the marshaller, this connector should be added
+*   \return MARSHALLER_NO_ERROR on success                                   */
+/*****************************************************************************/
+uint32_t ShmConnectorInit(const HIL_MARSHALLER_CONNECTOR_PARAMS_T* ptParams, void* pvMarshaller)
+{
+  HIL_MARSHALLER_CONNECTOR_T tMarshConn;
+  SHM_CONN_INTERNAL_T*       ptShmData = NULL;
+  uint32_t                   eRet;
+
+  if(NULL == (ptShmData = (SHM_CONN_INTERNAL_T*)malloc(sizeof(*ptShmData))))
+  {
+    eRet = HIL_MARSHALLER_E_OUTOFMEMORY;
+  } else
+  {
+    struct sockaddr_un tSockAddr = {0};
+    const char*        szPath    = (NULL != g_szShmSocketPath) ? g_szShmSocketPath : SHM_CONNECTOR_DEFAULT_PATH;
+
+    memset(&tMarshConn, 0, sizeof(tMarshConn));
+    memset(ptShmData, 0, sizeof(*ptShmData));
+
+    ptShmData->ulConnectorIdx = (uint32_t)~0;
+    ptShmData->pvMarshaller   = pvMarshaller;
+    ptShmData->ulTimeout      = ptParams->ulTimeout;
+    ptShmData->hListen        = INVALID_SOCKET;
+    ptShmData->hClient        = INVALID_SOCKET;
+    ptShmData->iEvtToServer   = -1;
+    ptShmData->iEvtToClient   = -1;
+    ptShmData->fRunning       = 1;
+    ptShmData->ulRxBufferSize = sizeof(HIL_TRANSPORT_HEADER) + ptParams->ulDataBufferSize;
+    pthread_mutex_init(&ptShmData->tLock, NULL);
+
+    strncpy(ptShmData->szPath, szPath, sizeof(ptShmData->szPath) - 1);
+    strncpy(tSockAddr.sun_path, ptShmData->szPath, sizeof(tSockAddr.sun_path) - 1);
+    tSockAddr.sun_family = AF_UNIX;
+
+    /* remove a stale socket of a previous run */
+    unlink(ptShmData->szPath);
+
+    if(NULL == (ptShmData->pbRxBuffer = (uint8_t*)malloc(ptShmData->ulRxBufferSize)))
+    {
+      eRet = HIL_MARSHALLER_E_OUTOFMEMORY;
+
+    } else if(INVALID_SOCKET == (ptShmData->hListen = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0)))
+    {
+      eRet = HIL_MARSHALLER_E_OUTOFRESOURCES;
+
+    } else if(SOCKET_ERROR == bind(ptShmData->hListen, (struct sockaddr*)&tSockAddr, sizeof(tSockAddr)))
+    {
+      eRet = HIL_MARSHALLER_E_OUTOFRESOURCES;
+
+    } else if(SOCKET_ERROR == listen(ptShmData->hListen, 0))
+    {
+      eRet = HIL_MARSHALLER_E_OUTOFRESOURCES;
+
+    } else if (0 != (pthread_create(&ptShmData->hThread, NULL, ShmConnectorThread, (void*)ptShmData)))
+    {
+      eRet = HIL_MARSHALLER_E_OUTOFRESOURCES;
+
+    } else
+    {
+      tMarshConn.pfnTransmit      = ShmConnectorSend;
+      tMarshConn.pfnDeinit        = ShmConnectorDeinit;
+      tMarshConn.pvUser           = ptShmData;
+      tMarshConn.ulDataBufferSize = ptParams->ulDataBufferSize;
+      tMarshConn.ulDataBufferCnt  = ptParams->ulDataBufferCnt;
+      tMarshConn.ulTimeout        = ptParams->ulTimeout;
+
+      eRet = HilMarshallerRegisterConnector(pvMarshaller,
+                                            &ptShmData->ulConnectorIdx,
+                                            &tMarshConn);
+    }
+
+    /* Something has failed, so uninitialize this connector instance */
+    if(eRet != MARSHALLER_NO_ERROR)
+    {
+      printf("Failed to create shared memory socket \"%s\"!\n", ptShmData->szPath);
+      ShmConnectorDeinit(ptShmData);
+    }
+  }
+
+  return eRet;
+}
@@ -0,0 +1,98 @@
+/* SPDX-License-Identifier: MIT */
+/**************************************************************************************
+ *
+ * Copyright (c) 2025, Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserved.
+ *
+ **************************************************************************************/
+
+#ifndef __SHMCONNECTOR__H
+#define __SHMCONNECTOR__H
+
+#include <pthread.h>
+#include <stdint.h>
+#include <sys/un.h>
+
+#ifdef __cplusplus
+  extern "C" {
+#endif
+
+#define SHM_CONNECTOR_DEFAULT_PATH "/tmp/cifx_marshaller_shm.sock"
+
+#define SHM_CONNECTOR_MAGIC        0x4D485343UL   /*!< "CSHM" */
+#define SHM_CONNECTOR_RING_SIZE    (64 * 1024)    /*!< Size of a ring in bytes, power of 2 */
+
+/*****************************************************************************/
+/*! Byte ring of the shared memory connector. Every frame is preceded by its
+*   length (uint32_t, host byte order) and may wrap around the end of
+*   abData. ulHead is only written by the producer, ulTail only by the
+*   consumer, both are free running byte counters.                           */
+/*****************************************************************************/
+typedef struct SHM_CONN_RING_Ttag
+{
+  uint32_t ulHead;
+  uint8_t  abPadHead[60];
+  uint32_t ulTail;
+  uint8_t  abPadTail[60];
+  uint8_t  abData[SHM_CONNECTOR_RING_SIZE];
+
+} SHM_CONN_RING_T;
+
+/*****************************************************************************/
+/*! Layout of the memfd passed to the client. On connect the server sends a
+*   single message containing the size of the layout and the file descriptors
+*   (SCM_RIGHTS) of the memfd, the eventfd signalled by the client after
+*   writing to tToServer and the eventfd signalled by the server after
+*   writing to tToClient.                                                    */
+/*****************************************************************************/
+typedef struct SHM_CONN_LAYOUT_Ttag
+{
+  uint32_t        ulMagic;
+  uint32_t        ulRingSize;
+  SHM_CONN_RING_T tToServer;
+  SHM_CONN_RING_T tToClient;
+
+} SHM_CONN_LAYOUT_T;
+
+#ifndef SHM_CONNECTOR_CLIENT
+
+#include "OS_Includes.h"
+#include "MarshallerInternal.h"
+
+/*****************************************************************************/
+/*! Internal shared memory connector data                                    */
+/*****************************************************************************/
+typedef struct SHM_CONN_INTERNAL_Ttag
+{
+  uint32_t           ulConnectorIdx;
+  void*              pvMarshaller;
+  uint32_t           ulTimeout;
+
+  int                fRunning;
+  pthread_t          hThread;
+  pthread_mutex_t    tLock;         /*!< Protects the connection against concurrent transmit */
+
+  SOCKET             hListen;
+  SOCKET             hClient;       /*!< Control connection, used to detect client termination */
+  int                iEvtToServer;
+  int                iEvtToClient;
+  SHM_CONN_LAYOUT_T* ptLayout;
+
+  uint8_t*           pbRxBuffer;    /*!< Receive buffer, holds one complete frame */
+  uint32_t           ulRxBufferSize;
+
+  char               szPath[sizeof(((struct sockaddr_un*)0)->sun_path)];
+
+  unsigned long      ulRxCount;
+  unsigned long      ulTxCount;
+
+} SHM_CONN_INTERNAL_T;
+
+uint32_t  ShmConnectorInit(const HIL_MARSHALLER_CONNECTOR_PARAMS_T* ptParams, void* pvMarshaller);
+
+#endif /* SHM_CONNECTOR_CLIENT */
+
+#ifdef __cplusplus
+  }
+#endif
+
+#endif /* __SHMCONNECTOR__H */
@@ -12,6 +12,10 @@
 #include <limits.h>
 #include <pthread.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <sys/socket.h>
+#include <sys/eventfd.h>
 
 #include "tcp_connector.h"
 #include "MarshallerErrors.h"
@@ -22,25 +26,188 @@ extern int            g_fTrafficOnce;
 
 extern unsigned short g_usPortNumber;
 
+#define TCP_TX_QUEUE_DEPTH 64  /*!< Maximum number of queued answers per connection */
+#define TCP_TX_IOV_MAX     32  /*!< Maximum number of iovecs per sendmsg() call        */
+
+/*****************************************************************************/
+/*! Returns sent buffers to the marshaller
+*   \param ptTcpData  TCP connector internal data
+*   \param ptDone     Sent (or dropped) buffers                              */
+/*****************************************************************************/
+static void TCPConnectorTxComplete(TCP_CONN_INTERNAL_T* ptTcpData, struct MARSHALLER_BUFFER_HEAD* ptDone)
+{
+  HIL_MARSHALLER_BUFFER_T* ptBuffer;
+
+  while(NULL != (ptBuffer = STAILQ_FIRST(ptDone)))
+  {
+    STAILQ_REMOVE_HEAD(ptDone, tList);
+    HilMarshallerConnTxComplete(ptBuffer->tMgmt.pvMarshaller,
+                                ptTcpData->ulConnectorIdx,
+                                ptBuffer);
+  }
+}
+
+/*****************************************************************************/
+/*! Sends as much of the transmit queue as the socket accepts without
+*   blocking. Must be called with tTxLock held.
+*   \param ptTcpData  TCP connector internal data
+*   \param ptDone     Returns the completely sent buffers
+*   \return 0 on success (queue may still contain data), -1 on socket error */
+/*****************************************************************************/
+static int TCPConnectorFlush(TCP_CONN_INTERNAL_T* ptTcpData, struct MARSHALLER_BUFFER_HEAD* ptDone)
+{
+  while(!STAILQ_EMPTY(&ptTcpData->tTxQueue))
+  {
+    struct iovec             atIov[TCP_TX_IOV_MAX];
+    struct msghdr            tMsg  = {0};
+    int                      iIov  = 0;
+    HIL_MARSHALLER_BUFFER_T* ptBuffer;
+    ssize_t                  iSent;
+
+    /* Transport header and payload of every queued answer are sent directly from the buffer */
+    STAILQ_FOREACH(ptBuffer, &ptTcpData->tTxQueue, tList)
+    {
+      uint32_t ulOffset = ptBuffer->tMgmt.ulActualSendOffset;
+
+      if(iIov + 2 > TCP_TX_IOV_MAX)
+        break;
+
+      if(ulOffset < sizeof(ptBuffer->tTransport))
+      {
+        atIov[iIov].iov_base = (uint8_t*)&ptBuffer->tTransport + ulOffset;
+        atIov[iIov].iov_len  = sizeof(ptBuffer->tTransport) - ulOffset;
+        ++iIov;
+        ulOffset = 0;
+      } else
+      {
+        ulOffset -= sizeof(ptBuffer->tTransport);
+      }
+
+      if(ptBuffer->tMgmt.ulUsedDataBufferLen > ulOffset)
+      {
+        atIov[iIov].iov_base = ptBuffer->abData + ulOffset;
+        atIov[iIov].iov_len  = ptBuffer->tMgmt.ulUsedDataBufferLen - ulOffset;
+        ++iIov;
+      }
+    }
+
+    tMsg.msg_iov    = atIov;
+    tMsg.msg_iovlen = iIov;
+
+    if(-1 == (iSent = sendmsg(ptTcpData->hClient, &tMsg, MSG_NOSIGNAL | MSG_DONTWAIT)))
+    {
+      if(EINTR == errno)
+        continue;
+
+      /* Socket buffer is full, the client thread continues when it becomes writable */
+      return ((EAGAIN == errno) || (EWOULDBLOCK == errno)) ? 0 : -1;
+    }
+
+    ptTcpData->ulTxCount += (unsigned long)iSent;
+
+    /* Retire the completely sent buffers, remember the position in a partially sent one */
+    while((iSent > 0) && (NULL != (ptBuffer = STAILQ_FIRST(&ptTcpData->tTxQueue))))
+    {
+      uint32_t ulLeft = sizeof(ptBuffer->tTransport) + ptBuffer->tMgmt.ulUsedDataBufferLen -
+                        ptBuffer->tMgmt.ulActualSendOffset;
+
+      if((size_t)iSent < ulLeft)
+      {
+        ptBuffer->tMgmt.ulActualSendOffset += (uint32_t)iSent;
+        iSent = 0;
+      } else
+      {
+        iSent -= ulLeft;
+        STAILQ_REMOVE_HEAD(&ptTcpData->tTxQueue, tList);
+        STAILQ_INSERT_TAIL(ptDone, ptBuffer, tList);
+        --ptTcpData->ulTxQueued;
+      }
+    }
+    pthread_cond_broadcast(&ptTcpData->tTxSpace);
+  }
+
+  return 0;
+}
+
+/*****************************************************************************/
+/*! Closes the client connection and drops all queued answers
+*   \param ptTcpData  TCP connector internal data                            */
+/*****************************************************************************/
+static void TCPConnectorCloseClient(TCP_CONN_INTERNAL_T* ptTcpData)
+{
+  struct MARSHALLER_BUFFER_HEAD tDone = STAILQ_HEAD_INITIALIZER(tDone);
+
+  pthread_mutex_lock(&ptTcpData->tTxLock);
+
+  if(INVALID_SOCKET != ptTcpData->hClient)
+  {
+    close(ptTcpData->hClient);
+    ptTcpData->hClient = INVALID_SOCKET;
+  }
+
+  STAILQ_CONCAT(&tDone, &ptTcpData->tTxQueue);
+  ptTcpData->ulTxQueued = 0;
+  pthread_cond_broadcast(&ptTcpData->tTxSpace);
+
+  pthread_mutex_unlock(&ptTcpData->tTxLock);
+
+  TCPConnectorTxComplete(ptTcpData, &tDone);
+}
+
 /*****************************************************************************/
-/*! Function called from marshaller when data is to be sent to interface
+/*! Function called from marshaller when data is to be sent to interface.
+*   The buffer is queued and sent without blocking, the client thread sends
+*   the rest when the socket becomes writable and returns the buffer to the
+*   marshaller afterwards.
 *   \param ptBuffer   Buffer to send
 *   \param pvUser     TCP connector internal data                            */
 /*****************************************************************************/
 static uint32_t TCPConnectorSend(HIL_MARSHALLER_BUFFER_T* ptBuffer, void* pvUser)
 {
-  TCP_CONN_INTERNAL_T* ptTcpData = (TCP_CONN_INTERNAL_T*)pvUser;
-  unsigned long        ulDataLen = sizeof(ptBuffer->tTransport) +
-                                   ptBuffer->tMgmt.ulUsedDataBufferLen;
+  TCP_CONN_INTERNAL_T*          ptTcpData = (TCP_CONN_INTERNAL_T*)pvUser;
+  struct MARSHALLER_BUFFER_HEAD tDone     = STAILQ_HEAD_INITIALIZER(tDone);
+  int                           fWakeup   = 0;
+
+  ptBuffer->tMgmt.ulActualSendOffset = 0;
+
+  /* Answers may be sent from several marshaller workers in parallel */
+  pthread_mutex_lock(&ptTcpData->tTxLock);
+
+  /* The queue is bounded, only a client not reading its answers lets the workers wait here */
+  while((INVALID_SOCKET != ptTcpData->hClient) && (ptTcpData->ulTxQueued >= TCP_TX_QUEUE_DEPTH))
+    pthread_cond_wait(&ptTcpData->tTxSpace, &ptTcpData->tTxLock);
 
-  ptTcpData->ulTxCount += ulDataLen;
+  if(INVALID_SOCKET == ptTcpData->hClient)
+  {
+    /* Connection is closed, the answer is dropped */
+    STAILQ_INSERT_TAIL(&tDone, ptBuffer, tList);
+  } else
+  {
+    int fIdle = STAILQ_EMPTY(&ptTcpData->tTxQueue);
+
+    STAILQ_INSERT_TAIL(&ptTcpData->tTxQueue, ptBuffer, tList);
+    ++ptTcpData->ulTxQueued;
+
+    /* Send directly if nothing is pending. Otherwise the client thread is already waiting
+       for the socket to become writable. */
+    if(fIdle)
+    {
+      (void)TCPConnectorFlush(ptTcpData, &tDone);
+      fWakeup = !STAILQ_EMPTY(&ptTcpData->tTxQueue);
+    }
+  }
+
+  pthread_mutex_unlock(&ptTcpData->tTxLock);
+
+  if(fWakeup)
+  {
+    uint64_t ullWakeup = 1;
 
-    /* If EINTR is returned try sending the packets again. */
-  while(-1 == send(ptTcpData->hClient, (char*)&ptBuffer->tTransport, ulDataLen, 0) && EINTR == errno);
+    if(sizeof(ullWakeup) != write(ptTcpData->hTxWakeup, &ullWakeup, sizeof(ullWakeup)))
+      perror("TCPConnectorSend: wakeup failed");
+  }
 
-  HilMarshallerConnTxComplete(ptBuffer->tMgmt.pvMarshaller,
-                              ptTcpData->ulConnectorIdx,
-                              ptBuffer);
+  TCPConnectorTxComplete(ptTcpData, &tDone);
 
   return MARSHALLER_NO_ERROR;
 }
@@ -64,8 +231,7 @@ static void TCPConnectorDeinit(void* pvUser)
       pthread_join(ptTcpData->hClientThread,NULL);
     }
 
-    if(INVALID_SOCKET != ptTcpData->hClient)
-      close(ptTcpData->hClient);
+    TCPConnectorCloseClient(ptTcpData);
 
     if(0 != ptTcpData->hServerThread)
     {
@@ -81,6 +247,11 @@ static void TCPConnectorDeinit(void* pvUser)
       HilMarshallerUnregisterConnector(ptTcpData->pvMarshaller, ptTcpData->ulConnectorIdx);
     }
 
+    if(-1 != ptTcpData->hTxWakeup)
+      close(ptTcpData->hTxWakeup);
+
+    pthread_cond_destroy(&ptTcpData->tTxSpace);
+    pthread_mutex_destroy(&ptTcpData->tTxLock);
     free(ptTcpData);
   }
 
@@ -100,21 +271,57 @@ void* ClientThread(void* pvParam)
 
   while(ptTcpData->fRunning)
   {
-    TYPE_FD_SET    tRead, tExcept;
+    TYPE_FD_SET    tRead, tWrite, tExcept;
     struct timeval tTimeout = {0};
     int            iErr     = 0;
+    int            iMaxFd   = (ptTcpData->hClient > ptTcpData->hTxWakeup) ? ptTcpData->hClient : ptTcpData->hTxWakeup;
 
     tTimeout.tv_sec = 5;
 
     FD_ZERO(&tRead);
+    FD_ZERO(&tWrite);
     FD_ZERO(&tExcept);
 
     FD_SET(ptTcpData->hClient, &tRead);
+    FD_SET(ptTcpData->hTxWakeup, &tRead);
     FD_SET(ptTcpData->hClient, &tExcept);
 
-    iErr = select(ptTcpData->hClient + 1, &tRead, NULL, &tExcept, &tTimeout);
+    /* Wait for the socket to become writable, if answers are pending */
+    pthread_mutex_lock(&ptTcpData->tTxLock);
+    if(!STAILQ_EMPTY(&ptTcpData->tTxQueue))
+      FD_SET(ptTcpData->hClient, &tWrite);
+    pthread_mutex_unlock(&ptTcpData->tTxLock);
+
+    iErr = select(iMaxFd + 1, &tRead, &tWrite, &tExcept, &tTimeout);
     if(0 < iErr)
     {
+      if(FD_ISSET(ptTcpData->hTxWakeup, &tRead))
+      {
+        uint64_t ullWakeup;
+
+        /* New answers are queued, they are handled with the next select() */
+        if(sizeof(ullWakeup) != read(ptTcpData->hTxWakeup, &ullWakeup, sizeof(ullWakeup)))
+          ullWakeup = 0;
+      }
+
+      if(FD_ISSET(ptTcpData->hClient, &tWrite))
+      {
+        struct MARSHALLER_BUFFER_HEAD tDone = STAILQ_HEAD_INITIALIZER(tDone);
+        int                           iRet;
+
+        pthread_mutex_lock(&ptTcpData->tTxLock);
+        iRet = TCPConnectorFlush(ptTcpData, &tDone);
+        pthread_mutex_unlock(&ptTcpData->tTxLock);
+
+        TCPConnectorTxComplete(ptTcpData, &tDone);
+
+        if(0 != iRet)
+        {
+          /* Client is not reachable anymore */
+          break;
+        }
+      }
+
       if(FD_ISSET(ptTcpData->hClient, &tRead))
       {
         /* We have data to read */
@@ -129,12 +336,14 @@ void* ClientThread(void* pvParam)
         /* If EINTR is returned try receiving the packets again. */
         while(-1 == (iRecv = recv(ptTcpData->hClient, (char*)pbData, iDataLen, 0)) && EINTR == errno);
 
-        if( (SOCKET_ERROR == iRecv) ||
-            (0            == iRecv) )
+        if( (SOCKET_ERROR == iRecv) && ((EAGAIN == errno) || (EWOULDBLOCK == errno)) )
+        {
+          /* Socket is non-blocking, nothing to read yet */
+
+        } else if( (SOCKET_ERROR == iRecv) ||
+                   (0            == iRecv) )
         {
           /* Gracefully closed socket */
-          close(ptTcpData->hClient);
-          ptTcpData->hClient = INVALID_SOCKET;
           free(pbData);
           break;
 
@@ -160,19 +369,18 @@ void* ClientThread(void* pvParam)
       if(FD_ISSET(ptTcpData->hClient, &tExcept))
       {
         /* Socket has been closed */
-        close(ptTcpData->hClient);
-        ptTcpData->hClient = INVALID_SOCKET;
         break;
       }
     } else if (iErr == 0)
     {
       /* Timeout -> close socket */
-      close(ptTcpData->hClient);
-      ptTcpData->hClient = INVALID_SOCKET;
       break;
     }
   }
 
+  /* Close the socket and return the answers not sent to the marshaller */
+  TCPConnectorCloseClient(ptTcpData);
+
   ptTcpData->hClientThread = 0;
 
   /* add code here to Kill network traffic timer event */
@@ -234,7 +442,13 @@ void* ServerThread(void* pvParam)
             printf("The server is not able to send small packets.\n");
             printf("So the communication could be very slow!\n");
           }
+          /* Answers are sent without blocking (see TCPConnectorSend()) */
+          fcntl(hClient, F_SETFL, fcntl(hClient, F_GETFL) | O_NONBLOCK);
+
+          pthread_mutex_lock(&ptTcpData->tTxLock);
           ptTcpData->hClient = hClient;
+          pthread_mutex_unlock(&ptTcpData->tTxLock);
+
           pthread_create(&ptTcpData->hClientThread, NULL,ClientThread, (void*)ptTcpData);
 
           /* Query remote name */
@@ -282,12 +496,21 @@ uint32_t TCPConnectorInit(const HIL_MARSHALLER_CONNECTOR_PARAMS_T* ptParams, voi
     ptTcpData->pvMarshaller   = pvMarshaller;
     ptTcpData->hClient        = INVALID_SOCKET;
     ptTcpData->fRunning       = 1;
+    ptTcpData->hTxWakeup      = eventfd(0, EFD_NONBLOCK);
+    pthread_mutex_init(&ptTcpData->tTxLock, NULL);
+    pthread_cond_init(&ptTcpData->tTxSpace, NULL);
+    STAILQ_INIT(&ptTcpData->tTxQueue);
 
     tSockAddr.sin_addr.s_addr = INADDR_ANY;
     tSockAddr.sin_port        = htons(g_usPortNumber);
     tSockAddr.sin_family      = AF_INET;
 
-    if(INVALID_SOCKET == (ptTcpData->hListen = socket(AF_INET, SOCK_STREAM, 0)))
+    if(-1 == ptTcpData->hTxWakeup)
+    {
+      ptTcpData->hListen = INVALID_SOCKET;
+      eRet               = HIL_MARSHALLER_E_OUTOFRESOURCES;
+
+    } else if(INVALID_SOCKET == (ptTcpData->hListen = socket(AF_INET, SOCK_STREAM, 0)))
     {
       eRet = HIL_MARSHALLER_E_OUTOFRESOURCES;
 
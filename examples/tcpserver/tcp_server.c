@@ -14,12 +14,20 @@
 #include <stdio.h>
 #include <strings.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <sys/stat.h>
 
 #include "tcp_connector.h"
+#ifdef MARSHALLER_UNIX_CONNECTOR
+#include "unix_connector.h"
+#endif
+#ifdef MARSHALLER_SHM_CONNECTOR
+#include "shm_connector.h"
+#endif
 #include "tcp_server.h"
 #include "cifxlinux.h"
 #include "cifx_download_hook.h"
+#include "marshaller_worker.h"
 #include "MarshallerErrors.h"
 
 /* Driver/Config base directory */
@@ -34,6 +42,15 @@ int               g_fTrafficOnce  = 0;
 
 unsigned short    g_usPortNumber = HIL_TRANSPORT_IP_PORT;
 
+/* number of worker threads handling requests (0 = handle in connector thread) */
+uint32_t          g_ulWorkerCnt  = MARSHALLER_WORKER_DEFAULT_CNT;
+/* number of requests per connector which may be pending */
+uint32_t          g_ulQueueDepth = MARSHALLER_QUEUE_DEFAULT_DEPTH;
+
+/* socket paths of the local connectors (NULL = default path) */
+char*             g_szUnixSocketPath = NULL;
+char*             g_szShmSocketPath  = NULL;
+
 struct CIFX_LINUX_INIT  g_tInit = {0};
 
 pthread_mutex_t*  g_ptMutex = NULL;
@@ -156,6 +173,14 @@ void DisplayHelp(void)
   printf("Available options:\n");
   printf("[-n <n>] initialize only a specific card specified by 'n'.\n");
   printf("[-p <n>] use port number specified by 'n'.\n");
+  printf("[-w <n>] number of worker threads handling requests in parallel (default %d, 0 = none).\n", MARSHALLER_WORKER_DEFAULT_CNT);
+  printf("[-q <n>] number of pending requests per connection (default %d).\n", MARSHALLER_QUEUE_DEFAULT_DEPTH);
+#ifdef MARSHALLER_UNIX_CONNECTOR
+  printf("[-u <path>] path of the unix domain socket (default %s).\n", UNIX_CONNECTOR_DEFAULT_PATH);
+#endif
+#ifdef MARSHALLER_SHM_CONNECTOR
+  printf("[-m <path>] path of the shared memory connector socket (default %s).\n", SHM_CONNECTOR_DEFAULT_PATH);
+#endif
   printf("[-d] display IP adress of the active adapter and return.\n");
   printf("[-a] display available cards and return.\n");
   printf("[-h] display this help.\n");
@@ -248,6 +273,58 @@ int ValidateArgs(int argc, char* argv[])
         {
           fRet = 0;
         }
+      }else if (0 == strcasecmp("-w", argv[iArgCnt]))
+      {
+        iArgCnt++;
+        if (((iArgCnt) < argc) && (atoi(argv[iArgCnt]) >= 0) && (atoi(argv[iArgCnt]) <= MARSHALLER_WORKER_MAX_CNT))
+        {
+          g_ulWorkerCnt = atoi( argv[iArgCnt]);
+          printf("Use %u worker threads!\n", g_ulWorkerCnt);
+
+        } else
+        {
+          fRet = 0;
+        }
+      }else if (0 == strcasecmp("-q", argv[iArgCnt]))
+      {
+        iArgCnt++;
+        if (((iArgCnt) < argc) && (atoi(argv[iArgCnt]) > 0))
+        {
+          g_ulQueueDepth = atoi( argv[iArgCnt]);
+          printf("Use queue depth: %u!\n", g_ulQueueDepth);
+
+        } else
+        {
+          fRet = 0;
+        }
+#ifdef MARSHALLER_UNIX_CONNECTOR
+      }else if (0 == strcasecmp("-u", argv[iArgCnt]))
+      {
+        iArgCnt++;
+        if ((iArgCnt) < argc)
+        {
+          g_szUnixSocketPath = argv[iArgCnt];
+          printf("Use unix socket: %s!\n", g_szUnixSocketPath);
+
+        } else
+        {
+          fRet = 0;
+        }
+#endif
+#ifdef MARSHALLER_SHM_CONNECTOR
+      }else if (0 == strcasecmp("-m", argv[iArgCnt]))
+      {
+        iArgCnt++;
+        if ((iArgCnt) < argc)
+        {
+          g_szShmSocketPath = argv[iArgCnt];
+          printf("Use shared memory socket: %s!\n", g_szShmSocketPath);
+
+        } else
+        {
+          fRet = 0;
+        }
+#endif
       }else if ((0 == strcasecmp("-d", argv[iArgCnt])) || (0 == strcasecmp("-a", argv[iArgCnt])) || (0 == strcasecmp("-h", argv[iArgCnt])))
       {
         /* already done */
@@ -378,7 +455,11 @@ int32_t APIENTRY xChannelCloseWrap ( CIFXHANDLE  hChannel)
 void MarshallerRequest(void* pvMarshaller, void* pvUser)
 {
   UNREFERENCED_PARAMETER(pvUser);
-  HilMarshallerMain(pvMarshaller);
+
+  if (g_ulWorkerCnt > 0)
+    MarshallerWorkerRequest(pvMarshaller);
+  else
+    HilMarshallerMain(pvMarshaller);
 }
 
 /*****************************************************************************/
@@ -462,63 +543,159 @@ static void GetChannelDir(char* szPath, size_t iPathLen, uint32_t ulChannel, BOA
 }
 
 /*****************************************************************************/
-/*! File storage callback (uses NX-API)                                      */
+/*! File stored by the download hook                                         */
+/*****************************************************************************/
+typedef struct FILE_STORAGE_Ttag
+{
+  int      iFd;                                   /*!< Temporary file, renamed on commit */
+  uint32_t ulDownloadMode;                        /*!< Download mode (firmware, config, module) */
+  char     szBoardName[CIFx_MAX_INFO_NAME_LENTH]; /*!< Board to restart after a firmware download */
+  char     szFileName[FILENAME_MAX];              /*!< Destination file */
+  char     szTmpFileName[FILENAME_MAX + 4];       /*!< Temporary file, the destination is kept until the download succeeded */
+
+} FILE_STORAGE_T;
+
+/*****************************************************************************/
+/*! File storage open callback (see PFN_FILESTORAGE_OPEN)                    */
 /*****************************************************************************/
-static int32_t HandleFileStorage(BOARD_INFORMATION* ptBoardInfo,
-                                 char* pszFileName, uint32_t ulFileSize,
-                                 uint8_t* pabFileData, uint32_t ulChannel,
-                                 uint32_t ulDownloadMode, void* pvUser)
+static int32_t HandleFileStorageOpen(BOARD_INFORMATION* ptBoardInfo,
+                                     char* pszFileName, uint32_t ulFileSize,
+                                     uint32_t ulChannel, uint32_t ulDownloadMode,
+                                     void* pvUser, void** ppvFile)
 {
-  int32_t lRet = CIFX_FUNCTION_FAILED;
-  char    abFileName[FILENAME_MAX];
-  FILE*   iFd;
+  FILE_STORAGE_T* ptFile;
 
+  (void)ulFileSize;
   (void)pvUser;
 
-  GetChannelDir(abFileName, FILENAME_MAX, ulChannel, ptBoardInfo);
-  strcat(abFileName, pszFileName);
+  if (NULL == (ptFile = calloc(1, sizeof(*ptFile))))
+    return CIFX_FUNCTION_FAILED;
 
-  printf("Store file: %s\n", abFileName);
-  if ( NULL != (iFd = fopen( abFileName, "w+")))
+  GetChannelDir(ptFile->szFileName, sizeof(ptFile->szFileName), ulChannel, ptBoardInfo);
+  strncat(ptFile->szFileName, pszFileName, sizeof(ptFile->szFileName) - strlen(ptFile->szFileName) - 1);
+  snprintf(ptFile->szTmpFileName, sizeof(ptFile->szTmpFileName), "%s.tmp", ptFile->szFileName);
+  snprintf(ptFile->szBoardName, sizeof(ptFile->szBoardName), "%s", ptBoardInfo->abBoardName);
+  ptFile->ulDownloadMode = ulDownloadMode;
+
+  printf("Store file: %s\n", ptFile->szFileName);
+  /* unbuffered, the download hook passes complete write-behind buffers */
+  if (-1 == (ptFile->iFd = open( ptFile->szTmpFileName, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)))
   {
-    int iFileSize;
-    if ( 0 < (iFileSize = fwrite( pabFileData, 1, ulFileSize, iFd)))
-    {
-      if ((((unsigned int)iFileSize) == ulFileSize))
-        lRet = CIFX_NO_ERROR;
-    } else
+    printf("File open failed (error=%d)!\n",errno);
+    printf("Please create directory in case path does not exist!\n");
+    free(ptFile);
+    return CIFX_FILE_OPEN_FAILED;
+  }
+
+  *ppvFile = ptFile;
+
+  return CIFX_NO_ERROR;
+}
+
+/*****************************************************************************/
+/*! File storage write callback (see PFN_FILESTORAGE_WRITE)                  */
+/*****************************************************************************/
+static int32_t HandleFileStorageWrite(void* pvFile, uint8_t* pabData, uint32_t ulDataLen, void* pvUser)
+{
+  FILE_STORAGE_T* ptFile = (FILE_STORAGE_T*)pvFile;
+
+  (void)pvUser;
+
+  while (ulDataLen > 0)
+  {
+    ssize_t iWritten = write( ptFile->iFd, pabData, ulDataLen);
+
+    if (iWritten < 0)
     {
-      printf("File storing failed %d\n", iFileSize);
+      if (EINTR == errno)
+        continue;
+
+      printf("File storing failed (error=%d)\n", errno);
+      return CIFX_FUNCTION_FAILED;
     }
-    fclose( iFd);
-  } else
+    pabData   += iWritten;
+    ulDataLen -= (uint32_t)iWritten;
+  }
+
+  return CIFX_NO_ERROR;
+}
+
+/*****************************************************************************/
+/*! File storage close callback (see PFN_FILESTORAGE_CLOSE). On commit the
+*   temporary file replaces the destination file.                            */
+/*****************************************************************************/
+static int32_t HandleFileStorageClose(void* pvFile, int fCommit, void* pvUser)
+{
+  FILE_STORAGE_T* ptFile = (FILE_STORAGE_T*)pvFile;
+  int32_t         lRet   = CIFX_NO_ERROR;
+
+  (void)pvUser;
+
+  /* make sure the data is on disk, before the old file gets replaced */
+  if (fCommit && (0 != fsync(ptFile->iFd)))
   {
-    printf("File open failed (error=%d)!\n",errno);
-    printf("Please create directory in case path does not exist!\n");
-    lRet = CIFX_FILE_OPEN_FAILED;
+    printf("File storing failed (error=%d)\n", errno);
+    lRet = CIFX_FUNCTION_FAILED;
   }
-  if (( DOWNLOAD_MODE_FIRMWARE == ulDownloadMode) && (lRet == CIFX_NO_ERROR))
+  close(ptFile->iFd);
+
+  if (!fCommit || (CIFX_NO_ERROR != lRet))
+  {
+    unlink(ptFile->szTmpFileName);
+
+  } else if (0 != rename(ptFile->szTmpFileName, ptFile->szFileName))
+  {
+    printf("File storing failed (error=%d)\n", errno);
+    unlink(ptFile->szTmpFileName);
+    lRet = CIFX_FUNCTION_FAILED;
+
+  } else if (DOWNLOAD_MODE_FIRMWARE == ptFile->ulDownloadMode)
   {
     /* if download succeeded restart device */
-    xDriverRestartDevice ( NULL, ptBoardInfo->abBoardName, NULL);
+    xDriverRestartDevice ( NULL, ptFile->szBoardName, NULL);
   }
 
+  free(ptFile);
+
   return lRet;
 }
 
+/*! File storage callbacks of the download hook */
+static const FILESTORAGE_FUNCTIONS_T s_tFileStorage =
+{
+  HandleFileStorageOpen,
+  HandleFileStorageWrite,
+  HandleFileStorageClose,
+};
+
 /*****************************************************************************/
 /*! Initialization the Marshallar                                         */
 /*****************************************************************************/
 uint32_t InitMarshaller(void)
 {
   HIL_MARSHALLER_PARAMS_T           tParams        = {0};
-  HIL_MARSHALLER_CONNECTOR_PARAMS_T tTCPConnector  = {0};
-
-  tTCPConnector.pfnConnectorInit = TCPConnectorInit;
-  tTCPConnector.pvConfigData     = NULL;
-  tTCPConnector.ulDataBufferCnt  = 1;
-  tTCPConnector.ulDataBufferSize = 6000;
-  tTCPConnector.ulTimeout        = 1000;
+  HIL_MARSHALLER_CONNECTOR_PARAMS_T atConnectors[3] = {{0}};
+  uint32_t                          ulConnectorCnt  = 0;
+
+  atConnectors[ulConnectorCnt].pfnConnectorInit = TCPConnectorInit;
+  atConnectors[ulConnectorCnt].pvConfigData     = NULL;
+  atConnectors[ulConnectorCnt].ulDataBufferCnt  = g_ulQueueDepth;
+  atConnectors[ulConnectorCnt].ulDataBufferSize = 6000;
+  atConnectors[ulConnectorCnt].ulTimeout        = 1000;
+  ulConnectorCnt++;
+
+#ifdef MARSHALLER_UNIX_CONNECTOR
+  /* local clients, same buffer layout as TCP */
+  atConnectors[ulConnectorCnt]                  = atConnectors[0];
+  atConnectors[ulConnectorCnt].pfnConnectorInit = UnixConnectorInit;
+  ulConnectorCnt++;
+#endif
+
+#ifdef MARSHALLER_SHM_CONNECTOR
+  atConnectors[ulConnectorCnt]                  = atConnectors[0];
+  atConnectors[ulConnectorCnt].pfnConnectorInit = ShmConnectorInit;
+  ulConnectorCnt++;
+#endif
 
   TRANSPORT_LAYER_CONFIG_T          tCifXTransport = {0};
   CIFX_TRANSPORT_CONFIG             tCifXConfig    = {{0}};
@@ -569,17 +746,23 @@ uint32_t InitMarshaller(void)
   tCifXConfig.tDRVFunctions.pfnxChannelFindNextFile        = xChannelFindNextFile;
 
   /* Install download hook */
-  xDownloadHook_Install(&tCifXConfig.tDRVFunctions, HandleFileStorage, &g_tInit);
+  xDownloadHook_Install(&tCifXConfig.tDRVFunctions, &s_tFileStorage, &g_tInit);
 
   tCifXTransport.pfnInit  = cifXTransportInit;
   tCifXTransport.pvConfig = &tCifXConfig;
 
-  tParams.ulMaxConnectors = 1;
+  tParams.ulMaxConnectors = ulConnectorCnt;
   tParams.atTransports    = &tCifXTransport;
   tParams.ulTransportCnt  = 1;
 
-  tParams.ptConnectors    = &tTCPConnector;
-  tParams.ulConnectorCnt  = 1;
+  tParams.ptConnectors    = atConnectors;
+  tParams.ulConnectorCnt  = ulConnectorCnt;
+
+  /* requests to different channels are handled in parallel by the workers */
+  tParams.ulMaxParallelRequests = g_ulWorkerCnt;
+
+  if ( (g_ulWorkerCnt > 0) && (0 != MarshallerWorkerStart(g_ulWorkerCnt)) )
+    return HIL_MARSHALLER_E_OUTOFRESOURCES;
 
   uint32_t eRet = HilMarshallerStart(&tParams, &g_pvMarshaller, MarshallerRequest, 0);
 
@@ -617,6 +800,8 @@ void DeinitMarshaller()
   if(NULL != g_pvMarshaller)
   {
     printf("\nWaiting for all process to end...\n");
+    if (g_ulWorkerCnt > 0)
+      MarshallerWorkerStop();
     HilMarshallerStop(g_pvMarshaller);
   }
 }
@@ -31,6 +31,14 @@ pthread_t     hClientThread;
 unsigned long ulRxCount;
 unsigned long ulTxCount;
 
+pthread_mutex_t tTxLock;
+
+/* Transmit queue (protected by tTxLock) */
+struct MARSHALLER_BUFFER_HEAD tTxQueue;   /* Answers not (completely) sent yet, chained via tList  */
+uint32_t                      ulTxQueued; /* Number of buffers in tTxQueue                         */
+pthread_cond_t                tTxSpace;   /* Signalled when buffers are removed from tTxQueue      */
+int                           hTxWakeup;  /* eventfd to wake up the client thread to flush tTxQueue */
+
 } TCP_CONN_INTERNAL_T;
 
 
@@ -0,0 +1,272 @@
+// SPDX-License-Identifier: MIT
+/**************************************************************************************
+ *
+ * Copyright (c) 2025, Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserved.
+ *
+ * Description: Unix domain socket (SOCK_SEQPACKET) connector for Hilscher marshaller.
+ *              Every datagram carries exactly one marshaller frame.
+ *
+ **************************************************************************************/
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include "unix_connector.h"
+#include "MarshallerErrors.h"
+
+/* path of the listening socket */
+extern char* g_szUnixSocketPath;
+
+/*****************************************************************************/
+/*! Function called from marshaller when data is to be sent to interface
+*   \param ptBuffer   Buffer to send
+*   \param pvUser     Unix connector internal data                           */
+/*****************************************************************************/
+static uint32_t UnixConnectorSend(HIL_MARSHALLER_BUFFER_T* ptBuffer, void* pvUser)
+{
+  UNIX_CONN_INTERNAL_T* ptUnixData = (UNIX_CONN_INTERNAL_T*)pvUser;
+  unsigned long         ulDataLen  = sizeof(ptBuffer->tTransport) +
+                                     ptBuffer->tMgmt.ulUsedDataBufferLen;
+
+  pthread_mutex_lock(&ptUnixData->tLock);
+
+  if(INVALID_SOCKET != ptUnixData->hClient)
+  {
+    ptUnixData->ulTxCount += ulDataLen;
+
+    /* If EINTR is returned try sending the frame again. */
+    while(-1 == send(ptUnixData->hClient, (char*)&ptBuffer->tTransport, ulDataLen, MSG_NOSIGNAL) && EINTR == errno);
+  }
+
+  pthread_mutex_unlock(&ptUnixData->tLock);
+
+  HilMarshallerConnTxComplete(ptBuffer->tMgmt.pvMarshaller,
+                              ptUnixData->ulConnectorIdx,
+                              ptBuffer);
+
+  return MARSHALLER_NO_ERROR;
+}
+
+/*****************************************************************************/
+/*! Closes the client connection
+*   \param ptUnixData Unix connector internal data                           */
+/*****************************************************************************/
+static void UnixConnectorCloseClient(UNIX_CONN_INTERNAL_T* ptUnixData)
+{
+  pthread_mutex_lock(&ptUnixData->tLock);
+  if(INVALID_SOCKET != ptUnixData->hClient)
+  {
+    close(ptUnixData->hClient);
+    ptUnixData->hClient = INVALID_SOCKET;
+    printf("Local connection closed!\n");
+  }
+  pthread_mutex_unlock(&ptUnixData->tLock);
+}
+
+/*****************************************************************************/
+/*! Unix connector uninitialization
+*   \param pvUser Pointer to internal connector data                         */
+/*****************************************************************************/
+static void UnixConnectorDeinit(void* pvUser)
+{
+  UNIX_CONN_INTERNAL_T* ptUnixData = (UNIX_CONN_INTERNAL_T*)pvUser;
+
+  /* Check if data is valid */
+  if(NULL != ptUnixData)
+  {
+    ptUnixData->fRunning = 0;
+
+    if(0 != ptUnixData->hThread)
+      pthread_join(ptUnixData->hThread, NULL);
+
+    UnixConnectorCloseClient(ptUnixData);
+
+    if(INVALID_SOCKET != ptUnixData->hListen)
+    {
+      close(ptUnixData->hListen);
+      unlink(ptUnixData->szPath);
+    }
+
+    /* Unregister from Marshaller */
+    if(ptUnixData->ulConnectorIdx != (uint32_t)~0)
+    {
+      HilMarshallerUnregisterConnector(ptUnixData->pvMarshaller, ptUnixData->ulConnectorIdx);
+    }
+
+    pthread_mutex_destroy(&ptUnixData->tLock);
+    free(ptUnixData->pbRxBuffer);
+    free(ptUnixData);
+  }
+}
+
+/*****************************************************************************/
+/*! Thread serving the listening socket and the client connection
+*   \param pvParam Pointer reference to unix connector structure
+*   \return        Always 0                                                  */
+/*****************************************************************************/
+static void* UnixConnectorThread(void* pvParam)
+{
+  UNIX_CONN_INTERNAL_T* ptUnixData = (UNIX_CONN_INTERNAL_T*)pvParam;
+
+  while(ptUnixData->fRunning)
+  {
+    struct pollfd atPoll[2] = {{0}};
+    nfds_t        tCnt      = 1;
+
+    atPoll[0].fd     = ptUnixData->hListen;
+    atPoll[0].events = POLLIN;
+
+    if(INVALID_SOCKET != ptUnixData->hClient)
+    {
+      atPoll[1].fd     = ptUnixData->hClient;
+      atPoll[1].events = POLLIN;
+      tCnt             = 2;
+    }
+
+    if(0 >= poll(atPoll, tCnt, 1000))
+      continue;
+
+    if(atPoll[0].revents & POLLIN)
+    {
+      SOCKET hClient = accept4(ptUnixData->hListen, NULL, NULL, SOCK_CLOEXEC);
+
+      if(INVALID_SOCKET == hClient)
+      {
+        /* nothing to do */
+      } else if(INVALID_SOCKET != ptUnixData->hClient)
+      {
+        /* We already have a client, so reject this one */
+        close(hClient);
+      } else
+      {
+        ptUnixData->ulRxCount = 0;
+        ptUnixData->ulTxCount = 0;
+        ptUnixData->hClient   = hClient;
+        printf("Connected with local client (%s)\n", ptUnixData->szPath);
+      }
+    }
+
+    if( (tCnt > 1) && (atPoll[1].revents & (POLLIN | POLLHUP | POLLERR)) )
+    {
+      struct iovec  tIov = {ptUnixData->pbRxBuffer, ptUnixData->ulRxBufferSize};
+      struct msghdr tMsg = {0};
+      ssize_t       iRecv;
+
+      tMsg.msg_iov    = &tIov;
+      tMsg.msg_iovlen = 1;
+
+      /* If EINTR is returned try receiving the frame again. */
+      while(-1 == (iRecv = recvmsg(ptUnixData->hClient, &tMsg, 0)) && EINTR == errno);
+
+      if(0 >= iRecv)
+      {
+        /* Gracefully closed socket */
+        UnixConnectorCloseClient(ptUnixData);
+
+      } else if(tMsg.msg_flags & MSG_TRUNC)
+      {
+        printf("Local connector: frame exceeds buffer size, discarded!\n");
+
+      } else
+      {
+        ptUnixData->ulRxCount += (unsigned long)iRecv;
+
+        HilMarshallerConnRxData(ptUnixData->pvMarshaller,
+                                ptUnixData->ulConnectorIdx,
+                                ptUnixData->pbRxBuffer,
+                                (uint32_t)iRecv);
+      }
+    }
+  }
+
+  return 0;
+}
+
+/*****************************************************************************/
+/*! Unix domain socket connector initialization
+*   \param ptParams     Marshaller specific parameters (e.g. timeout)
+*   \param pvMarshaller Handle to the marshaller, this connector should be added
+*   \return MARSHALLER_NO_ERROR on success                                   */
+/*****************************************************************************/
+uint32_t UnixConnectorInit(const HIL_MARSHALLER_CONNECTOR_PARAMS_T* ptParams, void* pvMarshaller)
+{
+  HIL_MARSHALLER_CONNECTOR_T tMarshConn;
+  UNIX_CONN_INTERNAL_T*      ptUnixData = NULL;
+  uint32_t                   eRet;
+
+  if(NULL == (ptUnixData = (UNIX_CONN_INTERNAL_T*)malloc(sizeof(*ptUnixData))))
+  {
+    eRet = HIL_MARSHALLER_E_OUTOFMEMORY;
+  } else
+  {
+    struct sockaddr_un tSockAddr = {0};
+    const char*        szPath    = (NULL != g_szUnixSocketPath) ? g_szUnixSocketPath : UNIX_CONNECTOR_DEFAULT_PATH;
+
+    memset(&tMarshConn, 0, sizeof(tMarshConn));
+    memset(ptUnixData, 0, sizeof(*ptUnixData));
+
+    ptUnixData->ulConnectorIdx = (uint32_t)~0;
+    ptUnixData->pvMarshaller   = pvMarshaller;
+    ptUnixData->hListen        = INVALID_SOCKET;
+    ptUnixData->hClient        = INVALID_SOCKET;
+    ptUnixData->fRunning       = 1;
+    ptUnixData->ulRxBufferSize = sizeof(HIL_TRANSPORT_HEADER) + ptParams->ulDataBufferSize;
+    pthread_mutex_init(&ptUnixData->tLock, NULL);
+
+    strncpy(ptUnixData->szPath, szPath, sizeof(ptUnixData->szPath) - 1);
+    strncpy(tSockAddr.sun_path, ptUnixData->szPath, sizeof(tSockAddr.sun_path) - 1);
+    tSockAddr.sun_family = AF_UNIX;
+
+    /* remove a stale socket of a previous run */
+    unlink(ptUnixData->szPath);
+
+    if(NULL == (ptUnixData->pbRxBuffer = (uint8_t*)malloc(ptUnixData->ulRxBufferSize)))
+    {
+      eRet = HIL_MARSHALLER_E_OUTOFMEMORY;
+
+    } else if(INVALID_SOCKET == (ptUnixData->hListen = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0)))
+    {
+      eRet = HIL_MARSHALLER_E_OUTOFRESOURCES;
+
+    } else if(SOCKET_ERROR == bind(ptUnixData->hListen, (struct sockaddr*)&tSockAddr, sizeof(tSockAddr)))
+    {
+      eRet = HIL_MARSHALLER_E_OUTOFRESOURCES;
+
+    } else if(SOCKET_ERROR == listen(ptUnixData->hListen, 0))
+    {
+      eRet = HIL_MARSHALLER_E_OUTOFRESOURCES;
+
+    } else if (0 != (pthread_create(&ptUnixData->hThread, NULL, UnixConnectorThread, (void*)ptUnixData)))
+    {
+      eRet = HIL_MARSHALLER_E_OUTOFRESOURCES;
+
+    } else
+    {
+      tMarshConn.pfnTransmit      = UnixConnectorSend;
+      tMarshConn.pfnDeinit        = UnixConnectorDeinit;
+      tMarshConn.pvUser           = ptUnixData;
+      tMarshConn.ulDataBufferSize = ptParams->ulDataBufferSize;
+      tMarshConn.ulDataBufferCnt  = ptParams->ulDataBufferCnt;
+      tMarshConn.ulTimeout        = ptParams->ulTimeout;
+
+      eRet = HilMarshallerRegisterConnector(pvMarshaller,
+                                            &ptUnixData->ulConnectorIdx,
+                                            &tMarshConn);
+    }
+
+    /* Something has failed, so uninitialize this connector instance */
+    if(eRet != MARSHALLER_NO_ERROR)
+    {
+      printf("Failed to create local socket \"%s\"!\n", ptUnixData->szPath);
+      UnixConnectorDeinit(ptUnixData);
+    }
+  }
+
+  return eRet;
+}
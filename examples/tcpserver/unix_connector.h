@@ -0,0 +1,54 @@
+/* SPDX-License-Identifier: MIT */
+/**************************************************************************************
+ *
+ * Copyright (c) 2025, Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserved.
+ *
+ **************************************************************************************/
+
+#ifndef __UNIXCONNECTOR__H
+#define __UNIXCONNECTOR__H
+
+#include <pthread.h>
+#include <sys/un.h>
+
+#include "OS_Includes.h"
+#include "MarshallerInternal.h"
+
+#ifdef __cplusplus
+  extern "C" {
+#endif
+
+#define UNIX_CONNECTOR_DEFAULT_PATH "/tmp/cifx_marshaller.sock"
+
+/*****************************************************************************/
+/*! Internal unix domain socket connector data                               */
+/*****************************************************************************/
+typedef struct UNIX_CONN_INTERNAL_Ttag
+{
+  uint32_t        ulConnectorIdx;
+  void*           pvMarshaller;
+
+  int             fRunning;
+  pthread_t       hThread;
+  pthread_mutex_t tLock;         /*!< Protects hClient against concurrent transmit */
+
+  SOCKET          hListen;
+  SOCKET          hClient;
+
+  uint8_t*        pbRxBuffer;    /*!< Receive buffer, holds one complete frame */
+  uint32_t        ulRxBufferSize;
+
+  char            szPath[sizeof(((struct sockaddr_un*)0)->sun_path)];
+
+  unsigned long   ulRxCount;
+  unsigned long   ulTxCount;
+
+} UNIX_CONN_INTERNAL_T;
+
+uint32_t  UnixConnectorInit(const HIL_MARSHALLER_CONNECTOR_PARAMS_T* ptParams, void* pvMarshaller);
+
+#ifdef __cplusplus
+  }
+#endif
+
+#endif /* __UNIXCONNECTOR__H */
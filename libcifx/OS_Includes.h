@@ -33,4 +33,11 @@
   #define CIFX_TOOLKIT_HWIF
 #endif
 
+#ifdef DEBUG
+  /* Real-time mode: functions marked with CIFX_TKIT_NOALLOC_SCOPE() must not allocate memory (see rt_linux.c) */
+  int  OS_NoAllocEnter(void);
+  void OS_NoAllocLeave(int* piScope);
+  #define CIFX_TKIT_NOALLOC_SCOPE() int iNoAllocScope __attribute__((cleanup(OS_NoAllocLeave), unused)) = OS_NoAllocEnter()
+#endif
+
 #endif /* __OS_INCLUDES__H */
@@ -12,6 +12,7 @@ Copyright (c) Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserv
   Changes:
     Date        Description
     -----------------------------------------------------------------------------------
+    2026-10-18  Added input change filter (xChannelIOSetChangeFilter(), xChannelIOReadChanged())
     2022-06-14  Added CIFX_IO_AREA_MASK definition
     2019-03-26  Added timeout definition for firmware update
     2018-11-19  - Update definitions and structures concerning xSysdeviceResetEx()
@@ -442,6 +443,18 @@ typedef __CIFx_PACKED_PRE struct PLC_MEMORY_INFORMATIONtag
   uint32_t*        pulIOAreaSize;        /*!< Memory size                            */
 } __CIFx_PACKED_POST PLC_MEMORY_INFORMATION;
 
+/*****************************************************************************/
+/*! Byte range of an input area watched by the change filter
+*   (see xChannelIOSetChangeFilter())                                        */
+/*****************************************************************************/
+#define CIFX_IO_MAX_CHANGE_RANGES             32
+
+typedef __CIFx_PACKED_PRE struct CIFX_IO_RANGEtag
+{
+  uint32_t         ulOffset;             /*!< Start offset inside the input area     */
+  uint32_t         ulLength;             /*!< Length of the range                    */
+} __CIFx_PACKED_POST CIFX_IO_RANGE;
+
 
 /***************************************************************************/
 /* Driver dependent information */
@@ -555,6 +568,8 @@ int32_t APIENTRY xChannelIOInfo              ( CIFXHANDLE  hChannel, uint32_t ul
 int32_t APIENTRY xChannelIORead              ( CIFXHANDLE  hChannel, uint32_t ulAreaNumber, uint32_t ulOffset,     uint32_t ulDataLen, void* pvData, uint32_t ulTimeout);
 int32_t APIENTRY xChannelIOWrite             ( CIFXHANDLE  hChannel, uint32_t ulAreaNumber, uint32_t ulOffset,     uint32_t ulDataLen, void* pvData, uint32_t ulTimeout);
 int32_t APIENTRY xChannelIOReadSendData      ( CIFXHANDLE  hChannel, uint32_t ulAreaNumber, uint32_t ulOffset,     uint32_t ulDataLen, void* pvData);
+int32_t APIENTRY xChannelIOSetChangeFilter   ( CIFXHANDLE  hChannel, uint32_t ulAreaNumber, uint32_t ulRangeCount, CIFX_IO_RANGE* ptRanges);
+int32_t APIENTRY xChannelIOReadChanged       ( CIFXHANDLE  hChannel, uint32_t ulAreaNumber, uint32_t ulOffset,     uint32_t ulDataLen, void* pvData, uint32_t ulTimeout, uint32_t* pulChangedRanges);
 
 int32_t APIENTRY xChannelControlBlock        ( CIFXHANDLE  hChannel, uint32_t ulCmd, uint32_t ulOffset, uint32_t ulDataLen, void* pvData);
 int32_t APIENTRY xChannelCommonStatusBlock   ( CIFXHANDLE  hChannel, uint32_t ulCmd, uint32_t ulOffset, uint32_t ulDataLen, void* pvData);
@@ -635,6 +650,8 @@ typedef int32_t (APIENTRY *PFN_XCHANNELIOINFO)             ( CIFXHANDLE  hChanne
 typedef int32_t (APIENTRY *PFN_XCHANNELIOREAD)             ( CIFXHANDLE  hChannel, uint32_t ulAreaNumber, uint32_t ulOffset,     uint32_t ulDataLen, void* pvData, uint32_t ulTimeout);
 typedef int32_t (APIENTRY *PFN_XCHANNELIOWRITE)            ( CIFXHANDLE  hChannel, uint32_t ulAreaNumber, uint32_t ulOffset,     uint32_t ulDataLen, void* pvData, uint32_t ulTimeout);
 typedef int32_t (APIENTRY *PFN_XCHANNELIOREADSENDDATA)     ( CIFXHANDLE  hChannel, uint32_t ulAreaNumber, uint32_t ulOffset,     uint32_t ulDataLen, void* pvData);
+typedef int32_t (APIENTRY *PFN_XCHANNELIOSETCHANGEFILTER)  ( CIFXHANDLE  hChannel, uint32_t ulAreaNumber, uint32_t ulRangeCount, CIFX_IO_RANGE* ptRanges);
+typedef int32_t (APIENTRY *PFN_XCHANNELIOREADCHANGED)      ( CIFXHANDLE  hChannel, uint32_t ulAreaNumber, uint32_t ulOffset,     uint32_t ulDataLen, void* pvData, uint32_t ulTimeout, uint32_t* pulChangedRanges);
 
 typedef int32_t (APIENTRY *PFN_XCHANNELCONTROLBLOCK)       ( CIFXHANDLE  hChannel, uint32_t ulCmd, uint32_t ulOffset, uint32_t ulDataLen, void* pvData);
 typedef int32_t (APIENTRY *PFN_XCHANNELCOMMONSTATUSBLOCK)  ( CIFXHANDLE  hChannel, uint32_t ulCmd, uint32_t ulOffset, uint32_t ulDataLen, void* pvData);
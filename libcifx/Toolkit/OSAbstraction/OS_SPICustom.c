@@ -12,6 +12,7 @@ Copyright (c) Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserv
   Changes:
     Date        Description
     -----------------------------------------------------------------------------------
+    2026-10-18  Added optional OS_SpiTransferV() (OS_SPI_HAS_TRANSFERV)
     2018-07-26  Added return value to OS_SpiInit()
     2014-08-27  created
 
@@ -93,6 +94,26 @@ void OS_SpiTransfer(void* pvOSDependent, uint8_t* pbSend, uint8_t* pbRecv, uint3
 {
 
 }
+
+#ifdef OS_SPI_HAS_TRANSFERV
+/*****************************************************************************/
+/*! Transfer several byte streams via SPI as one continuous transfer.
+*   Only needed if OS_SPI_HAS_TRANSFERV is defined. Replace the loop with
+*   a single bus transaction, if the target supports it.
+*   \param pvOSDependent OS Dependent parameter to identify card
+*   \param ptSegments    Segments to transfer in order
+*   \param ulCount       Number of segments                                  */
+/*****************************************************************************/
+void OS_SpiTransferV(void* pvOSDependent, const OS_SPI_SEGMENT_T* ptSegments, uint32_t ulCount)
+{
+  while(ulCount--)
+  {
+    if(ptSegments->ulLen > 0)
+      OS_SpiTransfer(pvOSDependent, ptSegments->pbSend, ptSegments->pbRecv, ptSegments->ulLen);
+    ++ptSegments;
+  }
+}
+#endif
 /*****************************************************************************/
 /*! \}                                                                       */
 /*****************************************************************************/
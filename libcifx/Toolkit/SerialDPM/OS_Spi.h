@@ -12,6 +12,7 @@ Copyright (c) Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserv
   Changes:
     Date        Description
     -----------------------------------------------------------------------------------
+    2026-10-18  Added optional OS_SpiTransferV() (vectored transfer, OS_SPI_HAS_TRANSFERV)
     2014-08-01  initial version
 
 **************************************************************************************/
@@ -31,6 +32,16 @@ extern "C"
 {
 #endif
 
+/*****************************************************************************/
+/*! Segment of a vectored SPI transfer (see OS_SpiTransferV())               */
+/*****************************************************************************/
+typedef struct OS_SPI_SEGMENT_Ttag
+{
+  uint8_t* pbSend;  /*!< Send buffer (NULL = send dummy bytes)      */
+  uint8_t* pbRecv;  /*!< Receive buffer (NULL = discard received bytes) */
+  uint32_t ulLen;   /*!< Length of the segment                      */
+} OS_SPI_SEGMENT_T;
+
 /*****************************************************************************/
 /*! Initialize SPI components
 *   \param pvOSDependent OS Dependent parameter
@@ -75,6 +86,22 @@ void OS_SpiUnlock(void* pvOSDependent);
 /*****************************************************************************/
 void OS_SpiTransfer(void* pvOSDependent, uint8_t* pbSend, uint8_t* pbRecv, uint32_t ulLen);
 
+#ifdef OS_SPI_HAS_TRANSFERV
+/*****************************************************************************/
+/*! Transfer several byte streams via SPI as one continuous transfer (chip
+*   select stays asserted). Every segment follows the rules of
+*   OS_SpiTransfer(), segments with ulLen 0 are skipped. Allows the target
+*   to issue a single bus transaction (e.g. one DMA transfer or one spidev
+*   SPI_IOC_MESSAGE(n) ioctl) for command header and data.
+*   Optional, only used if the port defines OS_SPI_HAS_TRANSFERV. Otherwise
+*   the segments are passed to OS_SpiTransfer() one by one.
+*   \param pvOSDependent OS Dependent parameter
+*   \param ptSegments    Segments to transfer in order
+*   \param ulCount       Number of segments                                  */
+/*****************************************************************************/
+void OS_SpiTransferV(void* pvOSDependent, const OS_SPI_SEGMENT_T* ptSegments, uint32_t ulCount);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
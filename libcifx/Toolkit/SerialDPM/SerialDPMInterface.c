@@ -12,6 +12,10 @@ Copyright (c) Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserv
   Changes:
     Date        Description
     -----------------------------------------------------------------------------------
+    2026-10-18  - Read/write functions transfer command and data of a chunk with a single
+                  OS_SpiTransfer() / OS_SpiTransferV() (OS_SPI_HAS_TRANSFERV) call instead of one
+                  call per byte
+                - Read_NX50() / Read_NX500() release the SPI lock on ready byte timeout
     2023-05-10  Adapted netX Read/Write function definitions to new ulOption parameter
     2019-08-06  Chip detection loop in SerialDPM_Init() reworked
     2018-08-09  fixed pclint warnings
@@ -46,6 +50,28 @@ Copyright (c) Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserv
   #error "CIFX_TOOLKIT_HWIF must be explicitly enabled to support serial DPM!"
 #endif
 
+/*****************************************************************************/
+/*! Transfer several byte streams via SPI as one continuous transfer. Uses
+*   OS_SpiTransferV() if the port provides it (OS_SPI_HAS_TRANSFERV),
+*   otherwise every segment is passed to OS_SpiTransfer().
+*   \param pvDevInstance  Device Instance
+*   \param ptSegments     Segments to transfer in order
+*   \param ulCount        Number of segments                                 */
+/*****************************************************************************/
+static void SerialDPM_TransferV(void* pvDevInstance, const OS_SPI_SEGMENT_T* ptSegments, uint32_t ulCount)
+{
+#ifdef OS_SPI_HAS_TRANSFERV
+  OS_SpiTransferV(pvDevInstance, ptSegments, ulCount);
+#else
+  while(ulCount--)
+  {
+    if(ptSegments->ulLen > 0)
+      OS_SpiTransfer(pvDevInstance, ptSegments->pbSend, ptSegments->pbRecv, ptSegments->ulLen);
+    ++ptSegments;
+  }
+#endif
+}
+
 /*****************************************************************************/
 /*! Read a number of bytes from SPI interface (netX50 Slave)
 *   \param ulOption       0 = memcpy / 1 = single transfer
@@ -61,6 +87,10 @@ static void* Read_NX50( uint32_t ulOption, void* pvDevInstance, void* pvAddr, vo
   uint32_t        ulByteTimeout = 100;
   uint32_t        ulDpmAddr     = (uint32_t)pvAddr;
   uint8_t*        pabData       = (uint8_t*)pvData;
+  uint8_t         abFill[MAX_TRANSFER_LEN];
+
+  /* Data is clocked out with the ready byte as fill pattern */
+  OS_Memset(abFill, 0xA5, sizeof(abFill));
 
   OS_SpiLock(ptDevice->pvOSDependent);
   while (ulLen > 0)
@@ -78,11 +108,14 @@ static void* Read_NX50( uint32_t ulOption, void* pvDevInstance, void* pvAddr, vo
     OS_SpiAssert(pvDevInstance);
     OS_SpiTransfer(pvDevInstance, abSend, NULL, MAX_CNT(abSend));
 
+    /* The number of idle bytes before the ready byte is not fixed. Poll them one by one, */
+    /* so no more bytes than requested are clocked out of the slave.                      */
     do
     {
       if(ulByteTimeout == 0)
       {
           OS_SpiDeassert(pvDevInstance);
+          OS_SpiUnlock(ptDevice->pvOSDependent);
           return pvData;
       }
       --ulByteTimeout;
@@ -92,14 +125,12 @@ static void* Read_NX50( uint32_t ulOption, void* pvDevInstance, void* pvAddr, vo
 
     } while((bUnused & 0xFF) != 0xA5);
 
-    while(ulChunkLen--)
-    {
-      OS_SpiTransfer(pvDevInstance, &bUnused, pabData++, 1);
-    }
+    OS_SpiTransfer(pvDevInstance, abFill, pabData, ulChunkLen);
 
     OS_SpiDeassert(pvDevInstance);
 
-    ulDpmAddr += MAX_TRANSFER_LEN;
+    ulDpmAddr += ulChunkLen;
+    pabData   += ulChunkLen;      /*lint !e662 */
   }
   OS_SpiUnlock(ptDevice->pvOSDependent);
 
@@ -116,9 +147,10 @@ static void* Read_NX50( uint32_t ulOption, void* pvDevInstance, void* pvAddr, vo
 /*****************************************************************************/
 static void* Write_NX50( uint32_t ulOption, void* pvDevInstance, void* pvAddr, void* pvData, uint32_t ulLen)
 {
-  DEVICEINSTANCE* ptDevice  = (DEVICEINSTANCE*) pvDevInstance;
-  uint32_t        ulDpmAddr = (uint32_t)pvAddr;
-  uint8_t*        pabData   = (uint8_t*)pvData;
+  DEVICEINSTANCE*  ptDevice      = (DEVICEINSTANCE*) pvDevInstance;
+  uint32_t         ulDpmAddr     = (uint32_t)pvAddr;
+  uint8_t*         pabData       = (uint8_t*)pvData;
+  OS_SPI_SEGMENT_T atSegments[2] = {{0}};
 
   OS_SpiLock(ptDevice->pvOSDependent);
   while (ulLen > 0)
@@ -133,9 +165,13 @@ static void* Write_NX50( uint32_t ulOption, void* pvDevInstance, void* pvAddr, v
     abSend[1] = (uint8_t)((ulDpmAddr >> 0) & 0xFF);
     abSend[2] = (uint8_t)ulChunkLen;
 
+    atSegments[0].pbSend = abSend;
+    atSegments[0].ulLen  = MAX_CNT(abSend);
+    atSegments[1].pbSend = pabData;
+    atSegments[1].ulLen  = ulChunkLen;
+
     OS_SpiAssert(pvDevInstance);
-    OS_SpiTransfer(pvDevInstance, abSend, NULL, MAX_CNT(abSend));
-    OS_SpiTransfer(pvDevInstance, pabData, NULL, ulChunkLen);
+    SerialDPM_TransferV(pvDevInstance, atSegments, MAX_CNT(atSegments));
     OS_SpiDeassert(pvDevInstance);
 
     ulDpmAddr += ulChunkLen;
@@ -156,12 +192,13 @@ static void* Write_NX50( uint32_t ulOption, void* pvDevInstance, void* pvAddr, v
 /*****************************************************************************/
 static void* Read_NX500( uint32_t ulOption, void* pvDevInstance, void* pvAddr, void* pvData, uint32_t ulLen)
 {
-  DEVICEINSTANCE* ptDevice      = (DEVICEINSTANCE*) pvDevInstance;
-  uint8_t         bUnused       = 0x00;
-  uint32_t        ulByteTimeout = 100;
-  uint32_t        ulDpmAddr     = (uint32_t)pvAddr;
-  uint8_t*        pabData       = (uint8_t*)pvData;
-  uint32_t        ulPreLen      = ulDpmAddr&0x3;
+  DEVICEINSTANCE*  ptDevice      = (DEVICEINSTANCE*) pvDevInstance;
+  uint8_t          bUnused       = 0x00;
+  uint32_t         ulByteTimeout = 100;
+  uint32_t         ulDpmAddr     = (uint32_t)pvAddr;
+  uint8_t*         pabData       = (uint8_t*)pvData;
+  uint32_t         ulPreLen      = ulDpmAddr&0x3;
+  OS_SPI_SEGMENT_T atSegments[3] = {{0}};
 
   /* Align offset and length */
   ulDpmAddr &= ~0x3;
@@ -184,11 +221,13 @@ static void* Read_NX500( uint32_t ulOption, void* pvDevInstance, void* pvAddr, v
     OS_SpiAssert(pvDevInstance);
     OS_SpiTransfer(pvDevInstance, abSend, NULL, MAX_CNT(abSend));
 
+    /* Poll the idle bytes one by one (see Read_NX50()) */
     do
     {
       if(ulByteTimeout == 0)
       {
           OS_SpiDeassert(pvDevInstance);
+          OS_SpiUnlock(ptDevice->pvOSDependent);
           return pvData;
       }
       --ulByteTimeout;
@@ -198,18 +237,14 @@ static void* Read_NX500( uint32_t ulOption, void* pvDevInstance, void* pvAddr, v
 
     } while((bUnused & 0xFF) != 0xA5);
 
-    if (ulPreLen)
-    {
-      OS_SpiTransfer(pvDevInstance, NULL, NULL, ulPreLen);
-      ulPreLen = 0;
-    }
+    /* Skip unaligned start, read data and discard alignment bytes in one transfer */
+    atSegments[0].ulLen  = ulPreLen;
+    atSegments[1].pbRecv = pabData;
+    atSegments[1].ulLen  = ulChunkLen;
+    atSegments[2].ulLen  = ulAlignedLen - ulChunkLen;
+    ulPreLen             = 0;
 
-    OS_SpiTransfer(pvDevInstance, NULL, pabData, ulChunkLen);
-
-    if (0 != (ulAlignedLen - ulChunkLen))
-    {
-      OS_SpiTransfer(pvDevInstance, NULL, NULL, ulAlignedLen - ulChunkLen);
-    }
+    SerialDPM_TransferV(pvDevInstance, atSegments, MAX_CNT(atSegments));
 
     OS_SpiDeassert(pvDevInstance);
 
@@ -285,18 +320,23 @@ static void* ReadModifyWrite_NX500( uint32_t ulOption, void* pvDevInstance, void
 /*****************************************************************************/
 static void* Read_NX10( uint32_t ulOption, void* pvDevInstance, void* pvAddr, void* pvData, uint32_t ulLen)
 {
-  DEVICEINSTANCE* ptDevice = (DEVICEINSTANCE*) pvDevInstance;
-  uint8_t         abSend[3];
+  DEVICEINSTANCE*  ptDevice      = (DEVICEINSTANCE*) pvDevInstance;
+  uint8_t          abSend[3];
+  OS_SPI_SEGMENT_T atSegments[2] = {{0}};
 
   /* Assemble command */
   abSend[0] = (uint8_t)(((uint32_t)pvAddr >> 8) & 0xFF);
   abSend[1] = (uint8_t)(((uint32_t)pvAddr >> 0) & 0xFF);
   abSend[2] = (uint8_t)(CMD_READ_NX10(ulLen));
 
+  atSegments[0].pbSend = abSend;
+  atSegments[0].ulLen  = MAX_CNT(abSend);
+  atSegments[1].pbRecv = (uint8_t*)pvData;
+  atSegments[1].ulLen  = ulLen;
+
   OS_SpiLock(ptDevice->pvOSDependent);
   OS_SpiAssert(pvDevInstance);
-  OS_SpiTransfer(pvDevInstance, abSend, NULL, MAX_CNT(abSend));
-  OS_SpiTransfer(pvDevInstance, NULL, (uint8_t*)pvData, ulLen);
+  SerialDPM_TransferV(pvDevInstance, atSegments, MAX_CNT(atSegments));
   OS_SpiDeassert(pvDevInstance);
   OS_SpiUnlock(ptDevice->pvOSDependent);
   return pvData;
@@ -312,18 +352,23 @@ static void* Read_NX10( uint32_t ulOption, void* pvDevInstance, void* pvAddr, vo
 /*****************************************************************************/
 static void* Write_NX10( uint32_t ulOption, void* pvDevInstance, void* pvAddr, void* pvData, uint32_t ulLen)
 {
-  DEVICEINSTANCE* ptDevice = (DEVICEINSTANCE*) pvDevInstance;
-  uint8_t         abSend[3];
+  DEVICEINSTANCE*  ptDevice      = (DEVICEINSTANCE*) pvDevInstance;
+  uint8_t          abSend[3];
+  OS_SPI_SEGMENT_T atSegments[2] = {{0}};
 
   /* Assemble command */
   abSend[0] = (uint8_t)(((uint32_t)pvAddr >> 8) & 0xFF);
   abSend[1] = (uint8_t)(((uint32_t)pvAddr >> 0) & 0xFF);
   abSend[2] = (uint8_t)(CMD_WRITE_NX10(ulLen));
 
+  atSegments[0].pbSend = abSend;
+  atSegments[0].ulLen  = MAX_CNT(abSend);
+  atSegments[1].pbSend = (uint8_t*)pvData;
+  atSegments[1].ulLen  = ulLen;
+
   OS_SpiLock(ptDevice->pvOSDependent);
   OS_SpiAssert(pvDevInstance);
-  OS_SpiTransfer(pvDevInstance, abSend, NULL, MAX_CNT(abSend));
-  OS_SpiTransfer(pvDevInstance, (uint8_t*)pvData, NULL, ulLen);
+  SerialDPM_TransferV(pvDevInstance, atSegments, MAX_CNT(atSegments));
   OS_SpiDeassert(pvDevInstance);
   OS_SpiUnlock(ptDevice->pvOSDependent);
   return pvAddr;
@@ -339,8 +384,9 @@ static void* Write_NX10( uint32_t ulOption, void* pvDevInstance, void* pvAddr, v
 /*****************************************************************************/
 static void* Read_NX51( uint32_t ulOption, void* pvDevInstance, void* pvAddr, void* pvData, uint32_t ulLen)
 {
-  DEVICEINSTANCE* ptDevice = (DEVICEINSTANCE*) pvDevInstance;
-  uint8_t         abSend[4];
+  DEVICEINSTANCE*  ptDevice      = (DEVICEINSTANCE*) pvDevInstance;
+  uint8_t          abSend[4];
+  OS_SPI_SEGMENT_T atSegments[2] = {{0}};
 
   /* Assemble command */
   abSend[0] = (uint8_t)(CMD_READ_NX51((uint32_t)pvAddr));
@@ -348,10 +394,14 @@ static void* Read_NX51( uint32_t ulOption, void* pvDevInstance, void* pvAddr, vo
   abSend[2] = (uint8_t)(((uint32_t)pvAddr >> 0) & 0xFF);
   abSend[3] = (uint8_t)(CMD_LEN_NX51(ulLen));
 
+  atSegments[0].pbSend = abSend;
+  atSegments[0].ulLen  = MAX_CNT(abSend);
+  atSegments[1].pbRecv = (uint8_t*)pvData;
+  atSegments[1].ulLen  = ulLen;
+
   OS_SpiLock(ptDevice->pvOSDependent);
   OS_SpiAssert(pvDevInstance);
-  OS_SpiTransfer(pvDevInstance, abSend, NULL, MAX_CNT(abSend));
-  OS_SpiTransfer(pvDevInstance, NULL, (uint8_t*)pvData, ulLen);
+  SerialDPM_TransferV(pvDevInstance, atSegments, MAX_CNT(atSegments));
   OS_SpiDeassert(pvDevInstance);
   OS_SpiUnlock(ptDevice->pvOSDependent);
   return pvData;
@@ -367,18 +417,23 @@ static void* Read_NX51( uint32_t ulOption, void* pvDevInstance, void* pvAddr, vo
 /*****************************************************************************/
 static void* Write_NX51( uint32_t ulOption, void* pvDevInstance, void* pvAddr, void* pvData, uint32_t ulLen)
 {
-  DEVICEINSTANCE* ptDevice = (DEVICEINSTANCE*) pvDevInstance;
-  uint8_t         abSend[3];
+  DEVICEINSTANCE*  ptDevice      = (DEVICEINSTANCE*) pvDevInstance;
+  uint8_t          abSend[3];
+  OS_SPI_SEGMENT_T atSegments[2] = {{0}};
 
   /* Assemble command */
   abSend[0] = (uint8_t)(CMD_WRITE_NX51((uint32_t)pvAddr));
   abSend[1] = (uint8_t)(((uint32_t)pvAddr >> 8) & 0xFF);
   abSend[2] = (uint8_t)(((uint32_t)pvAddr >> 0) & 0xFF);
 
+  atSegments[0].pbSend = abSend;
+  atSegments[0].ulLen  = MAX_CNT(abSend);
+  atSegments[1].pbSend = (uint8_t*)pvData;
+  atSegments[1].ulLen  = ulLen;
+
   OS_SpiLock(ptDevice->pvOSDependent);
   OS_SpiAssert(pvDevInstance);
-  OS_SpiTransfer(pvDevInstance, abSend, NULL, MAX_CNT(abSend));
-  OS_SpiTransfer(pvDevInstance, (uint8_t*)pvData, NULL, ulLen);
+  SerialDPM_TransferV(pvDevInstance, atSegments, MAX_CNT(atSegments));
   OS_SpiDeassert(pvDevInstance);
   OS_SpiUnlock(ptDevice->pvOSDependent);
   return pvAddr;
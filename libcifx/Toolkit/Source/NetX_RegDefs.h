@@ -12,6 +12,7 @@ Copyright (c) Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserv
   Changes:
     Date        Description
     -----------------------------------------------------------------------------------
+    2026-10-18  Added default reset/startup wait times for the adaptive device startup
     2016-04-07  Lint: Added guard for _MSC_VER to allow compilation using -wundef
     2010-04-21  DMA Triple Buffer definition updated (was an error in manual)
     2006-12-06  obsoleted #pragma once removed
@@ -46,10 +47,14 @@ Copyright (c) Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserv
 #define NETX_DPM_MEMORY_SIZE          0x10000
 #define NETX_DPM_REGBLOCK_SIZE        0x200
 
-#define NET_BOOTLOADER_RESET_TIME     500
+#define NET_BOOTLOADER_RESET_TIME     500   /* PCI devices, PCI configuration is restored after this time */
+#define NET_BOOTLOADER_RESET_TIME_DPM 500   /* DPM devices, DPM is polled after this time (may be lowered by tBootTiming) */
 #define NET_BOOTLOADER_STARTUP_CYCLES 50
 #define NET_BOOTLOADER_STARTUP_WAIT   100
 #define NET_BOOTLOADER_STARTUP_TIME   2000
+#define NET_BOOTLOADER_POLL_MIN       1     /* First poll interval while waiting for the device */
+#define NET_BOOTLOADER_POLL_MAX       10    /* Poll interval limit while waiting for the device */
+#define NET_NETX4000_PCI_RESET_TIME   1000  /* No DPM access during reset of netX4000/4100 PCI devices */
 
 /*****************************************************************************/
 /* Structures and Basic DPM Layout structures                                */
@@ -12,6 +12,9 @@ Copyright (c) Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserv
   Changes:
     Date        Description
     -----------------------------------------------------------------------------------
+    2026-10-18  Pipelined file data transfer in DEV_DownloadFile() for the DPM mailbox
+                (DEV_TransferPacket), see DEV_DownloadFileData(),
+                opt-in by CIFX_TKIT_DOWNLOAD_WINDOW > 1
     2023-04-21  Added file size 0 check and sending abort cmd in DEV_UploadFile(),
                 to prevent ERR_HIL_RESOURCE_IN_USE because of not executed HIL_FILE_UPLOAD_DATA_REQ
     2021-08-13  Removed "\r\n" from trace strings, now generally handled in USER-Trace()
@@ -898,6 +901,240 @@ int32_t DEV_ProcessFWDownload( PDEVICEINSTANCE       ptDevInstance,
   return lRet;
 } /*lint !e429 : pbBuffer not freed or returned */
 
+/*****************************************************************************/
+/*! Transfers the file data of a download via the mailbox of the channel.
+*   The next data packet is prepared (copy, CRC) and the progress callback is
+*   executed while the device handles the packets already sent. If
+*   CIFX_TKIT_DOWNLOAD_WINDOW is defined > 1 (default 1) and the mailbox
+*   accepts more than one packet (usPackagesAccepted), up to
+*   CIFX_TKIT_DOWNLOAD_WINDOW data packets are sent before waiting for a
+*   confirmation.
+*   \param ptChannel          Channel instance the download is performed on
+*   \param szFileName         File name (trace output only)
+*   \param ulSrc              Source identifier of the download packets
+*   \param pulCurrentId       Packet identifier, updated to the last identifier used
+*   \param ulTransferType     Type of transfer (see HIL_FILE_XFER_XXX defines)
+*   \param ulFileLength       Length of the file to download
+*   \param pabData            File data being downloaded
+*   \param ulMaxDataLength    Data length per packet
+*   \param ulTransferTimeout  Timeout for a single packet
+*   \param pfnCallback        User callback for download progress indications
+*   \param pfnRecvPktCallback User callback for unsolicited receive packets
+*   \param pvUser             User parameter passed on callback
+*   \return CIFX_NO_ERROR on success                                         */
+/*****************************************************************************/
+static int32_t DEV_DownloadFileData(PCHANNELINSTANCE      ptChannel,
+                                    char*                 szFileName,
+                                    uint32_t              ulSrc,
+                                    uint32_t*             pulCurrentId,
+                                    uint32_t              ulTransferType,
+                                    uint32_t              ulFileLength,
+                                    uint8_t*              pabData,
+                                    uint32_t              ulMaxDataLength,
+                                    uint32_t              ulTransferTimeout,
+                                    PFN_PROGRESS_CALLBACK pfnCallback,
+                                    PFN_RECV_PKT_CALLBACK pfnRecvPktCallback,
+                                    void*                 pvUser)
+{
+  union
+  {
+    CIFX_PACKET                   tPacket;
+    HIL_FILE_DOWNLOAD_DATA_REQ_T  tDownloadDataReq;
+  }          uSendPkt;
+  union
+  {
+    CIFX_PACKET                   tPacket;
+    HIL_FILE_DOWNLOAD_DATA_CNF_T  tDownloadDataCnf;
+  }          uRecvPkt;
+
+  PDEVICEINSTANCE ptDevInstance   = (PDEVICEINSTANCE)ptChannel->pvDeviceInstance;
+  uint32_t   ulWindow             = LE16_TO_HOST(HWIF_READ16(ptDevInstance, ptChannel->tSendMbx.ptSendMailboxStart->usPackagesAccepted));
+  uint32_t   ulSendLen            = 0;  /* Data length of the prepared packet, 0 if none is prepared */
+  uint32_t   ulSentLength         = 0;  /* File data sent to the device */
+  uint32_t   ulTransferedLength   = 0;  /* File data confirmed by the device */
+  uint32_t   ulOutstanding        = 0;  /* Data packets sent, but not yet confirmed */
+  uint32_t   ulMaxOutstanding     = 0;  /* Maximum number of packets in flight */
+  uint32_t   ulNextCnfId          = *pulCurrentId + 1;
+  uint32_t   ulCRC                = 0;
+  uint32_t   ulBlockNumber        = 0;
+  uint32_t   ulStartTime          = OS_GetMilliSecCounter();
+  uint32_t   ulLastActivity       = ulStartTime;
+  int32_t    lCount               = 0;
+  int32_t    lRet                 = CIFX_NO_ERROR;
+
+  if(ulWindow > CIFX_TKIT_DOWNLOAD_WINDOW)
+    ulWindow = CIFX_TKIT_DOWNLOAD_WINDOW;
+  if(0 == ulWindow)
+    ulWindow = 1;
+
+  OS_Memset(&uSendPkt, 0, sizeof(uSendPkt));
+  OS_Memset(&uRecvPkt, 0, sizeof(uRecvPkt));
+
+  while( (CIFX_NO_ERROR == lRet) && (ulTransferedLength < ulFileLength) )
+  {
+    uint32_t ulElapsed;
+    uint32_t ulWait;
+    int      fRetrySend = 0;
+
+    /* Prepare the next data packet, while the device handles the previous ones */
+    if( (0 == ulSendLen) && (ulSentLength < ulFileLength) )
+    {
+      uint32_t ulCmdDataState;
+
+      ulSendLen = ulFileLength - ulSentLength;
+      if(ulSendLen > ulMaxDataLength)
+        ulSendLen = ulMaxDataLength;
+
+      if(0 == ulSentLength)
+        ulCmdDataState = (ulSendLen == ulFileLength) ? HIL_PACKET_SEQ_NONE : HIL_PACKET_SEQ_FIRST;
+      else if((ulSentLength + ulSendLen) == ulFileLength)
+        ulCmdDataState = HIL_PACKET_SEQ_LAST;
+      else
+        ulCmdDataState = HIL_PACKET_SEQ_MIDDLE;
+
+      ++(*pulCurrentId);
+      uSendPkt.tDownloadDataReq.tHead.ulDest     = HOST_TO_LE32(HIL_PACKET_DEST_SYSTEM);
+      uSendPkt.tDownloadDataReq.tHead.ulSrc      = HOST_TO_LE32(ulSrc);
+      uSendPkt.tDownloadDataReq.tHead.ulDestId   = HOST_TO_LE32(0);
+      uSendPkt.tDownloadDataReq.tHead.ulSrcId    = HOST_TO_LE32(0);
+      uSendPkt.tDownloadDataReq.tHead.ulSta      = HOST_TO_LE32(0);
+      uSendPkt.tDownloadDataReq.tHead.ulRout     = HOST_TO_LE32(0);
+      uSendPkt.tDownloadDataReq.tHead.ulCmd      = HOST_TO_LE32(HIL_FILE_DOWNLOAD_DATA_REQ);
+      uSendPkt.tDownloadDataReq.tHead.ulId       = HOST_TO_LE32(*pulCurrentId);
+      uSendPkt.tDownloadDataReq.tHead.ulExt      = HOST_TO_LE32(ulCmdDataState);
+      uSendPkt.tDownloadDataReq.tHead.ulLen      = HOST_TO_LE32((uint32_t)(sizeof(HIL_FILE_DOWNLOAD_DATA_REQ_DATA_T) +
+                                                                           ulSendLen));
+
+      /* Copy file data to packet and create continued CRC */
+      OS_Memcpy( &uSendPkt.tDownloadDataReq.tData + 1, pabData + ulSentLength, ulSendLen);
+      ulCRC = CreateCRC32( ulCRC, pabData + ulSentLength, ulSendLen);
+      uSendPkt.tDownloadDataReq.tData.ulChksum   = HOST_TO_LE32(ulCRC);
+      uSendPkt.tDownloadDataReq.tData.ulBlockNo  = HOST_TO_LE32(ulBlockNumber);
+      ++ulBlockNumber;
+
+      /* ATTENTION: Module loading will relocate the module with the last packet.
+         So the confirmation packet takes longer, depending on the file size
+         (and contained firmware). Measurements showed that for every 100kB
+         the module needs one additional second for relocation */
+      if( (HIL_PACKET_SEQ_LAST == ulCmdDataState) &&
+          (HIL_FILE_XFER_MODULE == ulTransferType) )
+        ulTransferTimeout += (ulFileLength / (100 * 1024)) * 1000;
+    }
+
+    /* Send the prepared packet, if the device accepts another one */
+    if( (0 != ulSendLen) && (ulOutstanding < ulWindow) )
+    {
+      /* Only wait for the mailbox, if there is no confirmation to wait for */
+      lRet = DEV_PutPacket(ptChannel, &uSendPkt.tPacket, (0 == ulOutstanding) ? ulTransferTimeout : 0);
+
+      if(CIFX_NO_ERROR == lRet)
+      {
+        if(++ulOutstanding > ulMaxOutstanding)
+          ulMaxOutstanding = ulOutstanding;
+        ulSentLength  += ulSendLen;
+        ulSendLen      = 0;
+        ulLastActivity = OS_GetMilliSecCounter();
+        continue;
+
+      } else if( (CIFX_DEV_MAILBOX_FULL != lRet) || (0 == ulOutstanding) )
+      {
+        break;
+      }
+
+      /* The device may not take the packet, before we have read a confirmation */
+      lRet       = CIFX_NO_ERROR;
+      fRetrySend = 1;
+    }
+
+    /* Wait for the confirmation of the oldest outstanding packet */
+    ulElapsed = OS_GetMilliSecCounter() - ulLastActivity;
+    ulWait    = (ulElapsed < ulTransferTimeout) ? (ulTransferTimeout - ulElapsed) : 0;
+    if(fRetrySend && (ulWait > 1))
+      ulWait = 1;
+
+    lRet = DEV_GetPacket(ptChannel, &uRecvPkt.tPacket, (uint32_t)sizeof(uRecvPkt.tPacket), ulWait);
+
+    if(CIFX_DEV_GET_NO_PACKET == lRet)
+    {
+      if(fRetrySend && (ulElapsed < ulTransferTimeout))
+        lRet = CIFX_NO_ERROR;
+
+    } else if(CIFX_NO_ERROR == lRet)
+    {
+      if( (LE32_TO_HOST(uRecvPkt.tPacket.tHeader.ulCmd) == (HIL_FILE_DOWNLOAD_DATA_REQ | HIL_MSK_PACKET_ANSWER)) &&
+          (LE32_TO_HOST(uRecvPkt.tPacket.tHeader.ulSrc) == ulSrc)                                             &&
+          (LE32_TO_HOST(uRecvPkt.tPacket.tHeader.ulId)  == ulNextCnfId)                                       &&
+          (uRecvPkt.tPacket.tHeader.ulSrcId == 0)                                                              )
+      {
+        uint32_t ulCnfLen = ulFileLength - ulTransferedLength;
+
+        if(ulCnfLen > ulMaxDataLength)
+          ulCnfLen = ulMaxDataLength;
+
+        ++ulNextCnfId;
+        --ulOutstanding;
+        lCount         = 0;
+        ulLastActivity = OS_GetMilliSecCounter();
+
+        if(SUCCESS_HIL_OK == (lRet = LE32_TO_HOST((int32_t)(uRecvPkt.tDownloadDataCnf.tHead.ulSta))))
+        {
+          ulTransferedLength += ulCnfLen;
+
+          /* Indicate progress, if user wants a notification */
+          if(pfnCallback)
+            pfnCallback(ulTransferedLength, ulFileLength, pvUser,
+                        (ulTransferedLength == ulFileLength) ? CIFX_CALLBACK_FINISHED : CIFX_CALLBACK_ACTIVE,
+                        lRet);
+        }
+      } else
+      {
+        /* This is not our packet, check if the user wants it */
+        if(NULL != pfnRecvPktCallback)
+          pfnRecvPktCallback(&uRecvPkt.tPacket, pvUser);
+
+        /* Same limit of unrelated packets as in DEV_TransferPacket() */
+        if(++lCount >= 10)
+          lRet = CIFX_DEV_GET_TIMEOUT;
+      }
+    }
+  }
+
+  if(CIFX_NO_ERROR != lRet)
+  {
+    /* Read the confirmations of the packets still handled by the device,
+       so they are not taken as answer to the abort request */
+    while( (ulOutstanding > 0) &&
+           (CIFX_NO_ERROR == DEV_GetPacket(ptChannel, &uRecvPkt.tPacket, (uint32_t)sizeof(uRecvPkt.tPacket), ulTransferTimeout)) )
+    {
+      if( (LE32_TO_HOST(uRecvPkt.tPacket.tHeader.ulCmd) == (HIL_FILE_DOWNLOAD_DATA_REQ | HIL_MSK_PACKET_ANSWER)) &&
+          (LE32_TO_HOST(uRecvPkt.tPacket.tHeader.ulSrc) == ulSrc)                                             )
+        --ulOutstanding;
+      else if(NULL != pfnRecvPktCallback)
+        pfnRecvPktCallback(&uRecvPkt.tPacket, pvUser);
+    }
+
+    if(pfnCallback)
+      pfnCallback(ulTransferedLength, ulFileLength, pvUser, CIFX_CALLBACK_FINISHED, lRet);
+
+  } else if(g_ulTraceLevel & TRACE_LEVEL_INFO)
+  {
+    uint32_t ulTime  = OS_GetMilliSecCounter() - ulStartTime;
+    uint32_t ulRate;
+
+    if(0 == ulTime)
+      ulTime = 1;
+    ulRate = ulFileLength / ulTime; /* bytes per ms = kB/s */
+
+    USER_Trace(ptDevInstance,
+               TRACE_LEVEL_INFO,
+               "Download of '%s' finished: %u bytes in %u ms (%u.%03u MB/s, max. %u packets in flight)",
+               szFileName, (unsigned int)ulFileLength, (unsigned int)ulTime,
+               (unsigned int)(ulRate / 1000), (unsigned int)(ulRate % 1000), (unsigned int)ulMaxOutstanding);
+  }
+
+  return lRet;
+}
+
 /*****************************************************************************/
 /*! Download a file to the hardware
 *   \param pvChannel          Channel instance the download is performed on
@@ -1074,6 +1311,19 @@ int32_t DEV_DownloadFile(void*                 pvChannel,
 
       /* Data download packets */
       case HIL_FILE_DOWNLOAD_DATA_REQ:
+      if(DEV_TransferPacket == pfnTransferPacket)
+      {
+        /* Transfer via the mailbox of the toolkit, so the data can be pipelined */
+        lRet = DEV_DownloadFileData((PCHANNELINSTANCE)pvChannel, szFileName, ulSrc, &ulCurrentId,
+                                    ulTransferType, ulFileLength, pabActData, ulMaxDataLength,
+                                    ulTransferTimeout, pfnCallback, pfnRecvPktCallback, pvUser);
+
+        if(CIFX_NO_ERROR != lRet)
+          ulState = HIL_FILE_DOWNLOAD_ABORT_REQ;
+        else
+          fStopDownload = 1;
+
+      } else
       {
         ++ulCurrentId;
         uSendPkt.tDownloadDataReq.tHead.ulDest     = HOST_TO_LE32(HIL_PACKET_DEST_SYSTEM);
@@ -12,6 +12,10 @@ Copyright (c) Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserv
   Changes:
     Date        Description
     -----------------------------------------------------------------------------------
+    2026-10-18  - Convert each table entry with a width specific swap routine instead of
+                  per element copies, long runs are swapped 16 bytes at a time
+                - Support offsets != 0 and convert the last element of the buffer
+                - Added cifXSwapEndianess() and cifXConvertEndianessIO()
     2019-10-11  Change prototype of endianess conversion function
     2018-10-10  - Updated header and definitions to new Hilscher defines
                 - Derived from cifX Toolkit V1.6.0.0
@@ -27,94 +31,191 @@ Copyright (c) Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserv
 #include "cifXErrors.h"
 #include "cifXEndianess.h"
 
+#if defined(__GNUC__) && !defined(__clang__) && \
+    (defined(__ALTIVEC__) || defined(__SSSE3__) || defined(__ARM_NEON))
+  /* GCC vector extension, mapped to the byte shuffle of the target (AltiVec vperm, SSSE3 pshufb,
+     NEON tbl). Targets without a byte shuffle use the scalar loop, which is faster there. */
+  #define CIFX_ENDIANESS_VECTOR_SWAP
+  typedef uint8_t CIFX_ENDIANESS_VEC_T __attribute__((vector_size(16)));
+#endif
+
+#ifdef __GNUC__
+  /* fixed size copies are inlined as single (unaligned) loads and stores */
+  #define CIFX_ENDIANESS_COPY(d, s, l) __builtin_memcpy(d, s, l)
+  #define CIFX_BSWAP16(a) __builtin_bswap16(a)
+  #define CIFX_BSWAP32(a) __builtin_bswap32(a)
+  #define CIFX_BSWAP64(a) __builtin_bswap64(a)
+#else
+  #define CIFX_ENDIANESS_COPY(d, s, l) OS_Memcpy(d, s, l)
+  #define CIFX_BSWAP16(a) ((uint16_t)((((a) & 0x00FFU) << 8) | (((a) & 0xFF00U) >> 8)))
+  #define CIFX_BSWAP32(a) ( (((a) & 0x000000FFUL) << 24) | (((a) & 0x0000FF00UL) << 8) | \
+                            (((a) & 0x00FF0000UL) >> 8)  | (((a) & 0xFF000000UL) >> 24) )
+  #define CIFX_BSWAP64(a) ( ((uint64_t)CIFX_BSWAP32((uint32_t)(a)) << 32) | \
+                            (uint64_t)CIFX_BSWAP32((uint32_t)((a) >> 32)) )
+#endif
+
 /*****************************************************************************/
-/*! Convert a buffer from / to host endianess
-*   this structure is used for automatically transforming a structure (which
-*   is described by this structure) from/to host endianess                   */
+/*! Swaps a run of 16 bit values. The buffer may be unaligned.
+*   \param pbData    Start of the run
+*   \param iCount    Number of values                                        */
 /*****************************************************************************/
-int32_t cifXConvertEndianess(unsigned int uiOffset, void* pvBuffer, int iBufferLen,
-                             const CIFX_ENDIANESS_ENTRY_T* atConv, int iConvLen)
+static void cifXSwap16(uint8_t* pbData, int iCount)
 {
-/* Conversion needs only be done, it host and dpm endianess differ */
-#ifdef CIFX_TOOLKIT_BIGENDIAN
-  /* We need to make sure, that we can handle odd offsets, so we are using
-     a byte pointer here and build the appropriate data type byte by byte.
-     Compilers provide packing/unaligned access in different ways, and we
-     are not able to generalize it */
-  uint8_t* pbBuffer      = (uint8_t*)pvBuffer;
+#ifdef CIFX_ENDIANESS_VECTOR_SWAP
+  for(; iCount >= 8; iCount -= 8, pbData += 16)
+  {
+    CIFX_ENDIANESS_VEC_T tVec;
+
+    CIFX_ENDIANESS_COPY(&tVec, pbData, sizeof(tVec));
+    tVec = __builtin_shuffle(tVec, (CIFX_ENDIANESS_VEC_T){1,0,3,2,5,4,7,6,9,8,11,10,13,12,15,14});
+    CIFX_ENDIANESS_COPY(pbData, &tVec, sizeof(tVec));
+  }
+#endif
+
+  for(; iCount > 0; --iCount, pbData += 2)
+  {
+    uint16_t usValue;
+
+    CIFX_ENDIANESS_COPY(&usValue, pbData, sizeof(usValue));
+    usValue = CIFX_BSWAP16(usValue);
+    CIFX_ENDIANESS_COPY(pbData, &usValue, sizeof(usValue));
+  }
+}
+
+/*****************************************************************************/
+/*! Swaps a run of 32 bit values (see cifXSwap16())
+*   \param pbData    Start of the run
+*   \param iCount    Number of values                                        */
+/*****************************************************************************/
+static void cifXSwap32(uint8_t* pbData, int iCount)
+{
+#ifdef CIFX_ENDIANESS_VECTOR_SWAP
+  for(; iCount >= 4; iCount -= 4, pbData += 16)
+  {
+    CIFX_ENDIANESS_VEC_T tVec;
+
+    CIFX_ENDIANESS_COPY(&tVec, pbData, sizeof(tVec));
+    tVec = __builtin_shuffle(tVec, (CIFX_ENDIANESS_VEC_T){3,2,1,0,7,6,5,4,11,10,9,8,15,14,13,12});
+    CIFX_ENDIANESS_COPY(pbData, &tVec, sizeof(tVec));
+  }
+#endif
+
+  for(; iCount > 0; --iCount, pbData += 4)
+  {
+    uint32_t ulValue;
+
+    CIFX_ENDIANESS_COPY(&ulValue, pbData, sizeof(ulValue));
+    ulValue = CIFX_BSWAP32(ulValue);
+    CIFX_ENDIANESS_COPY(pbData, &ulValue, sizeof(ulValue));
+  }
+}
+
+/*****************************************************************************/
+/*! Swaps a run of 64 bit values (see cifXSwap16())
+*   \param pbData    Start of the run
+*   \param iCount    Number of values                                        */
+/*****************************************************************************/
+static void cifXSwap64(uint8_t* pbData, int iCount)
+{
+#ifdef CIFX_ENDIANESS_VECTOR_SWAP
+  for(; iCount >= 2; iCount -= 2, pbData += 16)
+  {
+    CIFX_ENDIANESS_VEC_T tVec;
+
+    CIFX_ENDIANESS_COPY(&tVec, pbData, sizeof(tVec));
+    tVec = __builtin_shuffle(tVec, (CIFX_ENDIANESS_VEC_T){7,6,5,4,3,2,1,0,15,14,13,12,11,10,9,8});
+    CIFX_ENDIANESS_COPY(pbData, &tVec, sizeof(tVec));
+  }
+#endif
+
+  for(; iCount > 0; --iCount, pbData += 8)
+  {
+    uint64_t ullValue;
+
+    CIFX_ENDIANESS_COPY(&ullValue, pbData, sizeof(ullValue));
+    ullValue = CIFX_BSWAP64(ullValue);
+    CIFX_ENDIANESS_COPY(pbData, &ullValue, sizeof(ullValue));
+  }
+}
+
+/*****************************************************************************/
+/*! Swaps all values described by a conversion table, independent of the
+*   host endianess. This is the conversion done by cifXConvertEndianess() on
+*   big endian hosts, it can be used to verify conversion tables on little
+*   endian hosts. Only values completely inside the buffer are swapped.
+*   \param uiOffset    Offset of the buffer inside the described structure
+*   \param pvBuffer    Buffer to convert
+*   \param iBufferLen  Length of the buffer
+*   \param atConv      Conversion table (offsets relative to the structure)
+*   \param iConvLen    Number of entries in atConv
+*   \return CIFX_NO_ERROR on success                                         */
+/*****************************************************************************/
+int32_t cifXSwapEndianess(unsigned int uiOffset, void* pvBuffer, int iBufferLen,
+                          const CIFX_ENDIANESS_ENTRY_T* atConv, int iConvLen)
+{
+  uint8_t* pbBuffer = (uint8_t*)pvBuffer;
+  long     lStart   = (long)uiOffset;
+  long     lEnd     = (long)uiOffset + iBufferLen;
   int      iActConvEntry;
-  int      iActElement;
 
 #ifdef CIFX_TOOLKIT_PARAMETER_CHECK
   if((NULL == pvBuffer) || (NULL == atConv))
     return CIFX_INVALID_POINTER;
 #endif /* CIFX_TOOLKIT_PARAMETER_CHECK */
 
-  /* On Big-endian targets, the given block shall only be read from start */
-  if(0 != uiOffset)
-    return CIFX_INVALID_PARAMETER;
-
-  /* Iterate over complete user table */
+  /* Iterate over complete user table, every entry is a run of equally sized values */
   for(iActConvEntry = 0; iActConvEntry < iConvLen; ++iActConvEntry)
   {
-    /* Iterate over all elements given from this entry. (From iOffset to iOffset + iElementCnt * size) */
-    for(iActElement = 0; iActElement < atConv[iActConvEntry].iElementCnt; ++iActElement)
+    const CIFX_ENDIANESS_ENTRY_T* ptEntry = &atConv[iActConvEntry];
+    long                          lWidth;
+    long                          lFirst;
+    long                          lLast;
+
+    switch(ptEntry->eWidth)
     {
-      switch(atConv[iActConvEntry].eWidth)
-      {
-      case eCIFX_ENDIANESS_WIDTH_8BIT:
-        /* nothing to do for 8 bit */
-        break;
-
-      case eCIFX_ENDIANESS_WIDTH_16BIT:
-        {
-          uint16_t usValue;
-          int      iOffset = atConv[iActConvEntry].iOffset + iActElement * 2;
-
-          if( (iOffset + 2) < iBufferLen)
-          {
-            OS_Memcpy(&usValue, pbBuffer + iOffset, 2);
-            usValue = LE16_TO_HOST(usValue);
-            OS_Memcpy(pbBuffer + iOffset, &usValue, 2);
-          }
-        }
-        break;
-
-      case eCIFX_ENDIANESS_WIDTH_32BIT:
-        {
-          uint32_t ulValue;
-          int      iOffset = atConv[iActConvEntry].iOffset + iActElement * 4;
-
-          if( (iOffset + 4) < iBufferLen)
-          {
-            OS_Memcpy(&ulValue, pbBuffer + iOffset, 4);
-            ulValue = LE32_TO_HOST(ulValue);
-            OS_Memcpy(pbBuffer + iOffset, &ulValue, 4);
-          }
-        }
-        break;
-
-      case eCIFX_ENDIANESS_WIDTH_64BIT:
-        {
-          uint64_t ullValue;
-          int      iOffset = atConv[iActConvEntry].iOffset + iActElement * 8;
-
-          if( (iOffset + 8) < iBufferLen)
-          {
-            OS_Memcpy(&ullValue, pbBuffer + iOffset, 8);
-            ullValue = LE64_TO_HOST(ullValue);
-            OS_Memcpy(pbBuffer + iOffset, &ullValue, 8);
-          }
-        }
-        break;
-
-      default:
-        /* This should never happen */
-        break;
-      }
+    case eCIFX_ENDIANESS_WIDTH_16BIT: lWidth = 2; break;
+    case eCIFX_ENDIANESS_WIDTH_32BIT: lWidth = 4; break;
+    case eCIFX_ENDIANESS_WIDTH_64BIT: lWidth = 8; break;
+    default:
+      /* nothing to do for 8 bit */
+      continue;
+    }
+
+    /* Clip the run to the values completely inside the buffer */
+    lFirst = ptEntry->iOffset;
+    lLast  = ptEntry->iOffset + ptEntry->iElementCnt * lWidth;
+
+    if(lFirst < lStart)
+      lFirst += ((lStart - lFirst + lWidth - 1) / lWidth) * lWidth;
+
+    if(lLast > lEnd)
+      lLast -= ((lLast - lEnd + lWidth - 1) / lWidth) * lWidth;
+
+    if(lLast <= lFirst)
+      continue;
+
+    switch(lWidth)
+    {
+    case 2:  cifXSwap16(pbBuffer + (lFirst - lStart), (int)((lLast - lFirst) / 2)); break;
+    case 4:  cifXSwap32(pbBuffer + (lFirst - lStart), (int)((lLast - lFirst) / 4)); break;
+    default: cifXSwap64(pbBuffer + (lFirst - lStart), (int)((lLast - lFirst) / 8)); break;
     }
   }
+
   return CIFX_NO_ERROR;
+}
+
+/*****************************************************************************/
+/*! Convert a buffer from / to host endianess
+*   this structure is used for automatically transforming a structure (which
+*   is described by this structure) from/to host endianess                   */
+/*****************************************************************************/
+int32_t cifXConvertEndianess(unsigned int uiOffset, void* pvBuffer, int iBufferLen,
+                             const CIFX_ENDIANESS_ENTRY_T* atConv, int iConvLen)
+{
+/* Conversion needs only be done, it host and dpm endianess differ */
+#ifdef CIFX_TOOLKIT_BIGENDIAN
+  return cifXSwapEndianess(uiOffset, pvBuffer, iBufferLen, atConv, iConvLen);
 #else
   UNREFERENCED_PARAMETER(uiOffset);
   UNREFERENCED_PARAMETER(pvBuffer);
@@ -124,3 +225,40 @@ int32_t cifXConvertEndianess(unsigned int uiOffset, void* pvBuffer, int iBufferL
   return CIFX_NO_ERROR; /*lint !e438 : unused variables */
 #endif /* CIFX_TOOLKIT_BIGENDIAN */
 }
+
+/*****************************************************************************/
+/*! Convert (part of) a process data image from / to host endianess. The
+*   layout of the IO areas is described by an area map, areas not contained
+*   in the map are treated as byte data.
+*   \param ulAreaNumber  IO area of the data (as passed to xChannelIORead/Write)
+*   \param ulOffset      Offset of the data inside the IO area
+*   \param pvData        Data to convert
+*   \param ulDataLen     Length of the data
+*   \param atAreas       Area map
+*   \param iAreaCnt      Number of entries in atAreas
+*   \return CIFX_NO_ERROR on success                                         */
+/*****************************************************************************/
+int32_t cifXConvertEndianessIO(uint32_t ulAreaNumber, uint32_t ulOffset, void* pvData, uint32_t ulDataLen,
+                               const CIFX_ENDIANESS_AREA_T* atAreas, int iAreaCnt)
+{
+  int iArea;
+
+#ifdef CIFX_TOOLKIT_PARAMETER_CHECK
+  if((NULL == pvData) || (NULL == atAreas))
+    return CIFX_INVALID_POINTER;
+#endif /* CIFX_TOOLKIT_PARAMETER_CHECK */
+
+  for(iArea = 0; iArea < iAreaCnt; ++iArea)
+  {
+    if(atAreas[iArea].ulAreaNumber == ulAreaNumber)
+    {
+      return cifXConvertEndianess(ulOffset,
+                                  pvData,
+                                  (int)ulDataLen,
+                                  atAreas[iArea].atConv,
+                                  atAreas[iArea].iConvLen);
+    }
+  }
+
+  return CIFX_NO_ERROR;
+}
@@ -12,6 +12,7 @@ Copyright (c) Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserv
   Changes:
     Date        Description
     -----------------------------------------------------------------------------------
+    2026-10-18  Added cifXSwapEndianess(), cifXConvertEndianessIO() and CIFX_ENDIANESS_AREA_T
     2019-10-11  Change prototype of endianess conversion function
     2018-10-10  - Updated header and definitions to new Hilscher defines
                 - Derived from cifX Toolkit V1.6.0.0
@@ -26,6 +27,8 @@ Copyright (c) Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserv
 #ifndef __CIFX_ENDIANESS__H
 #define __CIFX_ENDIANESS__H
 
+#include <stdint.h> /*lint !e537 !e451 */
+
 /* Give the user the possibility to use own macros for
    endianess conversion */
 #ifndef BIGENDIAN_MACROS_PROVIDED
@@ -86,7 +89,25 @@ typedef struct CIFX_ENDIANESS_ENTRY_Ttag
 
 } CIFX_ENDIANESS_ENTRY_T, *PCIFX_ENDIANESS_ENTRY_T;
 
+/*****************************************************************************/
+/*! Endianess description of an IO area of a process data image. The offsets
+*   of the entries are relative to the start of the IO area.                 */
+/*****************************************************************************/
+typedef struct CIFX_ENDIANESS_AREA_Ttag
+{
+  uint32_t                      ulAreaNumber; /*!< IO area number                 */
+  const CIFX_ENDIANESS_ENTRY_T* atConv;       /*!< Layout of the IO area          */
+  int                           iConvLen;     /*!< Number of entries in atConv    */
+
+} CIFX_ENDIANESS_AREA_T, *PCIFX_ENDIANESS_AREA_T;
+
 int32_t cifXConvertEndianess(unsigned int uiOffset, void* pvBuffer, int iBufferLen,
                              const CIFX_ENDIANESS_ENTRY_T* atConv, int iConvLen);
 
+int32_t cifXSwapEndianess(unsigned int uiOffset, void* pvBuffer, int iBufferLen,
+                          const CIFX_ENDIANESS_ENTRY_T* atConv, int iConvLen);
+
+int32_t cifXConvertEndianessIO(uint32_t ulAreaNumber, uint32_t ulOffset, void* pvData, uint32_t ulDataLen,
+                               const CIFX_ENDIANESS_AREA_T* atAreas, int iAreaCnt);
+
 #endif /* __CIFX_ENDIANESS__H */
@@ -12,6 +12,14 @@ Copyright (c) Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserv
   Changes:
     Date        Description
     -----------------------------------------------------------------------------------
+    2026-10-18  - CheckSysdeviceHandle() / CheckChannelHandle() use toolkit handle table
+                  instead of scanning the device list
+                - xChannelRegisterNotification() executes callbacks via DEV_NotifyCallback()
+                - IO and packet functions are marked with CIFX_TKIT_NOALLOC_SCOPE()
+                - Added input change filter (xChannelIOSetChangeFilter(), xChannelIOReadChanged())
+                - xChannelIOWrite() writes only changed data if the output area has a shadow
+                - Opening the output PLC memory pointer / xChannelPLCActivateWrite() invalidate
+                  the output shadows
     2023-04-26  - Added new compiler option CIFX_TOOLKIT_USE_CUSTOM_DRV_FUNCS
                 - Moved check parameter macros to cifXtoolkit.h
     2022-06-14  - Added option and handling for cached PLC memory pointers
@@ -52,6 +60,10 @@ int32_t cifXReadFirmwareIdent( PDEVICEINSTANCE ptDevInstance, uint32_t ulChannel
 void    cifXInitTime         ( PDEVICEINSTANCE ptDevInstance);
 #endif
 
+#ifdef CIFX_TOOLKIT_PARAMETER_CHECK
+int     cifXTKitIsRegisteredHandle( void* pvHandle);
+#endif
+
 /*****************************************************************************/
 /*!  \addtogroup CIFX_DRIVER_API cifX Driver API implementation
 *    \{                                                                      */
@@ -293,19 +305,10 @@ static int32_t CheckSysdeviceHandle(CIFXHANDLE hChannel)
         /* Maybe we are in the initialization phase and the list is not created yet. */
         lRet = CIFX_NO_ERROR;
 
-      }else
+      }else if (cifXTKitIsRegisteredHandle(ptSysDevice))
       {
-        /* Try to find the ptSysDevice pointer in one of the device instances */
-        uint32_t ulDev = 0;
-
-        for(ulDev = 0; ulDev < g_ulDeviceCount; ++ulDev)
-        {
-          if (ptSysDevice == &g_pptDevices[ulDev]->tSystemDevice)
-          {
-            lRet = CIFX_NO_ERROR;
-            break;
-          }
-        }
+        /* ptSysDevice pointer belongs to one of the device instances */
+        lRet = CIFX_NO_ERROR;
       }
     }
   }
@@ -340,24 +343,10 @@ static int32_t CheckChannelHandle(CIFXHANDLE hChannel)
         /* Maybe we are in the initialization phase and the list is not created yet. */
         lRet = CIFX_NO_ERROR;
 
-      }else
+      }else if (cifXTKitIsRegisteredHandle(ptDevice))
       {
-        /* Try to find the ptSysDevice pointer in one of the device instances */
-        uint32_t ulDev = 0;
-
-        /* Check if we can find our channel inside a device */
-        for(ulDev = 0; ulDev < g_ulDeviceCount; ++ulDev)
-        {
-          uint32_t ulChannel = 0;
-          for( ulChannel = 0; ulChannel < g_pptDevices[ulDev]->ulCommChannelCount; ++ulChannel)
-          {
-            if ( ptDevice == g_pptDevices[ulDev]->pptCommChannels[ulChannel])
-            {
-              lRet = CIFX_NO_ERROR;
-              break;
-            }
-          }
-        }
+        /* Channel pointer belongs to one of the device instances */
+        lRet = CIFX_NO_ERROR;
       }
     }
   }
@@ -1147,6 +1136,7 @@ int32_t APIENTRY xChannelPutPacket(CIFXHANDLE hChannel, CIFX_PACKET*  ptSendPkt,
 {
   int32_t          lRet      = CIFX_NO_ERROR;
   PCHANNELINSTANCE ptChannel = (PCHANNELINSTANCE)hChannel;
+  CIFX_TKIT_NOALLOC_SCOPE();
 
   /* Check if another command is active */
   if ( 0 == OS_WaitMutex( ptChannel->tSendMbx.pvSendMBXMutex, ulTimeout))
@@ -1172,6 +1162,7 @@ int32_t APIENTRY xChannelGetPacket(CIFXHANDLE hChannel, uint32_t ulSize, CIFX_PA
 {
   int32_t          lRet      = CIFX_NO_ERROR;
   PCHANNELINSTANCE ptChannel = (PCHANNELINSTANCE)hChannel;
+  CIFX_TKIT_NOALLOC_SCOPE();
 
   /* Check if another command is active */
   if ( 0 == OS_WaitMutex( ptChannel->tRecvMbx.pvRecvMBXMutex, ulTimeout))
@@ -1470,6 +1461,7 @@ int32_t APIENTRY xChannelIORead(CIFXHANDLE hChannel, uint32_t ulAreaNumber, uint
   int32_t          lRet        = CIFX_NO_ERROR;
   PIOINSTANCE      ptIOArea    = NULL;
   uint8_t          bIOBitState = HIL_FLAGS_NONE;
+  CIFX_TKIT_NOALLOC_SCOPE();
 
   if(!DEV_IsRunning(ptChannel))
     return CIFX_DEV_NOT_RUNNING;
@@ -1594,6 +1586,234 @@ int32_t APIENTRY xChannelIORead(CIFXHANDLE hChannel, uint32_t ulAreaNumber, uint
   return lRet;
 }
 
+/*****************************************************************************/
+/*! Sets the ranges of an input area watched by xChannelIOReadChanged().
+*   \param hChannel      Channel handle acquired by xChannelOpen
+*   \param ulAreaNumber  Number of the I/O Area (0..n)
+*   \param ulRangeCount  Number of ranges (max. CIFX_IO_MAX_CHANGE_RANGES),
+*                        0 to remove the filter
+*   \param ptRanges      Byte ranges inside the input area
+*   \return CIFX_NO_ERROR on success                                         */
+/*****************************************************************************/
+int32_t APIENTRY xChannelIOSetChangeFilter(CIFXHANDLE hChannel, uint32_t ulAreaNumber, uint32_t ulRangeCount, CIFX_IO_RANGE* ptRanges)
+{
+  PCHANNELINSTANCE    ptChannel   = (PCHANNELINSTANCE)hChannel;
+  PIOINSTANCE         ptIOArea    = NULL;
+  PIO_CHANGE_FILTER_T ptFilter    = NULL;
+  PIO_CHANGE_FILTER_T ptOldFilter = NULL;
+  uint32_t            ulStart     = 0xFFFFFFFFUL;
+  uint32_t            ulEnd       = 0;
+  uint32_t            ulRange;
+
+  CHECK_CHANNELHANDLE(hChannel);
+
+  if(ulAreaNumber >= ptChannel->ulIOInputAreas)
+    return CIFX_INVALID_PARAMETER;
+
+  if(ulRangeCount > CIFX_IO_MAX_CHANGE_RANGES)
+    return CIFX_INVALID_PARAMETER;
+
+  if((ulRangeCount > 0) && (NULL == ptRanges))
+    return CIFX_INVALID_POINTER;
+
+  ptIOArea = ptChannel->pptIOInputAreas[ulAreaNumber];
+
+  /* Validate the ranges and calculate the part of the area to read on every handshake */
+  for(ulRange = 0; ulRange < ulRangeCount; ++ulRange)
+  {
+    if( (0 == ptRanges[ulRange].ulLength)                                        ||
+        (ptRanges[ulRange].ulOffset >= ptIOArea->ulDPMAreaLength)                 ||
+        (ptRanges[ulRange].ulLength > ptIOArea->ulDPMAreaLength - ptRanges[ulRange].ulOffset) )
+      return CIFX_INVALID_ACCESS_SIZE;
+
+    if(ptRanges[ulRange].ulOffset < ulStart)
+      ulStart = ptRanges[ulRange].ulOffset;
+
+    if(ptRanges[ulRange].ulOffset + ptRanges[ulRange].ulLength > ulEnd)
+      ulEnd = ptRanges[ulRange].ulOffset + ptRanges[ulRange].ulLength;
+  }
+
+  if(ulRangeCount > 0)
+  {
+    uint32_t ulLength = ulEnd - ulStart;
+
+    if(NULL == (ptFilter = (PIO_CHANGE_FILTER_T)OS_Memalloc((uint32_t)sizeof(*ptFilter) + 2 * ulLength)))
+      return CIFX_FUNCTION_FAILED;
+
+    OS_Memset(ptFilter, 0, sizeof(*ptFilter));
+    OS_Memcpy(ptFilter->atRanges, ptRanges, ulRangeCount * (uint32_t)sizeof(ptRanges[0]));
+    ptFilter->ulRangeCount = ulRangeCount;
+    ptFilter->ulStart      = ulStart;
+    ptFilter->ulLength     = ulLength;
+    ptFilter->pbSnapshot   = (uint8_t*)(ptFilter + 1);
+    ptFilter->pbImage      = ptFilter->pbSnapshot + ulLength;
+  }
+
+  /* Don't replace the filter while xChannelIOReadChanged() uses it */
+  if(!OS_WaitMutex(ptIOArea->pvMutex, CIFX_TO_CHANGE_FILTER_LOCK))
+  {
+    if(NULL != ptFilter)
+      OS_Memfree(ptFilter);
+    return CIFX_DRV_CMD_ACTIVE;
+  }
+
+  ptOldFilter              = ptIOArea->ptChangeFilter;
+  ptIOArea->ptChangeFilter = ptFilter;
+
+  OS_ReleaseMutex(ptIOArea->pvMutex);
+
+  if(NULL != ptOldFilter)
+    OS_Memfree(ptOldFilter);
+
+  return CIFX_NO_ERROR;
+}
+
+/*****************************************************************************/
+/*! Reads the input data of the channel, if one of the ranges set by
+*   xChannelIOSetChangeFilter() changed since the last successful call.
+*   Input images without changes are acknowledged (handshake) and skipped,
+*   until a change is detected or the timeout elapsed. The first call after
+*   setting the filter reports all ranges as changed.
+*   \param hChannel         Channel handle acquired by xChannelOpen
+*   \param ulAreaNumber     Number of the I/O Area (0..n)
+*   \param ulOffset         Data offset in Input area
+*   \param ulDataLen        Length of data to read
+*   \param pvData           Buffer to place returned data
+*   \param ulTimeout        Timeout in ms to wait for a change
+*   \param pulChangedRanges Returned bit mask of the changed ranges (bit n =
+*                           n-th range passed to xChannelIOSetChangeFilter())
+*   \return CIFX_NO_ERROR on success, CIFX_DEV_EXCHANGE_TIMEOUT if no watched
+*           range changed within the timeout                                 */
+/*****************************************************************************/
+int32_t APIENTRY xChannelIOReadChanged(CIFXHANDLE hChannel, uint32_t ulAreaNumber, uint32_t ulOffset, uint32_t ulDataLen, void* pvData, uint32_t ulTimeout, uint32_t* pulChangedRanges)
+{
+  PCHANNELINSTANCE    ptChannel   = (PCHANNELINSTANCE)hChannel;
+  int32_t             lRet        = CIFX_DEV_EXCHANGE_TIMEOUT;
+  PIOINSTANCE         ptIOArea    = NULL;
+  PIO_CHANGE_FILTER_T ptFilter    = NULL;
+  uint8_t             bIOBitState = HIL_FLAGS_NONE;
+  uint32_t            ulStartTime = OS_GetMilliSecCounter();
+  CIFX_TKIT_NOALLOC_SCOPE();
+
+  CHECK_POINTER(pvData);
+  CHECK_POINTER(pulChangedRanges);
+
+  if(!DEV_IsRunning(ptChannel))
+    return CIFX_DEV_NOT_RUNNING;
+
+  if(ulAreaNumber >= ptChannel->ulIOInputAreas)
+    return CIFX_INVALID_PARAMETER;
+
+#ifdef CIFX_TOOLKIT_DMA
+  /* The change filter reads the DPM */
+  if( ptChannel->ulDeviceCOSFlags & HIL_COMM_COS_DMA)
+    return CIFX_FUNCTION_NOT_AVAILABLE;
+#endif
+
+  ptIOArea          = ptChannel->pptIOInputAreas[ulAreaNumber];
+  bIOBitState       = DEV_GetIOBitstate(ptChannel, ptIOArea, 0);
+  *pulChangedRanges = 0;
+
+  if( (ulOffset + ulDataLen) > ptIOArea->ulDPMAreaLength)
+    return CIFX_INVALID_ACCESS_SIZE; /* read size too long */
+
+  /* Check if another command is active */
+  if ( !OS_WaitMutex( ptIOArea->pvMutex, ulTimeout))
+    return CIFX_DRV_CMD_ACTIVE;
+
+  if(NULL == (ptFilter = ptIOArea->ptChangeFilter))
+  {
+    lRet = CIFX_FUNCTION_NOT_AVAILABLE;
+  } else
+  {
+    /* User data can be taken from the image, if it lies within the watched part */
+    int fDataInImage = (ulOffset >= ptFilter->ulStart) &&
+                       ((ulOffset + ulDataLen) <= (ptFilter->ulStart + ptFilter->ulLength));
+
+    while(1)
+    {
+      uint32_t ulElapsed   = OS_GetMilliSecCounter() - ulStartTime;
+      uint32_t ulRemaining = (ulElapsed < ulTimeout) ? (ulTimeout - ulElapsed) : 0;
+      uint32_t ulChanged   = 0;
+      uint32_t ulRange;
+
+      if( (HIL_FLAGS_NONE != bIOBitState) &&
+          !DEV_WaitForBitState(ptChannel, ptIOArea->bHandshakeBit, bIOBitState, ulRemaining) )
+        break;
+
+      /* Read the watched part of the area only */
+      HWIF_READN( ptChannel->pvDeviceInstance,
+                  ptFilter->pbImage,
+                  &ptIOArea->pbDPMAreaStart[ptFilter->ulStart],
+                  ptFilter->ulLength);
+
+      /* Compare the ranges with the image returned last time (memcmp of the C library is vectorised) */
+      for(ulRange = 0; ulRange < ptFilter->ulRangeCount; ++ulRange)
+      {
+        uint32_t ulRangeOffset = ptFilter->atRanges[ulRange].ulOffset - ptFilter->ulStart;
+
+        if( !ptFilter->fSnapshotValid ||
+            (0 != OS_Memcmp(ptFilter->pbImage + ulRangeOffset,
+                            ptFilter->pbSnapshot + ulRangeOffset,
+                            ptFilter->atRanges[ulRange].ulLength)) )
+          ulChanged |= (1UL << ulRange);
+      }
+
+      if(0 != ulChanged)
+      {
+        uint8_t* pbTemp = ptFilter->pbSnapshot;
+
+        if(fDataInImage)
+          OS_Memcpy(pvData, ptFilter->pbImage + (ulOffset - ptFilter->ulStart), ulDataLen);
+        else
+          HWIF_READN( ptChannel->pvDeviceInstance,
+                      pvData,
+                      &ptIOArea->pbDPMAreaStart[ulOffset],
+                      ulDataLen);
+
+        /* The actual image becomes the reference for the next call */
+        ptFilter->pbSnapshot     = ptFilter->pbImage;
+        ptFilter->pbImage        = pbTemp;
+        ptFilter->fSnapshotValid = 1;
+      }
+
+      if(HIL_FLAGS_NONE != bIOBitState)
+      {
+        /* Lock flag access */
+        OS_EnterLock(ptChannel->pvLock);
+
+        /* Read data done, also for unchanged data, so the device can update the area */
+        DEV_ToggleBit(ptChannel, (uint32_t)(1UL << ptIOArea->bHandshakeBit));
+
+        /* Unlock flag access */
+        OS_LeaveLock(ptChannel->pvLock);
+      }
+
+      if(0 != ulChanged)
+      {
+        *pulChangedRanges = ulChanged;
+        lRet              = CIFX_NO_ERROR;
+
+        /* Check COMM Flag for return value */
+        (void)DEV_IsCommunicating(ptChannel, &lRet);
+        break;
+      }
+
+      if(0 == ulRemaining)
+        break;
+
+      /* Without handshake the area is polled */
+      if(HIL_FLAGS_NONE == bIOBitState)
+        OS_Sleep(1);
+    }
+  }
+
+  /* Release command */
+  OS_ReleaseMutex( ptIOArea->pvMutex);
+
+  return lRet;
+}
+
 /*****************************************************************************/
 /*! Writes the Output data to the channel
 *   \param hChannel     Channel handle acquired by xChannelOpen
@@ -1610,6 +1830,7 @@ int32_t APIENTRY xChannelIOWrite(CIFXHANDLE hChannel, uint32_t ulAreaNumber, uin
   int32_t          lRet        = CIFX_NO_ERROR;
   PIOINSTANCE      ptIOArea    = NULL;
   uint8_t          bIOBitState = HIL_FLAGS_NONE;
+  CIFX_TKIT_NOALLOC_SCOPE();
 
   if(!DEV_IsRunning(ptChannel))
     return CIFX_DEV_NOT_RUNNING;
@@ -1695,10 +1916,7 @@ int32_t APIENTRY xChannelIOWrite(CIFXHANDLE hChannel, uint32_t ulAreaNumber, uin
     if(HIL_FLAGS_NONE == bIOBitState)
     {
       /* Read data without handshake */
-      HWIF_WRITEN(  ptChannel->pvDeviceInstance,
-                   &ptIOArea->pbDPMAreaStart[ulOffset],
-                    pvData,
-                    ulDataLen);
+      DEV_WriteIOData(ptChannel, ptIOArea, ulOffset, ulDataLen, pvData);
 
       /* Check COMM Flag for return value */
       (void)DEV_IsCommunicating(ptChannel, &lRet);
@@ -1711,10 +1929,7 @@ int32_t APIENTRY xChannelIOWrite(CIFXHANDLE hChannel, uint32_t ulAreaNumber, uin
       } else
       {
         /* Read data */
-        HWIF_WRITEN(  ptChannel->pvDeviceInstance,
-                     &ptIOArea->pbDPMAreaStart[ulOffset],
-                      pvData,
-                      ulDataLen);
+        DEV_WriteIOData(ptChannel, ptIOArea, ulOffset, ulDataLen, pvData);
 
         /* Lock flag access */
         OS_EnterLock(ptChannel->pvLock);
@@ -2061,6 +2276,11 @@ int32_t APIENTRY xChannelPLCMemoryPtr(CIFXHANDLE hChannel, uint32_t ulCmd, void*
   }
 #endif
 
+  /* Direct accesses to the output area bypass the output shadows (delta writes) */
+  if( ((CIFX_MEM_PTR_OPEN == ulCmd) || (CIFX_MEM_PTR_OPEN_USR == ulCmd)) &&
+      (ulAreaDefinition != CIFX_IO_INPUT_AREA) )
+    CIFX_TKIT_ATOMIC_INC(&ptChannel->ulIOResetCount);
+
 #ifdef CIFX_TOOLKIT_DMA
 
   /* Check for DMA transfer */
@@ -2403,6 +2623,9 @@ int32_t APIENTRY xChannelPLCActivateWrite(CIFXHANDLE hChannel, uint32_t ulAreaNu
       {
         PIOINSTANCE ptIOInst = ptChannel->pptIOOutputAreas[ulAreaNumber];
 
+        /* Area was written directly, invalidate the output shadows (delta writes) */
+        CIFX_TKIT_ATOMIC_INC(&ptChannel->ulIOResetCount);
+
         /* Flush the IO output cache to output buffer */
         if (NULL != ptChannel->tCachedIOOutputArea.pvMemPtr)
         {
@@ -3282,7 +3505,7 @@ int32_t APIENTRY xChannelRegisterNotification(CIFXHANDLE           hChannel,
           CIFX_NOTIFY_RX_MBX_FULL_DATA_T tData;
           tData.ulRecvCount = LE16_TO_HOST(HWIF_READ16(ptDevInst, ptChannel->tRecvMbx.ptRecvMailboxStart->usWaitingPackages));
 
-          pfnCallback(CIFX_NOTIFY_RX_MBX_FULL, sizeof(tData), &tData, pvUser);
+          DEV_NotifyCallback(ptChannel, pfnCallback, CIFX_NOTIFY_RX_MBX_FULL, sizeof(tData), &tData, pvUser);
         }
       }
     break;
@@ -3306,7 +3529,7 @@ int32_t APIENTRY xChannelRegisterNotification(CIFXHANDLE           hChannel,
           CIFX_NOTIFY_TX_MBX_EMPTY_DATA_T tData;
           tData.ulMaxSendCount = LE16_TO_HOST(HWIF_READ16(ptDevInst, ptChannel->tSendMbx.ptSendMailboxStart->usPackagesAccepted));
 
-          pfnCallback(CIFX_NOTIFY_TX_MBX_EMPTY, sizeof(tData), &tData, pvUser);
+          DEV_NotifyCallback(ptChannel, pfnCallback, CIFX_NOTIFY_TX_MBX_EMPTY, sizeof(tData), &tData, pvUser);
         }
 
       }
@@ -3347,7 +3570,7 @@ int32_t APIENTRY xChannelRegisterNotification(CIFXHANDLE           hChannel,
                                bIOBitState,
                                0))
         {
-          pfnCallback(ulNotification, 0, NULL, pvUser);
+          DEV_NotifyCallback(ptChannel, pfnCallback, ulNotification, 0, NULL, pvUser);
         }
 
         lRet = CIFX_NO_ERROR;
@@ -3390,7 +3613,7 @@ int32_t APIENTRY xChannelRegisterNotification(CIFXHANDLE           hChannel,
                                bIOBitState,
                                0))
         {
-          pfnCallback(ulNotification, 0, NULL, pvUser);
+          DEV_NotifyCallback(ptChannel, pfnCallback, ulNotification, 0, NULL, pvUser);
         }
       }
     }
@@ -3417,7 +3640,7 @@ int32_t APIENTRY xChannelRegisterNotification(CIFXHANDLE           hChannel,
                                 bState,
                                 0))
         {
-          pfnCallback(ulNotification, 0, NULL, pvUser);
+          DEV_NotifyCallback(ptChannel, pfnCallback, ulNotification, 0, NULL, pvUser);
         }
 
       }
@@ -3443,7 +3666,7 @@ int32_t APIENTRY xChannelRegisterNotification(CIFXHANDLE           hChannel,
                                   0);
 
         tData.ulComState = ptChannel->usNetxFlags & NCF_COMMUNICATING;
-        pfnCallback(CIFX_NOTIFY_COM_STATE, sizeof(tData), &tData, pvUser);
+        DEV_NotifyCallback(ptChannel, pfnCallback, CIFX_NOTIFY_COM_STATE, sizeof(tData), &tData, pvUser);
       }
     break;
 
@@ -12,6 +12,11 @@ Copyright (c) Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserv
   Changes:
     Date        Description
     -----------------------------------------------------------------------------------
+    2026-10-18  - Added DEV_NotifyCallback() to allow deferring notification callbacks
+                - Added DEV_NotifySignal() to report notifications without callback
+                - Added DEV_WriteIOData() for delta writes of the output areas
+                - Reset/startup waits poll with back-off instead of fixed sleeps, the
+                  wait times are configurable (tBootTiming), added boot timeline
     2023-04-18  Added new option parameter for HWIF_READN / WRITEN function, to be able to
                 recognize single HWIF_READ16/WRITE32 and HWIF_READ32/WRITE32 accesses
     2023-02-07  Added wait flag in DEV_Reset_Execute()
@@ -450,6 +455,99 @@ void DEV_ToggleBit(PCHANNELINSTANCE ptChannel, uint32_t ulBitMask)
   }
 }
 
+/*****************************************************************************/
+/*! Writes data to an IO output area. If the area has an output shadow, only
+*   the runs differing from the data written last are transferred. Runs
+*   separated by up to ulMergeGap unchanged bytes are written in one access,
+*   as every access has a fixed overhead on serial interfaces (HWIF).
+*   \param ptChannel    Channel instance
+*   \param ptIOArea     Output area
+*   \param ulOffset     Data offset in the area
+*   \param ulDataLen    Length of the data
+*   \param pvData       Data to write                                        */
+/*****************************************************************************/
+void DEV_WriteIOData(PCHANNELINSTANCE ptChannel, PIOINSTANCE ptIOArea, uint32_t ulOffset, uint32_t ulDataLen, void* pvData)
+{
+  PIO_OUTPUT_SHADOW_T ptShadow     = ptIOArea->ptOutputShadow;
+  uint8_t*            pbData       = (uint8_t*)pvData;
+  uint32_t            ulEnd        = ulOffset + ulDataLen;
+  uint8_t*            pbImage      = NULL;
+  uint32_t            ulResetCount = 0;
+
+  if(NULL == ptShadow)
+  {
+    HWIF_WRITEN(ptChannel->pvDeviceInstance, &ptIOArea->pbDPMAreaStart[ulOffset], pvData, ulDataLen);
+    return;
+  }
+
+  ulResetCount = CIFX_TKIT_ATOMIC_LOAD(&ptChannel->ulIOResetCount);
+  pbImage      = &ptShadow->pbImage[ulOffset];
+
+  if( (ptShadow->ulResetCount != ulResetCount) ||
+      (ulOffset < ptShadow->ulValidStart)      ||
+      (ulEnd    > ptShadow->ulValidEnd) )
+  {
+    /* Area content is not known completely, write all data */
+    HWIF_WRITEN(ptChannel->pvDeviceInstance, &ptIOArea->pbDPMAreaStart[ulOffset], pvData, ulDataLen);
+
+    if( (ptShadow->ulResetCount == ulResetCount) &&
+        (ulOffset <= ptShadow->ulValidEnd)        &&
+        (ulEnd    >= ptShadow->ulValidStart) )
+    {
+      /* Written data adjoins the valid data */
+      if(ulOffset < ptShadow->ulValidStart)
+        ptShadow->ulValidStart = ulOffset;
+      if(ulEnd > ptShadow->ulValidEnd)
+        ptShadow->ulValidEnd = ulEnd;
+    } else
+    {
+      ptShadow->ulValidStart = ulOffset;
+      ptShadow->ulValidEnd   = ulEnd;
+      ptShadow->ulResetCount = ulResetCount;
+    }
+
+    OS_Memcpy(pbImage, pbData, ulDataLen);
+
+  } else if(0 != OS_Memcmp(pbImage, pbData, ulDataLen))
+  {
+    uint32_t ulPos = 0;
+
+    while(ulPos < ulDataLen)
+    {
+      uint32_t ulRunStart;
+      uint32_t ulRunEnd;
+
+      /* Skip unchanged data */
+      while( (ulPos < ulDataLen) && (pbImage[ulPos] == pbData[ulPos]) )
+        ++ulPos;
+
+      if(ulPos == ulDataLen)
+        break;
+
+      /* Extend the run, until more than ulMergeGap unchanged bytes follow */
+      ulRunStart = ulPos;
+      ulRunEnd   = ++ulPos;
+
+      while(ulPos < ulDataLen)
+      {
+        if(pbImage[ulPos] != pbData[ulPos])
+          ulRunEnd = ulPos + 1;
+        else if(ulPos - ulRunEnd >= ptShadow->ulMergeGap)
+          break;
+
+        ++ulPos;
+      }
+
+      HWIF_WRITEN(ptChannel->pvDeviceInstance,
+                  &ptIOArea->pbDPMAreaStart[ulOffset + ulRunStart],
+                  &pbData[ulRunStart],
+                  ulRunEnd - ulRunStart);
+    }
+
+    OS_Memcpy(pbImage, pbData, ulDataLen);
+  }
+}
+
 /*****************************************************************************/
 /*! Waits for Sync state on the channel (polling mode)
 *   \param ptChannel    Channel instance to wait for bitstate
@@ -728,6 +826,111 @@ void DEV_ReadHandshakeFlags(PCHANNELINSTANCE ptChannel, int fReadSyncFlags, int
     OS_LeaveLock(ptChannel->pvLock);
 }
 
+/*****************************************************************************/
+/*! Sets all reset/startup wait times of the device, not given by the user,
+*   to the toolkit defaults
+*   \param ptDevInstance Device instance                                     */
+/*****************************************************************************/
+void DEV_InitBootTiming(PDEVICEINSTANCE ptDevInstance)
+{
+  CIFX_BOOT_TIMING_T* ptTiming = &ptDevInstance->tBootTiming;
+
+  if(0 == ptTiming->ulPCIResetTime)
+    ptTiming->ulPCIResetTime = NET_BOOTLOADER_RESET_TIME;
+
+  if(0 == ptTiming->ulDPMResetTime)
+    ptTiming->ulDPMResetTime = NET_BOOTLOADER_RESET_TIME_DPM;
+
+  if(0 == ptTiming->ulNetX4000PCIResetTime)
+    ptTiming->ulNetX4000PCIResetTime = NET_NETX4000_PCI_RESET_TIME;
+
+  if(0 == ptTiming->ulPollIntervalMin)
+    ptTiming->ulPollIntervalMin = NET_BOOTLOADER_POLL_MIN;
+
+  if(0 == ptTiming->ulPollIntervalMax)
+    ptTiming->ulPollIntervalMax = NET_BOOTLOADER_POLL_MAX;
+
+  if(ptTiming->ulPollIntervalMax < ptTiming->ulPollIntervalMin)
+    ptTiming->ulPollIntervalMax = ptTiming->ulPollIntervalMin;
+}
+
+/*****************************************************************************/
+/*! Waits for the next poll while waiting for a device state change. The
+*   poll interval starts at ulPollIntervalMin and is doubled on every call
+*   up to ulPollIntervalMax.
+*   \param ptDevInstance Device instance
+*   \param pulInterval   Actual poll interval (must be 0 on the first call) */
+/*****************************************************************************/
+void DEV_PollBackoff(PDEVICEINSTANCE ptDevInstance, uint32_t* pulInterval)
+{
+  if(0 == *pulInterval)
+    *pulInterval = ptDevInstance->tBootTiming.ulPollIntervalMin;
+
+  OS_Sleep(*pulInterval);
+
+  *pulInterval *= 2;
+  if(*pulInterval > ptDevInstance->tBootTiming.ulPollIntervalMax)
+    *pulInterval = ptDevInstance->tBootTiming.ulPollIntervalMax;
+}
+
+/*****************************************************************************/
+/*! Starts a new boot timeline of the device (reset/startup)
+*   \param ptDevInstance Device instance
+*   \param szEvent       First event of the timeline (static string)        */
+/*****************************************************************************/
+void DEV_BootTimelineStart(PDEVICEINSTANCE ptDevInstance, const char* szEvent)
+{
+  ptDevInstance->tBootTimeline.ulEventCount = 0;
+  ptDevInstance->tBootTimeline.ulStartTime  = OS_GetMilliSecCounter();
+
+  DEV_BootTimelineAdd(ptDevInstance, szEvent);
+}
+
+/*****************************************************************************/
+/*! Adds a timestamped event to the boot timeline of the device. Events are
+*   dropped if the timeline is full.
+*   \param ptDevInstance Device instance
+*   \param szEvent       Event description (static string)                  */
+/*****************************************************************************/
+void DEV_BootTimelineAdd(PDEVICEINSTANCE ptDevInstance, const char* szEvent)
+{
+  CIFX_BOOT_TIMELINE_T* ptTimeline = &ptDevInstance->tBootTimeline;
+  uint32_t              ulTime     = OS_GetMilliSecCounter() - ptTimeline->ulStartTime;
+
+  if(ptTimeline->ulEventCount < CIFX_BOOT_TIMELINE_EVENTS)
+  {
+    ptTimeline->atEvents[ptTimeline->ulEventCount].ulTime  = ulTime;
+    ptTimeline->atEvents[ptTimeline->ulEventCount].szEvent = szEvent;
+    ++ptTimeline->ulEventCount;
+  }
+
+  if(g_ulTraceLevel & TRACE_LEVEL_DEBUG)
+  {
+    USER_Trace(ptDevInstance,
+               TRACE_LEVEL_DEBUG,
+               "Boot timeline: %5u ms %s",
+               ulTime,
+               szEvent);
+  }
+}
+
+/*****************************************************************************/
+/*! Prohibits access to possibly uninitialized PCI memory during the reset of
+*   netX4000 based PCI devices. Timeout of 1s was communicated to be the upper
+*   boundary, so this is the only fixed wait of a system reset.
+*   \param ptDevInstance Device instance                                     */
+/*****************************************************************************/
+static void DEV_WaitNetX4000PCIReset(PDEVICEINSTANCE ptDevInstance)
+{
+  if( (ptDevInstance->fPCICard) &&
+      (( eCHIP_TYPE_NETX4000 == ptDevInstance->eChipType) ||
+       ( eCHIP_TYPE_NETX4100 == ptDevInstance->eChipType)  )  )
+  {
+    OS_Sleep(ptDevInstance->tBootTiming.ulNetX4000PCIResetTime);
+    DEV_BootTimelineAdd(ptDevInstance, "netX4000 PCI reset time elapsed");
+  }
+}
+
 /*****************************************************************************/
 /*! Wait for NOT READY in poll mode
 *   \param ptChannel Channel instance to check
@@ -816,12 +1019,11 @@ int DEV_WaitForReady_Poll(PCHANNELINSTANCE ptChannel, uint32_t ulTimeout)
   if(ptChannel->fIsSysDevice)
   {
     /* This is the system channel of the whole card */
-    /* Wait until firmware is running */
-    OS_Sleep( 10);
+    DEVICEINSTANCE* ptDevInstance  = (DEVICEINSTANCE*)ptChannel->pvDeviceInstance;
+    uint32_t        ulInterval     = 0;
 
     do
     {
-      DEVICEINSTANCE* ptDevInstance  = (DEVICEINSTANCE*)ptChannel->pvDeviceInstance;
       char            szCookie[5]    = {0};
 
       /* Read the DPM cookie */
@@ -847,8 +1049,8 @@ int DEV_WaitForReady_Poll(PCHANNELINSTANCE ptChannel, uint32_t ulTimeout)
       }
       ulDiffTime = OS_GetMilliSecCounter() - lStartTime;
 
-      /* Wait until firmware is running */
-      OS_Sleep(1);
+      /* Wait until firmware is running, poll fast at the beginning and back off */
+      DEV_PollBackoff(ptDevInstance, &ulInterval);
 
     } while ( ulDiffTime < ulTimeout);
   } else
@@ -859,9 +1061,6 @@ int DEV_WaitForReady_Poll(PCHANNELINSTANCE ptChannel, uint32_t ulTimeout)
     {
       do
       {
-        /* Wait until the channel is running */
-        OS_Sleep( 1);
-
         /* Wait for READY */
         if( DEV_IsReady(ptChannel))
         {
@@ -871,6 +1070,9 @@ int DEV_WaitForReady_Poll(PCHANNELINSTANCE ptChannel, uint32_t ulTimeout)
         }
         ulDiffTime = OS_GetMilliSecCounter() - lStartTime;
 
+        /* Wait until the channel is running */
+        OS_Sleep( 1);
+
       } while ( ulDiffTime < ulTimeout);
     }
   }
@@ -1457,6 +1659,42 @@ uint8_t DEV_GetHandshakeBitState(PCHANNELINSTANCE ptChannel, uint32_t ulBitMsk)
   return bRet;
 }
 
+/*****************************************************************************/
+/*! Execute a user notification callback. If the device instance provides a
+*   notification dispatcher (pfnNotifyDispatch) the callback is handed over to
+*   it, otherwise the callback is called directly in the current context.
+*   \param ptChannel       Channel instance the notification belongs to
+*   \param pfnCallback     User callback
+*   \param ulNotification  Notification (CIFX_NOTIFY_xxx)
+*   \param ulDataLen       Length of notification data
+*   \param pvData          Notification data
+*   \param pvUser          User parameter passed on registration             */
+/*****************************************************************************/
+void DEV_NotifyCallback(PCHANNELINSTANCE ptChannel, PFN_NOTIFY_CALLBACK pfnCallback, uint32_t ulNotification,
+                        uint32_t ulDataLen, void* pvData, void* pvUser)
+{
+  PDEVICEINSTANCE ptDevInstance = (PDEVICEINSTANCE)ptChannel->pvDeviceInstance;
+
+  if(NULL != ptDevInstance->pfnNotifyDispatch)
+    ptDevInstance->pfnNotifyDispatch(ptDevInstance, ptChannel, pfnCallback, ulNotification, ulDataLen, pvData, pvUser);
+  else
+    pfnCallback(ulNotification, ulDataLen, pvData, pvUser);
+}
+
+/*****************************************************************************/
+/*! Report a channel notification to the device instance (pfnNotifySignal).
+*   Called on every notification, even if no user callback is registered.
+*   \param ptChannel       Channel instance the notification belongs to
+*   \param ulNotification  Notification (CIFX_NOTIFY_xxx)                   */
+/*****************************************************************************/
+void DEV_NotifySignal(PCHANNELINSTANCE ptChannel, uint32_t ulNotification)
+{
+  PDEVICEINSTANCE ptDevInstance = (PDEVICEINSTANCE)ptChannel->pvDeviceInstance;
+
+  if(NULL != ptDevInstance->pfnNotifySignal)
+    ptDevInstance->pfnNotifySignal(ptDevInstance, ptChannel, ulNotification);
+}
+
 /*****************************************************************************/
 /*! Check the COS flags on this device
 *   \param ptDevInstance  Device instance                                    */
@@ -1597,6 +1835,9 @@ int32_t DEV_DoChannelInit(PCHANNELINSTANCE ptChannel, uint32_t ulTimeout)
 
   } else
   {
+    /* Output areas may be cleared by the firmware */
+    CIFX_TKIT_ATOMIC_INC(&ptChannel->ulIOResetCount);
+
     lRet = DEV_DoHostCOSChange(ptChannel,
                                HIL_APP_COS_INITIALIZATION | HIL_APP_COS_INITIALIZATION_ENABLE, /* set mask        */
                                0,                                                              /* clear mask      */
@@ -1691,6 +1932,9 @@ static void DEV_Reset_Prepare(PDEVICEINSTANCE ptDevInstance)
 
   for ( ulIdx = 0; ulIdx < ptDevInstance->ulCommChannelCount; ulIdx++)
   {
+    /* Output areas may be cleared by the firmware */
+    CIFX_TKIT_ATOMIC_INC(&ptDevInstance->pptCommChannels[ulIdx]->ulIOResetCount);
+
     OS_EnterLock(ptDevInstance->pptCommChannels[ulIdx]->pvLock);
     ptDevInstance->pptCommChannels[ulIdx]->usHostFlags      = 0;
     ptDevInstance->pptCommChannels[ulIdx]->usNetxFlags      = 0;
@@ -1821,6 +2065,8 @@ int32_t DEV_DoSystemStart(PCHANNELINSTANCE ptChannel, uint32_t ulTimeout, uint32
 
     } else
     {
+      DEV_BootTimelineStart(ptDevInstance, "system start requested");
+
       /* Prepare reset */
       DEV_Reset_Prepare(ptDevInstance);
 
@@ -1837,12 +2083,10 @@ int32_t DEV_DoSystemStart(PCHANNELINSTANCE ptChannel, uint32_t ulTimeout, uint32
       /* Now wait for the card to come back */
       if(CIFX_NO_ERROR == lRet)
       {
-        /* Prohibit access to possibly uninitialized PCI memory during reset of netX4000 based PCI devices.
-           Timeout of 1s was communicated to be the upper boundary. */
-        if( (ptDevInstance->fPCICard) &&
-            (( eCHIP_TYPE_NETX4000 == ptDevInstance->eChipType) ||
-             ( eCHIP_TYPE_NETX4100 == ptDevInstance->eChipType)  )  )
-          OS_Sleep(1000);
+        DEV_BootTimelineAdd(ptDevInstance, "device left READY state");
+
+        /* Prohibit access to possibly uninitialized PCI memory during reset of netX4000 based PCI devices */
+        DEV_WaitNetX4000PCIReset(ptDevInstance);
 
         /* now wait for card to become READY */
         if( !DEV_WaitForReady_Poll( ptSysDevice, ( 0 == ulTimeout) ? CIFX_TO_WAIT_HW : ulTimeout) )
@@ -1859,6 +2103,8 @@ int32_t DEV_DoSystemStart(PCHANNELINSTANCE ptChannel, uint32_t ulTimeout, uint32
 
         /* Re-read device handshake flags */
         DEV_Reset_Finish(ptDevInstance);
+
+        DEV_BootTimelineAdd(ptDevInstance, (CIFX_NO_ERROR == lRet) ? "device READY" : "device start failed");
       }
 
       /* it is not possible to distinguish between success and failure since do not know the correct state after reset */
@@ -1939,6 +2185,8 @@ int32_t DEV_DoSystemBootstart(PCHANNELINSTANCE ptChannel, uint32_t ulTimeout, ui
 
     } else
     {
+      DEV_BootTimelineStart(ptDevInstance, "boot start requested");
+
       /* Prepare reset */
       DEV_Reset_Prepare(ptDevInstance);
 
@@ -1955,12 +2203,10 @@ int32_t DEV_DoSystemBootstart(PCHANNELINSTANCE ptChannel, uint32_t ulTimeout, ui
       /* Now wait for the card to come back */
       if(CIFX_NO_ERROR == lRet)
       {
-        /* Prohibit access to possibly uninitialized PCI memory during reset of netX4000 based PCI devices.
-           Timeout of 1s was communicated to be the upper boundary. */
-        if( (ptDevInstance->fPCICard) &&
-            (( eCHIP_TYPE_NETX4000 == ptDevInstance->eChipType) ||
-             ( eCHIP_TYPE_NETX4100 == ptDevInstance->eChipType)  )  )
-          OS_Sleep(1000);
+        DEV_BootTimelineAdd(ptDevInstance, "device left READY state");
+
+        /* Prohibit access to possibly uninitialized PCI memory during reset of netX4000 based PCI devices */
+        DEV_WaitNetX4000PCIReset(ptDevInstance);
 
         /* now wait for card to become READY */
         if( !DEV_WaitForReady_Poll( ptSysDevice, ( 0 == ulTimeout) ? CIFX_TO_WAIT_HW : ulTimeout) )
@@ -1998,6 +2244,8 @@ int32_t DEV_DoSystemBootstart(PCHANNELINSTANCE ptChannel, uint32_t ulTimeout, ui
 
         /* Re-read device handshake flags */
         DEV_Reset_Finish(ptDevInstance);
+
+        DEV_BootTimelineAdd(ptDevInstance, (CIFX_NO_ERROR == lRet) ? "device READY" : "device start failed");
       }
     }
     OS_ReleaseMutex(ptDevInstance->tSystemDevice.pvInitMutex);
@@ -2057,6 +2305,8 @@ int32_t DEV_DoUpdateStart(PCHANNELINSTANCE ptChannel, uint32_t ulTimeout, uint32
     {
       char szCookie[5] = {0};
 
+      DEV_BootTimelineStart(ptDevInstance, "update start requested");
+
       /* Prepare reset */
       DEV_Reset_Prepare(ptDevInstance);
 
@@ -2073,12 +2323,10 @@ int32_t DEV_DoUpdateStart(PCHANNELINSTANCE ptChannel, uint32_t ulTimeout, uint32
       /* Now wait for the card to come back */
       if(CIFX_NO_ERROR == lRet)
       {
-        /* Prohibit access to possibly uninitialized PCI memory during reset of netX4000 based PCI devices.
-           Timeout of 1s was communicated to be the upper boundary. */
-        if( (ptDevInstance->fPCICard) &&
-            (( eCHIP_TYPE_NETX4000 == ptDevInstance->eChipType) ||
-             ( eCHIP_TYPE_NETX4100 == ptDevInstance->eChipType)  )  )
-          OS_Sleep(1000);
+        DEV_BootTimelineAdd(ptDevInstance, "device left READY state");
+
+        /* Prohibit access to possibly uninitialized PCI memory during reset of netX4000 based PCI devices */
+        DEV_WaitNetX4000PCIReset(ptDevInstance);
 
         /* now wait for card to become READY */
         if( !DEV_WaitForReady_Poll( ptSysDevice, CIFX_TO_WAIT_HW ) )
@@ -2136,12 +2384,10 @@ int32_t DEV_DoUpdateStart(PCHANNELINSTANCE ptChannel, uint32_t ulTimeout, uint32
             /* Only continue if update timeout was sufficient */
             if(CIFX_NO_ERROR == lRet)
             {
-              /* Prohibit access to possibly uninitialized PCI memory during reset of netX4000 based PCI devices.
-                 Timeout of 1s was communicated to be the upper boundary. */
-              if( (ptDevInstance->fPCICard) &&
-                  (( eCHIP_TYPE_NETX4000 == ptDevInstance->eChipType) ||
-                   ( eCHIP_TYPE_NETX4100 == ptDevInstance->eChipType)  )  )
-                OS_Sleep(1000);
+              DEV_BootTimelineAdd(ptDevInstance, "update applied, device left READY state");
+
+              /* Prohibit access to possibly uninitialized PCI memory during reset of netX4000 based PCI devices */
+              DEV_WaitNetX4000PCIReset(ptDevInstance);
 
               /* now wait for card to become READY again */
               if( !DEV_WaitForReady_Poll( ptSysDevice, CIFX_TO_FIRMWARE_START) )
@@ -2161,6 +2407,8 @@ int32_t DEV_DoUpdateStart(PCHANNELINSTANCE ptChannel, uint32_t ulTimeout, uint32
 
         /* Re-read device handshake flags */
         DEV_Reset_Finish(ptDevInstance);
+
+        DEV_BootTimelineAdd(ptDevInstance, (CIFX_NO_ERROR == lRet) ? "device READY" : "device start failed");
       }
 
       /* Log the current DPM state */
@@ -12,6 +12,18 @@ Copyright (c) Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserv
   Changes:
     Date        Description
     -----------------------------------------------------------------------------------
+    2026-10-18  - Added pvDeviceLock to DEVICEINSTANCE (per device COS polling lock)
+                - Added pfnNotifyDispatch to DEVICEINSTANCE and DEV_NotifyCallback()
+                - Added pfnNotifySignal to DEVICEINSTANCE and DEV_NotifySignal()
+                - Added configurable reset/startup wait times (tBootTiming) and the
+                  boot timeline (tBootTimeline) to DEVICEINSTANCE
+                - Added CIFX_TKIT_NOALLOC_SCOPE() default definition
+                - Added CIFX_TKIT_DOWNLOAD_WINDOW default definition
+                - Added CIFX_TKIT_ATOMIC_xxx default definitions
+                - Added input change filter (ptChangeFilter) to IOINSTANCE
+                  and CIFX_TO_CHANGE_FILTER_LOCK default definition
+                - Added output shadow (ptOutputShadow) to IOINSTANCE and ulIOResetCount
+                  to CHANNELINSTANCE for delta writes of the output areas
     2023-04-26  DEV function definitions from cifXToolkit.h moved here
     2023-04-18  Added new option parameter for HWIF_READN / WRITEN function, to be able to
                 recognize single HWIF_READ16/WRITE32 and HWIF_READ32/WRITE32 accesses
@@ -46,6 +58,35 @@ extern "C"
 #include "Hil_FirmwareIdent.h"
 #include "NetX_RegDefs.h"
 
+#ifndef CIFX_TKIT_NOALLOC_SCOPE
+  /* Marks a function, which must not allocate memory (IO, mailbox, DSR). Must be the
+     last declaration of the function. The OS layer may define a checking version. */
+  #define CIFX_TKIT_NOALLOC_SCOPE()
+#endif
+
+#ifndef CIFX_TKIT_DOWNLOAD_WINDOW
+  /* Maximum number of file download data packets sent to the device before waiting
+     for the confirmation. Pipelined data packets are not supported by every firmware,
+     so define a value > 1 only for firmware known to handle them. The number is
+     further limited by the packets the send mailbox accepts (usPackagesAccepted). */
+  #define CIFX_TKIT_DOWNLOAD_WINDOW  1
+#endif
+
+#ifndef CIFX_TO_CHANGE_FILTER_LOCK
+  /* Maximum time xChannelIOSetChangeFilter() waits for the IO area, while it is
+     read by xChannelIOReadChanged() */
+  #define CIFX_TO_CHANGE_FILTER_LOCK  100UL
+#endif
+
+#ifndef CIFX_TKIT_ATOMIC_LOAD
+  /* Sequentially consistent atomic accesses (GCC builtins by default, may be
+     defined by the compiler/OS specific headers) */
+  #define CIFX_TKIT_ATOMIC_LOAD(ptr)       __atomic_load_n((ptr), __ATOMIC_SEQ_CST)
+  #define CIFX_TKIT_ATOMIC_STORE(ptr, val) __atomic_store_n((ptr), (val), __ATOMIC_SEQ_CST)
+  #define CIFX_TKIT_ATOMIC_INC(ptr)        (void)__atomic_add_fetch((ptr), 1, __ATOMIC_SEQ_CST)
+  #define CIFX_TKIT_ATOMIC_DEC(ptr)        (void)__atomic_sub_fetch((ptr), 1, __ATOMIC_SEQ_CST)
+#endif
+
 /*****************************************************************************/
 /*!  \addtogroup CIFX_TK_STRUCTURE Toolkit Structure Definitions
 *    \{                                                                      */
@@ -72,6 +113,38 @@ typedef struct USERINSTANCEtag
 
 } USERINSTANCE, *PUSERINSTANCE;
 
+/*****************************************************************************/
+/*! Change filter of an input area (xChannelIOSetChangeFilter()). The images
+*   cover the range from ulStart to ulStart + ulLength, which contains all
+*   watched ranges. Allocated as one block including both images.           */
+/*****************************************************************************/
+typedef struct IO_CHANGE_FILTER_Ttag
+{
+  uint32_t                      ulRangeCount;             /*!< Number of watched ranges                   */
+  CIFX_IO_RANGE                 atRanges[CIFX_IO_MAX_CHANGE_RANGES]; /*!< Watched ranges                  */
+  uint32_t                      ulStart;                  /*!< Start offset of the images in the area     */
+  uint32_t                      ulLength;                 /*!< Length of the images                       */
+  int                           fSnapshotValid;           /*!< !=0 if pbSnapshot was filled               */
+  uint8_t*                      pbSnapshot;               /*!< Image last returned to the user            */
+  uint8_t*                      pbImage;                  /*!< Image read on the actual handshake         */
+
+} IO_CHANGE_FILTER_T, *PIO_CHANGE_FILTER_T;
+
+/*****************************************************************************/
+/*! Shadow of an output area for delta writes (USER_GetIODeltaWriteMode()).
+*   pbImage holds the data last written to the area, which is valid from
+*   ulValidStart to ulValidEnd. Allocated as one block including the image. */
+/*****************************************************************************/
+typedef struct IO_OUTPUT_SHADOW_Ttag
+{
+  uint32_t                      ulMergeGap;               /*!< Max. unchanged bytes written along to join two changed runs */
+  uint32_t                      ulResetCount;             /*!< ulIOResetCount of the channel the image belongs to */
+  uint32_t                      ulValidStart;             /*!< Start offset of the valid image data       */
+  uint32_t                      ulValidEnd;               /*!< End offset of the valid image data         */
+  uint8_t*                      pbImage;                  /*!< Image of the complete output area          */
+
+} IO_OUTPUT_SHADOW_T, *PIO_OUTPUT_SHADOW_T;
+
 /*****************************************************************************/
 /*! Structure defining an I/O Block                                          */
 /*****************************************************************************/
@@ -86,6 +159,8 @@ typedef struct IOINSTANCEtag
   uint32_t                      ulNotifyEvent;            /*!< Event that is signalled via callback             */
   PFN_NOTIFY_CALLBACK           pfnCallback;              /*!< Notification callback                            */
   void*                         pvUser;                   /*!< User pointer for callback                        */
+  PIO_CHANGE_FILTER_T           ptChangeFilter;           /*!< Change filter of an input area, NULL if disabled */
+  PIO_OUTPUT_SHADOW_T           ptOutputShadow;           /*!< Shadow of an output area, NULL if delta writes are disabled */
 
 } IOINSTANCE, *PIOINSTANCE;
 
@@ -209,6 +284,7 @@ typedef struct CHANNELINSTANCEtag
 
   PIOINSTANCE*          pptIOOutputAreas;                 /*!< Output Areas array for this channel  */
   uint32_t              ulIOOutputAreas;                  /*!< Number of Output areas               */
+  uint32_t              ulIOResetCount;                   /*!< Incremented on resets and direct (PLC) output accesses, invalidates the output shadows */
 
   PUSERINSTANCE*        pptUserAreas;                     /*!< User areas for this channel          */
   uint32_t              ulUserAreas;                      /*!< Number of user areas                 */
@@ -265,6 +341,19 @@ typedef enum CIFX_TOOLKIT_NOTIFY_Etag
 
 typedef void(*PFN_CIFXTK_NOTIFY)(void* pvDeviceInstance, CIFX_TOOLKIT_NOTIFY_E eEvent);
 
+/*****************************************************************************/
+/*! Function taking over the execution of a channel notification callback
+*   (e.g. to run it in another thread). pvData is only valid during the call. */
+/*****************************************************************************/
+typedef void(*PFN_CIFXTK_NOTIFY_DISPATCH)(void* pvDeviceInstance, void* pvChannel, PFN_NOTIFY_CALLBACK pfnCallback,
+                                          uint32_t ulNotification, uint32_t ulDataLen, void* pvData, void* pvUser);
+
+/*****************************************************************************/
+/*! Function called on every channel notification, independent of a registered
+*   callback and without dispatching (runs in DSR context, must not block)    */
+/*****************************************************************************/
+typedef void(*PFN_CIFXTK_NOTIFY_SIGNAL)(void* pvDeviceInstance, void* pvChannel, uint32_t ulNotification);
+
 typedef struct IRQ_TO_DSR_BUFFER_Ttag
 {
   HIL_DPM_HANDSHAKE_ARRAY_T tHandshakeBuffer;
@@ -281,6 +370,15 @@ typedef enum CIFX_TOOLKIT_CACHED_MODE_Etag
   eCACHED_MODE_ON                         /*!< Map IO buffer pointers in cached mode */
 } CIFX_TOOLKIT_CACHED_MODE_E;
 
+/*****************************************************************************/
+/*! Definition for delta writes of the IO output areas                       */
+/*****************************************************************************/
+typedef enum CIFX_TOOLKIT_IO_DELTA_WRITE_Etag
+{
+  eIO_DELTA_WRITE_OFF = 0,                /*!< xChannelIOWrite() transfers all data passed */
+  eIO_DELTA_WRITE_ON                      /*!< xChannelIOWrite() transfers only data changed since the last write */
+} CIFX_TOOLKIT_IO_DELTA_WRITE_E;
+
 /*****************************************************************************/
 /*! DMA buffer structure.
 *   In DMA mode, passing the physical and virtual pointers to pre-defined
@@ -398,6 +496,47 @@ typedef struct CIFX_SYNCH_DATA_Ttag
   #define HWIF_WRITEN(ptDev, Dst, Src, Len) OS_Memcpy(Dst, Src, Len)
 #endif /* CIFX_TOOLKIT_HWIF */
 
+/*****************************************************************************/
+/*! Wait times used while resetting and starting a device. Entries left 0
+*   are set to the toolkit defaults by cifXTKitAddDevice()                   */
+/*****************************************************************************/
+typedef struct CIFX_BOOT_TIMING_Ttag
+{
+  uint32_t ulPCIResetTime;          /*!< Time [ms] after a hardware reset of a PCI device, before its PCI
+                                         configuration is restored (default NET_BOOTLOADER_RESET_TIME) */
+  uint32_t ulDPMResetTime;          /*!< Time [ms] after a hardware reset of a DPM device, before the DPM
+                                         is polled (default NET_BOOTLOADER_RESET_TIME_DPM) */
+  uint32_t ulNetX4000PCIResetTime;  /*!< Time [ms] without any DPM access after a system reset of a netX4000/4100
+                                         PCI device (default NET_NETX4000_PCI_RESET_TIME) */
+  uint32_t ulPollIntervalMin;       /*!< First poll interval [ms] while waiting for the device, doubled on
+                                         every poll (default NET_BOOTLOADER_POLL_MIN) */
+  uint32_t ulPollIntervalMax;       /*!< Poll interval limit [ms] (default NET_BOOTLOADER_POLL_MAX) */
+
+} CIFX_BOOT_TIMING_T;
+
+#define CIFX_BOOT_TIMELINE_EVENTS 32 /*!< Maximum number of recorded events per reset/startup */
+
+/*****************************************************************************/
+/*! Timestamped event of a device reset/startup                             */
+/*****************************************************************************/
+typedef struct CIFX_BOOT_EVENT_Ttag
+{
+  uint32_t    ulTime;                /*!< Time [ms] since the start of the reset/startup */
+  const char* szEvent;               /*!< Description of the event (static string) */
+
+} CIFX_BOOT_EVENT_T;
+
+/*****************************************************************************/
+/*! Timeline of the last reset/startup of a device                           */
+/*****************************************************************************/
+typedef struct CIFX_BOOT_TIMELINE_Ttag
+{
+  uint32_t          ulStartTime;     /*!< OS_GetMilliSecCounter() at the start of the reset/startup */
+  uint32_t          ulEventCount;    /*!< Number of valid entries in atEvents */
+  CIFX_BOOT_EVENT_T atEvents[CIFX_BOOT_TIMELINE_EVENTS];
+
+} CIFX_BOOT_TIMELINE_T;
+
 /*****************************************************************************/
 /*! Structure defining a physical device passed to the toolkit. Passing it,
 *   will create all logical device associated with this instance             */
@@ -462,6 +601,15 @@ typedef struct DEVICEINSTANCEtag
   PFN_HWIF_MEMCPY           pfnHwIfWrite;           /*!< Definable hardware read function                        */
 #endif /* CIFX_TOOLKIT_HWIF */
 
+  void*                     pvDeviceLock;           /*!< Serializes COS polling and removal of this device (created by toolkit) */
+
+  PFN_CIFXTK_NOTIFY_DISPATCH pfnNotifyDispatch;     /*!< Optional, executes channel notification callbacks instead of
+                                                         calling them directly (NULL = call in DSR/caller context) */
+  PFN_CIFXTK_NOTIFY_SIGNAL  pfnNotifySignal;        /*!< Optional, called on every channel notification (NULL = not used) */
+
+  CIFX_BOOT_TIMING_T        tBootTiming;            /*!< Reset/startup wait times, may be set by the user before cifXTKitAddDevice() */
+  CIFX_BOOT_TIMELINE_T      tBootTimeline;          /*!< Timeline of the last reset/startup of the device */
+
 } DEVICEINSTANCE, *PDEVICEINSTANCE;
 
 /*****************************************************************************/
@@ -480,6 +628,7 @@ uint8_t DEV_GetIOBitstate         (PCHANNELINSTANCE ptChannel, PIOINSTANCE ptIOI
 
 int     DEV_WaitForBitState       (PCHANNELINSTANCE ptChannel, uint32_t ulBitNumber, uint8_t bState, uint32_t ulTimeout);
 void    DEV_ToggleBit             (PCHANNELINSTANCE ptChannel, uint32_t ulBitMask);
+void    DEV_WriteIOData           (PCHANNELINSTANCE ptChannel, PIOINSTANCE ptIOArea, uint32_t ulOffset, uint32_t ulDataLen, void* pvData);
 
 int     DEV_WaitForSyncState      (PCHANNELINSTANCE ptChannel, uint8_t bState, uint32_t ulTimeout);
 void    DEV_ToggleSyncBit         (PDEVICEINSTANCE  ptDevInstance, uint32_t ulBitMask);
@@ -512,8 +661,16 @@ int32_t DEV_BusState              (PCHANNELINSTANCE ptChannel, uint32_t ulCmd, u
 int32_t DEV_DoHostCOSChange       (PCHANNELINSTANCE ptChannel, uint32_t ulSetCOSMask, uint32_t ulClearCOSMask,
                                    uint32_t ulPostClearCOSMask, int32_t lSignallingError, uint32_t ulTimeout);
 void    DEV_CheckCOSFlags         (PDEVICEINSTANCE ptDevInstance);
+void    DEV_NotifyCallback        (PCHANNELINSTANCE ptChannel, PFN_NOTIFY_CALLBACK pfnCallback, uint32_t ulNotification,
+                                   uint32_t ulDataLen, void* pvData, void* pvUser);
+void    DEV_NotifySignal          (PCHANNELINSTANCE ptChannel, uint32_t ulNotification);
 uint8_t DEV_GetHandshakeBitState  (PCHANNELINSTANCE ptChannel, uint32_t ulBitMsk);
 
+void    DEV_InitBootTiming        (PDEVICEINSTANCE ptDevInstance);
+void    DEV_PollBackoff           (PDEVICEINSTANCE ptDevInstance, uint32_t* pulInterval);
+void    DEV_BootTimelineStart     (PDEVICEINSTANCE ptDevInstance, const char* szEvent);
+void    DEV_BootTimelineAdd       (PDEVICEINSTANCE ptDevInstance, const char* szEvent);
+
 /* Toolkit Internal Functions */
 int     DEV_RemoveChannelFiles    (PCHANNELINSTANCE ptChannel, uint32_t ulChannel,
                                    PFN_TRANSFER_PACKET    pfnTransferPacket,
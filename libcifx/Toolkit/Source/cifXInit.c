@@ -15,6 +15,14 @@ Copyright (c) Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserv
   Changes:
     Date        Description
     -----------------------------------------------------------------------------------
+    2026-10-18  - Added handle table for API handle validation (CIFX_TOOLKIT_PARAMETER_CHECK)
+                - COS polling locks the device instead of the complete device list,
+                  added cifXTKitCyclicTimerDevice() for per device poll timers
+                - Hardware reset and bootloader start poll the device with back-off
+                  instead of fixed sleeps, record the boot timeline of the device
+                - Free the input change filter of the IO areas
+                - Added new user function to enable delta writes of the output areas
+                  (USER_GetIODeltaWriteMode()), creates the output shadows
     2023-04-27  Added cifXReadHardwareIdent() function, to read netX "ChipType"
     2022-06-14  Added new user function to read IO buffer caching option
 
@@ -96,23 +104,268 @@ TKIT_DRIVER_INFORMATION g_tDriverInfo   = {0};    /*!< Global driver information
 
 void* g_pvTkitLock = NULL;
 
+#ifdef CIFX_TOOLKIT_PARAMETER_CHECK
 /*****************************************************************************/
-/*! Cyclic timer for COS bit checking, if we are running in polling mode     */
+/*! Handle table (open addressing, linear probing) containing the system
+*   device and all communication channels of the handled devices.
+*   The table is rebuilt whenever the device list changes, so the API handle
+*   validation does not need to scan the complete device list.
+*   The lookup does not take g_pvTkitLock. A rebuilt table is published
+*   through an atomic pointer, replaced tables are kept on a retired list
+*   and freed by a later rebuild, once no lookup is running.               */
+/*****************************************************************************/
+typedef struct CIFX_HANDLE_TABLE_Ttag
+{
+  struct CIFX_HANDLE_TABLE_Ttag* ptNextRetired;  /*!< Next table on the retired list                          */
+  uint32_t                       ulMask;         /*!< Number of table entries - 1 (entry count is a power of 2) */
+  PCHANNELINSTANCE               aptEntries[1];  /*!< Registered channel instances (NULL = free entry)          */
+
+} CIFX_HANDLE_TABLE_T;
+
+#define CIFX_HANDLE_TABLE_MIN_ENTRIES 16
+
+static CIFX_HANDLE_TABLE_T* s_ptHandleTable         = NULL;  /*!< Published table (atomic access)          */
+static CIFX_HANDLE_TABLE_T* s_ptRetiredHandleTables = NULL;  /*!< Replaced tables, protected by g_pvTkitLock */
+static uint32_t             s_ulHandleTableReaders  = 0;     /*!< Running lookups (atomic access)           */
+
+/*****************************************************************************/
+/*! Calculate the start index of a handle inside the handle table
+*   \param pvHandle Handle (channel instance pointer)
+*   \param ulMask   Table mask
+*   \return Table index                                                      */
+/*****************************************************************************/
+static uint32_t cifXTKitHashHandle(void* pvHandle, uint32_t ulMask)
+{
+  /* Channel instances are heap / structure aligned, so skip the lower bits */
+  return ((uint32_t)((uintptr_t)pvHandle >> 4) * 0x9E3779B1UL) & ulMask;
+}
+
+/*****************************************************************************/
+/*! Insert a channel instance into the handle table
+*   \param ptTable   Handle table
+*   \param ptChannel Channel instance to insert                              */
+/*****************************************************************************/
+static void cifXTKitInsertHandle(CIFX_HANDLE_TABLE_T* ptTable, PCHANNELINSTANCE ptChannel)
+{
+  uint32_t ulIdx = cifXTKitHashHandle(ptChannel, ptTable->ulMask);
+
+  while(NULL != ptTable->aptEntries[ulIdx])
+    ulIdx = (ulIdx + 1) & ptTable->ulMask;
+
+  ptTable->aptEntries[ulIdx] = ptChannel;
+}
+
+/*****************************************************************************/
+/*! Rebuild the handle table from the actual device list.
+*   NOTE: Must be called with g_pvTkitLock held                              */
+/*****************************************************************************/
+static void cifXTKitUpdateHandleTable(void)
+{
+  CIFX_HANDLE_TABLE_T* ptOldTable = s_ptHandleTable;
+  CIFX_HANDLE_TABLE_T* ptNewTable = NULL;
+  uint32_t             ulHandles  = 0;
+  uint32_t             ulEntries  = CIFX_HANDLE_TABLE_MIN_ENTRIES;
+  uint32_t             ulDevice;
+
+  if(NULL != g_pptDevices)
+  {
+    for(ulDevice = 0; ulDevice < g_ulDeviceCount; ++ulDevice)
+      ulHandles += 1 + g_pptDevices[ulDevice]->ulCommChannelCount;
+  }
+
+  if(0 != ulHandles)
+  {
+    uint32_t ulTableSize;
+
+    /* Keep the load factor below 50% to have short probe sequences */
+    while(ulEntries < 2 * ulHandles)
+      ulEntries <<= 1;
+
+    ulTableSize = (uint32_t)sizeof(*ptNewTable) + (ulEntries - 1) * (uint32_t)sizeof(ptNewTable->aptEntries[0]);
+
+    if(NULL == (ptNewTable = (CIFX_HANDLE_TABLE_T*)OS_Memalloc(ulTableSize)))
+    {
+      /* ulHandles != 0, so there is at least one device to trace to */
+      if(g_ulTraceLevel & TRACE_LEVEL_ERROR)
+      {
+        USER_Trace(g_pptDevices[0],
+                  TRACE_LEVEL_ERROR,
+                  "Error creating handle table, handle validation falls back to device list scan!");
+      }
+    } else
+    {
+      OS_Memset(ptNewTable, 0, ulTableSize);
+      ptNewTable->ulMask = ulEntries - 1;
+
+      for(ulDevice = 0; ulDevice < g_ulDeviceCount; ++ulDevice)
+      {
+        PDEVICEINSTANCE ptDevInst = g_pptDevices[ulDevice];
+        uint32_t        ulChannel;
+
+        cifXTKitInsertHandle(ptNewTable, &ptDevInst->tSystemDevice);
+
+        for(ulChannel = 0; ulChannel < ptDevInst->ulCommChannelCount; ++ulChannel)
+          cifXTKitInsertHandle(ptNewTable, ptDevInst->pptCommChannels[ulChannel]);
+      }
+    }
+  }
+
+  CIFX_TKIT_ATOMIC_STORE(&s_ptHandleTable, ptNewTable);
+
+  if(NULL != ptOldTable)
+  {
+    ptOldTable->ptNextRetired = s_ptRetiredHandleTables;
+    s_ptRetiredHandleTables   = ptOldTable;
+  }
+
+  /* A lookup starting after this check already sees the new table, so the
+     retired tables can be freed if no lookup is running */
+  if(0 == CIFX_TKIT_ATOMIC_LOAD(&s_ulHandleTableReaders))
+  {
+    while(NULL != s_ptRetiredHandleTables)
+    {
+      CIFX_HANDLE_TABLE_T* ptRetired = s_ptRetiredHandleTables;
+
+      s_ptRetiredHandleTables = ptRetired->ptNextRetired;
+      OS_Memfree(ptRetired);
+    }
+  }
+}
+
+/*****************************************************************************/
+/*! Search the device list for the given handle.
+*   NOTE: Must be called with g_pvTkitLock held
+*   \param pvHandle System device or channel handle
+*   \return !=0 if the handle is registered                                 */
+/*****************************************************************************/
+static int cifXTKitScanDevicesForHandle(void* pvHandle)
+{
+  uint32_t ulDevice;
+
+  if(NULL == g_pptDevices)
+    return 0;
+
+  for(ulDevice = 0; ulDevice < g_ulDeviceCount; ++ulDevice)
+  {
+    PDEVICEINSTANCE ptDevInst = g_pptDevices[ulDevice];
+    uint32_t        ulChannel;
+
+    if(pvHandle == (void*)&ptDevInst->tSystemDevice)
+      return 1;
+
+    for(ulChannel = 0; ulChannel < ptDevInst->ulCommChannelCount; ++ulChannel)
+    {
+      if(pvHandle == (void*)ptDevInst->pptCommChannels[ulChannel])
+        return 1;
+    }
+  }
+
+  return 0;
+}
+
+/*****************************************************************************/
+/*! Check if the given handle belongs to a device handled by the toolkit.
+*   The handle table is searched without taking g_pvTkitLock. Only if no
+*   handle table is available (e.g. allocation failed), the device list is
+*   scanned with g_pvTkitLock held.
+*   \param pvHandle System device or channel handle
+*   \return !=0 if the handle is registered                                 */
+/*****************************************************************************/
+int cifXTKitIsRegisteredHandle(void* pvHandle)
+{
+  CIFX_HANDLE_TABLE_T* ptTable;
+  int                  iRet = 0;
+
+  /* Announce the lookup before reading the table pointer, so a rebuild
+     does not free the table while it is searched */
+  CIFX_TKIT_ATOMIC_INC(&s_ulHandleTableReaders);
+
+  ptTable = CIFX_TKIT_ATOMIC_LOAD(&s_ptHandleTable);
+
+  if(NULL != ptTable)
+  {
+    uint32_t ulIdx = cifXTKitHashHandle(pvHandle, ptTable->ulMask);
+
+    while(NULL != ptTable->aptEntries[ulIdx])
+    {
+      if(pvHandle == (void*)ptTable->aptEntries[ulIdx])
+      {
+        iRet = 1;
+        break;
+      }
+
+      ulIdx = (ulIdx + 1) & ptTable->ulMask;
+    }
+  }
+
+  CIFX_TKIT_ATOMIC_DEC(&s_ulHandleTableReaders);
+
+  if(NULL == ptTable)
+  {
+    OS_EnterLock(g_pvTkitLock);
+    iRet = cifXTKitScanDevicesForHandle(pvHandle);
+    OS_LeaveLock(g_pvTkitLock);
+  }
+
+  return iRet;
+}
+#endif /* CIFX_TOOLKIT_PARAMETER_CHECK */
+
+/*****************************************************************************/
+/*! Cyclic timer for COS bit checking, if we are running in polling mode.
+*   The device list lock is only held to pick the next device, so a slow
+*   device does not delay adding/removing or polling the other devices.     */
 /*****************************************************************************/
 void cifXTKitCyclicTimer(void)
 {
-  uint32_t ulIdx;
+  uint32_t ulIdx = 0;
 
-  OS_EnterLock(g_pvTkitLock);
-  for(ulIdx = 0; ulIdx < g_ulDeviceCount; ulIdx++)
+  while(1)
   {
-    if(!g_pptDevices[ulIdx]->fIrqEnabled)
+    PDEVICEINSTANCE ptDevInstance;
+
+    OS_EnterLock(g_pvTkitLock);
+
+    /* NOTE: If a device is removed in the meantime, the following device may be
+             skipped in this cycle */
+    if(ulIdx >= g_ulDeviceCount)
+    {
+      OS_LeaveLock(g_pvTkitLock);
+      break;
+    }
+
+    ptDevInstance = g_pptDevices[ulIdx++];
+
+    /* Lock the device before releasing the list, so it can't be removed while polling */
+    OS_EnterLock(ptDevInstance->pvDeviceLock);
+    OS_LeaveLock(g_pvTkitLock);
+
+    if(!ptDevInstance->fIrqEnabled)
     {
       /* Device is not running in IRQ mode, so we need to check COS */
-      DEV_CheckCOSFlags(g_pptDevices[ulIdx]);
+      DEV_CheckCOSFlags(ptDevInstance);
     }
+
+    OS_LeaveLock(ptDevInstance->pvDeviceLock);
   }
-  OS_LeaveLock(g_pvTkitLock);
+}
+
+/*****************************************************************************/
+/*! Cyclic timer for COS bit checking of a single device, if it is running in
+*   polling mode. Allows polling each device with its own timer instead of
+*   calling cifXTKitCyclicTimer().
+*   NOTE: The caller must stop calling this function before the device is
+*         removed (cifXTKitRemoveDevice() / cifXTKitDeinit())
+*   \param ptDevInstance Device to check                                     */
+/*****************************************************************************/
+void cifXTKitCyclicTimerDevice(PDEVICEINSTANCE ptDevInstance)
+{
+  OS_EnterLock(ptDevInstance->pvDeviceLock);
+
+  if(!ptDevInstance->fIrqEnabled)
+    DEV_CheckCOSFlags(ptDevInstance);
+
+  OS_LeaveLock(ptDevInstance->pvDeviceLock);
 }
 
 /*****************************************************************************/
@@ -150,6 +403,10 @@ static void cifXDeleteChannelInstance(PCHANNELINSTANCE ptChannelInst)
         /* Delete synchronisation object */
         OS_DeleteMutex(ptIoInst->pvMutex);
 
+        /* Delete change filter (includes the images) */
+        if(NULL != ptIoInst->ptChangeFilter)
+          OS_Memfree(ptIoInst->ptChangeFilter);
+
         OS_Memfree(ptIoInst);
         ptChannelInst->pptIOInputAreas[ulTemp] = NULL;
       }
@@ -173,6 +430,10 @@ static void cifXDeleteChannelInstance(PCHANNELINSTANCE ptChannelInst)
         /* Delete synchronisation object */
         OS_DeleteMutex(ptIoInst->pvMutex);
 
+        /* Delete output shadow (includes the image) */
+        if(NULL != ptIoInst->ptOutputShadow)
+          OS_Memfree(ptIoInst->ptOutputShadow);
+
         OS_Memfree(ptIoInst);
         ptChannelInst->pptIOOutputAreas[ulTemp] = NULL;
       }
@@ -307,6 +568,10 @@ static int32_t cifXHardwareReset(PDEVICEINSTANCE ptDevInstance)
 
   void*                   pvPCIConfig    = NULL;
   uint32_t                ulIdx          = 0;
+  uint32_t                ulState        = 0;
+  uint32_t                ulInterval     = 0;
+  uint32_t                ulDiffTime     = 0;
+  int32_t                 lStartTime     = 0;
   int32_t                 lRet           = CIFX_DRV_INIT_STATE_ERROR;
   volatile uint32_t*      pulHostReset   = &ptDevInstance->ptGlobalRegisters->ulHostReset;
   volatile uint32_t*      pulSystemState = &ptDevInstance->ptGlobalRegisters->ulSystemState;
@@ -333,8 +598,12 @@ static int32_t cifXHardwareReset(PDEVICEINSTANCE ptDevInstance)
   for(ulIdx = 0; ulIdx < sizeof(s_aulResetSequence) / sizeof(s_aulResetSequence[0]); ++ulIdx)
     HWIF_WRITE32(ptDevInstance, *pulHostReset, HOST_TO_LE32(s_aulResetSequence[ulIdx]));
 
-  /* Wait until netX is in reset */
-  OS_Sleep(NET_BOOTLOADER_RESET_TIME);
+  DEV_BootTimelineAdd(ptDevInstance, "hardware reset");
+
+  /* Wait until netX is in reset. PCI devices need to be out of reset again, before
+     the PCI configuration can be restored. DPM devices are polled afterwards. */
+  OS_Sleep( ptDevInstance->fPCICard ? ptDevInstance->tBootTiming.ulPCIResetTime :
+                                      ptDevInstance->tBootTiming.ulDPMResetTime);
 
   /* Write PCI config */
   if( ptDevInstance->fPCICard)
@@ -359,35 +628,53 @@ static int32_t cifXHardwareReset(PDEVICEINSTANCE ptDevInstance)
     ptDevInstance->pfnNotify(ptDevInstance, eCIFX_TOOLKIT_EVENT_POSTRESET);
   }
 
+  DEV_BootTimelineAdd(ptDevInstance, "reset time elapsed");
+
   /* Wait for romloader to signal PCI Boot State */
-  for(ulIdx = 0; (ulIdx < NET_BOOTLOADER_STARTUP_CYCLES) && (lRet != CIFX_NO_ERROR); ++ulIdx)
+  lStartTime = (int32_t)OS_GetMilliSecCounter();
+  do
   {
-    uint32_t ulState;
-    OS_Sleep(NET_BOOTLOADER_STARTUP_WAIT);
-
     ulState = LE32_TO_HOST(HWIF_READ32(ptDevInstance, *pulSystemState)); /*lint !e564 */
 
     /* Check if state not 0xFFFFFFFF. This happens if memory is not available. */
     if( (ulState == CIFX_DPM_INVALID_CONTENT)   ||
         (ulState == CIFX_DPM_NO_MEMORY_ASSIGNED)  )
     {
-      /* Error, register block not available */
+      /* Register block not (yet) available, DPM devices may still be in reset */
       lRet = CIFX_MEMORY_MAPPING_FAILED;
 
-      if(g_ulTraceLevel & TRACE_LEVEL_ERROR)
-      {
-        USER_Trace(ptDevInstance,
-                   TRACE_LEVEL_ERROR,
-                   "DPM Content invalid after Reset (Data=0x%08X)!",
-                   ulState);
-      }
-      break;
+      /* PCI devices are out of reset, when the configuration was restored */
+      if(ptDevInstance->fPCICard)
+        break;
 
     } else
     {
       /* Detect chip type after hardware reset */
       lRet = cifXDetectChipTypebyROMLoader( ptDevInstance, ulState);
     }
+
+    if(CIFX_NO_ERROR == lRet)
+      break;
+
+    ulDiffTime = OS_GetMilliSecCounter() - lStartTime;
+
+    DEV_PollBackoff(ptDevInstance, &ulInterval);
+
+  } while(ulDiffTime < NET_BOOTLOADER_STARTUP_CYCLES * NET_BOOTLOADER_STARTUP_WAIT);
+
+  if(CIFX_MEMORY_MAPPING_FAILED == lRet)
+  {
+    /* Error, register block not available */
+    if(g_ulTraceLevel & TRACE_LEVEL_ERROR)
+    {
+      USER_Trace(ptDevInstance,
+                 TRACE_LEVEL_ERROR,
+                 "DPM Content invalid after Reset (Data=0x%08X)!",
+                 ulState);
+    }
+  } else if(CIFX_NO_ERROR == lRet)
+  {
+    DEV_BootTimelineAdd(ptDevInstance, "ROM loader ready");
   }
 
   return lRet;
@@ -501,15 +788,26 @@ static int32_t cifXRunBootloader(PDEVICEINSTANCE ptDevInstance)
 
         if(CIFX_NO_ERROR == lRet)
         {
-          uint32_t  ulIdx  = 0;
+          uint32_t  ulIdx      = 0;
+          uint32_t  ulInterval = 0;
+          uint32_t  ulDiffTime = 0;
+          int32_t   lStartTime = (int32_t)OS_GetMilliSecCounter();
+
+          DEV_BootTimelineAdd(ptDevInstance, "bootloader downloaded");
 
           /* Wait until 2nd Stage loader or firmware is running */
-          for(ulIdx = 0; ulIdx < NET_BOOTLOADER_STARTUP_CYCLES; ++ulIdx)
+          for(ulIdx = 0; ulDiffTime < NET_BOOTLOADER_STARTUP_CYCLES * NET_BOOTLOADER_STARTUP_WAIT; ++ulIdx)
           {
             volatile uint32_t* pulDpmStart = (volatile uint32_t*)ptDevInstance->pbDPM;
 
-            /* Wait until bootloader is active */
-            OS_Sleep(NET_BOOTLOADER_STARTUP_WAIT);
+            /* Wait until bootloader is active. The user notification may reconfigure
+               the DPM interface, so it is called after the full startup wait as before. */
+            if( ptDevInstance->pfnNotify && (0 == ulIdx))
+              OS_Sleep(NET_BOOTLOADER_STARTUP_WAIT);
+            else
+              DEV_PollBackoff(ptDevInstance, &ulInterval);
+
+            ulDiffTime = OS_GetMilliSecCounter() - lStartTime;
 
             /* Call user, to setup DPM, in case the bootloader uses
                 other timings/bit width than the original ROM loader settings */
@@ -544,6 +842,8 @@ static int32_t cifXRunBootloader(PDEVICEINSTANCE ptDevInstance)
                 /* All states are OK */
                 lRet = CIFX_NO_ERROR;
 
+                DEV_BootTimelineAdd(ptDevInstance, "bootloader running");
+
                 if(g_ulTraceLevel & TRACE_LEVEL_DEBUG)
                 {
                   USER_Trace(ptDevInstance,
@@ -3386,6 +3686,88 @@ static int32_t cifXCheckCachedBufferEnable(PDEVICEINSTANCE ptDevInstance)
   return lRet;
 }
 
+/*****************************************************************************/
+/*! Check for delta writes of the IO output areas and create the output
+*   shadows of all communication channels
+*   \param ptDevInstance Instance to start up
+*   \return CIFX_NO_ERROR on success                                         */
+/*****************************************************************************/
+static int32_t cifXCheckIODeltaWriteEnable(PDEVICEINSTANCE ptDevInstance)
+{
+  CIFX_DEVICE_INFORMATION tDevInfo;
+  int32_t                 lRet        = CIFX_NO_ERROR;
+  uint32_t                ulMergeGap  = 0;
+  uint32_t                ulChannel;
+
+  OS_Memset(&tDevInfo, 0, sizeof(tDevInfo));
+
+  /* Initialize file information structure */
+  tDevInfo.ulDeviceNumber   = ptDevInstance->ulDeviceNumber;
+  tDevInfo.ulSerialNumber   = ptDevInstance->ulSerialNumber;
+  tDevInfo.ulChannel        = CIFX_SYSTEM_DEVICE;
+  tDevInfo.ptDeviceInstance = ptDevInstance;
+
+  /* Ask for delta writes */
+  switch(USER_GetIODeltaWriteMode(&tDevInfo, &ulMergeGap))
+  {
+    case eIO_DELTA_WRITE_OFF:
+      return CIFX_NO_ERROR;
+
+    case eIO_DELTA_WRITE_ON:
+    break;
+
+    default:
+      if (g_ulTraceLevel & TRACE_LEVEL_ERROR)
+      {
+        USER_Trace(ptDevInstance,
+                   TRACE_LEVEL_ERROR,
+                   "USER_GetIODeltaWriteMode() returned invalid mode");
+      }
+      return CIFX_INVALID_PARAMETER;
+  }
+
+  for(ulChannel = 0; (CIFX_NO_ERROR == lRet) && (ulChannel < ptDevInstance->ulCommChannelCount); ++ulChannel)
+  {
+    PCHANNELINSTANCE ptChannel = ptDevInstance->pptCommChannels[ulChannel];
+    uint32_t         ulArea;
+
+    for(ulArea = 0; ulArea < ptChannel->ulIOOutputAreas; ++ulArea)
+    {
+      PIOINSTANCE         ptIOArea = ptChannel->pptIOOutputAreas[ulArea];
+      PIO_OUTPUT_SHADOW_T ptShadow = (PIO_OUTPUT_SHADOW_T)OS_Memalloc((uint32_t)sizeof(*ptShadow) + ptIOArea->ulDPMAreaLength);
+
+      if(NULL == ptShadow)
+      {
+        lRet = CIFX_INVALID_POINTER;
+
+        if(g_ulTraceLevel & TRACE_LEVEL_ERROR)
+        {
+          USER_Trace(ptDevInstance,
+                     TRACE_LEVEL_ERROR,
+                     "Error creating IO output shadow buffer!");
+        }
+        break;
+      }
+
+      /* Image content is unknown until the first write */
+      OS_Memset(ptShadow, 0, sizeof(*ptShadow));
+      ptShadow->ulMergeGap     = ulMergeGap;
+      ptShadow->pbImage        = (uint8_t*)(ptShadow + 1);
+      ptIOArea->ptOutputShadow = ptShadow;
+    }
+  }
+
+  if( (CIFX_NO_ERROR == lRet) && (g_ulTraceLevel & TRACE_LEVEL_DEBUG) )
+  {
+    USER_Trace(ptDevInstance,
+               TRACE_LEVEL_DEBUG,
+               "Delta writes of IO output areas enabled (merge gap=%u bytes)",
+               ulMergeGap);
+  }
+
+  return lRet;
+}
+
 #ifdef CIFX_TOOLKIT_DMA
 /*****************************************************************************/
 /*! Check for DMA enable
@@ -3786,6 +4168,8 @@ static int32_t cifXStartDevice(PDEVICEINSTANCE ptDevInstance)
 
   ptDevInstance->lInitError = CIFX_NO_ERROR;
 
+  DEV_BootTimelineStart(ptDevInstance, "device start");
+
   /* Assume every card has the register block at the end of the DPM */
   ptDevInstance->ptGlobalRegisters = (PNETX_GLOBAL_REG_BLOCK)(ptDevInstance->pbDPM +
                                                               ptDevInstance->ulDPMSize -
@@ -3809,6 +4193,8 @@ static int32_t cifXStartDevice(PDEVICEINSTANCE ptDevInstance)
              Toolkit even if firmware startup fails (e.g. Wrong firmware for this card) */
           int32_t lTempResult;
 
+          DEV_BootTimelineAdd(ptDevInstance, "system channel ready");
+
           /* Check if we have a BASE OS system to download and to start*/
           lTempResult = cifXHandleRAMBaseOSModule( ptDevInstance);
           if( CIFX_NO_ERROR == lTempResult)
@@ -3818,12 +4204,15 @@ static int32_t cifXStartDevice(PDEVICEINSTANCE ptDevInstance)
 
             /* Download firmware / module files */
             (void)cifXDownloadFWFiles(ptDevInstance, &tDevChannelCfg);
+            DEV_BootTimelineAdd(ptDevInstance, "firmware files downloaded");
 
             /* Download configuration files */
             (void)cifXDownloadCNFFiles(ptDevInstance, &tDevChannelCfg);
+            DEV_BootTimelineAdd(ptDevInstance, "configuration files downloaded");
 
             /* Start firmware / module files if necessary */
             lTempResult = cifXStartRAMFirmware(ptDevInstance, &tDevChannelCfg);
+            DEV_BootTimelineAdd(ptDevInstance, "firmware started");
           }
 
           /* Only enter our error if no function already inserted one. Readout of channel
@@ -3861,6 +4250,8 @@ static int32_t cifXStartDevice(PDEVICEINSTANCE ptDevInstance)
              Toolkit even if firmware startup fails (e.g. Wrong firmware for this card) */
           int32_t lTempResult;
 
+          DEV_BootTimelineAdd(ptDevInstance, "system channel ready");
+
           /* Check if we have a BASE OS system to download and to start*/
           lTempResult = cifXHandleFlashBaseOSModule( ptDevInstance);
           if( CIFX_NO_ERROR == lTempResult)
@@ -3870,12 +4261,15 @@ static int32_t cifXStartDevice(PDEVICEINSTANCE ptDevInstance)
 
             /* Download firmware / module files */
             (void)cifXDownloadFWFiles(ptDevInstance, &tDevChannelCfg);
+            DEV_BootTimelineAdd(ptDevInstance, "firmware files downloaded");
 
             /* Download configuration files */
             (void)cifXDownloadCNFFiles(ptDevInstance, &tDevChannelCfg);
+            DEV_BootTimelineAdd(ptDevInstance, "configuration files downloaded");
 
             /* Start firmware / module files if necessary */
             lTempResult = cifXStartFlashFirmware(ptDevInstance, &tDevChannelCfg);
+            DEV_BootTimelineAdd(ptDevInstance, "firmware started");
           }
 
           /* Only enter our error if no function already inserted one. Readout of channel
@@ -3944,6 +4338,7 @@ static int32_t cifXStartDevice(PDEVICEINSTANCE ptDevInstance)
 
       /* Read the channel layouts, and build the CHANNELINSTANCES for this device */
       lRet = cifXCreateChannels(ptDevInstance, &tDevChannelCfg);
+      DEV_BootTimelineAdd(ptDevInstance, "channels created");
     }
   }
 
@@ -3983,6 +4378,12 @@ static int32_t cifXStartDevice(PDEVICEINSTANCE ptDevInstance)
     lRet = cifXCheckCachedBufferEnable(ptDevInstance);
   }
 
+  if(CIFX_NO_ERROR == lRet)
+  {
+    /* Check for delta writes of the IO output areas */
+    lRet = cifXCheckIODeltaWriteEnable(ptDevInstance);
+  }
+
   if(CIFX_NO_ERROR == lRet)
   {
     /* Check IRQ enable */
@@ -3993,6 +4394,8 @@ static int32_t cifXStartDevice(PDEVICEINSTANCE ptDevInstance)
   if(CIFX_NO_ERROR != lRet)
     ptDevInstance->lInitError = lRet;
 
+  DEV_BootTimelineAdd(ptDevInstance, (CIFX_NO_ERROR == lRet) ? "device started" : "device start failed");
+
   return lRet;
 }
 
@@ -4009,6 +4412,10 @@ static int32_t cifXStopDevice(PDEVICEINSTANCE ptDevInstance)
   uint32_t         ulIdx          = 0;
   PCHANNELINSTANCE ptSystemDevice = &ptDevInstance->tSystemDevice;
 
+  /* Wait for a running COS poll of this device. New polls are prevented
+     by g_pvTkitLock held by the caller. */
+  OS_EnterLock(ptDevInstance->pvDeviceLock);
+
   /* Process all created communication channels */
   for(ulIdx = 0; ulIdx < ptDevInstance->ulCommChannelCount; ++ulIdx)
   {
@@ -4100,6 +4507,14 @@ static int32_t cifXStopDevice(PDEVICEINSTANCE ptDevInstance)
     }
   }
 
+#ifdef CIFX_TOOLKIT_PARAMETER_CHECK
+  cifXTKitUpdateHandleTable();
+#endif
+
+  OS_LeaveLock(ptDevInstance->pvDeviceLock);
+  OS_DeleteLock(ptDevInstance->pvDeviceLock);
+  ptDevInstance->pvDeviceLock = NULL;
+
   return lRet;
 }
 
@@ -4211,9 +4626,19 @@ int32_t cifXTKitAddDevice(PDEVICEINSTANCE ptDevInstance)
   }
 #endif
 
+  if(NULL == (ptDevInstance->pvDeviceLock = OS_CreateLock()))
+    return CIFX_INVALID_POINTER;
+
+  /* Use the default reset/startup wait times, if not set by the user */
+  DEV_InitBootTiming(ptDevInstance);
+
   /* Run the toolkit start device functions */
   lRet = cifXStartDevice(ptDevInstance);
-  if(CIFX_NO_ERROR == lRet)
+  if(CIFX_NO_ERROR != lRet)
+  {
+    OS_DeleteLock(ptDevInstance->pvDeviceLock);
+    ptDevInstance->pvDeviceLock = NULL;
+  } else
   {
     /* Lock tkit global data access against reentrancy*/
     OS_EnterLock(g_pvTkitLock);
@@ -4240,6 +4665,11 @@ int32_t cifXTKitAddDevice(PDEVICEINSTANCE ptDevInstance)
       /* Add the new entry to the device list */
       g_pptDevices[g_ulDeviceCount - 1] = ptDevInstance;
 
+#ifdef CIFX_TOOLKIT_PARAMETER_CHECK
+      /* Make system device and channel handles known to the API validation */
+      cifXTKitUpdateHandleTable();
+#endif
+
       /* Setup interrupts if as given during cifXStartDevice() */
       if(0 != (ptDevInstance->fIrqEnabled))
       {
@@ -4404,6 +4834,10 @@ void cifXTKitDeinit( void)
   }
   g_ulDeviceCount = 0;
 
+#ifdef CIFX_TOOLKIT_PARAMETER_CHECK
+  cifXTKitUpdateHandleTable();
+#endif
+
   if(g_pvTkitLock)
   {
     OS_LeaveLock(g_pvTkitLock);
@@ -12,6 +12,10 @@ Copyright (c) Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserv
   Changes:
     Date        Description
     -----------------------------------------------------------------------------------
+    2026-10-18  - Re-check host COS handshake state under lock before writing COS flags
+                - Notification callbacks are executed via DEV_NotifyCallback()
+                - Notifications are reported via DEV_NotifySignal(), even without callback
+                - cifXTKitDSRHandler() is marked with CIFX_TKIT_NOALLOC_SCOPE()
     2021-10-15  - Rework handling in DSR function, added ulHostCOSFlagsSaved variable
     2018-10-10  - Updated header and definitions to new Hilscher defines
                 - Derived from cifX Toolkit V1.6.0.0
@@ -162,34 +166,41 @@ static void ProcessIOArea(PCHANNELINSTANCE  ptChannel,
 
   if(usChangedBits & usBitMask)
   {
-    PFN_NOTIFY_CALLBACK pfnCallback = NULL;
-    uint8_t             bIOBitState = DEV_GetIOBitstate(ptChannel, ptIoArea, fOutput);
+    int     fNotify     = 0;
+    uint8_t bIOBitState = DEV_GetIOBitstate(ptChannel, ptIoArea, fOutput);
 
     switch(bIOBitState)
     {
     case HIL_FLAGS_EQUAL:
       if(0 == (usUnequalBits & usBitMask))
-        pfnCallback = ptIoArea->pfnCallback;
+        fNotify = 1;
       break;
 
     case HIL_FLAGS_NOT_EQUAL:
       if(usUnequalBits & usBitMask)
-        pfnCallback = ptIoArea->pfnCallback;
+        fNotify = 1;
       break;
 
     case HIL_FLAGS_CLEAR:
       if(0 == (ptChannel->usNetxFlags & usBitMask))
-        pfnCallback = ptIoArea->pfnCallback;
+        fNotify = 1;
       break;
 
     case HIL_FLAGS_SET:
       if(ptChannel->usNetxFlags & usBitMask)
-        pfnCallback = ptIoArea->pfnCallback;
+        fNotify = 1;
       break;
     }
 
-    if(pfnCallback)
-      pfnCallback(ptIoArea->ulNotifyEvent, 0, NULL, ptIoArea->pvUser);
+    if(fNotify)
+    {
+      PFN_NOTIFY_CALLBACK pfnCallback = ptIoArea->pfnCallback;
+
+      DEV_NotifySignal(ptChannel, ptIoArea->ulNotifyEvent);
+
+      if(pfnCallback)
+        DEV_NotifyCallback(ptChannel, pfnCallback, ptIoArea->ulNotifyEvent, 0, NULL, ptIoArea->pvUser);
+    }
 
     OS_SetEvent(ptChannel->ahHandshakeBitEvents[ptIoArea->bHandshakeBit]);
   }
@@ -201,6 +212,8 @@ static void ProcessIOArea(PCHANNELINSTANCE  ptChannel,
 /*****************************************************************************/
 void cifXTKitDSRHandler(PDEVICEINSTANCE ptDevInstance)
 {
+  CIFX_TKIT_NOALLOC_SCOPE();
+
   if(!ptDevInstance->fResetActive)
   {
     /* Get actual data buffer index */
@@ -310,9 +323,11 @@ void cifXTKitDSRHandler(PDEVICEINSTANCE ptDevInstance)
             if(fProcess)
             {
               /* There is a valid channel */
+              DEV_NotifySignal(ptSyncChannel, CIFX_NOTIFY_SYNC);
+
               /* Check if we have a callback assigned */
               if (ptSyncChannel->tSynch.pfnCallback)
-                ptSyncChannel->tSynch.pfnCallback( CIFX_NOTIFY_SYNC, 0, NULL, ptSyncChannel->tSynch.pvUser);
+                DEV_NotifyCallback(ptSyncChannel, ptSyncChannel->tSynch.pfnCallback, CIFX_NOTIFY_SYNC, 0, NULL, ptSyncChannel->tSynch.pvUser);
 
               /* Signal event to allow waiting for sync state without callback */
               if( ptDevInstance->tSyncData.ahSyncBitEvents[ulBitPos])
@@ -361,6 +376,8 @@ void cifXTKitDSRHandler(PDEVICEINSTANCE ptDevInstance)
           {
             OS_SetEvent(ptChannel->ahHandshakeBitEvents[NCF_COMMUNICATING_BIT_NO]);
 
+            DEV_NotifySignal(ptChannel, CIFX_NOTIFY_COM_STATE);
+
             /* check if notification is registered */
             if (NULL != ptChannel->tComState.pfnCallback)
             {
@@ -368,10 +385,12 @@ void cifXTKitDSRHandler(PDEVICEINSTANCE ptDevInstance)
 
               tData.ulComState = (ptChannel->usNetxFlags & NCF_COMMUNICATING);
 
-              ptChannel->tComState.pfnCallback( CIFX_NOTIFY_COM_STATE,
-                                                sizeof(tData),
-                                                &tData,
-                                                ptChannel->tComState.pvUser);
+              DEV_NotifyCallback(ptChannel,
+                                 ptChannel->tComState.pfnCallback,
+                                 CIFX_NOTIFY_COM_STATE,
+                                 sizeof(tData),
+                                 &tData,
+                                 ptChannel->tComState.pvUser);
             }
           }
 
@@ -439,17 +458,23 @@ void cifXTKitDSRHandler(PDEVICEINSTANCE ptDevInstance)
               /* Lock flag access */
               OS_EnterLock(ptChannel->pvLock);
 
-              /* Update COS flags */
-              HWIF_WRITE32(ptDevInstance, ptChannel->ptControlBlock->ulApplicationCOS, HOST_TO_LE32(ptChannel->ulHostCOSFlags));
+              /* DEV_DoHostCOSChange() may have sent a COS command since usUnequalBits
+                 was sampled, so check the handshake state again while holding the lock */
+              if( (ptChannel->ulHostCOSFlagsSaved != ptChannel->ulHostCOSFlags) &&
+                  !((ptChannel->usNetxFlags ^ ptChannel->usHostFlags) & NCF_HOST_COS_ACK) )
+              {
+                /* Update COS flags */
+                HWIF_WRITE32(ptDevInstance, ptChannel->ptControlBlock->ulApplicationCOS, HOST_TO_LE32(ptChannel->ulHostCOSFlags));
 
-              /* Store the written values */
-              ptChannel->ulHostCOSFlagsSaved = ptChannel->ulHostCOSFlags;
+                /* Store the written values */
+                ptChannel->ulHostCOSFlagsSaved = ptChannel->ulHostCOSFlags;
 
-              /* Signal new COS flags */
-              DEV_ToggleBit(ptChannel, HCF_HOST_COS_CMD);
+                /* Signal new COS flags */
+                DEV_ToggleBit(ptChannel, HCF_HOST_COS_CMD);
 
-              /* Remove all enable flags from the local COS flags */
-              ptChannel->ulHostCOSFlags &= ~(HIL_APP_COS_BUS_ON_ENABLE | HIL_APP_COS_INITIALIZATION_ENABLE | HIL_APP_COS_LOCK_CONFIGURATION_ENABLE);
+                /* Remove all enable flags from the local COS flags */
+                ptChannel->ulHostCOSFlags &= ~(HIL_APP_COS_BUS_ON_ENABLE | HIL_APP_COS_INITIALIZATION_ENABLE | HIL_APP_COS_LOCK_CONFIGURATION_ENABLE);
+              }
 
               /* Unlock flag access */
               OS_LeaveLock(ptChannel->pvLock);
@@ -508,6 +533,9 @@ void cifXTKitDSRHandler(PDEVICEINSTANCE ptDevInstance)
         /* Check Receive Mailbox */
         if( usChangedBits & ptChannel->tRecvMbx.ulRecvACKBitmask)
         {
+          if(usUnequalBits & ptChannel->tRecvMbx.ulRecvACKBitmask)
+            DEV_NotifySignal(ptChannel, CIFX_NOTIFY_RX_MBX_FULL);
+
           if( (usUnequalBits & ptChannel->tRecvMbx.ulRecvACKBitmask) &&
               (NULL != ptChannel->tRecvMbx.pfnCallback) )
           {
@@ -515,10 +543,12 @@ void cifXTKitDSRHandler(PDEVICEINSTANCE ptDevInstance)
 
             tRxData.ulRecvCount = LE16_TO_HOST(HWIF_READ16(ptDevInstance, ptChannel->tRecvMbx.ptRecvMailboxStart->usWaitingPackages));
 
-            ptChannel->tRecvMbx.pfnCallback(CIFX_NOTIFY_RX_MBX_FULL,
-                                            sizeof(tRxData),
-                                            &tRxData,
-                                            ptChannel->tRecvMbx.pvUser);
+            DEV_NotifyCallback(ptChannel,
+                               ptChannel->tRecvMbx.pfnCallback,
+                               CIFX_NOTIFY_RX_MBX_FULL,
+                               sizeof(tRxData),
+                               &tRxData,
+                               ptChannel->tRecvMbx.pvUser);
           }
           OS_SetEvent(ptChannel->ahHandshakeBitEvents[ptChannel->tRecvMbx.bRecvACKBitoffset]);
         }
@@ -526,6 +556,9 @@ void cifXTKitDSRHandler(PDEVICEINSTANCE ptDevInstance)
         /* Check Send Mailbox */
         if( usChangedBits & ptChannel->tSendMbx.ulSendCMDBitmask)
         {
+          if(0 == (usUnequalBits & ptChannel->tSendMbx.ulSendCMDBitmask))
+            DEV_NotifySignal(ptChannel, CIFX_NOTIFY_TX_MBX_EMPTY);
+
           if( (0    == (usUnequalBits & ptChannel->tSendMbx.ulSendCMDBitmask)) &&
               (NULL != ptChannel->tSendMbx.pfnCallback) )
           {
@@ -533,10 +566,12 @@ void cifXTKitDSRHandler(PDEVICEINSTANCE ptDevInstance)
 
             tTxData.ulMaxSendCount = LE16_TO_HOST(HWIF_READ16(ptDevInstance, ptChannel->tSendMbx.ptSendMailboxStart->usPackagesAccepted));
 
-            ptChannel->tSendMbx.pfnCallback(CIFX_NOTIFY_TX_MBX_EMPTY,
-                                            sizeof(tTxData),
-                                            &tTxData,
-                                            ptChannel->tSendMbx.pvUser);
+            DEV_NotifyCallback(ptChannel,
+                               ptChannel->tSendMbx.pfnCallback,
+                               CIFX_NOTIFY_TX_MBX_EMPTY,
+                               sizeof(tTxData),
+                               &tTxData,
+                               ptChannel->tSendMbx.pvUser);
           }
           OS_SetEvent(ptChannel->ahHandshakeBitEvents[ptChannel->tSendMbx.bSendCMDBitoffset]);
         }
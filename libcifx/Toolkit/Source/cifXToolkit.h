@@ -12,6 +12,7 @@ Copyright (c) Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserv
   Changes:
     Date        Description
     -----------------------------------------------------------------------------------
+    2026-10-18  - Added new user function USER_GetIODeltaWriteMode()
     2023-04-26  - Moved DEV function definitions to cifXHWFunctions.h
                 - Check parameter macros from cifXFunctions.c moved here
     2021-06-14  - Added new user function USER_GetCachedIOBufferMode()
@@ -58,6 +59,7 @@ void      cifXTKitDisableHWInterrupt(PDEVICEINSTANCE ptDevInstance);
 void      cifXTKitEnableHWInterrupt(PDEVICEINSTANCE ptDevInstance);
 
 void      cifXTKitCyclicTimer  (void);
+void      cifXTKitCyclicTimerDevice(PDEVICEINSTANCE ptDevInstance);
 
 /*****************************************************************************/
 /*! \}                                                                       */
@@ -152,6 +154,7 @@ void      USER_GetAliasName             (PCIFX_DEVICE_INFORMATION ptDevInfo, uin
 int       USER_GetInterruptEnable       (PCIFX_DEVICE_INFORMATION ptDevInfo);
 int       USER_GetDMAMode               (PCIFX_DEVICE_INFORMATION ptDevInfo);
 int       USER_GetCachedIOBufferMode    (PCIFX_DEVICE_INFORMATION ptDevInfo);
+int       USER_GetIODeltaWriteMode      (PCIFX_DEVICE_INFORMATION ptDevInfo, uint32_t* pulMergeGap);
 
 void      USER_Trace                    (PDEVICEINSTANCE ptDevInstance, uint32_t ulTraceLevel, const char* szFormat, ...);
 
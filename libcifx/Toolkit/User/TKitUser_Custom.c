@@ -12,6 +12,7 @@ Copyright (c) Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserv
   Changes:
     Date        Description
     -----------------------------------------------------------------------------------
+    2026-10-18  Added USER_GetIODeltaWriteMode() function template
     2022-06-14  Added USER_GetCachedIOBufferMode() function template
     2021-08-13  Add a new line handling to USER_Trace() if necessary
     2006-08-07  initial version
@@ -152,6 +153,17 @@ int USER_GetCachedIOBufferMode(PCIFX_DEVICE_INFORMATION ptDevInfo)
 {
 }
 
+/*****************************************************************************/
+/*! Check if only changed output data is to be written on this device
+*   \param ptDevInfo    Device Information
+*   \param pulMergeGap  Returned number of unchanged bytes up to which two
+*                       changed runs are written in one access
+*   \return eIO_DELTA_WRITE_ON to enable delta writes                        */
+/*****************************************************************************/
+int USER_GetIODeltaWriteMode(PCIFX_DEVICE_INFORMATION ptDevInfo, uint32_t* pulMergeGap)
+{
+}
+
 #ifdef CIFX_TOOLKIT_DMA
 /*****************************************************************************/
 /*! Check if dma should be enabled for this device
@@ -0,0 +1,434 @@
+// SPDX-License-Identifier: MIT
+/**************************************************************************************
+ *
+ * Copyright (c) 2025, Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserved.
+ *
+ * Description: Header-only C++17 layer on top of the cifX API (cifXUser.h).
+ *
+ *              The layout of a process image is described at compile time, e.g.:
+ *
+ *                struct DriveInputs
+ *                {
+ *                  static constexpr std::size_t size = 16;
+ *
+ *                  static constexpr cifx::Field<uint16_t, 0> status{};
+ *                  static constexpr cifx::Field<int32_t,  4> position{};
+ *                  static constexpr cifx::Bit<2, 3>          ready{};
+ *                };
+ *
+ *                cifx::ProcessImage<DriveInputs> in;
+ *                channel.read(in);
+ *                int32_t pos = in[DriveInputs::position];
+ *
+ *              Accessors are resolved at compile time to a load/store at a fixed offset
+ *              (plus a byte swap on big endian hosts, the DPM is little endian).
+ *
+ **************************************************************************************/
+
+#ifndef CIFX_HPP
+#define CIFX_HPP
+
+#if __cplusplus < 201703L
+#error "cifx.hpp requires C++17"
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "cifXUser.h"
+#include "cifXErrors.h"
+
+namespace cifx
+{
+
+/*****************************************************************************/
+/*! Error of a cifX API function, thrown by the RAII wrappers                */
+/*****************************************************************************/
+class Error : public std::runtime_error
+{
+public:
+  Error(const char* szFunction, int32_t lError)
+  : std::runtime_error(describe(szFunction, lError)), m_lError(lError) {}
+
+  int32_t code() const noexcept { return m_lError; }
+
+private:
+  static std::string describe(const char* szFunction, int32_t lError)
+  {
+    char szError[256] = {0};
+
+    if(CIFX_NO_ERROR != xDriverGetErrorDescription(lError, szError, sizeof(szError)))
+      std::snprintf(szError, sizeof(szError), "Unknown error");
+
+    char szText[320];
+    std::snprintf(szText, sizeof(szText), "%s failed (0x%08X): %s", szFunction, (unsigned int)lError, szError);
+    return szText;
+  }
+
+  int32_t m_lError;
+};
+
+namespace detail
+{
+  inline void check(const char* szFunction, int32_t lRet)
+  {
+    if(CIFX_NO_ERROR != lRet)
+      throw Error(szFunction, lRet);
+  }
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+  constexpr bool fHostBigEndian = true;
+#else
+  constexpr bool fHostBigEndian = false;
+#endif
+
+  template<std::size_t Size> struct UInt;
+  template<> struct UInt<1> { using type = uint8_t;  };
+  template<> struct UInt<2> { using type = uint16_t; };
+  template<> struct UInt<4> { using type = uint32_t; };
+  template<> struct UInt<8> { using type = uint64_t; };
+
+  template<typename U> constexpr U bswap(U tValue) noexcept
+  {
+    if constexpr(sizeof(U) == 1)      return tValue;
+    else if constexpr(sizeof(U) == 2) return __builtin_bswap16(tValue);
+    else if constexpr(sizeof(U) == 4) return __builtin_bswap32(tValue);
+    else                              return __builtin_bswap64(tValue);
+  }
+
+  /* Loads a value stored little endian at an arbitrary (unaligned) address */
+  template<typename T> inline T load(const uint8_t* pbData) noexcept
+  {
+    if constexpr(fHostBigEndian && std::is_arithmetic_v<T> && (sizeof(T) > 1))
+    {
+      typename UInt<sizeof(T)>::type tRaw;
+      T                              tValue;
+
+      std::memcpy(&tRaw, pbData, sizeof(tRaw));
+      tRaw = bswap(tRaw);
+      std::memcpy(&tValue, &tRaw, sizeof(tValue));
+      return tValue;
+    } else
+    {
+      T tValue;
+
+      std::memcpy(&tValue, pbData, sizeof(tValue));
+      return tValue;
+    }
+  }
+
+  /* Stores a value little endian at an arbitrary (unaligned) address */
+  template<typename T> inline void store(uint8_t* pbData, T tValue) noexcept
+  {
+    if constexpr(fHostBigEndian && std::is_arithmetic_v<T> && (sizeof(T) > 1))
+    {
+      typename UInt<sizeof(T)>::type tRaw;
+
+      std::memcpy(&tRaw, &tValue, sizeof(tRaw));
+      tRaw = bswap(tRaw);
+      std::memcpy(pbData, &tRaw, sizeof(tRaw));
+    } else
+    {
+      std::memcpy(pbData, &tValue, sizeof(tValue));
+    }
+  }
+} /* namespace detail */
+
+/*****************************************************************************/
+/*! Typed value at a fixed byte offset of a process image. Arithmetic types
+*   are converted from/to little endian, other (trivially copyable) types,
+*   e.g. std::array<uint8_t, N>, are copied unchanged.                       */
+/*****************************************************************************/
+template<typename T, std::size_t Offset>
+struct Field
+{
+  static_assert(std::is_trivially_copyable_v<T>, "cifx::Field requires a trivially copyable type");
+
+  using type = T;
+  static constexpr std::size_t offset = Offset;
+  static constexpr std::size_t end    = Offset + sizeof(T);
+};
+
+/*****************************************************************************/
+/*! Single bit of a process image (e.g. a digital input)                     */
+/*****************************************************************************/
+template<std::size_t ByteOffset, unsigned int BitNo>
+struct Bit
+{
+  static_assert(BitNo < 8, "cifx::Bit number must be 0..7");
+
+  using type = bool;
+  static constexpr std::size_t offset = ByteOffset;
+  static constexpr std::size_t end    = ByteOffset + 1;
+  static constexpr uint8_t     mask   = (uint8_t)(1U << BitNo);
+};
+
+/*****************************************************************************/
+/*! Typed access to process data with the layout Layout. The memory is
+*   provided by Derived::data(), which is either the buffer of a ProcessImage
+*   or the DPM (see PlcImage::Access).                                       */
+/*****************************************************************************/
+template<typename Layout, typename Derived>
+class ImageAccess
+{
+public:
+  static constexpr std::size_t size = Layout::size;
+
+  template<typename T, std::size_t Offset>
+  T get(Field<T, Offset>) const noexcept
+  {
+    static_assert(Field<T, Offset>::end <= Layout::size, "field exceeds the process image");
+    return detail::load<T>(bytes() + Offset);
+  }
+
+  template<typename T, std::size_t Offset>
+  void set(Field<T, Offset>, const typename Field<T, Offset>::type& tValue) noexcept
+  {
+    static_assert(Field<T, Offset>::end <= Layout::size, "field exceeds the process image");
+    detail::store<T>(bytes() + Offset, tValue);
+  }
+
+  template<std::size_t ByteOffset, unsigned int BitNo>
+  bool get(Bit<ByteOffset, BitNo>) const noexcept
+  {
+    static_assert(ByteOffset < Layout::size, "bit exceeds the process image");
+    return 0 != (bytes()[ByteOffset] & Bit<ByteOffset, BitNo>::mask);
+  }
+
+  template<std::size_t ByteOffset, unsigned int BitNo>
+  void set(Bit<ByteOffset, BitNo>, bool fValue) noexcept
+  {
+    static_assert(ByteOffset < Layout::size, "bit exceeds the process image");
+    if(fValue)
+      bytes()[ByteOffset] |= Bit<ByteOffset, BitNo>::mask;
+    else
+      bytes()[ByteOffset] &= (uint8_t)~Bit<ByteOffset, BitNo>::mask;
+  }
+
+  /* read access, in[Layout::field] */
+  template<typename F>
+  typename F::type operator[](F tField) const noexcept { return get(tField); }
+
+private:
+  uint8_t*       bytes()       noexcept { return static_cast<Derived*>(this)->data(); }
+  const uint8_t* bytes() const noexcept { return static_cast<const Derived*>(this)->data(); }
+};
+
+/*****************************************************************************/
+/*! Process image buffer, exchanged with xChannelIORead()/xChannelIOWrite()
+*   (see Channel::read(), Channel::write())                                  */
+/*****************************************************************************/
+template<typename Layout>
+class ProcessImage : public ImageAccess<Layout, ProcessImage<Layout>>
+{
+public:
+  uint8_t*       data()       noexcept { return m_abData; }
+  const uint8_t* data() const noexcept { return m_abData; }
+
+private:
+  alignas(8) uint8_t m_abData[Layout::size] = {};
+};
+
+/*****************************************************************************/
+/*! Driver handle (xDriverOpen()/xDriverClose()). The driver itself must be
+*   initialized before (cifXDriverInit()).                                   */
+/*****************************************************************************/
+class Driver
+{
+public:
+  Driver()
+  {
+    detail::check("xDriverOpen", xDriverOpen(&m_hDriver));
+  }
+  ~Driver()
+  {
+    if(nullptr != m_hDriver)
+      (void)xDriverClose(m_hDriver);
+  }
+
+  Driver(const Driver&)            = delete;
+  Driver& operator=(const Driver&) = delete;
+  Driver(Driver&& tOther) noexcept : m_hDriver(std::exchange(tOther.m_hDriver, nullptr)) {}
+  Driver& operator=(Driver&& tOther) noexcept
+  {
+    std::swap(m_hDriver, tOther.m_hDriver);
+    return *this;
+  }
+
+  CIFXHANDLE handle() const noexcept { return m_hDriver; }
+
+private:
+  CIFXHANDLE m_hDriver = nullptr;
+};
+
+/*****************************************************************************/
+/*! Communication channel (xChannelOpen()/xChannelClose())                   */
+/*****************************************************************************/
+class Channel
+{
+public:
+  Channel(const Driver& tDriver, const char* szBoard, uint32_t ulChannel)
+  {
+    detail::check("xChannelOpen", xChannelOpen(tDriver.handle(), const_cast<char*>(szBoard), ulChannel, &m_hChannel));
+  }
+  ~Channel()
+  {
+    if(nullptr != m_hChannel)
+      (void)xChannelClose(m_hChannel);
+  }
+
+  Channel(const Channel&)            = delete;
+  Channel& operator=(const Channel&) = delete;
+  Channel(Channel&& tOther) noexcept : m_hChannel(std::exchange(tOther.m_hChannel, nullptr)) {}
+  Channel& operator=(Channel&& tOther) noexcept
+  {
+    std::swap(m_hChannel, tOther.m_hChannel);
+    return *this;
+  }
+
+  /*! Reads the input image (xChannelIORead()), returns the cifX error code */
+  template<typename Layout>
+  int32_t read(ProcessImage<Layout>& tImage, uint32_t ulArea = 0, uint32_t ulOffset = 0, uint32_t ulTimeout = 0) noexcept
+  {
+    return xChannelIORead(m_hChannel, ulArea, ulOffset, (uint32_t)Layout::size, tImage.data(), ulTimeout);
+  }
+
+  /*! Writes the output image (xChannelIOWrite()), returns the cifX error code */
+  template<typename Layout>
+  int32_t write(ProcessImage<Layout>& tImage, uint32_t ulArea = 0, uint32_t ulOffset = 0, uint32_t ulTimeout = 0) noexcept
+  {
+    return xChannelIOWrite(m_hChannel, ulArea, ulOffset, (uint32_t)Layout::size, tImage.data(), ulTimeout);
+  }
+
+  CIFXHANDLE handle() const noexcept { return m_hChannel; }
+
+private:
+  CIFXHANDLE m_hChannel = nullptr;
+};
+
+/*****************************************************************************/
+/*! Direct DPM access to an IO area (xChannelPLCMemoryPtr()). The process
+*   data is accessed in place, the handshake is done by the Access guard
+*   returned by lock():
+*
+*     cifx::PlcImage<DriveInputs, CIFX_IO_INPUT_AREA> in(channel);
+*     if(auto tAccess = in.lock())
+*       pos = tAccess[DriveInputs::position];   // xChannelPLCActivateRead() on scope exit
+*                                                                            */
+/*****************************************************************************/
+template<typename Layout, uint32_t AreaDefinition>
+class PlcImage
+{
+  static_assert((CIFX_IO_INPUT_AREA == AreaDefinition) || (CIFX_IO_OUTPUT_AREA == AreaDefinition),
+                "AreaDefinition must be CIFX_IO_INPUT_AREA or CIFX_IO_OUTPUT_AREA");
+
+public:
+  /*! Handshake guard, the area is handed back to the device on destruction */
+  class Access : public ImageAccess<Layout, Access>
+  {
+  public:
+    Access(Access&& tOther) noexcept
+    : m_pbData(tOther.m_pbData), m_hChannel(tOther.m_hChannel), m_ulArea(tOther.m_ulArea),
+      m_fValid(std::exchange(tOther.m_fValid, false)) {}
+    Access(const Access&)            = delete;
+    Access& operator=(const Access&) = delete;
+    Access& operator=(Access&&)      = delete;
+
+    ~Access()
+    {
+      if(m_fValid)
+      {
+        if constexpr(CIFX_IO_INPUT_AREA == AreaDefinition)
+          (void)xChannelPLCActivateRead(m_hChannel, m_ulArea);
+        else
+          (void)xChannelPLCActivateWrite(m_hChannel, m_ulArea);
+      }
+    }
+
+    /*! false if the area is not ready (still owned by the device) */
+    explicit operator bool() const noexcept { return m_fValid; }
+
+    uint8_t*       data()       noexcept { return m_pbData; }
+    const uint8_t* data() const noexcept { return m_pbData; }
+
+  private:
+    friend class PlcImage;
+
+    Access(uint8_t* pbData, CIFXHANDLE hChannel, uint32_t ulArea, bool fValid) noexcept
+    : m_pbData(pbData), m_hChannel(hChannel), m_ulArea(ulArea), m_fValid(fValid) {}
+
+    uint8_t*   m_pbData;
+    CIFXHANDLE m_hChannel;
+    uint32_t   m_ulArea;
+    bool       m_fValid;
+  };
+
+  PlcImage(const Channel& tChannel, uint32_t ulArea = 0) : m_hChannel(tChannel.handle()), m_ulArea(ulArea)
+  {
+    PLC_MEMORY_INFORMATION tMemory = memoryInfo();
+
+    detail::check("xChannelPLCMemoryPtr", xChannelPLCMemoryPtr(m_hChannel, CIFX_MEM_PTR_OPEN, &tMemory));
+    m_pvMemoryID = tMemory.pvMemoryID;
+
+    if(m_ulSize < Layout::size)
+    {
+      (void)xChannelPLCMemoryPtr(m_hChannel, CIFX_MEM_PTR_CLOSE, &tMemory);
+      throw Error("PlcImage (IO area smaller than the layout)", CIFX_INVALID_ACCESS_SIZE);
+    }
+  }
+  ~PlcImage()
+  {
+    PLC_MEMORY_INFORMATION tMemory = memoryInfo();
+
+    (void)xChannelPLCMemoryPtr(m_hChannel, CIFX_MEM_PTR_CLOSE, &tMemory);
+  }
+
+  PlcImage(const PlcImage&)            = delete;
+  PlcImage& operator=(const PlcImage&) = delete;
+
+  /*! Checks the handshake (xChannelPLCIsReadReady()/xChannelPLCIsWriteReady())
+      and returns a guard, which is valid if the area may be accessed */
+  Access lock() noexcept
+  {
+    uint32_t ulState = 0;
+    int32_t  lRet;
+
+    if constexpr(CIFX_IO_INPUT_AREA == AreaDefinition)
+      lRet = xChannelPLCIsReadReady(m_hChannel, m_ulArea, &ulState);
+    else
+      lRet = xChannelPLCIsWriteReady(m_hChannel, m_ulArea, &ulState);
+
+    return Access(m_pbMemory, m_hChannel, m_ulArea, (CIFX_NO_ERROR == lRet) && (0 != ulState));
+  }
+
+private:
+  PLC_MEMORY_INFORMATION memoryInfo() noexcept
+  {
+    PLC_MEMORY_INFORMATION tMemory;
+
+    tMemory.pvMemoryID           = m_pvMemoryID;
+    tMemory.ppvMemoryPtr         = reinterpret_cast<void**>(&m_pbMemory);
+    tMemory.ulAreaDefinition     = AreaDefinition;
+    tMemory.ulAreaNumber         = m_ulArea;
+    tMemory.pulIOAreaStartOffset = &m_ulStartOffset;
+    tMemory.pulIOAreaSize        = &m_ulSize;
+    return tMemory;
+  }
+
+  CIFXHANDLE m_hChannel;
+  uint32_t   m_ulArea;
+  void*      m_pvMemoryID    = nullptr;
+  uint8_t*   m_pbMemory      = nullptr;
+  uint32_t   m_ulStartOffset = 0;
+  uint32_t   m_ulSize        = 0;
+};
+
+} /* namespace cifx */
+
+#endif /* CIFX_HPP */
@@ -0,0 +1,128 @@
+/* SPDX-License-Identifier: MIT */
+/**************************************************************************************
+ *
+ * Copyright (c) 2025, Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserved.
+ *
+ * Description: File format of the DPM access trace (dpm_trace_file of struct
+ *              CIFX_LINUX_INIT, library built with DPM_TRACE).
+ *
+ *              The file starts with a CIFX_DPM_TRACE_HEADER followed by a ring of
+ *              ring_size bytes. The ring contains CIFX_DPM_TRACE_RECORD entries (8 byte
+ *              aligned, size bytes long, optionally followed by the accessed data).
+ *              head and tail are absolute byte positions (ring offset = pos % ring_size).
+ *              A record never wraps: if less than sizeof(CIFX_DPM_TRACE_RECORD) bytes are
+ *              left at the end of the ring, or the record is marked with
+ *              CIFX_DPM_TRACE_FLAG_PAD, the next record starts at the beginning of the ring.
+ *
+ **************************************************************************************/
+
+#ifndef __CIFX_DPM_TRACE__H
+#define __CIFX_DPM_TRACE__H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+
+#define CIFX_DPM_TRACE_MAGIC          0x54445843UL /*!< "CXDT"                                  */
+#define CIFX_DPM_TRACE_VERSION        1
+#define CIFX_DPM_TRACE_MAX_DEVICES    16           /*!< Devices described in the header          */
+#define CIFX_DPM_TRACE_MAX_REGIONS    128          /*!< Regions per device                       */
+#define CIFX_DPM_TRACE_MAX_DATA       4096         /*!< Data captured per access, larger accesses are truncated */
+#define CIFX_DPM_TRACE_DEFAULT_SIZE   (16 * 1024 * 1024) /*!< Default ring size                   */
+
+/* flags of the trace (CIFX_DPM_TRACE_HEADER) */
+#define CIFX_DPM_TRACE_HDR_DATA       0x00000001   /*!< Records contain the accessed data        */
+
+/* flags of a record */
+#define CIFX_DPM_TRACE_FLAG_WRITE     0x01         /*!< Write access (read access otherwise)     */
+#define CIFX_DPM_TRACE_FLAG_DATA      0x02         /*!< Accessed data follows the record         */
+#define CIFX_DPM_TRACE_FLAG_SINGLE    0x04         /*!< Single 8/16/32 bit access (HWIF_READ8/16/32, HWIF_WRITE8/16/32) */
+#define CIFX_DPM_TRACE_FLAG_PAD       0x80         /*!< Padding up to the end of the ring        */
+
+#define CIFX_DPM_TRACE_DEVICE_UNKNOWN 0xFF         /*!< Access to a device not in the header     */
+#define CIFX_DPM_TRACE_CHANNEL_NONE   0xFFFF       /*!< Region does not belong to a channel      */
+
+/*****************************************************************************/
+/*! Type of a DPM region                                                     */
+/*****************************************************************************/
+typedef enum CIFX_DPM_TRACE_REGION_Etag
+{
+  eCIFX_DPM_REGION_OTHER = 0,     /*!< Not covered by a region (e.g. netX registers)    */
+  eCIFX_DPM_REGION_SYSTEM,        /*!< System channel (except mailboxes)                */
+  eCIFX_DPM_REGION_HANDSHAKE,     /*!< Handshake block / handshake cell of a channel    */
+  eCIFX_DPM_REGION_SEND_MBX,      /*!< Send mailbox                                     */
+  eCIFX_DPM_REGION_RECV_MBX,      /*!< Receive mailbox                                  */
+  eCIFX_DPM_REGION_IO_INPUT,      /*!< IO input area                                    */
+  eCIFX_DPM_REGION_IO_OUTPUT,     /*!< IO output area                                   */
+  eCIFX_DPM_REGION_CONTROL,       /*!< Control block                                    */
+  eCIFX_DPM_REGION_STATUS,        /*!< Common/extended status block                     */
+  eCIFX_DPM_REGION_CHANNEL,       /*!< Rest of a communication channel                  */
+
+  eCIFX_DPM_REGION_COUNT
+} CIFX_DPM_TRACE_REGION_E;
+
+/*****************************************************************************/
+/*! DPM region of a device                                                   */
+/*****************************************************************************/
+struct CIFX_DPM_TRACE_REGION
+{
+  uint32_t offset;   /*!< Offset in the DPM                                  */
+  uint32_t length;   /*!< Length in bytes                                    */
+  uint16_t type;     /*!< see CIFX_DPM_TRACE_REGION_E                        */
+  uint16_t channel;  /*!< Communication channel, CIFX_DPM_TRACE_CHANNEL_NONE */
+};
+
+/*****************************************************************************/
+/*! Traced device. The regions are updated on every (re-)start of the device */
+/*****************************************************************************/
+struct CIFX_DPM_TRACE_DEVICE
+{
+  char                         name[16];      /*!< Name of the device (e.g. cifX0) */
+  uint32_t                     dpm_size;      /*!< Size of the DPM                 */
+  uint32_t                     region_count;  /*!< Number of valid regions         */
+  struct CIFX_DPM_TRACE_REGION regions[CIFX_DPM_TRACE_MAX_REGIONS];
+};
+
+/*****************************************************************************/
+/*! Header of the trace file                                                 */
+/*****************************************************************************/
+struct CIFX_DPM_TRACE_HEADER
+{
+  uint32_t                     magic;         /*!< CIFX_DPM_TRACE_MAGIC                           */
+  uint16_t                     version;       /*!< CIFX_DPM_TRACE_VERSION                         */
+  uint16_t                     reserved;
+  uint32_t                     header_size;   /*!< Offset of the ring in the file                 */
+  uint32_t                     ring_size;     /*!< Size of the ring in bytes                      */
+  uint32_t                     flags;         /*!< see CIFX_DPM_TRACE_HDR_XXX                     */
+  uint32_t                     device_count;  /*!< Number of valid devices                        */
+  uint64_t                     start_time_ns; /*!< CLOCK_REALTIME of time_ns = 0                  */
+  uint64_t                     head;          /*!< Position of the next record                    */
+  uint64_t                     tail;          /*!< Position of the oldest record                  */
+  uint64_t                     records;       /*!< Number of records written (incl. overwritten)  */
+  struct CIFX_DPM_TRACE_DEVICE devices[CIFX_DPM_TRACE_MAX_DEVICES];
+};
+
+/*****************************************************************************/
+/*! Record of a DPM access                                                   */
+/*****************************************************************************/
+struct CIFX_DPM_TRACE_RECORD
+{
+  uint64_t time_ns;     /*!< Start of the access (CLOCK_MONOTONIC, relative to the trace start) */
+  uint32_t duration_ns; /*!< Duration of the access                                 */
+  uint32_t offset;      /*!< Offset in the DPM of the device                        */
+  uint32_t length;      /*!< Number of bytes accessed                               */
+  uint32_t thread;      /*!< Thread id (gettid()) of the accessing thread           */
+  uint32_t sequence;    /*!< Record number (lower 32 bits)                          */
+  uint8_t  device;      /*!< Index in devices of the header                         */
+  uint8_t  flags;       /*!< see CIFX_DPM_TRACE_FLAG_XXX                            */
+  uint16_t size;        /*!< Size of the record incl. data (multiple of 8)          */
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CIFX_DPM_TRACE__H */
@@ -7,6 +7,10 @@
  *
  **************************************************************************************/
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* pthread_setaffinity_np() */
+#endif
+
 #include "cifXToolkit.h"
 #include "cifXHWFunctions.h"
 #include "cifxlinux.h"
@@ -28,6 +32,7 @@
 #include <sys/time.h>
 #include <sys/resource.h>
 #include <sys/file.h>
+#include <sys/eventfd.h>
 
 #include <dirent.h>
 #include <string.h>
@@ -57,8 +62,31 @@ extern PDEVICEINSTANCE* g_pptDevices;
 #ifdef CIFXETHERNET
 extern void*            g_eth_list_lock;
 #endif
+#ifdef CIFX_TOOLKIT_PARAMETER_CHECK
+extern int              cifXTKitIsRegisteredHandle( void* pvHandle);
+#endif
 FILE*                   g_logfd = 0;
-static int              s_netx_device_counter = 0;
+
+/*****************************************************************************/
+/*! Automatically detectable device (see cifx_discovery_build())            */
+/*****************************************************************************/
+struct CIFX_DISCOVERY_ENTRY_T
+{
+  int                       pci_card;                        /*!< !=0 if device is a pci card */
+  char                      path[CIFX_MAX_FILE_NAME_LENGTH]; /*!< sysfs path of pci devices */
+  unsigned int              device_id;                       /*!< pci device id */
+  unsigned int              subdevice_id;                    /*!< pci subsystem device id */
+  int                       flash_based;                     /*!< !=0 if pci ids identify a flash based card */
+  CIFX_DEVICE_TYPE_E        dev_type;                        /*!< uio or vfio */
+  int                       dev_num;                         /*!< uio/vfio number (-1 legacy vfio) */
+  char                      alias[CIFx_MAX_INFO_NAME_LENTH]; /*!< alias given via uio name (device-tree) */
+  CIFX_TOOLKIT_DEVICETYPE_E start_type;                      /*!< start type given via uio name (device-tree) */
+};
+
+static pthread_mutex_t                s_discovery_lock  = PTHREAD_MUTEX_INITIALIZER;
+static struct CIFX_DISCOVERY_ENTRY_T* s_discovery_index = NULL; /*!< custom devices first, followed by pci devices */
+static int                            s_discovery_count = 0;
+static int                            s_discovery_valid = 0;
 
 #ifdef CIFX_PLUGIN_SUPPORT
 struct CIFX_PLUGIN_T
@@ -73,11 +101,11 @@ static SLIST_HEAD(PLUGIN_LIST, CIFX_PLUGIN_T) s_tPluginList = SLIST_HEAD_INITIAL
 
 #endif
 
+/* indexed by CIFX_DEVICE_TYPE_E */
 static char* s_cifx_device_type_str[] = { "uio",
                                           "spi",
-#ifdef VFIO_SUPPORT
                                           "vfio",
-#endif
+                                          "eventfd",
                                           "unknown"};
 
 #define COS_THREAD_STACK_MIN  0x1000  /* Stack size needed by Thread for
@@ -96,10 +124,12 @@ static void __init()   __attribute__((__constructor__));
 static void __deinit() __attribute__((__destructor__));
 
 static void* cifXPollingThread(void *arg);
-static int            polling_thread_running = 0;
-static pthread_t      polling_thread         = {0};
+static int            polling_thread_enabled = 0;      /*!< !=0 if non-irq devices get a polling thread */
 static pthread_attr_t polling_thread_attr    = {{0}};
-static unsigned short polling_thread_stop    = 0;
+static unsigned long  polling_interval       = 0;      /*!< Default poll interval in ms */
+static struct CIFX_BOOT_TIMING boot_timing  = {0};    /*!< Reset/startup wait times, 0 = toolkit default */
+static PDEVICEINSTANCE s_restart_list        = NULL;  /*!< Devices being restarted (may be removed from the device list), protected by g_pvTkitLock */
+static int             s_deinit_active       = 0;     /*!< !=0 if cifXDriverDeinit() is running, no new restarts are accepted */
 
 #ifdef CIFX_DRV_HWIF
   void* HWIFDPMRead ( uint32_t ulOpt, void* pvDevInstance, void* pvDpmAddr, void* pvDst, uint32_t ulLen);
@@ -110,7 +140,10 @@ static unsigned short polling_thread_stop    = 0;
   static void cifx_unmap_dma_buffer(struct CIFX_DEVICE_T *device);
 #endif
 static int sysfs_get_pci_id( char* dev_path, char* file, unsigned int* id);
-static int pci_get_hilscher_device_id_by_idx( int index, char* device_id, uint32_t name_len, int full_path);
+static int cifx_discovery_get_uio(int uio_num, struct CIFX_DISCOVERY_ENTRY_T* entry);
+#if defined(VFIO_SUPPORT) || !defined(CIFX_NO_PCIACCESS_LIB)
+static int cifx_discovery_get_pci(const char* path, struct CIFX_DISCOVERY_ENTRY_T* entry);
+#endif
 
 /*****************************************************************************/
 /*! Initialization function called on load of libcifx_tk.so                  */
@@ -126,6 +159,13 @@ static void __init()
 static void __deinit()
 {
   cifXDriverDeinit();
+
+  pthread_mutex_lock(&s_discovery_lock);
+  free(s_discovery_index);
+  s_discovery_index = NULL;
+  s_discovery_count = 0;
+  s_discovery_valid = 0;
+  pthread_mutex_unlock(&s_discovery_lock);
 }
 
 int check_if_locked( int fd) {
@@ -638,68 +678,74 @@ unsigned long cifx_uio_get_mem_addr(int uio_num, int bar)
 }
 
 /*****************************************************************************/
-/*! Returns the alias given via device-tree
+/*! Reads the name of an uio device
 *     \param uio_num  Number of uio device
-*     \return pointer to buffer - needs to be freed after usage              */
+*     \param name     Returned name
+*     \param len      Size of name buffer
+*     \return !=0 on success                                                 */
 /*****************************************************************************/
-char* cifx_uio_get_device_alias(int uio_num)
+static int uio_read_name(int uio_num, char* name, size_t len)
 {
   char  filename[64];
-  char  ret[64];
-  char* alias = NULL;
+  char  format[16];
+  int   ret = 0;
   FILE* file;
 
   sprintf(filename, "/sys/class/uio/uio%d/name",uio_num);
+  snprintf(format, sizeof(format), "%%%ds", (int)len - 1);
 
   file = fopen(filename,"r");
   if(file)
   {
-    if (1==fscanf(file,"%s",ret)) {
-      char* buf = strstr(ret, ",");
-      if ((buf != NULL) && ((long unsigned int)(buf+1-ret)<strlen(ret))) {
-        buf = strstr(buf+1, ",");
-        if ((buf != NULL) && ((long unsigned int)(buf+1-ret)<strlen(ret))) {
-          if (strcmp((buf+1),"-") != 0) {
-            alias = (char*)malloc(CIFx_MAX_INFO_NAME_LENTH);
-            sprintf(alias,"%s",buf+1);
-          }
-        }
+    if (1==fscanf(file,format,name))
+      ret = 1;
+    fclose(file);
+  }
+  return ret;
+}
+
+/*****************************************************************************/
+/*! Extracts the alias from an uio device name ("<name>,<start type>,<alias>")
+*     \param name   uio device name
+*     \param alias  Returned alias (empty if not given)
+*     \param len    Size of alias buffer                                     */
+/*****************************************************************************/
+static void uio_name_get_alias(const char* name, char* alias, size_t len)
+{
+  const char* buf = strstr(name, ",");
+
+  alias[0] = '\0';
+  if ((buf != NULL) && ((long unsigned int)(buf+1-name)<strlen(name))) {
+    buf = strstr(buf+1, ",");
+    if ((buf != NULL) && ((long unsigned int)(buf+1-name)<strlen(name))) {
+      if (strcmp((buf+1),"-") != 0) {
+        snprintf(alias, len, "%s", buf+1);
       }
     }
-    fclose(file);
   }
-  return alias;
 }
 
 /*****************************************************************************/
-/*! Returns the startuptype of the device given via device-tree
-*     \param uio_num  Number of uio device
+/*! Extracts the start type from an uio device name ("<name>,<start type>,<alias>")
+*     \param name   uio device name
 *     \return device type (ram,flash,auto,dont touch)                        */
 /*****************************************************************************/
-CIFX_TOOLKIT_DEVICETYPE_E cifx_uio_get_device_startuptype(int uio_num)
+static CIFX_TOOLKIT_DEVICETYPE_E uio_name_get_startuptype(const char* name)
 {
   char  buf[64];
-  char  filename[64];
   char* next = NULL;
   CIFX_TOOLKIT_DEVICETYPE_E ret = eCIFX_DEVICE_AUTODETECT;
-  FILE* file;
-
-  sprintf(filename, "/sys/class/uio/uio%d/name",uio_num);
 
-  file = fopen(filename,"r");
-  if(file)
-  {
-    if (1==fscanf(file,"%s",buf)) {
-      next = strstr(buf, ",");
-      if ((next != NULL) && ((long unsigned int)(next+1-buf)<strlen(buf))) {
-        char* end = strstr(next+1, ",");
-        next+=1;
-        if (end != NULL) {
-          *end = 0;
-        }
-      }
+  snprintf(buf, sizeof(buf), "%s", name);
+  next = strstr(buf, ",");
+  if ((next != NULL) && ((long unsigned int)(next+1-buf)<strlen(buf))) {
+    char* end = strstr(next+1, ",");
+    next+=1;
+    if (end != NULL) {
+      *end = 0;
     }
-    fclose(file);
+  } else {
+    next = NULL;
   }
   if (next != NULL) {
     if (strncmp(next, UIO_NETX_START_TYPE_AUTO, CIFx_MAX_INFO_NAME_LENTH) == 0) {
@@ -718,6 +764,48 @@ CIFX_TOOLKIT_DEVICETYPE_E cifx_uio_get_device_startuptype(int uio_num)
   return ret;
 }
 
+/*****************************************************************************/
+/*! Returns the alias given via device-tree
+*     \param uio_num  Number of uio device
+*     \return pointer to buffer - needs to be freed after usage              */
+/*****************************************************************************/
+char* cifx_uio_get_device_alias(int uio_num)
+{
+  struct CIFX_DISCOVERY_ENTRY_T entry;
+  char                          name[64];
+  char*                         alias = NULL;
+
+  if (cifx_discovery_get_uio(uio_num, &entry) != 0) {
+    /* not discovered (e.g. user card), so query it */
+    if (!uio_read_name(uio_num, name, sizeof(name)))
+      return NULL;
+    uio_name_get_alias(name, entry.alias, sizeof(entry.alias));
+  }
+  if (entry.alias[0] != '\0')
+    alias = strdup(entry.alias);
+
+  return alias;
+}
+
+/*****************************************************************************/
+/*! Returns the startuptype of the device given via device-tree
+*     \param uio_num  Number of uio device
+*     \return device type (ram,flash,auto,dont touch)                        */
+/*****************************************************************************/
+CIFX_TOOLKIT_DEVICETYPE_E cifx_uio_get_device_startuptype(int uio_num)
+{
+  struct CIFX_DISCOVERY_ENTRY_T entry;
+  char                          name[64];
+
+  if (cifx_discovery_get_uio(uio_num, &entry) == 0)
+    return entry.start_type;
+
+  if (!uio_read_name(uio_num, name, sizeof(name)))
+    return eCIFX_DEVICE_AUTODETECT;
+
+  return uio_name_get_startuptype(name);
+}
+
 int cifx_uio_validate_name(int uio_num, const char* name)
 {
   char  filename[64];
@@ -1259,6 +1347,10 @@ int cifx_hil_pci_flash_based( int device_id, int subdevice_id) {
 
 int cifx_hil_pci_flash_based_by_path( char* pci_path) {
   unsigned int vendor_id, device_id, subdevice_id;
+  struct CIFX_DISCOVERY_ENTRY_T entry;
+
+  if ((pci_path != NULL) && (cifx_discovery_get_pci(pci_path, &entry) == 0))
+    return entry.flash_based;
 
   if (pci_path != NULL) {
     if (IS_HILSCHER_PCI_DEV(pci_path, &vendor_id)) {
@@ -1356,159 +1448,658 @@ int cifx_hil_pci_flash_based_by_path( char* pci_path) {
   }
 #endif /* defined(VFIO_SUPPORT) || !defined(CIFX_NO_PCIACCESS_LIB) */
 
+/*****************************************************************************/
+/*! Returns the poll period of a device in us (device.conf "pollinterval="
+*   or poll_interval passed to cifXDriverInit())
+*     \param dev_intern  Internal device structure
+*     \return Poll period in us                                              */
+/*****************************************************************************/
+static unsigned long cifXGetPollInterval(PCIFX_DEVICE_INTERNAL_T dev_intern)
+{
+  if(dev_intern->poll_interval_us != 0)
+    return dev_intern->poll_interval_us;
+
+  return polling_interval * 1000;
+}
+
+/*****************************************************************************/
+/*! Adds a number of nanoseconds to a timespec
+*     \param ts       Time to modify
+*     \param ns       Nanoseconds to add                                      */
+/*****************************************************************************/
+static void timespec_add_ns(struct timespec* ts, uint64_t ns)
+{
+  ns += (uint64_t)ts->tv_nsec;
+
+  ts->tv_sec  += (time_t)(ns / 1000000000ULL);
+  ts->tv_nsec  = (long)(ns % 1000000000ULL);
+}
+
 /*****************************************************************************/
 /*! Thread for cyclic Toolkit timer, which handles polling of COS bits on
-*   non-irq cards
-*     \param arg      Pollinterval in ms
+*   a non-irq card. Every polled card has its own thread, so a card does
+*   not delay the COS handling of the other cards.
+*   The thread sleeps until absolute deadlines (CLOCK_MONOTONIC), so the
+*   poll period does not drift by the time spent in the COS handling.
+*   Deadlines which have already passed are counted and skipped instead of
+*   polling several times in a row.
+*     \param arg      Internal device structure (PCIFX_DEVICE_INTERNAL_T)
 *     \return NULL on termination                                            */
 /*****************************************************************************/
 static void* cifXPollingThread(void *arg)
 {
-  unsigned long pollinterval = (unsigned long)arg;
-  struct timespec polling_sleep;
+  PCIFX_DEVICE_INTERNAL_T dev_intern = (PCIFX_DEVICE_INTERNAL_T)arg;
+  uint64_t                period_ns  = (uint64_t)cifXGetPollInterval(dev_intern) * 1000;
+  struct timespec         deadline;
+
+  if( (dev_intern->set_poll_cpu)  &&
+      (dev_intern->poll_cpu >= 0) &&
+      (dev_intern->poll_cpu < CPU_SETSIZE) )
+  {
+    cpu_set_t cpuset;
+    int       ret;
+
+    CPU_ZERO(&cpuset);
+    CPU_SET(dev_intern->poll_cpu, &cpuset);
+
+    if( (ret = pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset)) != 0 )
+    {
+      if(g_ulTraceLevel & TRACE_LEVEL_ERROR)
+      {
+        USER_Trace(dev_intern->devinstance, TRACE_LEVEL_ERROR,
+                   "Failed to pin polling thread to CPU %d (pthread_setaffinity_np=%d)",
+                   dev_intern->poll_cpu, ret);
+      }
+    }
+  }
+
+  cifXRTPrefaultStack();
 
-  polling_sleep.tv_sec = 0;
-  polling_sleep.tv_nsec = pollinterval * 1000 * 1000;
+  clock_gettime(CLOCK_MONOTONIC, &deadline);
 
-  while( 0 == polling_thread_stop )
+  while( 0 == dev_intern->poll_stop )
   {
-    cifXTKitCyclicTimer();
-    nanosleep(&polling_sleep, NULL);
+    struct timespec now;
+    int64_t         lateness;
+
+    while(EINTR == clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL))
+      ;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    lateness = (int64_t)(now.tv_sec - deadline.tv_sec) * 1000000000LL +
+               (now.tv_nsec - deadline.tv_nsec);
+    if(lateness < 0)
+      lateness = 0;
+
+    __atomic_add_fetch(&dev_intern->poll_cycles, 1, __ATOMIC_RELAXED);
+    if((uint64_t)lateness > __atomic_load_n(&dev_intern->poll_max_lateness_ns, __ATOMIC_RELAXED))
+      __atomic_store_n(&dev_intern->poll_max_lateness_ns, (uint64_t)lateness, __ATOMIC_RELAXED);
+
+    cifXTKitCyclicTimerDevice(dev_intern->devinstance);
+
+    /* Woke up at least one period too late, skip the missed deadlines */
+    if((uint64_t)lateness >= period_ns)
+    {
+      uint64_t missed = (uint64_t)lateness / period_ns;
+
+      __atomic_add_fetch(&dev_intern->poll_missed, missed, __ATOMIC_RELAXED);
+      timespec_add_ns(&deadline, missed * period_ns);
+    }
+    timespec_add_ns(&deadline, period_ns);
   }
   return NULL;
 }
 
-
 /*****************************************************************************/
-/*! Wraps the cifX Toolkit callback to the user's known parameters
-*   The user does not need to know about our device instance, as he only
-*   provided a CIFX_DEVICE_T structure
-*     \param pvDeviceInstance  Device the callback was made for
-*     \param eEvent            Signalled event                               */
+/*! Starts the COS polling thread of a device, if polling is enabled and the
+*   device is not running in IRQ mode
+*     \param dev_intern  Internal device structure
+*     \return CIFX_NO_ERROR on success                                       */
 /*****************************************************************************/
-static void cifXWrapEvent(void* pvDeviceInstance, CIFX_TOOLKIT_NOTIFY_E eEvent)
+static int32_t cifXStartPollingThread(PCIFX_DEVICE_INTERNAL_T dev_intern)
 {
-  PDEVICEINSTANCE         ptDevInstance = (PDEVICEINSTANCE)pvDeviceInstance;
-  PCIFX_DEVICE_INTERNAL_T ptInternal    = (PCIFX_DEVICE_INTERNAL_T)ptDevInstance->pvOSDependent;
-  struct CIFX_DEVICE_T*   ptDevice      = ptInternal->userdevice;
+  int ret;
 
-  ptDevice->notify(ptDevice, (CIFX_NOTIFY_E)eEvent);
+  if( !polling_thread_enabled || dev_intern->devinstance->fIrqEnabled )
+    return CIFX_NO_ERROR;
+
+  dev_intern->poll_stop = 0;
+
+  if( (ret = pthread_create(&dev_intern->poll_thread, &polling_thread_attr, cifXPollingThread, (void*)dev_intern)) != 0 )
+  {
+    ERR( "Could not create polling thread for %s (pthread_create=%d)\n", dev_intern->devinstance->szName, ret);
+    return CIFX_DRV_INIT_STATE_ERROR;
+  }
+  dev_intern->poll_running = 1;
+
+  return CIFX_NO_ERROR;
 }
 
 /*****************************************************************************/
-/*! Internal function for adding device to toolkit control
-*     \param ptDevice  Device to add
-*     \param num       Number to use for identifier ("cifX<num>")
-*     \param user_card !=0 if card was given through user parameter
+/*! Stops the COS polling thread of a device, if it is running
+*     \param dev_intern  Internal device structure                           */
+/*****************************************************************************/
+static void cifXStopPollingThread(PCIFX_DEVICE_INTERNAL_T dev_intern)
+{
+  if(dev_intern->poll_running)
+  {
+    dev_intern->poll_stop = 1;
+    pthread_join(dev_intern->poll_thread, NULL);
+    dev_intern->poll_running = 0;
+  }
+}
+
+/*****************************************************************************/
+/*! Returns the statistics of the COS polling thread of a device
+*     \param szBoard     Name or alias of the device
+*     \param ptStats     Returned statistics
+*     \param fReset      !=0 to reset the counters after reading them
 *     \return CIFX_NO_ERROR on success                                       */
 /*****************************************************************************/
-static int32_t cifXDriverAddDevice(struct CIFX_DEVICE_T* ptDevice, unsigned int num, int user_card)
+int32_t cifXDriverGetPollStatistics(const char* szBoard, struct CIFX_POLL_STATISTICS* ptStats, int fReset)
 {
-  PDEVICEINSTANCE         ptDevInstance = NULL;
-  PCIFX_DEVICE_INTERNAL_T ptInternalDev = NULL;
-  int32_t                 ret           = CIFX_FUNCTION_FAILED;
+  int32_t  lRet  = CIFX_INVALID_BOARD;
+  uint32_t ulIdx = 0;
 
-#ifdef CIFX_DRV_HWIF
-  if ( ((ptDevice->hwif_read) && (NULL == ptDevice->hwif_write)) ||
-       ((ptDevice->hwif_write) && (NULL == ptDevice->hwif_read))) {
-    ERR( "Error initializing device! Misconfigured HW-Function Interface (read- or write-function is not defined)!\n");
-    return CIFX_INVALID_PARAMETER;
-  }
-#endif
-  if(NULL == (ptInternalDev = (PCIFX_DEVICE_INTERNAL_T)malloc(sizeof(*ptInternalDev))))
-  {
-    ERR( "Error allocating internal device structures\n");
-  } else if(NULL == (ptDevInstance = (PDEVICEINSTANCE)malloc(sizeof(*ptDevInstance))))
-  {
-    ERR( "Error allocating internal device structures\n");
-    free(ptInternalDev);
-    ptInternalDev = NULL;
-  } else
+  if( (NULL == szBoard) || (NULL == ptStats) )
+    return CIFX_INVALID_POINTER;
+
+  if (NULL == g_pvTkitLock)
+    return CIFX_DRV_NOT_INITIALIZED;
+
+  OS_EnterLock(g_pvTkitLock);
+
+  for (ulIdx = 0; ulIdx < g_ulDeviceCount; ulIdx++)
   {
-    memset(ptDevInstance, 0, sizeof(*ptDevInstance));
-    memset(ptInternalDev, 0, sizeof(*ptInternalDev));
+    PDEVICEINSTANCE ptDev = g_pptDevices[ulIdx];
 
-    ptInternalDev->userdevice  = ptDevice;
-    ptInternalDev->devinstance = ptDevInstance;
-    ptInternalDev->user_card   = user_card;
+    if( (OS_Strcmp( ptDev->szName,  szBoard) == 0) ||
+        (OS_Strcmp( ptDev->szAlias, szBoard) == 0) )
+    {
+      PCIFX_DEVICE_INTERNAL_T dev_intern = (PCIFX_DEVICE_INTERNAL_T)ptDev->pvOSDependent;
 
-    ptDevInstance->pvOSDependent     = (void*)ptInternalDev;
-    ptDevInstance->pbDPM             = (unsigned char*)ptDevice->dpm;
-    ptDevInstance->ulDPMSize         = ptDevice->dpmlen;
-    ptDevInstance->ulPhysicalAddress = ptDevice->dpmaddr;
+      if(!dev_intern->poll_running)
+      {
+        /* device is running in IRQ mode or polling is disabled */
+        lRet = CIFX_FUNCTION_NOT_AVAILABLE;
+        break;
+      }
 
-    ptDevInstance->pbExtendedMemory      = (uint8_t*)ptDevice->extmem;
-    ptDevInstance->ulExtendedMemorySize  = ptDevice->extmemlen;
+      ptStats->poll_interval_us = cifXGetPollInterval(dev_intern);
+      ptStats->poll_cpu         = dev_intern->set_poll_cpu ? dev_intern->poll_cpu : -1;
 
-    /* get the device type and underlying driver info */
-    /* note that the SPI device may use uio_fd as well for its irq handle */
-    if ((ptDevice->uio_fd >= 0) && (ptDevice->uio_num >= 0))
-      ptInternalDev->device_type = eCIFX_DEVICE_TYPE_UIO;
-    else if ((ptDevice->userparam != NULL) && (ptDevice->uio_num == UIO_NUM_SPI_DEVICE))
-      ptInternalDev->device_type = eCIFX_DEVICE_TYPE_SPI;
-    else if ((ptDevice->userparam != NULL) && (ptDevice->uio_num == UIO_NUM_VFIO_DEVICE))
-      ptInternalDev->device_type = eCIFX_DEVICE_TYPE_VFIO;
-    else
-      ptInternalDev->device_type = eCIFX_DEVICE_TYPE_UNKNOWN;
+      if(fReset)
+      {
+        ptStats->cycles           = __atomic_exchange_n(&dev_intern->poll_cycles,          0, __ATOMIC_RELAXED);
+        ptStats->missed_deadlines = __atomic_exchange_n(&dev_intern->poll_missed,          0, __ATOMIC_RELAXED);
+        ptStats->max_lateness_ns  = __atomic_exchange_n(&dev_intern->poll_max_lateness_ns, 0, __ATOMIC_RELAXED);
+      } else
+      {
+        ptStats->cycles           = __atomic_load_n(&dev_intern->poll_cycles,          __ATOMIC_RELAXED);
+        ptStats->missed_deadlines = __atomic_load_n(&dev_intern->poll_missed,          __ATOMIC_RELAXED);
+        ptStats->max_lateness_ns  = __atomic_load_n(&dev_intern->poll_max_lateness_ns, __ATOMIC_RELAXED);
+      }
+      lRet = CIFX_NO_ERROR;
+      break;
+    }
+  }
 
-#ifdef CIFX_DRV_HWIF
-    /* set to the linux default read/write function, to be able to handle all devices (also memory mapped) */
-    ptDevInstance->pfnHwIfRead  = HWIFDPMRead;
-    ptDevInstance->pfnHwIfWrite = HWIFDPMWrite;
-#endif
+  OS_LeaveLock(g_pvTkitLock);
 
-#ifdef CIFX_TOOLKIT_DMA
-    if (ptDevice->dma_buffer_cnt)
+  return lRet;
+}
+
+/*****************************************************************************/
+/*! Returns the timeline of the last reset/startup of a device
+*     \param szBoard     Name or alias of the device
+*     \param ptEvents    Returned events
+*     \param pulCount    in: Number of entries in ptEvents, out: Number of events
+*     \return CIFX_NO_ERROR on success, CIFX_BUFFER_TOO_SHORT if not all
+*             events fit into ptEvents                                       */
+/*****************************************************************************/
+int32_t cifXDriverGetBootTimeline(const char* szBoard, struct CIFX_BOOT_EVENT* ptEvents, uint32_t* pulCount)
+{
+  int32_t  lRet  = CIFX_DRV_CMD_ACTIVE;
+  uint32_t ulIdx = 0;
+
+  if( (NULL == szBoard) || (NULL == ptEvents) || (NULL == pulCount) )
+    return CIFX_INVALID_POINTER;
+
+  if (NULL == g_pvTkitLock)
+    return CIFX_DRV_NOT_INITIALIZED;
+
+  /* The timeline is written by the reset/startup functions of the toolkit with the
+     init mutex of the system device held. g_pvTkitLock is not held while waiting
+     for a running reset, so the device list is searched again on every try. */
+  while (CIFX_DRV_CMD_ACTIVE == lRet)
+  {
+    PDEVICEINSTANCE ptDev = NULL;
+
+    OS_EnterLock(g_pvTkitLock);
+
+    lRet = CIFX_INVALID_BOARD;
+    for (ulIdx = 0; ulIdx < g_ulDeviceCount; ulIdx++)
     {
-      unsigned int i = 0;
-      ptDevInstance->ulDMABufferCount = ptDevice->dma_buffer_cnt;
-      for (i=0;i<ptDevice->dma_buffer_cnt;i++)
+      if( (OS_Strcmp( g_pptDevices[ulIdx]->szName,  szBoard) == 0) ||
+          (OS_Strcmp( g_pptDevices[ulIdx]->szAlias, szBoard) == 0) )
       {
-        ptDevInstance->atDmaBuffers[i].ulSize            = ptDevice->dma_buffer[i].ulSize;
-        ptDevInstance->atDmaBuffers[i].ulPhysicalAddress = ptDevice->dma_buffer[i].ulPhysicalAddress;
-        ptDevInstance->atDmaBuffers[i].pvBuffer          = ptDevice->dma_buffer[i].pvBuffer;
-        ptDevInstance->atDmaBuffers[i].pvUser            = NULL;
+        ptDev = g_pptDevices[ulIdx];
+        break;
       }
     }
-#endif
-    if(ptDevice->notify)
+
+    if (NULL == ptDev)
     {
-      ptDevInstance->pfnNotify = cifXWrapEvent;
-    }
+      /* device not found */
 
-    snprintf(ptDevInstance->szName,
-             sizeof(ptDevInstance->szName),
-             "cifX%u",
-             num);
+    } else if (!OS_WaitMutex(ptDev->tSystemDevice.pvInitMutex, 0))
+    {
+      /* reset/startup in progress */
+      lRet = CIFX_DRV_CMD_ACTIVE;
 
-    if (ptDevice->uio_num>=0) {
-      /* extract alias from uio device name (can be used via device-tree) */
-      char* szAlias = cifx_uio_get_device_alias(ptDevice->uio_num);
-      if (szAlias != NULL) {
-        snprintf(ptDevInstance->szAlias,
-                 sizeof(ptDevInstance->szName),
-                 "%s",
-                 szAlias);
-        free(szAlias);
+    } else
+    {
+      CIFX_BOOT_TIMELINE_T* ptTimeline = &ptDev->tBootTimeline;
+      uint32_t              ulEvent;
+
+      lRet = CIFX_NO_ERROR;
+      for (ulEvent = 0; ulEvent < ptTimeline->ulEventCount; ulEvent++)
+      {
+        if (ulEvent >= *pulCount)
+        {
+          lRet = CIFX_BUFFER_TOO_SHORT;
+          break;
+        }
+        ptEvents[ulEvent].time_ms = ptTimeline->atEvents[ulEvent].ulTime;
+        ptEvents[ulEvent].event   = ptTimeline->atEvents[ulEvent].szEvent;
       }
+      *pulCount = ptTimeline->ulEventCount;
+
+      OS_ReleaseMutex(ptDev->tSystemDevice.pvInitMutex);
     }
 
-    /* Default to no logfile */
-    ptInternalDev->log_file = NULL;
+    OS_LeaveLock(g_pvTkitLock);
 
-    /* Create log file if neccessary */
-    if(g_ulTraceLevel > 0)
-    {
-      size_t pathlen     = strlen(g_szDriverBaseDir) + sizeof(ptDevInstance->szName) + 2 + 4; /* +2 for 1x NUL and 1 additional '/'
-                                                                                                 +4 for extension ".log" */
-      char*  logfilepath = malloc(pathlen);
+    if (CIFX_DRV_CMD_ACTIVE == lRet)
+      OS_Sleep(1);
+  }
 
-      snprintf(logfilepath, pathlen, "%s/%s.log", g_szDriverBaseDir, ptDevInstance->szName);
+  return lRet;
+}
 
-      if (g_logfd == 0) {
-        ptInternalDev->log_file = fopen(logfilepath, "w+");
-      } else {
-        ptInternalDev->log_file = g_logfd;
+/*****************************************************************************/
+/*! Drops the cached device configuration (device.conf, firmware and
+*   configuration directories), so it is read again on the next access
+*     \param szBoard     Name or alias of the device, NULL for all devices
+*     \return CIFX_NO_ERROR on success                                       */
+/*****************************************************************************/
+int32_t cifXDriverReloadDeviceConfig(const char* szBoard)
+{
+  int32_t  lRet  = CIFX_INVALID_BOARD;
+  uint32_t ulIdx = 0;
+
+  if (NULL == g_pvTkitLock)
+    return CIFX_DRV_NOT_INITIALIZED;
+
+  OS_EnterLock(g_pvTkitLock);
+
+  for (ulIdx = 0; ulIdx < g_ulDeviceCount; ulIdx++)
+  {
+    PDEVICEINSTANCE ptDev = g_pptDevices[ulIdx];
+
+    if( (NULL == szBoard)                          ||
+        (OS_Strcmp( ptDev->szName,  szBoard) == 0) ||
+        (OS_Strcmp( ptDev->szAlias, szBoard) == 0) )
+    {
+      cifXConfigCacheInvalidate((PCIFX_DEVICE_INTERNAL_T)ptDev->pvOSDependent);
+      lRet = CIFX_NO_ERROR;
+    }
+  }
+
+  OS_LeaveLock(g_pvTkitLock);
+
+  return lRet;
+}
+
+
+/*****************************************************************************/
+/*! Signals the eventfd of a channel notification, if it was requested via
+*   cifXChannelGetNotificationFd() (pfnNotifySignal of the device instance).
+*   Called directly from the DSR, independent of registered callbacks.
+*     \param pvDeviceInstance  Device instance
+*     \param pvChannel         Channel instance
+*     \param ulNotification    Signalled notification                      */
+/*****************************************************************************/
+static void cifXSignalNotificationFd(void* pvDeviceInstance, void* pvChannel, uint32_t ulNotification)
+{
+  PCIFX_DEVICE_INTERNAL_T dev_intern = (PCIFX_DEVICE_INTERNAL_T)((PDEVICEINSTANCE)pvDeviceInstance)->pvOSDependent;
+  uint32_t                ulChannel  = ((PCHANNELINSTANCE)pvChannel)->ulChannelNumber;
+  uint64_t                ullVal     = 1;
+
+  if ( (ulNotification < CIFX_NOTIFY_RX_MBX_FULL) || (ulNotification > CIFX_NOTIFY_COM_STATE) ||
+       (ulChannel >= CIFX_MAX_NUMBER_OF_CHANNELS) )
+    return;
+
+  if (!__atomic_load_n(&dev_intern->notify_fd_active[ulChannel][ulNotification - 1], __ATOMIC_ACQUIRE))
+    return;
+
+  /* a full counter can be ignored, the eventfd is readable anyway */
+  if (write(dev_intern->notify_fd[ulChannel][ulNotification - 1], &ullVal, sizeof(ullVal)) < 0)
+    return;
+}
+
+/*****************************************************************************/
+/*! Returns the eventfd slot of a channel notification
+*     \param hChannel        Channel handle
+*     \param ulNotification  Notification (CIFX_NOTIFY_XXX)
+*     \param ppfd            Returned eventfd slot in the internal device structure
+*     \param ppiActive       Returned activation flag of the slot
+*     \return CIFX_NO_ERROR on success                                       */
+/*****************************************************************************/
+static int32_t cifXGetNotificationFdSlot(CIFXHANDLE hChannel, uint32_t ulNotification, int** ppfd, int** ppiActive)
+{
+  PCHANNELINSTANCE        ptChannel  = (PCHANNELINSTANCE)hChannel;
+  PCIFX_DEVICE_INTERNAL_T dev_intern = NULL;
+
+  if (NULL == g_pvTkitLock)
+    return CIFX_DRV_NOT_INITIALIZED;
+
+  if (NULL == ptChannel)
+    return CIFX_INVALID_HANDLE;
+
+#ifdef CIFX_TOOLKIT_PARAMETER_CHECK
+  if ( !cifXTKitIsRegisteredHandle(ptChannel) || !ptChannel->fIsChannel )
+    return CIFX_INVALID_HANDLE;
+#endif
+
+  if ( (ulNotification < CIFX_NOTIFY_RX_MBX_FULL) || (ulNotification > CIFX_NOTIFY_COM_STATE) ||
+       (ptChannel->ulChannelNumber >= CIFX_MAX_NUMBER_OF_CHANNELS) )
+    return CIFX_INVALID_PARAMETER;
+
+  dev_intern = (PCIFX_DEVICE_INTERNAL_T)((PDEVICEINSTANCE)ptChannel->pvDeviceInstance)->pvOSDependent;
+  *ppfd      = &dev_intern->notify_fd[ptChannel->ulChannelNumber][ulNotification - 1];
+  *ppiActive = &dev_intern->notify_fd_active[ptChannel->ulChannelNumber][ulNotification - 1];
+
+  return CIFX_NO_ERROR;
+}
+
+/*****************************************************************************/
+/*! Returns a pollable file descriptor (eventfd) for a channel notification,
+*   as alternative to the callbacks registered via xChannelRegisterNotification.
+*   The eventfd becomes readable, whenever the toolkit detects the notification
+*   (reading it returns the number of notifications since the last read). It is
+*   signalled directly from the interrupt handling, independent of a registered
+*   callback and of the callback threads. The application fetches the data
+*   itself (e.g. xChannelGetPacket()). The eventfd is signalled once when it is
+*   requested, so the application checks the current state first.
+*   The descriptor is owned by the driver and stays valid until
+*   cifXDriverDeinit(), so it must not be closed by the application. Like
+*   callbacks, notifications require interrupt mode.
+*     \param hChannel        Channel handle
+*     \param ulNotification  Notification (CIFX_NOTIFY_XXX)
+*     \param piFd            Returned eventfd
+*     \return CIFX_NO_ERROR on success                                       */
+/*****************************************************************************/
+int32_t cifXChannelGetNotificationFd(CIFXHANDLE hChannel, uint32_t ulNotification, int* piFd)
+{
+  PCHANNELINSTANCE ptChannel  = (PCHANNELINSTANCE)hChannel;
+  int*             pfd        = NULL;
+  int*             piActive   = NULL;
+  int              fAreaValid = 1;
+  uint64_t         ullVal     = 1;
+  int32_t          lRet;
+
+  if (NULL == piFd)
+    return CIFX_INVALID_POINTER;
+
+  if (CIFX_NO_ERROR != (lRet = cifXGetNotificationFdSlot(hChannel, ulNotification, &pfd, &piActive)))
+    return lRet;
+
+  if (!((PDEVICEINSTANCE)ptChannel->pvDeviceInstance)->fIrqEnabled)
+    return CIFX_INTERRUPT_DISABLED;
+
+  /* process data notifications need the corresponding IO area */
+  switch (ulNotification)
+  {
+    case CIFX_NOTIFY_PD0_IN:  fAreaValid = (ptChannel->ulIOInputAreas  > 0); break;
+    case CIFX_NOTIFY_PD1_IN:  fAreaValid = (ptChannel->ulIOInputAreas  > 1); break;
+    case CIFX_NOTIFY_PD0_OUT: fAreaValid = (ptChannel->ulIOOutputAreas > 0); break;
+    case CIFX_NOTIFY_PD1_OUT: fAreaValid = (ptChannel->ulIOOutputAreas > 1); break;
+    default:                                                                break;
+  }
+
+  if (!fAreaValid)
+    return CIFX_INVALID_PARAMETER;
+
+  OS_EnterLock(g_pvTkitLock);
+  if (*pfd < 0)
+    *pfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+  if (*pfd >= 0)
+  {
+    __atomic_store_n(piActive, 1, __ATOMIC_RELEASE);
+
+    /* let the application check the current state */
+    if (write(*pfd, &ullVal, sizeof(ullVal)) < 0)
+    {
+      DBG( "Initial notification eventfd signal failed (errno=%d)\n", errno);
+    }
+
+    *piFd = *pfd;
+  }
+  OS_LeaveLock(g_pvTkitLock);
+
+  if (*pfd < 0)
+  {
+    ERR( "Error creating notification eventfd (errno=%d)\n", errno);
+    return CIFX_FUNCTION_FAILED;
+  }
+
+  return CIFX_NO_ERROR;
+}
+
+/*****************************************************************************/
+/*! Stops signalling the eventfd returned by cifXChannelGetNotificationFd().
+*   Pending notifications are discarded, the descriptor stays open and is
+*   returned again by the next cifXChannelGetNotificationFd() call.
+*     \param hChannel        Channel handle
+*     \param ulNotification  Notification (CIFX_NOTIFY_XXX)
+*     \return CIFX_NO_ERROR on success                                       */
+/*****************************************************************************/
+int32_t cifXChannelReleaseNotificationFd(CIFXHANDLE hChannel, uint32_t ulNotification)
+{
+  int*     pfd      = NULL;
+  int*     piActive = NULL;
+  uint64_t ullVal;
+  int32_t  lRet;
+
+  if (CIFX_NO_ERROR != (lRet = cifXGetNotificationFdSlot(hChannel, ulNotification, &pfd, &piActive)))
+    return lRet;
+
+  OS_EnterLock(g_pvTkitLock);
+  if ( (*pfd < 0) || !__atomic_load_n(piActive, __ATOMIC_ACQUIRE) )
+  {
+    lRet = CIFX_CALLBACK_NOT_REGISTERED;
+  } else
+  {
+    __atomic_store_n(piActive, 0, __ATOMIC_RELEASE);
+
+    /* discard pending notifications */
+    while (read(*pfd, &ullVal, sizeof(ullVal)) > 0)
+      ;
+  }
+  OS_LeaveLock(g_pvTkitLock);
+
+  return lRet;
+}
+
+/*****************************************************************************/
+/*! Closes all notification eventfds of a device
+*     \param dev_intern  Internal device structure                          */
+/*****************************************************************************/
+static void cifXCloseNotificationFds(PCIFX_DEVICE_INTERNAL_T dev_intern)
+{
+  uint32_t ulChannel;
+  uint32_t ulNotify;
+
+  for (ulChannel = 0; ulChannel < CIFX_MAX_NUMBER_OF_CHANNELS; ulChannel++)
+  {
+    for (ulNotify = 0; ulNotify < CIFX_NOTIFY_COM_STATE; ulNotify++)
+    {
+      dev_intern->notify_fd_active[ulChannel][ulNotify] = 0;
+      if (dev_intern->notify_fd[ulChannel][ulNotify] >= 0)
+        close(dev_intern->notify_fd[ulChannel][ulNotify]);
+      dev_intern->notify_fd[ulChannel][ulNotify] = -1;
+    }
+  }
+}
+
+/*****************************************************************************/
+/*! Wraps the cifX Toolkit callback to the user's known parameters
+*   The user does not need to know about our device instance, as he only
+*   provided a CIFX_DEVICE_T structure
+*     \param pvDeviceInstance  Device the callback was made for
+*     \param eEvent            Signalled event                               */
+/*****************************************************************************/
+static void cifXWrapEvent(void* pvDeviceInstance, CIFX_TOOLKIT_NOTIFY_E eEvent)
+{
+  PDEVICEINSTANCE         ptDevInstance = (PDEVICEINSTANCE)pvDeviceInstance;
+  PCIFX_DEVICE_INTERNAL_T ptInternal    = (PCIFX_DEVICE_INTERNAL_T)ptDevInstance->pvOSDependent;
+  struct CIFX_DEVICE_T*   ptDevice      = ptInternal->userdevice;
+
+  ptDevice->notify(ptDevice, (CIFX_NOTIFY_E)eEvent);
+}
+
+/*****************************************************************************/
+/*! Internal function for adding device to toolkit control
+*     \param ptDevice  Device to add
+*     \param num       Number to use for identifier ("cifX<num>")
+*     \param user_card !=0 if card was given through user parameter
+*     \return CIFX_NO_ERROR on success                                       */
+/*****************************************************************************/
+static int32_t cifXDriverAddDevice(struct CIFX_DEVICE_T* ptDevice, unsigned int num, int user_card)
+{
+  PDEVICEINSTANCE         ptDevInstance = NULL;
+  PCIFX_DEVICE_INTERNAL_T ptInternalDev = NULL;
+  int32_t                 ret           = CIFX_FUNCTION_FAILED;
+
+#ifdef CIFX_DRV_HWIF
+  if ( ((ptDevice->hwif_read) && (NULL == ptDevice->hwif_write)) ||
+       ((ptDevice->hwif_write) && (NULL == ptDevice->hwif_read))) {
+    ERR( "Error initializing device! Misconfigured HW-Function Interface (read- or write-function is not defined)!\n");
+    return CIFX_INVALID_PARAMETER;
+  }
+#endif
+  if(NULL == (ptInternalDev = (PCIFX_DEVICE_INTERNAL_T)malloc(sizeof(*ptInternalDev))))
+  {
+    ERR( "Error allocating internal device structures\n");
+  } else if(NULL == (ptDevInstance = (PDEVICEINSTANCE)malloc(sizeof(*ptDevInstance))))
+  {
+    ERR( "Error allocating internal device structures\n");
+    free(ptInternalDev);
+    ptInternalDev = NULL;
+  } else
+  {
+    memset(ptDevInstance, 0, sizeof(*ptDevInstance));
+    memset(ptInternalDev, 0, sizeof(*ptInternalDev));
+
+    ptInternalDev->userdevice  = ptDevice;
+    ptInternalDev->devinstance = ptDevInstance;
+    ptInternalDev->user_card   = user_card;
+    memset(ptInternalDev->notify_fd, 0xFF, sizeof(ptInternalDev->notify_fd));
+
+    /* Notification callbacks are executed by the callback threads, if enabled */
+    if(cifXNotifyDispatchEnabled())
+      ptDevInstance->pfnNotifyDispatch = cifXNotifyDispatch;
+
+    /* eventfds of cifXChannelGetNotificationFd() are signalled directly */
+    ptDevInstance->pfnNotifySignal = cifXSignalNotificationFd;
+
+    ptDevInstance->tBootTiming.ulPCIResetTime         = boot_timing.pci_reset_time;
+    ptDevInstance->tBootTiming.ulDPMResetTime         = boot_timing.dpm_reset_time;
+    ptDevInstance->tBootTiming.ulNetX4000PCIResetTime = boot_timing.netx4000_pci_reset_time;
+    ptDevInstance->tBootTiming.ulPollIntervalMin      = boot_timing.poll_interval_min;
+    ptDevInstance->tBootTiming.ulPollIntervalMax      = boot_timing.poll_interval_max;
+
+    ptDevInstance->pvOSDependent     = (void*)ptInternalDev;
+    ptDevInstance->pbDPM             = (unsigned char*)ptDevice->dpm;
+    ptDevInstance->ulDPMSize         = ptDevice->dpmlen;
+    ptDevInstance->ulPhysicalAddress = ptDevice->dpmaddr;
+
+    ptDevInstance->pbExtendedMemory      = (uint8_t*)ptDevice->extmem;
+    ptDevInstance->ulExtendedMemorySize  = ptDevice->extmemlen;
+
+    /* get the device type and underlying driver info */
+    /* note that the SPI device may use uio_fd as well for its irq handle */
+    if ((ptDevice->uio_fd >= 0) && (ptDevice->uio_num >= 0))
+      ptInternalDev->device_type = eCIFX_DEVICE_TYPE_UIO;
+    else if ((ptDevice->userparam != NULL) && (ptDevice->uio_num == UIO_NUM_SPI_DEVICE))
+      ptInternalDev->device_type = eCIFX_DEVICE_TYPE_SPI;
+    else if ((ptDevice->userparam != NULL) && (ptDevice->uio_num == UIO_NUM_VFIO_DEVICE))
+      ptInternalDev->device_type = eCIFX_DEVICE_TYPE_VFIO;
+    else if ((ptDevice->uio_fd >= 0) && (ptDevice->uio_num == UIO_NUM_EVENTFD_DEVICE))
+      ptInternalDev->device_type = eCIFX_DEVICE_TYPE_EVENTFD;
+    else
+      ptInternalDev->device_type = eCIFX_DEVICE_TYPE_UNKNOWN;
+
+#ifdef CIFX_DRV_HWIF
+    /* set to the linux default read/write function, to be able to handle all devices (also memory mapped) */
+    ptDevInstance->pfnHwIfRead  = HWIFDPMRead;
+    ptDevInstance->pfnHwIfWrite = HWIFDPMWrite;
+#endif
+
+#ifdef CIFX_TOOLKIT_DMA
+    if (ptDevice->dma_buffer_cnt)
+    {
+      unsigned int i = 0;
+      ptDevInstance->ulDMABufferCount = ptDevice->dma_buffer_cnt;
+      for (i=0;i<ptDevice->dma_buffer_cnt;i++)
+      {
+        ptDevInstance->atDmaBuffers[i].ulSize            = ptDevice->dma_buffer[i].ulSize;
+        ptDevInstance->atDmaBuffers[i].ulPhysicalAddress = ptDevice->dma_buffer[i].ulPhysicalAddress;
+        ptDevInstance->atDmaBuffers[i].pvBuffer          = ptDevice->dma_buffer[i].pvBuffer;
+        ptDevInstance->atDmaBuffers[i].pvUser            = NULL;
+      }
+    }
+#endif
+    if(ptDevice->notify)
+    {
+      ptDevInstance->pfnNotify = cifXWrapEvent;
+    }
+
+    snprintf(ptDevInstance->szName,
+             sizeof(ptDevInstance->szName),
+             "cifX%u",
+             num);
+
+    if (ptDevice->uio_num>=0) {
+      /* extract alias from uio device name (can be used via device-tree) */
+      char* szAlias = cifx_uio_get_device_alias(ptDevice->uio_num);
+      if (szAlias != NULL) {
+        snprintf(ptDevInstance->szAlias,
+                 sizeof(ptDevInstance->szName),
+                 "%s",
+                 szAlias);
+        free(szAlias);
+      }
+    }
+
+    /* Default to no logfile */
+    ptInternalDev->log_file = NULL;
+
+    /* Create log file if neccessary */
+    if(g_ulTraceLevel > 0)
+    {
+      size_t pathlen     = strlen(g_szDriverBaseDir) + sizeof(ptDevInstance->szName) + 2 + 4; /* +2 for 1x NUL and 1 additional '/'
+                                                                                                 +4 for extension ".log" */
+      char*  logfilepath = malloc(pathlen);
+
+      snprintf(logfilepath, pathlen, "%s/%s.log", g_szDriverBaseDir, ptDevInstance->szName);
+
+      if (g_logfd == 0) {
+        ptInternalDev->log_file = fopen(logfilepath, "w+");
+      } else {
+        ptInternalDev->log_file = g_logfd;
       }
       if( NULL == ptInternalDev->log_file)
       {
@@ -1590,8 +2181,15 @@ static int32_t cifXDriverAddDevice(struct CIFX_DEVICE_T* ptDevice, unsigned int
       }
     }
 #endif
+    /* device.conf and the firmware directories are read via the configuration cache */
+    if(CIFX_NO_ERROR == ret)
+      ret = cifXConfigCacheCreate(ptInternalDev);
+
     /* Add the device to the toolkits handled device list */
     if(CIFX_NO_ERROR == ret) {
+#ifdef CIFX_DRV_DPM_TRACE
+      cifXDPMTraceAddDevice(ptDevInstance);
+#endif
       if(ptDevInstance->ulDPMSize >= NETX_DPM_MEMORY_SIZE) {
         uint32_t ulVal = 0;
         /* Make sure to disable IRQs before passing device to Toolkit, since */
@@ -1611,13 +2209,26 @@ static int32_t cifXDriverAddDevice(struct CIFX_DEVICE_T* ptDevice, unsigned int
         /* de-initialize the hardware function interface */
         if (ptDevice->hwif_deinit)
           ptDevice->hwif_deinit( ptDevice);
+#endif
+      } else if ((ret = cifXStartPollingThread(ptInternalDev))) {
+        cifXTKitRemoveDevice(ptDevInstance->szName, 1);
+#ifdef CIFX_DRV_HWIF
+        if (ptDevice->hwif_deinit)
+          ptDevice->hwif_deinit( ptDevice);
 #endif
       }
+#ifdef CIFX_DRV_DPM_TRACE
+      /* the DPM layout (channels, mailboxes, IO areas) is known after the start */
+      if(CIFX_NO_ERROR == ret)
+        cifXDPMTraceAddDevice(ptDevInstance);
+#endif
     }
   }
 
   if(CIFX_NO_ERROR != ret)
   {
+    if(NULL != ptInternalDev)
+      cifXConfigCacheFree(ptInternalDev);
     free(ptDevInstance);
     free(ptInternalDev);
 #ifdef CIFXETHERNET
@@ -1676,12 +2287,21 @@ int32_t cifXDriverInit(const struct CIFX_LINUX_INIT* init_params)
 
   g_ulTraceLevel = init_params->trace_level;
 
+  if(NULL != init_params->boot_timing)
+    boot_timing = *init_params->boot_timing;
+  else
+    memset(&boot_timing, 0, sizeof(boot_timing));
+
+  /* Lock the memory before any driver thread is created */
+  if((CIFX_NO_ERROR == lRet) && init_params->rt_mode)
+    lRet = cifXRTStart();
+
   if(CIFX_NO_ERROR == lRet)
   {
     unsigned long poll_interval = init_params->poll_interval;
     size_t        tStackSize    = init_params->poll_StackSize;
 
-    polling_thread_running = 0;
+    polling_thread_enabled = 0;
 
     if(poll_interval != (unsigned long)CIFX_POLLINTERVAL_DISABLETHREAD)
     {
@@ -1696,8 +2316,9 @@ int32_t cifXDriverInit(const struct CIFX_LINUX_INIT* init_params)
       if ( tStackSize == 0)
         tStackSize = COS_THREAD_STACK_MIN;
 
-      /* Create COS flag polling thread for non-irq devices */
-      polling_thread_stop = 0;
+      /* Setup COS flag polling thread attributes for non-irq devices.
+         The threads are created when the devices are added. */
+      polling_interval = poll_interval;
 
       if( (ret = pthread_attr_init(&polling_thread_attr)) != 0 )
       {
@@ -1725,12 +2346,35 @@ int32_t cifXDriverInit(const struct CIFX_LINUX_INIT* init_params)
       {
         ERR( "Failed to set priority of polling thread (pthread_attr_setschedparam=%d)\n", ret);
         lRet = CIFX_DRV_INIT_STATE_ERROR;
-      } else if( (ret = pthread_create(&polling_thread, &polling_thread_attr, cifXPollingThread, (void*)poll_interval)) != 0 )
+      } else
       {
-        ERR( "Could not create polling thread (pthread_create=%d)\n", ret);
-        lRet = CIFX_DRV_INIT_STATE_ERROR;
+        polling_thread_enabled = 1;
       }
-      polling_thread_running = 1;
+    }
+
+    if((CIFX_NO_ERROR == lRet) && (init_params->notify_threads > 0))
+    {
+      /* Start notification callback threads before any device is added */
+      if(CIFX_NO_ERROR != (lRet = cifXNotifyDispatchStart(init_params->notify_threads)))
+        ERR( "Failed to start %d notification callback threads (Status=0x%08X)\n", init_params->notify_threads, lRet);
+    }
+
+    if((CIFX_NO_ERROR == lRet) && (init_params->packet_pool > 0))
+    {
+      if(CIFX_NO_ERROR != (lRet = cifXPacketPoolStart(init_params->packet_pool)))
+        ERR( "Failed to create packet pool of %u packets (Status=0x%08X)\n", init_params->packet_pool, lRet);
+    }
+
+    if((CIFX_NO_ERROR == lRet) && (NULL != init_params->dpm_trace_file))
+    {
+#ifdef CIFX_DRV_DPM_TRACE
+      /* Start the trace before any device is added, to record the device start-up */
+      if(CIFX_NO_ERROR != (lRet = cifXDPMTraceStart(init_params->dpm_trace_file, init_params->dpm_trace_size, init_params->dpm_trace_data)))
+        ERR( "Failed to start DPM trace to %s (Status=0x%08X)\n", init_params->dpm_trace_file, lRet);
+#else
+      ERR( "DPM trace requested, but the library is built without DPM_TRACE\n");
+      lRet = CIFX_FUNCTION_NOT_AVAILABLE;
+#endif
     }
 
     if(CIFX_NO_ERROR == lRet)
@@ -1887,113 +2531,368 @@ int32_t cifXDriverInit(const struct CIFX_LINUX_INIT* init_params)
     }
   }
 
-  return lRet;
+  return lRet;
+}
+
+/*****************************************************************************/
+/*! Marks a device as being restarted. The device is removed from the toolkit
+*   during the restart, so the caller must not hold g_pvTkitLock while the
+*   device starts up again (see cifXRestartDevice())
+*     \param szBoardName Name or alias of the device
+*     \param pptDev      Returned device instance
+*     \return CIFX_NO_ERROR on success, CIFX_DRV_CMD_ACTIVE if the device is
+*             already being restarted, CIFX_DRV_NOT_INITIALIZED if the
+*             driver is de-initialized                                       */
+/*****************************************************************************/
+static int32_t cifXClaimDeviceRestart(const char* szBoardName, PDEVICEINSTANCE* pptDev)
+{
+  int32_t         lRet  = CIFX_INVALID_BOARD;
+  uint32_t        ulIdx = 0;
+  PDEVICEINSTANCE ptRestart;
+
+  if (NULL == g_pvTkitLock)
+    return CIFX_DRV_NOT_INITIALIZED;
+
+  OS_EnterLock(g_pvTkitLock);
+
+  if (s_deinit_active)
+  {
+    OS_LeaveLock(g_pvTkitLock);
+    return CIFX_DRV_NOT_INITIALIZED;
+  }
+
+  /* A device being restarted is not in the device list while it starts up */
+  for (ptRestart = s_restart_list; NULL != ptRestart;
+       ptRestart = ((PCIFX_DEVICE_INTERNAL_T)ptRestart->pvOSDependent)->restart_next)
+  {
+    if( (OS_Strcmp( ptRestart->szName,  szBoardName) == 0) ||
+        (OS_Strcmp( ptRestart->szAlias, szBoardName) == 0) )
+    {
+      OS_LeaveLock(g_pvTkitLock);
+      return CIFX_DRV_CMD_ACTIVE;
+    }
+  }
+
+  /* Seach the device with the given name */
+  for (ulIdx = 0; ulIdx < g_ulDeviceCount; ulIdx++)
+  {
+    PDEVICEINSTANCE         ptDev      = g_pptDevices[ulIdx];
+    PCIFX_DEVICE_INTERNAL_T dev_intern = (PCIFX_DEVICE_INTERNAL_T)ptDev->pvOSDependent;
+
+    if( (OS_Strcmp( ptDev->szName,  szBoardName) == 0) ||
+        (OS_Strcmp( ptDev->szAlias, szBoardName) == 0) )
+    {
+      if (dev_intern->restart_active)
+      {
+        lRet = CIFX_DRV_CMD_ACTIVE;
+      } else
+      {
+        dev_intern->restart_active = 1;
+        dev_intern->restart_next   = s_restart_list;
+        s_restart_list             = ptDev;
+        *pptDev = ptDev;
+        lRet    = CIFX_NO_ERROR;
+      }
+      break;
+    }
+  }
+
+  OS_LeaveLock(g_pvTkitLock);
+
+  return lRet;
+}
+
+/*****************************************************************************/
+/*! Releases a device claimed by cifXClaimDeviceRestart()
+*     \param ptDev       Device instance                                     */
+/*****************************************************************************/
+static void cifXReleaseDeviceRestart(PDEVICEINSTANCE ptDev)
+{
+  PCIFX_DEVICE_INTERNAL_T dev_intern = (PCIFX_DEVICE_INTERNAL_T)ptDev->pvOSDependent;
+  PDEVICEINSTANCE*        pptEntry   = &s_restart_list;
+
+  OS_EnterLock(g_pvTkitLock);
+
+  while (NULL != *pptEntry)
+  {
+    if (ptDev == *pptEntry)
+    {
+      *pptEntry = dev_intern->restart_next;
+      break;
+    }
+    pptEntry = &((PCIFX_DEVICE_INTERNAL_T)(*pptEntry)->pvOSDependent)->restart_next;
+  }
+  dev_intern->restart_next   = NULL;
+  dev_intern->restart_active = 0;
+
+  OS_LeaveLock(g_pvTkitLock);
+}
+
+/*****************************************************************************/
+/*! Restarts a device claimed by cifXClaimDeviceRestart(). The device is
+*   removed from the toolkit and added again, which reruns the firmware and
+*   configuration download from the device configuration directory.
+*   g_pvTkitLock is only held while the device lists are changed, so several
+*   devices can be restarted in parallel.
+*     \param ptDev       Device instance
+*     \return CIFX_NO_ERROR on success                                       */
+/*****************************************************************************/
+static int32_t cifXRestartDevice(PDEVICEINSTANCE ptDev)
+{
+  PCIFX_DEVICE_INTERNAL_T dev_intern = (PCIFX_DEVICE_INTERNAL_T)ptDev->pvOSDependent;
+  int32_t                 lRet       = CIFX_NO_ERROR;
+
+  if (g_ulTraceLevel & TRACE_LEVEL_DEBUG)
+  {
+    USER_Trace( ptDev,
+                TRACE_LEVEL_DEBUG,
+               "RESTART DEVICE requested for device: %s",
+                ptDev->szName);
+  }
+  /* Remove a device */
+#ifdef CIFXETHERNET
+  if (1 == dev_intern->eth_support)
+  {
+    NETX_ETH_DEV_CFG_T config;
+
+    sprintf( config.cifx_name, "%s", ptDev->szName);
+    cifxeth_remove_device( NULL, &config);
+  }
+#endif
+  cifXStopPollingThread(dev_intern);
+
+  if ( CIFX_NO_ERROR == (lRet = cifXTKitRemoveDevice(ptDev->szName, 1)))
+  {
+    /* channel instances are re-created, wait for callbacks still queued */
+    cifXNotifyDispatchFlush();
+    /* re-read the device configuration on re-insert */
+    cifXConfigCacheInvalidate(dev_intern);
+#ifdef CIFX_DRV_HWIF
+    /* de-initialize hardware interface */
+    if (dev_intern->userdevice->hwif_deinit)
+      dev_intern->userdevice->hwif_deinit( dev_intern->userdevice);
+
+    /* re-initialize hardware interface */
+    if (dev_intern->userdevice->hwif_init) {
+      lRet = dev_intern->userdevice->hwif_init( dev_intern->userdevice);
+      if (CIFX_NO_ERROR != lRet) {
+        if (g_ulTraceLevel & TRACE_LEVEL_ERROR)
+        {
+          char szError[1024] ={0};
+          USER_Trace(ptDev,
+                     TRACE_LEVEL_ERROR,
+                     "Failed to initialize custom hardware interface. 'hwif_init' returns 0x%lx - %s! Skip adding custom device to toolkit!",
+                     (unsigned int)lRet,
+                     ((CIFX_NO_ERROR == xDriverGetErrorDescription( lRet,  szError, sizeof(szError))) ? szError : "Unknown error"));
+        }
+      }
+    }
+#endif
+    /* Re-insert a device */
+    if ((lRet == CIFX_NO_ERROR) && (CIFX_NO_ERROR == (lRet = cifXTKitAddDevice( ptDev))))
+    {
+      lRet = cifXStartPollingThread(dev_intern);
+#ifdef CIFX_DRV_DPM_TRACE
+      cifXDPMTraceAddDevice(ptDev);
+#endif
+#ifdef CIFXETHERNET
+      if (1 == dev_intern->eth_support)
+      {
+        NETX_ETH_DEV_CFG_T config;
+
+        sprintf( config.cifx_name, "%s", ptDev->szName);
+        cifxeth_create_device( &config);
+      }
+#endif
+    } else
+    {
+#ifdef CIFX_DRV_HWIF
+      /* de-initialize hardware interface */
+      if (dev_intern->userdevice->hwif_deinit)
+        dev_intern->userdevice->hwif_deinit( dev_intern->userdevice);
+#endif
+    }
+  }
+  if (g_ulTraceLevel & TRACE_LEVEL_DEBUG)
+  {
+    USER_Trace(ptDev,
+              TRACE_LEVEL_DEBUG,
+              "RESTART DEVICE done, (Status: 0x%08X)\n",
+              lRet);
+  }
+
+  return lRet;
+}
+
+/*****************************************************************************/
+/*! cifX driver restart function
+*     \param hDriver     Handle to the driver
+*     \param szBoardName Identifier for the Board
+*     \param pvData      For further extensions can be NULL
+*     \return CIFX_NO_ERROR on success                                       */
+/*****************************************************************************/
+ int32_t xDriverRestartDevice ( CIFXHANDLE  hDriver, char* szBoardName, void* pvData)
+ {
+   PDEVICEINSTANCE ptDev = NULL;
+   int32_t         lRet;
+
+   UNREFERENCED_PARAMETER(pvData);
+   UNREFERENCED_PARAMETER(hDriver);
+
+   if (CIFX_NO_ERROR == (lRet = cifXClaimDeviceRestart(szBoardName, &ptDev)))
+   {
+     lRet = cifXRestartDevice(ptDev);
+     cifXReleaseDeviceRestart(ptDev);
+   }
+
+   return lRet;
+}
+
+/*****************************************************************************/
+/*! Provisioning job of a single device                                      */
+/*****************************************************************************/
+struct CIFX_PROVISION_JOB_T
+{
+  pthread_t                   thread;      /*!< Thread restarting the device */
+  int                         running;     /*!< !=0 if thread was created */
+  PDEVICEINSTANCE             devinstance; /*!< Claimed device, NULL if the device was not found / is busy */
+  char                        name[CIFx_MAX_INFO_NAME_LENTH]; /*!< Device name reported to the callback */
+  PFN_CIFX_PROVISION_PROGRESS progress;    /*!< User progress callback */
+  void*                       user;        /*!< User parameter of the callback */
+  int32_t                     result;      /*!< Result of the restart */
+};
+
+/*****************************************************************************/
+/*! Reports the progress of a provisioning job to the user
+*     \param job         Provisioning job
+*     \param state       Actual state
+*     \param start_time  Start of the provisioning in ms                     */
+/*****************************************************************************/
+static void cifXProvisionReport(struct CIFX_PROVISION_JOB_T* job, CIFX_PROVISION_STATE_E state, uint32_t start_time)
+{
+  struct CIFX_PROVISION_PROGRESS progress;
+
+  if (NULL == job->progress)
+    return;
+
+  progress.board   = job->name;
+  progress.state   = state;
+  progress.error   = job->result;
+  progress.time_ms = OS_GetMilliSecCounter() - start_time;
+
+  job->progress(&progress, job->user);
 }
 
 /*****************************************************************************/
-/*! cifX driver restart function
-*     \param hDriver     Handle to the driver
-*     \param szBoardName Identifier for the Board
-*     \param pvData      For further extensions can be NULL
-*     \return CIFX_NO_ERROR on success                                       */
+/*! Thread restarting a single device of cifXDriverProvisionDevices()
+*     \param arg         Provisioning job
+*     \return NULL                                                           */
 /*****************************************************************************/
- int32_t xDriverRestartDevice ( CIFXHANDLE  hDriver, char* szBoardName, void* pvData)
- {
-   int32_t    lRet  = CIFX_INVALID_BOARD;
-   uint32_t   ulIdx = 0;
+static void* cifXProvisionThread(void* arg)
+{
+  struct CIFX_PROVISION_JOB_T* job        = (struct CIFX_PROVISION_JOB_T*)arg;
+  uint32_t                     start_time = OS_GetMilliSecCounter();
 
-   UNREFERENCED_PARAMETER(pvData);
-   UNREFERENCED_PARAMETER(hDriver);
+  cifXProvisionReport(job, eCIFX_PROVISION_STARTED, start_time);
 
-   OS_EnterLock(g_pvTkitLock);
+  job->result = cifXRestartDevice(job->devinstance);
+  cifXReleaseDeviceRestart(job->devinstance);
 
-   /* Seach the device with the given name */
-   for (ulIdx = 0; ulIdx < g_ulDeviceCount; ulIdx++)
-   {
-     /* Compare the device name */
-     PDEVICEINSTANCE ptDev = g_pptDevices[ulIdx];
-
-     if( (OS_Strcmp( ptDev->szName,  szBoardName) == 0) ||
-         (OS_Strcmp( ptDev->szAlias, szBoardName) == 0) )
-     {
-#if CIFXETHERNET || CIFX_DRV_HWIF
-       PCIFX_DEVICE_INTERNAL_T dev_intern = (PCIFX_DEVICE_INTERNAL_T)ptDev->pvOSDependent;
-#endif
+  cifXProvisionReport(job, eCIFX_PROVISION_FINISHED, start_time);
 
-       if (g_ulTraceLevel & TRACE_LEVEL_DEBUG)
-       {
-         USER_Trace( ptDev,
-                     TRACE_LEVEL_DEBUG,
-                    "RESTART DEVICE requested for device: %s",
-                     szBoardName);
-       }
-       /* Remove a device */
-#ifdef CIFXETHERNET
-       if (1 == dev_intern->eth_support)
-       {
-         NETX_ETH_DEV_CFG_T config;
+  return NULL;
+}
 
-         sprintf( config.cifx_name, "%s", ptDev->szName);
-         cifxeth_remove_device( NULL, &config);
-       }
-#endif
-       if ( CIFX_NO_ERROR == (lRet = cifXTKitRemoveDevice(ptDev->szName, 1)))
-       {
-#ifdef CIFX_DRV_HWIF
-         /* de-initialize hardware interface */
-         if (dev_intern->userdevice->hwif_deinit)
-           dev_intern->userdevice->hwif_deinit( dev_intern->userdevice);
-
-         /* re-initialize hardware interface */
-         if (dev_intern->userdevice->hwif_init) {
-           lRet = dev_intern->userdevice->hwif_init( dev_intern->userdevice);
-           if (CIFX_NO_ERROR != lRet) {
-             if (g_ulTraceLevel & TRACE_LEVEL_ERROR)
-             {
-               char szError[1024] ={0};
-               USER_Trace(ptDev,
-                          TRACE_LEVEL_ERROR,
-                          "Failed to initialize custom hardware interface. 'hwif_init' returns 0x%lx - %s! Skip adding custom device to toolkit!",
-                          (unsigned int)lRet,
-                          ((CIFX_NO_ERROR == xDriverGetErrorDescription( lRet,  szError, sizeof(szError))) ? szError : "Unknown error"));
-             }
-           }
-         }
-#endif
-         /* Re-insert a device */
-         if ((lRet == CIFX_NO_ERROR) && (CIFX_NO_ERROR == (lRet = cifXTKitAddDevice( ptDev))))
-         {
-#ifdef CIFXETHERNET
-           if (1 == dev_intern->eth_support)
-           {
-             NETX_ETH_DEV_CFG_T config;
+/*****************************************************************************/
+/*! Provisions several devices in parallel. Every device is restarted by an
+*   own thread, which downloads the firmware and configuration files of the
+*   device configuration directory (see xDriverRestartDevice()). The files of
+*   one device are still downloaded one after the other, as all downloads
+*   pass the system channel of the device.
+*     \param boards      Names or aliases of the devices, NULL for all devices
+*     \param board_cnt   Number of entries in boards
+*     \param progress    Progress callback (may be NULL). It is called from
+*                        the provisioning threads, so calls of different
+*                        devices may overlap.
+*     \param user        User parameter passed to the callback
+*     \return CIFX_NO_ERROR if all devices were provisioned, otherwise the
+*             error of the first failed device                               */
+/*****************************************************************************/
+int32_t cifXDriverProvisionDevices(const char* const* boards, uint32_t board_cnt,
+                                   PFN_CIFX_PROVISION_PROGRESS progress, void* user)
+{
+  struct CIFX_PROVISION_JOB_T* jobs       = NULL;
+  pthread_attr_t               attr;
+  uint32_t                     job_cnt    = 0;
+  uint32_t                     idx;
+  int32_t                      lRet       = CIFX_NO_ERROR;
+  int                          ret;
+
+  if ((NULL != boards) && (0 == board_cnt))
+    return CIFX_INVALID_PARAMETER;
 
-             sprintf( config.cifx_name, "%s", ptDev->szName);
-             cifxeth_create_device( &config);
-           }
-#endif
-         } else
-         {
-#ifdef CIFX_DRV_HWIF
-           /* de-initialize hardware interface */
-           if (dev_intern->userdevice->hwif_deinit)
-             dev_intern->userdevice->hwif_deinit( dev_intern->userdevice);
-#endif
-          }
-       }
-       if (g_ulTraceLevel & TRACE_LEVEL_DEBUG)
-       {
-         USER_Trace(ptDev,
-                   TRACE_LEVEL_DEBUG,
-                   "RESTART DEVICE done, (Status: 0x%08X)\n",
-                   lRet);
-       }
-       break;
+  if (NULL == g_pvTkitLock)
+    return CIFX_DRV_NOT_INITIALIZED;
+
+  /* collect the names first, the device list changes while devices are restarted */
+  OS_EnterLock(g_pvTkitLock);
+  job_cnt = (NULL == boards) ? (uint32_t)g_ulDeviceCount : board_cnt;
+  if ( (job_cnt > 0) &&
+       (NULL != (jobs = calloc(job_cnt, sizeof(*jobs)))) )
+  {
+    for (idx = 0; idx < job_cnt; idx++)
+    {
+      OS_Strncpy(jobs[idx].name,
+                 (NULL == boards) ? g_pptDevices[idx]->szName : boards[idx],
+                 sizeof(jobs[idx].name) - 1);
     }
   }
-
   OS_LeaveLock(g_pvTkitLock);
 
+  if (0 == job_cnt)
+    return CIFX_NO_ERROR;
+
+  if (NULL == jobs)
+    return CIFX_INVALID_POINTER;
+
+  pthread_attr_init(&attr);
+  cifXRTSetThreadStack(&attr);
+
+  for (idx = 0; idx < job_cnt; idx++)
+  {
+    struct CIFX_PROVISION_JOB_T* job = &jobs[idx];
+
+    job->progress = progress;
+    job->user     = user;
+
+    if (CIFX_NO_ERROR != (job->result = cifXClaimDeviceRestart(job->name, &job->devinstance)))
+    {
+      cifXProvisionReport(job, eCIFX_PROVISION_FINISHED, OS_GetMilliSecCounter());
+      continue;
+    }
+
+    if (0 != (ret = pthread_create(&job->thread, &attr, cifXProvisionThread, job)))
+    {
+      ERR("Failed to create provisioning thread for '%s' (pthread_create=%d), restarting it synchronously\n", job->name, ret);
+      cifXProvisionThread(job);
+    } else
+    {
+      job->running = 1;
+    }
+  }
+  pthread_attr_destroy(&attr);
+
+  for (idx = 0; idx < job_cnt; idx++)
+  {
+    if (jobs[idx].running)
+      pthread_join(jobs[idx].thread, NULL);
+
+    if ((CIFX_NO_ERROR == lRet) && (CIFX_NO_ERROR != jobs[idx].result))
+      lRet = jobs[idx].result;
+  }
+
+  free(jobs);
+
   return lRet;
 }
 
@@ -2002,20 +2901,28 @@ int32_t cifXDriverInit(const struct CIFX_LINUX_INIT* init_params)
 /*****************************************************************************/
 void cifXDriverDeinit()
 {
-  /* Stop polling thread if it was enabled */
-  if(polling_thread_running)
-  {
-    polling_thread_stop    = 1;
-    pthread_join(polling_thread, NULL);
-    pthread_attr_destroy(&polling_thread_attr);
-    polling_thread_running = 0;
-  }
-
   if (NULL == g_pvTkitLock) /* toolkit is already de-initialized */
+  {
+    if(polling_thread_enabled)
+    {
+      pthread_attr_destroy(&polling_thread_attr);
+      polling_thread_enabled = 0;
+    }
     return;
+  }
 
   OS_EnterLock(g_pvTkitLock);
 
+  /* refuse new restarts and wait for devices being restarted, they are not in
+     the device list meanwhile */
+  s_deinit_active = 1;
+  while (NULL != s_restart_list)
+  {
+    OS_LeaveLock(g_pvTkitLock);
+    OS_Sleep(1);
+    OS_EnterLock(g_pvTkitLock);
+  }
+
   /* Remove all internal device structures */
   while(g_ulDeviceCount > 0)
   {
@@ -2030,8 +2937,15 @@ void cifXDriverDeinit()
       cifxeth_remove_device( NULL, &config);
     }
 #endif
+    /* Stop polling thread of the device if it was enabled */
+    cifXStopPollingThread(dev_intern);
+
     cifXTKitRemoveDevice(devinstance->szName , 1);
 
+    /* the device does not signal notifications anymore, wait for callbacks still queued */
+    cifXNotifyDispatchFlush();
+    cifXCloseNotificationFds(dev_intern);
+
     if( NULL != dev_intern->log_file)
     {
       USER_Trace(devinstance, 0, "----- cifX Driver Log stopped ---------------------");
@@ -2054,12 +2968,26 @@ void cifXDriverDeinit()
       dev_intern->userdevice = NULL;
     }
 
+    cifXConfigCacheFree(dev_intern);
     free(dev_intern);
     free(devinstance);
   }
 
   OS_LeaveLock(g_pvTkitLock);
 
+  cifXNotifyDispatchStop();
+  cifXPacketPoolStop();
+#ifdef CIFX_DRV_DPM_TRACE
+  cifXDPMTraceStop();
+#endif
+  cifXRTStop();
+
+  if(polling_thread_enabled)
+  {
+    pthread_attr_destroy(&polling_thread_attr);
+    polling_thread_enabled = 0;
+  }
+
 #ifdef CIFX_PLUGIN_SUPPORT
   struct CIFX_PLUGIN_T* plugin;
 
@@ -2097,6 +3025,9 @@ void cifXDriverDeinit()
     g_szDriverBaseDir = NULL;
   }
   cifXTKitDeinit();
+
+  /* g_pvTkitLock is deleted, so restarts are refused until the next cifXDriverInit() */
+  s_deinit_active = 0;
 }
 
 
@@ -2232,68 +3163,29 @@ int pci_get_device_type_and_num(char* pci_path, CIFX_DEVICE_TYPE_E * dev_type, i
 }
 
 /*****************************************************************************/
-/*! Searched PCI for Hilscher device by given index and returns PCI bus id
-*     \param index            number of device
-*     \param device_id        returned device id
-*     \param device_id_len    max length of buffer device_id
-*     \param full_path        0 - name is device id / 1 - full path to device
-*     \param dev_type         uio or vfio device
-*     \return NULL if no device with this number was found                   */
-/*****************************************************************************/
-static int pci_get_hilscher_device_id_by_idx( int index, char* device_id, uint32_t device_id_len, int full_path) {
-  char          pci_bus_path[] = SYSFS_PCI_DEV_PATH;
-  struct dirent **namelist;
-  int           pci_devs;
-  int           ret = -ENODEV;
-  int           vendor_devs = 0;
-
-  pci_devs = scandir( pci_bus_path, &namelist, 0, alphasort);
-  if(pci_devs > 0) {
-    for (int i=0; i<pci_devs;i++) {
-      char dev_path[CIFX_MAX_FILE_NAME_LENGTH];
-      unsigned int id;
-
-      snprintf( dev_path, CIFX_MAX_FILE_NAME_LENGTH,"%s/%s", pci_bus_path, namelist[i]->d_name);
-      if (ret == 0) {
-        //finshed to free
-      } else if (!IS_HILSCHER_PCI_DEV(dev_path, &id)) {
-         //skip it
-      } else if (vendor_devs++ == index) {
-        ret = 0;
-        if (device_id != NULL) {
-          if (full_path != 0) {
-            snprintf( device_id, device_id_len, "%s%s", pci_bus_path, namelist[i]->d_name);
-          } else {
-            snprintf( device_id, device_id_len, "%s", namelist[i]->d_name);
-          }
-        }
-      }
-      free(namelist[i]);
-    }
-    free(namelist);
-  }
-  return ret;
-}
-
-/*****************************************************************************/
-/*! Returns number of hilscher pci devices
-*     \return Number of found devices                                        */
+/*! Appends a device to the discovery index (s_discovery_lock must be held)
+*     \param entry  Device to add
+*     \return 0 on success < 0 on error                                      */
 /*****************************************************************************/
-static int cifx_get_pci_device_count(void) {
-  int idx = 0;
+static int cifx_discovery_add(const struct CIFX_DISCOVERY_ENTRY_T* entry) {
+  struct CIFX_DISCOVERY_ENTRY_T* index = realloc( s_discovery_index, (s_discovery_count + 1) * sizeof(*index));
 
-  while ((pci_get_hilscher_device_id_by_idx( idx++, NULL, 0, 0)) == 0) {}
-  return idx-1;
+  if (index == NULL) {
+    ERR( "Error allocating memory for device index\n");
+    return -ENOMEM;
+  }
+  s_discovery_index = index;
+  s_discovery_index[s_discovery_count++] = *entry;
+  return 0;
 }
 
 /*****************************************************************************/
-/*! Returns number of custom uio devices (non-pci e.g. ISA or other memory mapped)
-*     \return Number of found devices                                        */
+/*! Adds all custom uio devices (non-pci e.g. ISA or other memory mapped)
+*   to the discovery index (s_discovery_lock must be held)                   */
 /*****************************************************************************/
-static int cifx_uio_get_custom_device_count(void) {
-  struct dirent**       namelist;
-  int                   num_uios;
-  int                   ret = 0;
+static void cifx_discovery_scan_custom(void) {
+  struct dirent** namelist;
+  int             num_uios;
 
   num_uios = scandir("/sys/class/uio", &namelist, 0, alphasort);
   if(num_uios > 0)
@@ -2303,239 +3195,182 @@ static int cifx_uio_get_custom_device_count(void) {
     for(currentuio = 0; currentuio < num_uios; ++currentuio)
     {
       unsigned int uio_num;
+      char         name[64];
 
-      if(0 == sscanf(namelist[currentuio]->d_name,
+      if(1 != sscanf(namelist[currentuio]->d_name,
                      "uio%u",
                      &uio_num))
       {
         /* Error extracting uio number */
 
-      } else if (cifx_uio_validate_name( uio_num, CIFX_UIO_CUSTOM_CARD_NAME) == 1)
+      } else if (!uio_read_name( uio_num, name, sizeof(name)))
+      {
+        ERR( "Error querying name of uio%u\n", uio_num);
+
+      } else if (0 == strncmp(name, CIFX_UIO_CUSTOM_CARD_NAME, strlen(CIFX_UIO_CUSTOM_CARD_NAME)))
       {
         /* device is a netX device */
-        ++ret;
+        struct CIFX_DISCOVERY_ENTRY_T entry;
+
+        memset(&entry, 0, sizeof(entry));
+        entry.pci_card   = 0;
+        entry.dev_type   = eCIFX_DEVICE_TYPE_UIO;
+        entry.dev_num    = uio_num;
+        entry.start_type = uio_name_get_startuptype(name);
+        uio_name_get_alias(name, entry.alias, sizeof(entry.alias));
+
+        cifx_discovery_add(&entry);
       }
       free(namelist[currentuio]);
     }
     free(namelist);
   }
-  return ret;
 }
 
 /*****************************************************************************/
-/*! Returns the number of automatically detectable cifX devices.
-*     \return Number of found netX/cifX (uio&vfio) devices                   */
+/*! Adds all compatible Hilscher pci devices, bound to uio_netx or vfio-pci,
+*   to the discovery index (s_discovery_lock must be held)                   */
 /*****************************************************************************/
-int cifXGetDeviceCount(void)
-{
-  int custom_count = cifx_uio_get_custom_device_count();
-  int pci_count = cifx_get_pci_device_count();
+static void cifx_discovery_scan_pci(void) {
+  struct dirent** namelist;
+  int             num_devs;
 
-  DBG("Found %d custom (uio_netx) and %d pci devices.\n", custom_count, pci_count);
+  num_devs = scandir( SYSFS_PCI_DEV_PATH, &namelist, 0, alphasort);
+  if(num_devs > 0) {
+    for(int current_dev = 0; current_dev < num_devs; ++current_dev) {
+      struct CIFX_DISCOVERY_ENTRY_T entry;
+      unsigned int                  id = 0;
 
-  return custom_count + pci_count;
-}
+      memset(&entry, 0, sizeof(entry));
+      snprintf( entry.path, sizeof(entry.path), "%s/%s", SYSFS_PCI_DEV_PATH, namelist[current_dev]->d_name);
+      free(namelist[current_dev]);
 
-/*****************************************************************************/
-/*! Validates if the driver can handle the device
-*     \return 0 on success < 0 on error                                      */
-/*****************************************************************************/
-static int check_if_compatible_pci_card( char* pci_path) {
-  if (pci_path != NULL) {
-    unsigned int id = 0;
-
-    if (IS_HILSCHER_PCI_DEV(pci_path, &id)) {
-      /* now check if the driver can handle the device */
-      if (sysfs_get_pci_id( pci_path, "device", &id) == 0) {
-         if ( (id == NETX_CHIP_PCI_DEVICE_ID) ||
-              (id == NETPLC100C_PCI_DEVICE_ID) ||
-              (id == NETJACK100_PCI_DEVICE_ID) ||
-              (id == CIFX4000_PCI_DEVICE_ID) ) {
-          return 0;
-        } else {
-          DBG( "Skip Hilscher device '%s' as it is not listed as a compatible device (sub device id=0x%X)\n", pci_path, id);
+      if (!IS_HILSCHER_PCI_DEV(entry.path, &id)) {
+        /* not a Hilscher device */
+        continue;
+      }
+
+      /* check if the driver can handle the device */
+      if (sysfs_get_pci_id( entry.path, "device", &entry.device_id) != 0) {
+        ERR( "Error retrieving sub device id of '%s' - skip device\n", entry.path);
+        continue;
+      }
+      if ( (entry.device_id != NETX_CHIP_PCI_DEVICE_ID) &&
+           (entry.device_id != NETPLC100C_PCI_DEVICE_ID) &&
+           (entry.device_id != NETJACK100_PCI_DEVICE_ID) &&
+           (entry.device_id != CIFX4000_PCI_DEVICE_ID) ) {
+        DBG( "Skip Hilscher device '%s' as it is not listed as a compatible device (sub device id=0x%X)\n", entry.path, entry.device_id);
+        continue;
+      }
+      if ( pci_get_device_type_and_num( entry.path, &entry.dev_type, &entry.dev_num) != 0) {
+        /* no supported driver assigned */
+        continue;
+      }
+      entry.pci_card   = 1;
+      entry.start_type = eCIFX_DEVICE_AUTODETECT;
+      if (sysfs_get_pci_id( entry.path, "subsystem_device", &entry.subdevice_id) == 0) {
+#if defined(VFIO_SUPPORT) || !defined(CIFX_NO_PCIACCESS_LIB)
+        entry.flash_based = cifx_hil_pci_flash_based( entry.device_id, entry.subdevice_id);
+#endif
+      }
+      if (entry.dev_type == eCIFX_DEVICE_TYPE_UIO) {
+        char name[64];
+
+        if (uio_read_name( entry.dev_num, name, sizeof(name))) {
+          entry.start_type = uio_name_get_startuptype(name);
+          uio_name_get_alias(name, entry.alias, sizeof(entry.alias));
         }
-      } else {
-        ERR( "Error retrieving sub device id of '%s' - skip device\n", pci_path);
       }
+      cifx_discovery_add(&entry);
     }
+    free(namelist);
   }
-  return -EINVAL;
 }
 
 /*****************************************************************************/
-/*! Scan for cifX custom devices
-*     \param iNum             Number of card to detect (0..num_of_cards)
-*     \param fCheckAccess     If !=0, function denies access if device is
-*                             already used by another application
-*     \return NULL if no device with this number was found                   */
+/*! Scans once for all automatically detectable devices and builds the
+*   discovery index, serving all later queries (s_discovery_lock must be held)*/
 /*****************************************************************************/
-static struct CIFX_DEVICE_T* cifx_find_custom_device( int iNum, int fCheckAccess) {
-  struct dirent**       namelist;
-  int                   custom_uios;
-  int                   num_uios = 0;
-  int                   founddevice = 0;
-  struct CIFX_DEVICE_T* device = NULL;
-
-  if ((device = malloc(sizeof(*device))) == NULL) {
-    ERR( "Error allocating memory for uio_netx custom device %d\n", iNum);
-    return NULL;
-  }
-  memset(device, 0, sizeof(*device));
-  device->uio_fd = -1;
-
-  num_uios = scandir("/sys/class/uio", &namelist, 0, alphasort);
-  if(num_uios > 0)
-  {
-    int currentuio;
-    int founddevice = 0;
-
-    for(currentuio = 0; currentuio < num_uios; ++currentuio)
-    {
-      unsigned int uio_num = 0;
-
-      if(founddevice)
-      {
-        /* we already found the device, so skip it.
-           we need to handle all data from name list, so we need to
-           cycle through whole list */
-      } else if(0 == sscanf(namelist[currentuio]->d_name,
-                           "uio%u",
-                           &uio_num))
-      {
-        /* Error extracting uio number */
-
-      } else if( !cifx_uio_validate_name( uio_num, CIFX_UIO_CUSTOM_CARD_NAME) )
-      {
-        /* device is not a custom netX device */
-
-      } else if(custom_uios++ != iNum)
-      {
-        /* not the device we are looking for, so skip it */
+static void cifx_discovery_build(void) {
+  free(s_discovery_index);
+  s_discovery_index = NULL;
+  s_discovery_count = 0;
 
-      } else
-      {
-        int ret = 0;
+  cifx_discovery_scan_custom();
+  cifx_discovery_scan_pci();
 
-        DBG("Found cifx %d: uio_netx custom device\n", iNum);
+  s_discovery_valid = 1;
+}
 
-        if ((ret = cifx_open( NULL, eCIFX_DEVICE_TYPE_UIO, uio_num, fCheckAccess, device)) < 0) {
-          ERR( "cifx_open() failed (ret=%d)\n", ret);
-          goto open_err;
-        } else if ((ret = cifx_map_mem( device, eMEM_DPM, (void*)&device->dpm, &device->dpmaddr, &device->dpmlen, 0)) < 0) {
-          ERR( "cifx_map_mem() failed (ret=%d)\n", ret);
-          goto map_err;
-        } else {
-          device->pci_card = 0;
+/*****************************************************************************/
+/*! Returns the discovered information of an uio device
+*     \param uio_num  Number of uio device
+*     \param entry    Returned information
+*     \return 0 on success < 0 if the device was not discovered              */
+/*****************************************************************************/
+static int cifx_discovery_get_uio(int uio_num, struct CIFX_DISCOVERY_ENTRY_T* entry) {
+  int ret = -ENODEV;
 
-          /* try to map extended memory */
-          if (cifx_map_mem( device, eMEM_EXTMEM, (void*)&device->extmem, &device->extmemaddr, &device->extmemlen, 0) == 0) {
-            DBG("Extended memory found (0x%X - 0x%lX)\n", (unsigned int)device->extmemaddr, device->extmemlen);
-          }
-#ifdef CIFX_TOOLKIT_DMA
-          cifx_map_dma_buffer( device);
-#endif
-          founddevice = 1;
-        }
-      }
-      free(namelist[currentuio]);
+  pthread_mutex_lock(&s_discovery_lock);
+  for (int idx = 0; idx < s_discovery_count; idx++) {
+    if ( (s_discovery_index[idx].dev_type == eCIFX_DEVICE_TYPE_UIO) &&
+         (s_discovery_index[idx].dev_num == uio_num) ) {
+      *entry = s_discovery_index[idx];
+      ret = 0;
+      break;
     }
-    free(namelist);
   }
-  if (founddevice != 0)
-    return device;
-
-map_err:
-  cifx_close(device);
-open_err:
-  if (device != NULL)
-    free(device);
-
-  return NULL;
+  pthread_mutex_unlock(&s_discovery_lock);
+  return ret;
 }
 
+#if defined(VFIO_SUPPORT) || !defined(CIFX_NO_PCIACCESS_LIB)
 /*****************************************************************************/
-/*! Scan for cifX device (uio or vfio depending on dev_type)
-*     \param iNum             Number of card to detect (0..num_of_cards)
-*     \param fCheckAccess     If !=0, function denies access if device is
-*                             already used by another application
-*     \param dev_type         uio or vfio device
-*     \return NULL if no device with this number was found                   */
+/*! Returns the discovered information of a pci device
+*     \param path     sysfs path of the device
+*     \param entry    Returned information
+*     \return 0 on success < 0 if the device was not discovered              */
 /*****************************************************************************/
-static struct CIFX_DEVICE_T* cifx_find_pci_device(int iNum, int fCheckAccess) {
-  struct dirent**       namelist;
-  int                   num_devs;
-  struct CIFX_DEVICE_T* device = NULL;
-  int founddevice = 0;
-  CIFX_DEVICE_TYPE_E dev_type;
+static int cifx_discovery_get_pci(const char* path, struct CIFX_DISCOVERY_ENTRY_T* entry) {
+  int ret = -ENODEV;
 
-  if ((device = malloc(sizeof(*device))) == NULL) {
-    ERR( "Error allocating memory\n");
-    return NULL;
+  pthread_mutex_lock(&s_discovery_lock);
+  for (int idx = 0; idx < s_discovery_count; idx++) {
+    if ( (s_discovery_index[idx].pci_card) &&
+         (strcmp(s_discovery_index[idx].path, path) == 0) ) {
+      *entry = s_discovery_index[idx];
+      ret = 0;
+      break;
+    }
   }
-  memset(device, 0, sizeof(*device));
-  device->uio_fd = -1;
-
-  num_devs = scandir( SYSFS_PCI_DEV_PATH, &namelist, 0, alphasort);;
-  if(num_devs > 0) {
-    for(int current_dev = 0; current_dev < num_devs; ++current_dev) {
-      int num_dev;
-      char pci_dev_path[CIFX_MAX_FILE_NAME_LENGTH];
-
-      snprintf( pci_dev_path, CIFX_MAX_FILE_NAME_LENGTH, "%s/%s", SYSFS_PCI_DEV_PATH, namelist[current_dev]->d_name);
-
-      if(founddevice) {
-        /* we already found the device, so skip it.
-           we need to handle all data from name list, so we need to
-           cycle through whole list */
-
-      } else if( check_if_compatible_pci_card( pci_dev_path) ) {
-        /* not a compatible (Hilscher) device */
-
-      } else if ( pci_get_device_type_and_num( pci_dev_path, &dev_type, &num_dev) != 0) {
-        /* device is not a Hilscher device */
-
-      } else if(s_netx_device_counter++ != iNum) {
-        /* not the device we are looking for, so skip it */
-
-      } else {
-        int ret = 0;
-
-        DBG("Found cifx %d: PCI device ('%s')\n", iNum, pci_dev_path);
-
-        if ((ret = cifx_open( pci_dev_path, dev_type, num_dev, fCheckAccess, device)) < 0) {
-          ERR( "cifx_open() failed (ret=%d)\n", ret);
-          goto open_err;
-        } else if ((ret = cifx_map_mem( device, eMEM_DPM, (void*)&device->dpm, &device->dpmaddr, &device->dpmlen, 0)) < 0) {
-          ERR( "cifx_map_mem() failed (ret=%d)\n", ret);
-          goto map_err;
-        } else {
-          device->pci_card = 1;
-
-          /* try to map extended memory */
-          if (cifx_map_mem( device, eMEM_EXTMEM, (void*)&device->extmem, &device->extmemaddr, &device->extmemlen, 0) == 0) {
-            DBG("Extended memory found (0x%X - 0x%lX)\n", (unsigned int)device->extmemaddr, device->extmemlen);
-          }
-#ifdef CIFX_TOOLKIT_DMA
-          cifx_map_dma_buffer( device);
+  pthread_mutex_unlock(&s_discovery_lock);
+  return ret;
+}
 #endif
-          founddevice = 1;
-        }
-      }
-      free(namelist[current_dev]);
-    }
-    free(namelist);
+
+/*****************************************************************************/
+/*! Returns the number of automatically detectable cifX devices. Every call
+*   rescans the system, the result serves all following cifXFindDevice() calls.
+*     \return Number of found netX/cifX (uio&vfio) devices                   */
+/*****************************************************************************/
+int cifXGetDeviceCount(void)
+{
+  int custom_count = 0;
+  int pci_count    = 0;
+
+  pthread_mutex_lock(&s_discovery_lock);
+  cifx_discovery_build();
+  for (int idx = 0; idx < s_discovery_count; idx++) {
+    if (s_discovery_index[idx].pci_card)
+      pci_count++;
+    else
+      custom_count++;
   }
-  if (founddevice != 0)
-    return device;
+  pthread_mutex_unlock(&s_discovery_lock);
 
-map_err:
-  cifx_close(device);
-open_err:
-  if (device != NULL)
-    free(device);
+  DBG("Found %d custom (uio_netx) and %d pci devices.\n", custom_count, pci_count);
 
-  return NULL;
+  return custom_count + pci_count;
 }
 
 /*****************************************************************************/
@@ -2546,14 +3381,60 @@ open_err:
 *     \return NULL if no device with this number was found                   */
 /*****************************************************************************/
 struct CIFX_DEVICE_T* cifXFindDevice(int iNum, int fCheckAccess) {
-  struct CIFX_DEVICE_T* device = NULL;
+  struct CIFX_DISCOVERY_ENTRY_T entry;
+  struct CIFX_DEVICE_T*         device = NULL;
+  int                           found  = 0;
+  int                           ret    = 0;
+
+  if (iNum < 0)
+    return NULL;
+
+  pthread_mutex_lock(&s_discovery_lock);
+  /* (re-)scan if not done yet or the device was not present during the last scan */
+  if ( (!s_discovery_valid) || (iNum >= s_discovery_count) )
+    cifx_discovery_build();
+
+  if (iNum < s_discovery_count) {
+    entry = s_discovery_index[iNum];
+    found = 1;
+  }
+  pthread_mutex_unlock(&s_discovery_lock);
+
+  if (!found)
+    return NULL;
+
+  if ((device = malloc(sizeof(*device))) == NULL) {
+    ERR( "Error allocating memory for device %d\n", iNum);
+    return NULL;
+  }
+  memset(device, 0, sizeof(*device));
+  device->uio_fd = -1;
 
-  s_netx_device_counter = 0;
+  if (entry.pci_card) {
+    DBG("Found cifx %d: PCI device ('%s')\n", iNum, entry.path);
+  } else {
+    DBG("Found cifx %d: uio_netx custom device\n", iNum);
+  }
 
-  if (NULL == (device = cifx_find_custom_device( iNum, fCheckAccess))) {
+  if ((ret = cifx_open( entry.pci_card ? entry.path : NULL, entry.dev_type, entry.dev_num, fCheckAccess, device)) < 0) {
+    ERR( "cifx_open() failed (ret=%d)\n", ret);
+    free(device);
+    return NULL;
+  } else if ((ret = cifx_map_mem( device, eMEM_DPM, (void*)&device->dpm, &device->dpmaddr, &device->dpmlen, 0)) < 0) {
+    ERR( "cifx_map_mem() failed (ret=%d)\n", ret);
+    cifx_close(device);
+    free(device);
+    return NULL;
+  }
+  device->pci_card = entry.pci_card;
 
-    return cifx_find_pci_device( iNum, fCheckAccess);
+  /* try to map extended memory */
+  if (cifx_map_mem( device, eMEM_EXTMEM, (void*)&device->extmem, &device->extmemaddr, &device->extmemlen, 0) == 0) {
+    DBG("Extended memory found (0x%X - 0x%lX)\n", (unsigned int)device->extmemaddr, device->extmemlen);
   }
+#ifdef CIFX_TOOLKIT_DMA
+  cifx_map_dma_buffer( device);
+#endif
   return device;
 }
 
@@ -2584,6 +3465,9 @@ void* HWIFDPMRead( uint32_t ulOpt, void* pvDevInstance, void* pvDpmAddr, void* p
   PDEVICEINSTANCE         pDev          = (PDEVICEINSTANCE)pvDevInstance;
   PCIFX_DEVICE_INTERNAL_T ptInternalDev = (PCIFX_DEVICE_INTERNAL_T)pDev->pvOSDependent;
   struct CIFX_DEVICE_T*   ptDevice      = ptInternalDev->userdevice;
+#ifdef CIFX_DRV_DPM_TRACE
+  uint64_t                ullTraceStart = cifXDPMTraceBegin();
+#endif
   (void) ulOpt;
 
   if (ptDevice->hwif_read)/* call the custom defined hw-read function */
@@ -2591,6 +3475,9 @@ void* HWIFDPMRead( uint32_t ulOpt, void* pvDevInstance, void* pvDpmAddr, void* p
   else /* if function is not defined, its a memory mapped DPM */
     OS_Memcpy( pvDst, pvDpmAddr, ulLen);
 
+#ifdef CIFX_DRV_DPM_TRACE
+  cifXDPMTraceAccess( ullTraceStart, pvDevInstance, ulOpt, 0, pvDpmAddr, pvDst, ulLen);
+#endif
   return pvDst;
 }
 
@@ -2606,6 +3493,10 @@ void* HWIFDPMWrite( uint32_t ulOpt, void* pvDevInstance, void* pvDpmAddr, void*
   PDEVICEINSTANCE         pDev          = (PDEVICEINSTANCE)pvDevInstance;
   PCIFX_DEVICE_INTERNAL_T ptInternalDev = (PCIFX_DEVICE_INTERNAL_T)pDev->pvOSDependent;
   struct CIFX_DEVICE_T*   ptDevice      = ptInternalDev->userdevice;
+#ifdef CIFX_DRV_DPM_TRACE
+  uint64_t                ullTraceStart = cifXDPMTraceBegin();
+  void*                   pvTraceAddr   = pvDpmAddr;
+#endif
   (void) ulOpt;
 
   if (ptDevice->hwif_write)/* call the custom defined hw-write function */
@@ -2613,6 +3504,9 @@ void* HWIFDPMWrite( uint32_t ulOpt, void* pvDevInstance, void* pvDpmAddr, void*
   else /* if function is not defined, its a memory mapped DPM */
     OS_Memcpy( pvDpmAddr, pvSrc, ulLen);
 
+#ifdef CIFX_DRV_DPM_TRACE
+  cifXDPMTraceAccess( ullTraceStart, pvDevInstance, ulOpt, 1, pvTraceAddr, pvSrc, ulLen);
+#endif
   return pvDpmAddr;
 }
 #endif
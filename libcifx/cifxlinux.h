@@ -29,6 +29,23 @@ extern "C"
 #define CIFX_POLLINTERVAL_DISABLETHREAD  (~0) /*!< Disable polling completely */
 #define DMA_BUFFER_COUNT            8
 
+/*****************************************************************************/
+/*! Wait times [ms] used while resetting and starting a device, 0 = default  */
+/*****************************************************************************/
+struct CIFX_BOOT_TIMING
+{
+  uint32_t pci_reset_time;          /*!< Wait after a hardware reset of a PCI device before its PCI
+                                         configuration is restored (default 500ms)                 */
+  uint32_t dpm_reset_time;          /*!< Wait after a hardware reset of a DPM device before the DPM
+                                         is polled (default 500ms). May be lowered for
+                                         devices, which clear the DPM fast enough on reset.         */
+  uint32_t netx4000_pci_reset_time; /*!< No DPM access after a system reset of a netX4000/4100 PCI
+                                         device (default 1000ms)                                    */
+  uint32_t poll_interval_min;       /*!< First poll interval while waiting for the device, doubled
+                                         on every poll (default 1ms)                                */
+  uint32_t poll_interval_max;       /*!< Poll interval limit (default 10ms)                         */
+};
+
 /*****************************************************************************/
 /*! Driver initialization structure                                          */
 /*****************************************************************************/
@@ -48,10 +65,99 @@ struct CIFX_LINUX_INIT
   int                   poll_StackSize;   /*!< Stack size of polling thread            */
   int                   poll_schedpolicy; /*!< Schedule policy of poll thread          */
   FILE*                 logfd;
+  int                   notify_threads;   /*!< Number of threads executing the notification callbacks.
+                                               0 = callbacks are executed in the interrupt (DSR) thread.
+                                               Callbacks of one channel are always executed in order by
+                                               the same thread. A callback may still be called shortly
+                                               after its notification was unregistered, if the event
+                                               occurred before. */
+  const struct CIFX_BOOT_TIMING* boot_timing; /*!< Reset/startup wait times of all devices, NULL = defaults */
+  int                   rt_mode;          /*!< !=0 = real-time mode. Locks the process memory (mlockall),
+                                               prefaults the stacks of the driver threads and, in DEBUG
+                                               builds, aborts if the IO, mailbox or DSR functions allocate
+                                               memory. Requires CAP_IPC_LOCK or a sufficient RLIMIT_MEMLOCK. */
+  uint32_t              packet_pool;      /*!< Number of packets preallocated for xChannelAllocPacket().
+                                               0 = packets are allocated from the heap. */
+  const char*           dpm_trace_file;   /*!< File to record all DPM accesses to (see cifxdpmtrace.h),
+                                               NULL = disabled. Requires a library built with DPM_TRACE. */
+  uint32_t              dpm_trace_size;   /*!< Size of the trace ring in bytes, the oldest accesses are
+                                               overwritten (0 = 16MB) */
+  int                   dpm_trace_data;   /*!< !=0 = record the accessed data too (up to 4kB per access) */
 };
 
 int32_t cifXDriverInit(const struct CIFX_LINUX_INIT* init_params);
 void    cifXDriverDeinit();
+
+/*****************************************************************************/
+/*! Statistics of the COS polling thread of a non-irq device                 */
+/*****************************************************************************/
+struct CIFX_POLL_STATISTICS
+{
+  unsigned long poll_interval_us; /*!< Poll period in us                                     */
+  int           poll_cpu;         /*!< CPU the polling thread is pinned to, -1 if not pinned */
+  uint64_t      cycles;           /*!< Number of poll cycles                                 */
+  uint64_t      missed_deadlines; /*!< Number of skipped poll cycles (woke up >= 1 period late) */
+  uint64_t      max_lateness_ns;  /*!< Worst case wake up delay after the deadline in ns    */
+};
+
+/* packets from the packet pool (packet_pool of struct CIFX_LINUX_INIT), or from the heap if no pool is used.
+   Fails with CIFX_NO_MORE_ENTRIES if the pool is exhausted. Every thread keeps up to 8 free packets for its own
+   use. hChannel is reserved (may be NULL), all packets must be freed before cifXDriverDeinit() */
+int32_t xChannelAllocPacket(CIFXHANDLE hChannel, CIFX_PACKET** pptPacket);
+int32_t xChannelFreePacket (CIFXHANDLE hChannel, CIFX_PACKET* ptPacket);
+
+int32_t cifXDriverGetPollStatistics(const char* szBoard, struct CIFX_POLL_STATISTICS* ptStats, int fReset);
+
+/*****************************************************************************/
+/*! Event of the last reset/startup of a device                              */
+/*****************************************************************************/
+struct CIFX_BOOT_EVENT
+{
+  uint32_t    time_ms; /*!< Time since the start of the reset/startup */
+  const char* event;   /*!< Description of the event                  */
+};
+
+/* timeline of the last reset/startup of a device (*pulCount: in = size of ptEvents, out = number of events) */
+int32_t cifXDriverGetBootTimeline(const char* szBoard, struct CIFX_BOOT_EVENT* ptEvents, uint32_t* pulCount);
+
+/* device.conf and the firmware/configuration directories are cached per device and re-read automatically
+   on changes (inotify). Forces a re-read on the next access, e.g. if inotify is not available (szBoard = NULL: all devices) */
+int32_t cifXDriverReloadDeviceConfig(const char* szBoard);
+
+/*****************************************************************************/
+/*! Provisioning state of a device (see cifXDriverProvisionDevices())        */
+/*****************************************************************************/
+typedef enum CIFX_PROVISION_STATE_Etag
+{
+  eCIFX_PROVISION_STARTED = 0, /*!< Device restart started, files are downloaded               */
+  eCIFX_PROVISION_FINISHED,    /*!< Device restarted (or failed), see error of the progress info */
+
+} CIFX_PROVISION_STATE_E;
+
+/*****************************************************************************/
+/*! Progress information of a device passed to PFN_CIFX_PROVISION_PROGRESS   */
+/*****************************************************************************/
+struct CIFX_PROVISION_PROGRESS
+{
+  const char*            board;   /*!< Name or alias of the device, as passed to cifXDriverProvisionDevices() */
+  CIFX_PROVISION_STATE_E state;   /*!< Actual state                                          */
+  int32_t                error;   /*!< Result of the device restart (eCIFX_PROVISION_FINISHED) */
+  uint32_t               time_ms; /*!< Time since the provisioning of the device was started */
+};
+
+typedef void(*PFN_CIFX_PROVISION_PROGRESS)(const struct CIFX_PROVISION_PROGRESS* progress, void* user);
+
+/* restarts the given devices (boards = NULL: all devices) in parallel, each device downloads the firmware and
+   configuration files of its device configuration directory. The callback is called from the provisioning threads,
+   the individual startup steps are available via cifXDriverGetBootTimeline() */
+int32_t cifXDriverProvisionDevices(const char* const* boards, uint32_t board_cnt,
+                                   PFN_CIFX_PROVISION_PROGRESS progress, void* user);
+
+/* pollable channel notifications (CIFX_NOTIFY_XXX), the returned eventfd is owned by the driver */
+int32_t cifXChannelGetNotificationFd(CIFXHANDLE hChannel, uint32_t ulNotification, int* piFd);
+
+int32_t cifXChannelReleaseNotificationFd(CIFXHANDLE hChannel, uint32_t ulNotification);
+
 int32_t cifXGetDriverVersion(uint32_t ulSize, char* szVersion);
 
 typedef int32_t (*PFN_DRV_HWIF_INIT)   ( struct CIFX_DEVICE_T* ptDevice);
@@ -105,6 +211,7 @@ struct CIFX_DEVICE_T
 /*       the structures size the device type is coded into the uio_num.  */
 #define UIO_NUM_SPI_DEVICE  -2
 #define UIO_NUM_VFIO_DEVICE -3
+#define UIO_NUM_EVENTFD_DEVICE -4 /* uio_fd is an eventfd, signalled by the device on each interrupt */
   int             uio_num;    /*!< uio number, < 0 for non-uio devices      */
 
   int             uio_fd;     /*!< uio file handle */
@@ -42,23 +42,27 @@
 /* internal is pointer to CIFX_DEVICE_INTERNAL_T */
 #define IS_UIO_DEVICE(internal) (internal->device_type == eCIFX_DEVICE_TYPE_UIO ? 1 : 0)
 #define IS_SPI_DEVICE(internal) (internal->device_type == eCIFX_DEVICE_TYPE_SPI ? 1 : 0)
+#define IS_EVENTFD_DEVICE(internal) (internal->device_type == eCIFX_DEVICE_TYPE_EVENTFD ? 1 : 0)
 #ifdef VFIO_SUPPORT
   #define GET_VFIO_PARAM_FROM_DEV(device) ((device != NULL) ? (struct vfio_fd*)(device->userparam) : NULL)
   #define GET_VFIO_PARAM(internal)        ((internal != NULL) ? GET_VFIO_PARAM_FROM_DEV(internal->userdevice) : NULL)
 
   #define IS_VFIO_DEVICE(internal)    (internal->device_type == eCIFX_DEVICE_TYPE_VFIO ? 1 : 0)
   #define GET_IRQ_FD(internal)        (IS_VFIO_DEVICE(internal) ? GET_VFIO_PARAM(internal)->irq.efd : internal->userdevice->uio_fd)
-  #define GET_IRQ_READ_LEN(internal)  (IS_VFIO_DEVICE(internal) ? (sizeof(uint64_t)) : (sizeof(uint32_t)))
-  #define GET_IRQ_TYPE(internal)      (IS_UIO_DEVICE(internal) ? eCIFX_IRQ_TYPE_UIO : (IS_VFIO_DEVICE(internal) ? eCIFX_IRQ_TYPE_VFIO : eCIFX_IRQ_TYPE_GPIO))
+  #define GET_IRQ_READ_LEN(internal)  ((IS_VFIO_DEVICE(internal) || IS_EVENTFD_DEVICE(internal)) ? (sizeof(uint64_t)) : (sizeof(uint32_t)))
+  #define GET_IRQ_TYPE(internal)      (IS_UIO_DEVICE(internal) ? eCIFX_IRQ_TYPE_UIO : (IS_VFIO_DEVICE(internal) ? eCIFX_IRQ_TYPE_VFIO : \
+                                       (IS_EVENTFD_DEVICE(internal) ? eCIFX_IRQ_TYPE_EVENTFD : eCIFX_IRQ_TYPE_GPIO)))
 #else
   #define GET_IRQ_FD(internal)        (internal->userdevice->uio_fd)
-  #define GET_IRQ_READ_LEN(internal)  (sizeof(uint32_t))
-  #define GET_IRQ_TYPE(internal)      (IS_UIO_DEVICE(internal) ? eCIFX_IRQ_TYPE_UIO : eCIFX_IRQ_TYPE_GPIO)
+  #define GET_IRQ_READ_LEN(internal)  (IS_EVENTFD_DEVICE(internal) ? (sizeof(uint64_t)) : (sizeof(uint32_t)))
+  #define GET_IRQ_TYPE(internal)      (IS_UIO_DEVICE(internal) ? eCIFX_IRQ_TYPE_UIO : \
+                                       (IS_EVENTFD_DEVICE(internal) ? eCIFX_IRQ_TYPE_EVENTFD : eCIFX_IRQ_TYPE_GPIO))
 #endif
 
 enum CIFX_IRQ_TYPE {
   eCIFX_IRQ_TYPE_UIO,
   eCIFX_IRQ_TYPE_GPIO,
+  eCIFX_IRQ_TYPE_EVENTFD,
 #ifdef VFIO_SUPPORT
   eCIFX_IRQ_TYPE_VFIO,
 #endif
@@ -69,6 +73,7 @@ typedef enum CIFX_DEVICE_TYPE_Etag
   eCIFX_DEVICE_TYPE_UIO = 0,
   eCIFX_DEVICE_TYPE_SPI,
   eCIFX_DEVICE_TYPE_VFIO,
+  eCIFX_DEVICE_TYPE_EVENTFD,
   eCIFX_DEVICE_TYPE_UNKNOWN,
 } CIFX_DEVICE_TYPE_E;
 
@@ -89,6 +94,24 @@ typedef struct CIFX_DEVICE_INTERNAL_Ttag
   pthread_t             irq_thread;             /*!< Interrupt thread handle     */
   int                   irq_stop;               /*!< flag to signal IRQ handler to stop */
 
+  pthread_t             poll_thread;            /*!< COS polling thread handle (non-irq devices) */
+  int                   poll_running;           /*!< !=0 if poll_thread was created */
+  int                   poll_stop;              /*!< flag to signal polling thread to stop */
+  unsigned long         poll_interval_us;       /*!< Device specific poll period in us, 0 to use default */
+  int                   set_poll_cpu;           /*!< Flag if polling thread should be pinned to poll_cpu */
+  int                   poll_cpu;               /*!< CPU to run the polling thread on */
+  uint64_t              poll_cycles;            /*!< Number of poll cycles */
+  uint64_t              poll_missed;            /*!< Number of missed poll deadlines */
+  uint64_t              poll_max_lateness_ns;   /*!< Worst case wake up delay of the polling thread */
+
+  int                   notify_fd[CIFX_MAX_NUMBER_OF_CHANNELS][CIFX_NOTIFY_COM_STATE]; /*!< eventfds handed out by cifXChannelGetNotificationFd(), -1 if not created */
+  int                   notify_fd_active[CIFX_MAX_NUMBER_OF_CHANNELS][CIFX_NOTIFY_COM_STATE]; /*!< !=0 if the eventfd is signalled on notifications */
+
+  struct CIFX_CONFIG_CACHE_T* config_cache; /*!< Parsed device.conf and directory listings (user_linux.c) */
+
+  int                   restart_active;   /*!< !=0 while the device is restarted (xDriverRestartDevice(), cifXDriverProvisionDevices()) */
+  PDEVICEINSTANCE       restart_next;     /*!< Next device being restarted (list protected by g_pvTkitLock) */
+
   int                   user_card;        /*!< !=0 if user specified card. This card will not be deleted on exit */
   FILE                  *log_file;        /*!< Handle to logfile if any */
 
@@ -106,9 +129,15 @@ typedef struct CIFX_DEVICE_INTERNAL_Ttag
 
 
 #ifdef VFIO_SUPPORT
+#include <linux/vfio.h>
+
+#define VFIO_IRQ_COUNT 1
+
 struct vfio_irq_res {
   int efd;                             /* eventfd file descriptor required for interrupt handling */
-  struct vfio_irq_set*  vfio_irq_ctrl; /* ioctl structure required to (un-)mask the interrupt     */
+  struct vfio_irq_set*  vfio_irq_ctrl; /* ioctl structure required to (un-)mask the interrupt (points to
+                                          vfio_irq_buf while the interrupt is enabled)             */
+  uint32_t              vfio_irq_buf[(sizeof(struct vfio_irq_set) / sizeof(uint32_t)) + VFIO_IRQ_COUNT];
 };
 
 struct vfio_fd {
@@ -126,6 +155,49 @@ struct vfio_fd {
 };
 #endif /* VFIO_SUPPORT */
 
+/* Device configuration cache (user_linux.c) */
+int32_t cifXConfigCacheCreate    (PCIFX_DEVICE_INTERNAL_T internaldev);
+void    cifXConfigCacheInvalidate(PCIFX_DEVICE_INTERNAL_T internaldev);
+void    cifXConfigCacheFree      (PCIFX_DEVICE_INTERNAL_T internaldev);
+
+/* Notification dispatcher (notify_linux.c) */
+int32_t cifXNotifyDispatchStart  (int iThreads);
+void    cifXNotifyDispatchStop   (void);
+void    cifXNotifyDispatchFlush  (void);
+int     cifXNotifyDispatchEnabled(void);
+void    cifXNotifyDispatch       (void* pvDeviceInstance, void* pvChannel, PFN_NOTIFY_CALLBACK pfnCallback,
+                                  uint32_t ulNotification, uint32_t ulDataLen, void* pvData, void* pvUser);
+
+/* Packet pool (pktpool_linux.c) */
+int32_t cifXPacketPoolStart      (uint32_t ulPackets);
+void    cifXPacketPoolStop       (void);
+
+#ifdef CIFX_DRV_DPM_TRACE
+/* DPM access trace (dpmtrace_linux.c) */
+int32_t  cifXDPMTraceStart    (const char* szFile, uint32_t ulRingSize, int fData);
+void     cifXDPMTraceStop     (void);
+void     cifXDPMTraceAddDevice(void* pvDevInstance);
+uint64_t cifXDPMTraceBegin    (void);
+void     cifXDPMTraceAccess   (uint64_t ullStart, void* pvDevInstance, uint32_t ulOpt, int fWrite,
+                               void* pvDpmAddr, void* pvData, uint32_t ulLen);
+#endif
+
+/* Real-time mode (rt_linux.c) */
+#define RT_THREAD_STACK_SIZE (128 * 1024) /*!< Stack size (+PTHREAD_STACK_MIN) of driver threads in real-time mode */
+
+int32_t cifXRTStart         (void);
+void    cifXRTStop          (void);
+int     cifXRTEnabled       (void);
+void    cifXRTSetThreadStack(pthread_attr_t* ptAttr);
+void    cifXRTPrefaultStack (void);
+
+#ifdef DEBUG
+void    cifXRTCheckAlloc    (const char* szFunction);
+#define RT_CHECK_ALLOC()    cifXRTCheckAlloc(__func__)
+#else
+#define RT_CHECK_ALLOC()
+#endif
+
 #ifdef CIFXETHERNET
 int USER_GetEthernet(PCIFX_DEVICE_INFORMATION ptDevInfo);
 #endif
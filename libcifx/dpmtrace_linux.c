@@ -0,0 +1,408 @@
+// SPDX-License-Identifier: MIT
+/**************************************************************************************
+ *
+ * Copyright (c) 2025, Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserved.
+ *
+ * Description: DPM access trace (dpm_trace_file of struct CIFX_LINUX_INIT, library built
+ *              with DPM_TRACE). Records every DPM access of the toolkit (HWIFDPMRead(),
+ *              HWIFDPMWrite()) with timestamp, duration, thread, offset, length and
+ *              optionally the data into a memory mapped ring file (see cifxdpmtrace.h).
+ *              The file stays valid if the application crashes. The accesses can be
+ *              analysed and replayed with the cifx_dpmtrace tool (examples/dpmtrace).
+ *
+ **************************************************************************************/
+
+#ifdef CIFX_DRV_DPM_TRACE
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* syscall() */
+#endif
+
+#include "cifxlinux_internal.h"
+#include "cifxdpmtrace.h"
+#include "cifXHWFunctions.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#define DPM_TRACE_MIN_SIZE  (64 * 1024) /*!< Minimum ring size */
+
+static int                           s_fEnabled  = 0;
+static pthread_mutex_t               s_tLock     = PTHREAD_MUTEX_INITIALIZER;
+static int                           s_iFd       = -1;
+static struct CIFX_DPM_TRACE_HEADER* s_ptHeader  = NULL;
+static uint8_t*                      s_pbRing    = NULL;
+static size_t                        s_tMapSize  = 0;
+static uint64_t                      s_ullStart  = 0;  /*!< CLOCK_MONOTONIC of time_ns = 0 */
+static void*                         s_apvDevices[CIFX_DPM_TRACE_MAX_DEVICES]; /*!< Device instances of s_ptHeader->devices */
+static __thread uint32_t             s_ulThread  = 0;  /*!< Thread id of the calling thread (0 = not yet read) */
+
+/*****************************************************************************/
+/*! Returns the time of the given clock in ns
+*   \param tClock  Clock to read
+*   \return Time in ns                                                       */
+/*****************************************************************************/
+static uint64_t DPMTraceTime(clockid_t tClock)
+{
+  struct timespec tNow;
+
+  clock_gettime(tClock, &tNow);
+  return (uint64_t)tNow.tv_sec * 1000000000ULL + (uint64_t)tNow.tv_nsec;
+}
+
+/*****************************************************************************/
+/*! Returns the position of the record following the record at the given
+*   position (skips the padding at the end of the ring)
+*   \param ullPos  Position of a record
+*   \return Position of the next record                                      */
+/*****************************************************************************/
+static uint64_t DPMTraceNext(uint64_t ullPos)
+{
+  uint32_t                      ulRingSize = s_ptHeader->ring_size;
+  uint32_t                      ulLeft     = ulRingSize - (uint32_t)(ullPos % ulRingSize);
+  struct CIFX_DPM_TRACE_RECORD* ptRecord;
+
+  if(ulLeft < sizeof(*ptRecord))
+    return ullPos + ulLeft;
+
+  ptRecord = (struct CIFX_DPM_TRACE_RECORD*)(s_pbRing + (ullPos % ulRingSize));
+  if(ptRecord->flags & CIFX_DPM_TRACE_FLAG_PAD)
+    return ullPos + ulLeft;
+
+  return ullPos + ptRecord->size;
+}
+
+/*****************************************************************************/
+/*! Writes a record to the ring, the oldest records are overwritten. Must be
+*   called with s_tLock held.
+*   \param ptRecord   Record (size includes the data)
+*   \param pvData     Data following the record
+*   \param ulDataLen  Length of the data                                     */
+/*****************************************************************************/
+static void DPMTraceWrite(struct CIFX_DPM_TRACE_RECORD* ptRecord, const void* pvData, uint32_t ulDataLen)
+{
+  uint32_t ulRingSize = s_ptHeader->ring_size;
+  uint64_t ullHead    = s_ptHeader->head;
+  uint32_t ulLeft     = ulRingSize - (uint32_t)(ullHead % ulRingSize);
+  uint32_t ulPad      = (ulLeft < ptRecord->size) ? ulLeft : 0;
+  uint8_t* pbDst;
+
+  /* free the space of the oldest records */
+  while(ullHead + ulPad + ptRecord->size - s_ptHeader->tail > ulRingSize)
+    s_ptHeader->tail = DPMTraceNext(s_ptHeader->tail);
+
+  /* records never wrap, skip the rest of the ring */
+  if(ulPad > 0)
+  {
+    if(ulPad >= sizeof(*ptRecord))
+    {
+      struct CIFX_DPM_TRACE_RECORD* ptPad = (struct CIFX_DPM_TRACE_RECORD*)(s_pbRing + (ullHead % ulRingSize));
+
+      memset(ptPad, 0, sizeof(*ptPad));
+      ptPad->flags = CIFX_DPM_TRACE_FLAG_PAD;
+      ptPad->size  = (uint16_t)ulPad;
+    }
+    ullHead += ulPad;
+  }
+
+  ptRecord->sequence = (uint32_t)s_ptHeader->records;
+
+  pbDst = s_pbRing + (ullHead % ulRingSize);
+  memcpy(pbDst, ptRecord, sizeof(*ptRecord));
+  if(ulDataLen > 0)
+    memcpy(pbDst + sizeof(*ptRecord), pvData, ulDataLen);
+
+  s_ptHeader->head = ullHead + ptRecord->size;
+  ++s_ptHeader->records;
+}
+
+/*****************************************************************************/
+/*! Returns the start time of a DPM access, must be called before the access
+*   \return Start time (CLOCK_MONOTONIC), 0 if the trace is disabled         */
+/*****************************************************************************/
+uint64_t cifXDPMTraceBegin(void)
+{
+  if(!__atomic_load_n(&s_fEnabled, __ATOMIC_ACQUIRE))
+    return 0;
+
+  return DPMTraceTime(CLOCK_MONOTONIC);
+}
+
+/*****************************************************************************/
+/*! Records a DPM access, must be called after the access
+*   \param ullStart       Start time of the access (see cifXDPMTraceBegin())
+*   \param pvDevInstance  Device instance
+*   \param ulOpt          Access option of the hardware interface (1 = single access)
+*   \param fWrite         !=0 for a write access
+*   \param pvDpmAddr      Accessed DPM address
+*   \param pvData         Data written or read
+*   \param ulLen          Number of bytes accessed                           */
+/*****************************************************************************/
+void cifXDPMTraceAccess(uint64_t ullStart, void* pvDevInstance, uint32_t ulOpt, int fWrite,
+                        void* pvDpmAddr, void* pvData, uint32_t ulLen)
+{
+  PDEVICEINSTANCE              ptDev       = (PDEVICEINSTANCE)pvDevInstance;
+  uint64_t                     ullEnd;
+  struct CIFX_DPM_TRACE_RECORD tRecord;
+  uint32_t                     ulDataLen   = 0;
+  uint32_t                     ulDevice;
+
+  if(0 == ullStart)
+    return;
+
+  ullEnd = DPMTraceTime(CLOCK_MONOTONIC);
+
+  if(0 == s_ulThread)
+    s_ulThread = (uint32_t)syscall(SYS_gettid);
+
+  memset(&tRecord, 0, sizeof(tRecord));
+  tRecord.time_ns     = ullStart - s_ullStart;
+  tRecord.duration_ns = (uint32_t)(ullEnd - ullStart);
+  tRecord.offset      = (uint32_t)((uint8_t*)pvDpmAddr - ptDev->pbDPM);
+  tRecord.length      = ulLen;
+  tRecord.thread      = s_ulThread;
+  tRecord.device      = CIFX_DPM_TRACE_DEVICE_UNKNOWN;
+  tRecord.flags       = (fWrite ? CIFX_DPM_TRACE_FLAG_WRITE : 0) | ((1 == ulOpt) ? CIFX_DPM_TRACE_FLAG_SINGLE : 0);
+
+  pthread_mutex_lock(&s_tLock);
+
+  if(NULL != s_ptHeader)
+  {
+    for(ulDevice = 0; ulDevice < s_ptHeader->device_count; ulDevice++)
+    {
+      if(s_apvDevices[ulDevice] == pvDevInstance)
+      {
+        tRecord.device = (uint8_t)ulDevice;
+        break;
+      }
+    }
+
+    if(s_ptHeader->flags & CIFX_DPM_TRACE_HDR_DATA)
+    {
+      ulDataLen      = (ulLen > CIFX_DPM_TRACE_MAX_DATA) ? CIFX_DPM_TRACE_MAX_DATA : ulLen;
+      tRecord.flags |= CIFX_DPM_TRACE_FLAG_DATA;
+    }
+    tRecord.size = (uint16_t)((sizeof(tRecord) + ulDataLen + 7) & ~7UL);
+
+    DPMTraceWrite(&tRecord, pvData, ulDataLen);
+  }
+
+  pthread_mutex_unlock(&s_tLock);
+}
+
+/*****************************************************************************/
+/*! Adds a region to the device description of the trace header
+*   \param ptTraceDev  Device description
+*   \param ptDev       Device instance
+*   \param pvStart     Start of the region in the DPM (NULL = not available)
+*   \param ulLength    Length of the region
+*   \param eType       Region type
+*   \param usChannel   Communication channel of the region                   */
+/*****************************************************************************/
+static void DPMTraceAddRegion(struct CIFX_DPM_TRACE_DEVICE* ptTraceDev, PDEVICEINSTANCE ptDev, void* pvStart,
+                              uint32_t ulLength, CIFX_DPM_TRACE_REGION_E eType, uint16_t usChannel)
+{
+  struct CIFX_DPM_TRACE_REGION* ptRegion;
+
+  if((NULL == pvStart) || (0 == ulLength) || (ptTraceDev->region_count >= CIFX_DPM_TRACE_MAX_REGIONS))
+    return;
+
+  ptRegion          = &ptTraceDev->regions[ptTraceDev->region_count++];
+  ptRegion->offset  = (uint32_t)((uint8_t*)pvStart - ptDev->pbDPM);
+  ptRegion->length  = ulLength;
+  ptRegion->type    = (uint16_t)eType;
+  ptRegion->channel = usChannel;
+}
+
+/*****************************************************************************/
+/*! Adds the regions of a channel to the device description of the trace
+*   header
+*   \param ptTraceDev  Device description
+*   \param ptDev       Device instance
+*   \param ptChannel   Channel instance
+*   \param usChannel   Communication channel number (CIFX_DPM_TRACE_CHANNEL_NONE
+*                      for the system channel)                              */
+/*****************************************************************************/
+static void DPMTraceAddChannel(struct CIFX_DPM_TRACE_DEVICE* ptTraceDev, PDEVICEINSTANCE ptDev,
+                               PCHANNELINSTANCE ptChannel, uint16_t usChannel)
+{
+  uint32_t ulArea;
+
+  DPMTraceAddRegion(ptTraceDev, ptDev, ptChannel->pbDPMChannelStart, ptChannel->ulDPMChannelLength,
+                    ptChannel->fIsSysDevice ? eCIFX_DPM_REGION_SYSTEM : eCIFX_DPM_REGION_CHANNEL, usChannel);
+  DPMTraceAddRegion(ptTraceDev, ptDev, ptChannel->ptHandshakeCell, sizeof(HIL_DPM_HANDSHAKE_CELL_T),
+                    eCIFX_DPM_REGION_HANDSHAKE, usChannel);
+  DPMTraceAddRegion(ptTraceDev, ptDev, ptChannel->tSendMbx.ptSendMailboxStart, ptChannel->tSendMbx.ulSendMailboxLength,
+                    eCIFX_DPM_REGION_SEND_MBX, usChannel);
+  DPMTraceAddRegion(ptTraceDev, ptDev, ptChannel->tRecvMbx.ptRecvMailboxStart, ptChannel->tRecvMbx.ulRecvMailboxLength,
+                    eCIFX_DPM_REGION_RECV_MBX, usChannel);
+  DPMTraceAddRegion(ptTraceDev, ptDev, ptChannel->ptControlBlock, ptChannel->ulControlBlockSize,
+                    eCIFX_DPM_REGION_CONTROL, usChannel);
+  DPMTraceAddRegion(ptTraceDev, ptDev, ptChannel->ptCommonStatusBlock, ptChannel->ulCommonStatusSize,
+                    eCIFX_DPM_REGION_STATUS, usChannel);
+  DPMTraceAddRegion(ptTraceDev, ptDev, ptChannel->ptExtendedStatusBlock, ptChannel->ulExtendedStatusSize,
+                    eCIFX_DPM_REGION_STATUS, usChannel);
+
+  for(ulArea = 0; (NULL != ptChannel->pptIOInputAreas) && (ulArea < ptChannel->ulIOInputAreas); ulArea++)
+    DPMTraceAddRegion(ptTraceDev, ptDev, ptChannel->pptIOInputAreas[ulArea]->pbDPMAreaStart,
+                      ptChannel->pptIOInputAreas[ulArea]->ulDPMAreaLength, eCIFX_DPM_REGION_IO_INPUT, usChannel);
+
+  for(ulArea = 0; (NULL != ptChannel->pptIOOutputAreas) && (ulArea < ptChannel->ulIOOutputAreas); ulArea++)
+    DPMTraceAddRegion(ptTraceDev, ptDev, ptChannel->pptIOOutputAreas[ulArea]->pbDPMAreaStart,
+                      ptChannel->pptIOOutputAreas[ulArea]->ulDPMAreaLength, eCIFX_DPM_REGION_IO_OUTPUT, usChannel);
+}
+
+/*****************************************************************************/
+/*! Adds a device to the trace header or updates its DPM layout. Called
+*   before the device is passed to the toolkit (accesses during the start-up
+*   are assigned to the device) and after every (re-)start (DPM layout).
+*   \param pvDevInstance  Device instance                                    */
+/*****************************************************************************/
+void cifXDPMTraceAddDevice(void* pvDevInstance)
+{
+  PDEVICEINSTANCE               ptDev      = (PDEVICEINSTANCE)pvDevInstance;
+  struct CIFX_DPM_TRACE_DEVICE* ptTraceDev = NULL;
+  uint32_t                      ulDevice;
+
+  pthread_mutex_lock(&s_tLock);
+
+  if(NULL != s_ptHeader)
+  {
+    for(ulDevice = 0; ulDevice < s_ptHeader->device_count; ulDevice++)
+    {
+      if(s_apvDevices[ulDevice] == pvDevInstance)
+        break;
+    }
+
+    if(ulDevice < s_ptHeader->device_count)
+    {
+      ptTraceDev = &s_ptHeader->devices[ulDevice];
+    } else if(ulDevice < CIFX_DPM_TRACE_MAX_DEVICES)
+    {
+      s_apvDevices[ulDevice] = pvDevInstance;
+      ptTraceDev             = &s_ptHeader->devices[ulDevice];
+      ++s_ptHeader->device_count;
+    } else
+    {
+      ERR("DPM trace supports %u devices, accesses of %s are not assigned\n", CIFX_DPM_TRACE_MAX_DEVICES, ptDev->szName);
+    }
+  }
+
+  if(NULL != ptTraceDev)
+  {
+    uint32_t ulChannel;
+
+    memset(ptTraceDev, 0, sizeof(*ptTraceDev));
+    strncpy(ptTraceDev->name, ptDev->szName, sizeof(ptTraceDev->name) - 1);
+    ptTraceDev->dpm_size = ptDev->ulDPMSize;
+
+    DPMTraceAddChannel(ptTraceDev, ptDev, &ptDev->tSystemDevice, CIFX_DPM_TRACE_CHANNEL_NONE);
+    DPMTraceAddRegion(ptTraceDev, ptDev, ptDev->pbHandshakeBlock, sizeof(HIL_DPM_HANDSHAKE_ARRAY_T),
+                      eCIFX_DPM_REGION_HANDSHAKE, CIFX_DPM_TRACE_CHANNEL_NONE);
+
+    for(ulChannel = 0; (NULL != ptDev->pptCommChannels) && (ulChannel < ptDev->ulCommChannelCount); ulChannel++)
+      DPMTraceAddChannel(ptTraceDev, ptDev, ptDev->pptCommChannels[ulChannel], (uint16_t)ulChannel);
+  }
+
+  pthread_mutex_unlock(&s_tLock);
+}
+
+/*****************************************************************************/
+/*! Starts the DPM access trace
+*   \param szFile      Trace file (created or truncated)
+*   \param ulRingSize  Size of the ring in bytes (0 = CIFX_DPM_TRACE_DEFAULT_SIZE)
+*   \param fData       !=0 to record the accessed data
+*   \return CIFX_NO_ERROR on success                                         */
+/*****************************************************************************/
+int32_t cifXDPMTraceStart(const char* szFile, uint32_t ulRingSize, int fData)
+{
+  long   lPage        = sysconf(_SC_PAGESIZE);
+  size_t tHeaderSize  = (sizeof(*s_ptHeader) + (size_t)lPage - 1) & ~((size_t)lPage - 1);
+  void*  pvMap;
+
+  if(0 == ulRingSize)
+    ulRingSize = CIFX_DPM_TRACE_DEFAULT_SIZE;
+
+  ulRingSize &= ~7UL;
+  if(ulRingSize < DPM_TRACE_MIN_SIZE)
+    return CIFX_INVALID_PARAMETER;
+
+  if(NULL != s_ptHeader)
+    return CIFX_DRV_INIT_STATE_ERROR;
+
+  if(0 > (s_iFd = open(szFile, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)))
+  {
+    ERR("Failed to create DPM trace file %s (errno=%d)\n", szFile, errno);
+    return CIFX_FILE_OPEN_FAILED;
+  }
+
+  s_tMapSize = tHeaderSize + ulRingSize;
+  if(0 != ftruncate(s_iFd, (off_t)s_tMapSize))
+  {
+    ERR("Failed to size DPM trace file %s (errno=%d)\n", szFile, errno);
+    close(s_iFd);
+    s_iFd = -1;
+    return CIFX_FILE_OPEN_FAILED;
+  }
+
+  if(MAP_FAILED == (pvMap = mmap(NULL, s_tMapSize, PROT_READ | PROT_WRITE, MAP_SHARED, s_iFd, 0)))
+  {
+    ERR("Failed to map DPM trace file %s (errno=%d)\n", szFile, errno);
+    close(s_iFd);
+    s_iFd = -1;
+    return CIFX_MEMORY_MAPPING_FAILED;
+  }
+
+  pthread_mutex_lock(&s_tLock);
+
+  s_ptHeader = (struct CIFX_DPM_TRACE_HEADER*)pvMap;
+  s_pbRing   = (uint8_t*)pvMap + tHeaderSize;
+  memset(s_apvDevices, 0, sizeof(s_apvDevices));
+
+  s_ptHeader->magic         = CIFX_DPM_TRACE_MAGIC;
+  s_ptHeader->version       = CIFX_DPM_TRACE_VERSION;
+  s_ptHeader->header_size   = (uint32_t)tHeaderSize;
+  s_ptHeader->ring_size     = ulRingSize;
+  s_ptHeader->flags         = fData ? CIFX_DPM_TRACE_HDR_DATA : 0;
+  s_ptHeader->start_time_ns = DPMTraceTime(CLOCK_REALTIME);
+  s_ullStart                = DPMTraceTime(CLOCK_MONOTONIC);
+
+  pthread_mutex_unlock(&s_tLock);
+
+  __atomic_store_n(&s_fEnabled, 1, __ATOMIC_RELEASE);
+
+  return CIFX_NO_ERROR;
+}
+
+/*****************************************************************************/
+/*! Stops the DPM access trace and closes the trace file                     */
+/*****************************************************************************/
+void cifXDPMTraceStop(void)
+{
+  __atomic_store_n(&s_fEnabled, 0, __ATOMIC_RELEASE);
+
+  pthread_mutex_lock(&s_tLock);
+
+  if(NULL != s_ptHeader)
+  {
+    DBG("DPM trace: %llu accesses recorded\n", (unsigned long long)s_ptHeader->records);
+
+    msync(s_ptHeader, s_tMapSize, MS_SYNC);
+    munmap(s_ptHeader, s_tMapSize);
+    close(s_iFd);
+
+    s_ptHeader = NULL;
+    s_pbRing   = NULL;
+    s_iFd      = -1;
+  }
+
+  pthread_mutex_unlock(&s_tLock);
+}
+
+#endif /* CIFX_DRV_DPM_TRACE */
@@ -610,6 +610,7 @@ static int cifxeth_create_cifx_thread(NETX_ETH_DEV_T* internal_dev)
   internal_dev->stop_to_eth = 0;
   if(0 == (ret = pthread_attr_init(&attr)))
   {
+    cifXRTSetThreadStack(&attr);
     ret = pthread_create(&internal_dev->cifx_to_eth_thread,
                           &attr,
                           cifx_to_eth_thread,
@@ -631,6 +632,7 @@ static int cifxeth_create_com_thread(NETX_ETH_DEV_T* internal_dev)
   internal_dev->stop_to_cifx = 0;
   if(0 == (ret = pthread_attr_init(&attr)))
   {
+    cifXRTSetThreadStack(&attr);
     ret = pthread_create(&internal_dev->eth_to_cifx_thread,
                                  &attr,
                                  eth_to_cifx_thread,
@@ -657,6 +659,8 @@ static void* eth_to_cifx_thread(void* arg)
   cifx_packet.tReq.tHead.ulCmd  = DRVETH_GCI_CMD_SEND_ETH_FRAME_REQ;
   cifx_packet.tReq.tHead.ulDest = HIL_PACKET_DEST_DEFAULT_CHANNEL;
 
+  cifXRTPrefaultStack();
+
   while(1)
   {
     fd_set readfds, exceptfds;
@@ -879,6 +883,8 @@ static void* cifx_to_eth_thread(void* arg)
   time_t          last_update      = 0;
   int32_t         lRet;
 
+  cifXRTPrefaultStack();
+
   while(1)
   {
     if (internal_dev->stop_to_eth == 1)
@@ -0,0 +1,295 @@
+// SPDX-License-Identifier: MIT
+/**************************************************************************************
+ *
+ * Copyright (c) 2025, Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserved.
+ *
+ * Description: Notification dispatcher. Executes the user notification callbacks in a
+ *              pool of callback threads instead of the DSR (IRQ thread) context.
+ *
+ *              Every callback thread owns a bounded lock-free MPSC queue. The DSR (and
+ *              xChannelRegisterNotification()) push notification records into the queue
+ *              of the thread the channel is mapped to, so the notifications of a channel
+ *              are always executed in order by the same thread.
+ *
+ **************************************************************************************/
+
+#include "cifxlinux_internal.h"
+#include "cifXHWFunctions.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <semaphore.h>
+#include <sched.h>
+
+#define NOTIFY_QUEUE_SIZE   1024  /*!< Records per callback thread (must be a power of two) */
+#define NOTIFY_MAX_THREADS  16    /*!< Maximum number of callback threads */
+
+/*****************************************************************************/
+/*! Queued notification                                                      */
+/*****************************************************************************/
+typedef struct NOTIFY_RECORD_Ttag
+{
+  uint32_t            ulSequence;     /*!< Slot sequence number (Vyukov bounded queue) */
+  PFN_NOTIFY_CALLBACK pfnCallback;    /*!< User callback */
+  void*               pvUser;         /*!< User parameter */
+  uint32_t            ulNotification; /*!< CIFX_NOTIFY_XXX */
+  uint32_t            ulDataLen;      /*!< Length of valid data in tData */
+  union
+  {
+    CIFX_NOTIFY_RX_MBX_FULL_DATA_T  tRxMbxFull;
+    CIFX_NOTIFY_TX_MBX_EMPTY_DATA_T tTxMbxEmpty;
+    CIFX_NOTIFY_COM_STATE_T         tComState;
+  } tData;                            /*!< Copy of the notification data, the DSR passes stack data */
+} NOTIFY_RECORD_T;
+
+/*****************************************************************************/
+/*! Callback thread and its queue                                            */
+/*****************************************************************************/
+typedef struct NOTIFY_WORKER_Ttag
+{
+  pthread_t        tThread;
+  sem_t            tWakeup;
+  uint32_t         ulEnqueuePos;                   /*!< Next slot to be claimed by a producer */
+  uint32_t         ulDequeuePos;                   /*!< Next slot to be executed (worker only) */
+  uint64_t         ullEnqueued;                    /*!< Number of queued notifications */
+  uint64_t         ullProcessed;                   /*!< Number of executed notifications */
+  NOTIFY_RECORD_T  atQueue[NOTIFY_QUEUE_SIZE];
+} NOTIFY_WORKER_T;
+
+static NOTIFY_WORKER_T* s_ptWorkers     = NULL;
+static int              s_iWorkerCount  = 0;
+static int              s_fStop         = 0;
+static uint64_t         s_ullOverflows  = 0; /*!< Number of times a producer found a full queue */
+
+/*****************************************************************************/
+/*! Callback thread, executes the queued notifications in order
+*   \param arg  Worker structure
+*   \return NULL                                                             */
+/*****************************************************************************/
+static void* cifXNotifyThread(void* arg)
+{
+  NOTIFY_WORKER_T* ptWorker = (NOTIFY_WORKER_T*)arg;
+
+  cifXRTPrefaultStack();
+
+  while(1)
+  {
+    NOTIFY_RECORD_T* ptRecord = &ptWorker->atQueue[ptWorker->ulDequeuePos & (NOTIFY_QUEUE_SIZE - 1)];
+    uint32_t         ulSeq    = __atomic_load_n(&ptRecord->ulSequence, __ATOMIC_ACQUIRE);
+
+    if((int32_t)(ulSeq - (ptWorker->ulDequeuePos + 1)) < 0)
+    {
+      /* queue is empty, all notifications queued before the stop request are executed */
+      if(__atomic_load_n(&s_fStop, __ATOMIC_ACQUIRE))
+        break;
+
+      sem_wait(&ptWorker->tWakeup);
+      continue;
+    }
+
+    ptRecord->pfnCallback(ptRecord->ulNotification,
+                          ptRecord->ulDataLen,
+                          (ptRecord->ulDataLen > 0) ? &ptRecord->tData : NULL,
+                          ptRecord->pvUser);
+
+    /* release the slot for the next round */
+    __atomic_store_n(&ptRecord->ulSequence, ptWorker->ulDequeuePos + NOTIFY_QUEUE_SIZE, __ATOMIC_RELEASE);
+    ++ptWorker->ulDequeuePos;
+    __atomic_add_fetch(&ptWorker->ullProcessed, 1, __ATOMIC_RELEASE);
+  }
+
+  return NULL;
+}
+
+/*****************************************************************************/
+/*! Notification dispatch function (see PFN_CIFXTK_NOTIFY_DISPATCH). Queues
+*   the notification to the callback thread the channel is mapped to.
+*   \param pvDeviceInstance  Device instance
+*   \param pvChannel         Channel instance
+*   \param pfnCallback       User callback
+*   \param ulNotification    Notification
+*   \param ulDataLen         Length of notification data
+*   \param pvData            Notification data
+*   \param pvUser            User parameter                                  */
+/*****************************************************************************/
+void cifXNotifyDispatch(void* pvDeviceInstance, void* pvChannel, PFN_NOTIFY_CALLBACK pfnCallback,
+                        uint32_t ulNotification, uint32_t ulDataLen, void* pvData, void* pvUser)
+{
+  /* channel instances are allocated, so the low bits carry no information */
+  NOTIFY_WORKER_T* ptWorker = &s_ptWorkers[((uintptr_t)pvChannel >> 6) % (uintptr_t)s_iWorkerCount];
+  NOTIFY_RECORD_T* ptRecord;
+  uint32_t         ulPos    = __atomic_load_n(&ptWorker->ulEnqueuePos, __ATOMIC_RELAXED);
+  int              fFull    = 0;
+
+  UNREFERENCED_PARAMETER(pvDeviceInstance);
+
+  /* claim a slot */
+  while(1)
+  {
+    int32_t lDiff;
+
+    ptRecord = &ptWorker->atQueue[ulPos & (NOTIFY_QUEUE_SIZE - 1)];
+    lDiff    = (int32_t)(__atomic_load_n(&ptRecord->ulSequence, __ATOMIC_ACQUIRE) - ulPos);
+
+    if(lDiff == 0)
+    {
+      if(__atomic_compare_exchange_n(&ptWorker->ulEnqueuePos, &ulPos, ulPos + 1, 1,
+                                     __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        break;
+    } else if(lDiff < 0)
+    {
+      /* queue is full, wait for the callback thread to free a slot. Notifications
+         must not get lost, as the application relies on them (e.g. RX_MBX_FULL). */
+      if(!fFull)
+      {
+        fFull = 1;
+        __atomic_add_fetch(&s_ullOverflows, 1, __ATOMIC_RELAXED);
+      }
+
+      /* A callback of this thread caused the notification, nobody else empties
+         the queue. Execute the callback directly instead of waiting forever
+         (it overtakes the queued notifications of the channel). */
+      if(pthread_equal(pthread_self(), ptWorker->tThread))
+      {
+        pfnCallback(ulNotification, ulDataLen, pvData, pvUser);
+        return;
+      }
+
+      sem_post(&ptWorker->tWakeup);
+      sched_yield();
+      ulPos = __atomic_load_n(&ptWorker->ulEnqueuePos, __ATOMIC_RELAXED);
+    } else
+    {
+      ulPos = __atomic_load_n(&ptWorker->ulEnqueuePos, __ATOMIC_RELAXED);
+    }
+  }
+
+  ptRecord->pfnCallback    = pfnCallback;
+  ptRecord->pvUser         = pvUser;
+  ptRecord->ulNotification = ulNotification;
+  ptRecord->ulDataLen      = 0;
+  if(NULL != pvData)
+  {
+    ptRecord->ulDataLen = (ulDataLen > sizeof(ptRecord->tData)) ? sizeof(ptRecord->tData) : ulDataLen;
+    memcpy(&ptRecord->tData, pvData, ptRecord->ulDataLen);
+  }
+
+  __atomic_add_fetch(&ptWorker->ullEnqueued, 1, __ATOMIC_RELAXED);
+  __atomic_store_n(&ptRecord->ulSequence, ulPos + 1, __ATOMIC_RELEASE);
+
+  sem_post(&ptWorker->tWakeup);
+}
+
+/*****************************************************************************/
+/*! Waits until all notifications queued so far are executed                */
+/*****************************************************************************/
+void cifXNotifyDispatchFlush(void)
+{
+  int iWorker;
+
+  for(iWorker = 0; iWorker < s_iWorkerCount; iWorker++)
+  {
+    NOTIFY_WORKER_T* ptWorker = &s_ptWorkers[iWorker];
+    uint64_t         ullQueued = __atomic_load_n(&ptWorker->ullEnqueued, __ATOMIC_ACQUIRE);
+
+    /* a callback must not wait for its own thread */
+    if(pthread_equal(pthread_self(), ptWorker->tThread))
+      continue;
+
+    while(__atomic_load_n(&ptWorker->ullProcessed, __ATOMIC_ACQUIRE) < ullQueued)
+      OS_Sleep(1);
+  }
+}
+
+/*****************************************************************************/
+/*! Starts the callback threads
+*   \param iThreads  Number of callback threads
+*   \return CIFX_NO_ERROR on success                                         */
+/*****************************************************************************/
+int32_t cifXNotifyDispatchStart(int iThreads)
+{
+  pthread_attr_t tAttr;
+  int            iWorker;
+  int            ret;
+
+  if((iThreads <= 0) || (iThreads > NOTIFY_MAX_THREADS))
+    return CIFX_INVALID_PARAMETER;
+
+  if(NULL != s_ptWorkers)
+    return CIFX_DRV_INIT_STATE_ERROR;
+
+  if(NULL == (s_ptWorkers = calloc(iThreads, sizeof(*s_ptWorkers))))
+    return CIFX_DRV_INIT_STATE_ERROR;
+
+  s_fStop        = 0;
+  s_ullOverflows = 0;
+
+  pthread_attr_init(&tAttr);
+  cifXRTSetThreadStack(&tAttr);
+
+  for(iWorker = 0; iWorker < iThreads; iWorker++)
+  {
+    NOTIFY_WORKER_T* ptWorker = &s_ptWorkers[iWorker];
+    uint32_t         ulSlot;
+
+    for(ulSlot = 0; ulSlot < NOTIFY_QUEUE_SIZE; ulSlot++)
+      ptWorker->atQueue[ulSlot].ulSequence = ulSlot;
+
+    sem_init(&ptWorker->tWakeup, 0, 0);
+
+    if(0 != (ret = pthread_create(&ptWorker->tThread, &tAttr, cifXNotifyThread, ptWorker)))
+    {
+      ERR("Failed to create notification callback thread (pthread_create=%d)\n", ret);
+      sem_destroy(&ptWorker->tWakeup);
+      break;
+    }
+  }
+  s_iWorkerCount = iWorker;
+  pthread_attr_destroy(&tAttr);
+
+  if(iWorker != iThreads)
+  {
+    cifXNotifyDispatchStop();
+    return CIFX_DRV_INIT_STATE_ERROR;
+  }
+
+  return CIFX_NO_ERROR;
+}
+
+/*****************************************************************************/
+/*! Stops the callback threads. Notifications queued before are executed.    */
+/*****************************************************************************/
+void cifXNotifyDispatchStop(void)
+{
+  int iWorker;
+
+  if(NULL == s_ptWorkers)
+    return;
+
+  __atomic_store_n(&s_fStop, 1, __ATOMIC_RELEASE);
+
+  for(iWorker = 0; iWorker < s_iWorkerCount; iWorker++)
+  {
+    sem_post(&s_ptWorkers[iWorker].tWakeup);
+    pthread_join(s_ptWorkers[iWorker].tThread, NULL);
+    sem_destroy(&s_ptWorkers[iWorker].tWakeup);
+  }
+
+  if(s_ullOverflows > 0)
+  {
+    DBG("Notification queue overflowed %llu times, consider more callback threads\n", (unsigned long long)s_ullOverflows);
+  }
+
+  free(s_ptWorkers);
+  s_ptWorkers    = NULL;
+  s_iWorkerCount = 0;
+}
+
+/*****************************************************************************/
+/*! Returns the state of the dispatcher
+*   \return !=0 if the callback threads are running                          */
+/*****************************************************************************/
+int cifXNotifyDispatchEnabled(void)
+{
+  return (NULL != s_ptWorkers);
+}
@@ -59,10 +59,6 @@
 #define BLOCK64 sizeof(uint64_t)
 #define BLOCK32 sizeof(uint32_t)
 
-#ifdef VFIO_SUPPORT
-  #define VFIO_IRQ_COUNT 1
-#endif
-
 /*****************************************************************************/
 /*! O/S Specific initialization (initializes libpciaccess)
 *     \return CIFX_NO_ERROR on success                                       */
@@ -109,6 +105,7 @@ void* OS_Memalloc(uint32_t ulSize) {
   void *mem_ptr;
 
   FUNC_TRACE("entry");
+  RT_CHECK_ALLOC();
 
   mem_ptr = malloc(ulSize);
 
@@ -397,33 +394,30 @@ void disable_vfio_irq( PCIFX_DEVICE_INTERNAL_T info) {
     if (ioctl( pfd->vfio_fd, VFIO_DEVICE_SET_IRQS, pfd->irq.vfio_irq_ctrl) < 0) {
       ERR( "Error masking irq (ret=%d)\n", errno);
     }
-    free(pfd->irq.vfio_irq_ctrl);
+    pfd->irq.vfio_irq_ctrl = NULL;
   }
 }
 
 int enable_vfio_irq( PCIFX_DEVICE_INTERNAL_T info) {
-    int ret = -ENOMEM;
     struct vfio_fd* pfd = (struct vfio_fd*)info->userdevice->userparam;
 
     if (pfd == NULL)
       return -EINVAL;
 
-    pfd->irq.vfio_irq_ctrl = malloc(sizeof(struct vfio_irq_set)+(sizeof(uint32_t)*VFIO_IRQ_COUNT));
-    if (pfd->irq.vfio_irq_ctrl != NULL) {
-        pfd->irq.vfio_irq_ctrl->argsz = sizeof(struct vfio_irq_set)+(sizeof(uint32_t)*VFIO_IRQ_COUNT);
-        pfd->irq.vfio_irq_ctrl->index = 0;
-        pfd->irq.vfio_irq_ctrl->start = 0;
-        pfd->irq.vfio_irq_ctrl->count = VFIO_IRQ_COUNT;
-        pfd->irq.vfio_irq_ctrl->flags = (VFIO_IRQ_SET_DATA_EVENTFD|VFIO_IRQ_SET_ACTION_TRIGGER);
-
-        if ((pfd->irq.efd = eventfd( 0, 0)) >= 0) {
-            *((uint32_t*)pfd->irq.vfio_irq_ctrl->data) = pfd->irq.efd;
-            if (ioctl( pfd->vfio_fd, VFIO_DEVICE_SET_IRQS, pfd->irq.vfio_irq_ctrl) == 0)
-              return 0;
-        }
-        ret = -errno;
+    /* the ioctl structure is part of the device, (un-)masking the interrupt does not allocate memory */
+    pfd->irq.vfio_irq_ctrl = (struct vfio_irq_set*)pfd->irq.vfio_irq_buf;
+    pfd->irq.vfio_irq_ctrl->argsz = sizeof(struct vfio_irq_set)+(sizeof(uint32_t)*VFIO_IRQ_COUNT);
+    pfd->irq.vfio_irq_ctrl->index = 0;
+    pfd->irq.vfio_irq_ctrl->start = 0;
+    pfd->irq.vfio_irq_ctrl->count = VFIO_IRQ_COUNT;
+    pfd->irq.vfio_irq_ctrl->flags = (VFIO_IRQ_SET_DATA_EVENTFD|VFIO_IRQ_SET_ACTION_TRIGGER);
+
+    if ((pfd->irq.efd = eventfd( 0, 0)) >= 0) {
+        *((uint32_t*)pfd->irq.vfio_irq_ctrl->data) = pfd->irq.efd;
+        if (ioctl( pfd->vfio_fd, VFIO_DEVICE_SET_IRQS, pfd->irq.vfio_irq_ctrl) == 0)
+          return 0;
     }
-    return ret;
+    return -errno;
 }
 #endif
 
@@ -443,6 +437,8 @@ static void *netx_irq_thread(void *ptr) {
   if(!info)
     return (void *) -1;
 
+  cifXRTPrefaultStack();
+
   /* check if it's an uio device or a custom */
   irq_type = GET_IRQ_TYPE(info);
   while( info->irq_stop == 0 )
@@ -472,7 +468,7 @@ static void *netx_irq_thread(void *ptr) {
           /* This should never happen, as the uio driver already filters our IRQs */
           break;
       }
-      if (irq_type != eCIFX_IRQ_TYPE_GPIO) {
+      if ((irq_type != eCIFX_IRQ_TYPE_GPIO) && (irq_type != eCIFX_IRQ_TYPE_EVENTFD)) {
         /* the kernel module disabled the device irq, so we need to enable it again after processing */
 #ifdef VFIO_SUPPORT
         if (irq_type == eCIFX_IRQ_TYPE_VFIO)
@@ -717,6 +713,7 @@ void* OS_CreateMutex(void) {
   pthread_mutexattr_t attr;
   int                 iRet;
   FUNC_TRACE("entry");
+  RT_CHECK_ALLOC();
 
   if( mut == NULL )
   {
@@ -837,6 +834,7 @@ void* OS_CreateLock(void) {
   int                 iRet;
 
   FUNC_TRACE("entry");
+  RT_CHECK_ALLOC();
 
   pthread_mutexattr_init(&mta);
   if( (iRet = pthread_mutexattr_settype(&mta, PTHREAD_MUTEX_RECURSIVE)) != 0 )
@@ -1040,6 +1038,7 @@ void* OS_CreateEvent(void) {
   int                 iRet;
 
   FUNC_TRACE("entry");
+  RT_CHECK_ALLOC();
 
   if( ev == NULL )
   {
@@ -0,0 +1,313 @@
+// SPDX-License-Identifier: MIT
+/**************************************************************************************
+ *
+ * Copyright (c) 2025, Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserved.
+ *
+ * Description: Packet pool (packet_pool of struct CIFX_LINUX_INIT). Provides CIFX_PACKET
+ *              buffers via xChannelAllocPacket()/xChannelFreePacket().
+ *
+ *              The packets are allocated once by cifXDriverInit() and are aligned to
+ *              cache lines. Free packets are kept in a lock-free stack, its head carries
+ *              a tag, so a packet taken and returned by another thread in between is
+ *              detected. Every thread caches a few free packets, so most calls do not
+ *              access the shared stack at all.
+ *
+ **************************************************************************************/
+
+#include "cifxlinux_internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define PKTPOOL_ALIGN       64          /*!< Alignment of the packets (cache line) */
+#define PKTPOOL_CACHE_SIZE  8           /*!< Max. free packets cached per thread */
+#define PKTPOOL_END         0xFFFFFFFFU /*!< End of the free list */
+
+/*****************************************************************************/
+/*! Free packets cached by a thread                                          */
+/*****************************************************************************/
+typedef struct PKTPOOL_CACHE_Ttag
+{
+  uint32_t ulGeneration;                    /*!< Pool the cached packets belong to (s_ulGeneration) */
+  uint32_t ulCount;                         /*!< Number of cached packets */
+  uint32_t aulPackets[PKTPOOL_CACHE_SIZE];  /*!< Indices of the cached packets */
+} PKTPOOL_CACHE_T;
+
+static uint8_t*       s_pbPackets      = NULL; /*!< Packet memory, NULL if no pool is used */
+static uint32_t       s_ulPacketCount  = 0;
+static size_t         s_tStride        = 0;    /*!< Distance of two packets */
+static uint32_t*      s_pulNext        = NULL; /*!< Free list links (index of the next free packet) */
+static uint64_t       s_ullFreeHead    = 0;    /*!< Tag (upper 32 bits) | index of the first free packet */
+static uint32_t       s_ulCacheLimit   = 0;    /*!< Packets a thread may cache */
+static uint32_t       s_ulGeneration   = 0;    /*!< Incremented on every start, invalidates the thread caches */
+static uint64_t       s_ullExhausted   = 0;    /*!< Number of failed allocations */
+static pthread_key_t  s_tCacheKey;             /*!< Returns the cached packets on thread exit */
+
+static __thread PKTPOOL_CACHE_T s_tCache = {0};
+
+/*****************************************************************************/
+/*! Takes a packet from the free list
+*   \return Packet index, PKTPOOL_END if the pool is empty                   */
+/*****************************************************************************/
+static uint32_t cifXPktPoolPop(void)
+{
+  uint64_t ullHead = __atomic_load_n(&s_ullFreeHead, __ATOMIC_ACQUIRE);
+
+  while(1)
+  {
+    uint32_t ulIdx = (uint32_t)ullHead;
+    uint64_t ullNew;
+
+    if(PKTPOOL_END == ulIdx)
+      return PKTPOOL_END;
+
+    ullNew = ((ullHead + (1ULL << 32)) & 0xFFFFFFFF00000000ULL) |
+             __atomic_load_n(&s_pulNext[ulIdx], __ATOMIC_RELAXED);
+
+    if(__atomic_compare_exchange_n(&s_ullFreeHead, &ullHead, ullNew, 1,
+                                   __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE))
+      return ulIdx;
+  }
+}
+
+/*****************************************************************************/
+/*! Returns a packet to the free list
+*   \param ulIdx  Packet index                                               */
+/*****************************************************************************/
+static void cifXPktPoolPush(uint32_t ulIdx)
+{
+  uint64_t ullHead = __atomic_load_n(&s_ullFreeHead, __ATOMIC_RELAXED);
+  uint64_t ullNew;
+
+  do
+  {
+    __atomic_store_n(&s_pulNext[ulIdx], (uint32_t)ullHead, __ATOMIC_RELAXED);
+    ullNew = ((ullHead + (1ULL << 32)) & 0xFFFFFFFF00000000ULL) | ulIdx;
+
+  } while(!__atomic_compare_exchange_n(&s_ullFreeHead, &ullHead, ullNew, 1,
+                                       __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+/*****************************************************************************/
+/*! Returns the packet cache of the calling thread
+*   \return Packet cache                                                     */
+/*****************************************************************************/
+static PKTPOOL_CACHE_T* cifXPktPoolGetCache(void)
+{
+  PKTPOOL_CACHE_T* ptCache = &s_tCache;
+
+  if(ptCache->ulGeneration != s_ulGeneration)
+  {
+    /* first use in this thread, or the cache holds packets of a previous pool */
+    ptCache->ulGeneration = s_ulGeneration;
+    ptCache->ulCount      = 0;
+    pthread_setspecific(s_tCacheKey, ptCache);
+  }
+
+  return ptCache;
+}
+
+/*****************************************************************************/
+/*! Thread exit handler, returns the packets cached by the thread
+*   \param pvCache  Packet cache of the thread                               */
+/*****************************************************************************/
+static void cifXPktPoolThreadExit(void* pvCache)
+{
+  PKTPOOL_CACHE_T* ptCache = (PKTPOOL_CACHE_T*)pvCache;
+
+  if( (NULL != s_pbPackets) &&
+      (ptCache->ulGeneration == s_ulGeneration) )
+  {
+    while(ptCache->ulCount > 0)
+      cifXPktPoolPush(ptCache->aulPackets[--ptCache->ulCount]);
+  }
+}
+
+/*****************************************************************************/
+/*! Allocates the packet pool
+*   \param ulPackets  Number of packets
+*   \return CIFX_NO_ERROR on success                                         */
+/*****************************************************************************/
+int32_t cifXPacketPoolStart(uint32_t ulPackets)
+{
+  uint32_t ulIdx;
+  int      ret;
+
+  if( (0 == ulPackets) || (PKTPOOL_END == ulPackets) )
+    return CIFX_INVALID_PARAMETER;
+
+  if(NULL != s_pbPackets)
+    return CIFX_DRV_INIT_STATE_ERROR;
+
+  s_tStride = (sizeof(CIFX_PACKET) + PKTPOOL_ALIGN - 1) & ~((size_t)PKTPOOL_ALIGN - 1);
+
+  if(0 != (ret = pthread_key_create(&s_tCacheKey, cifXPktPoolThreadExit)))
+  {
+    ERR("Failed to create the packet pool (pthread_key_create=%d)\n", ret);
+    return CIFX_DRV_INIT_STATE_ERROR;
+  }
+
+  if( (0 != posix_memalign((void**)&s_pbPackets, PKTPOOL_ALIGN, s_tStride * ulPackets)) ||
+      (NULL == (s_pulNext = malloc(ulPackets * sizeof(*s_pulNext)))) )
+  {
+    ERR("Failed to allocate the packet pool (%u packets)\n", ulPackets);
+    free(s_pbPackets);
+    s_pbPackets = NULL;
+    pthread_key_delete(s_tCacheKey);
+    return CIFX_DRV_INIT_STATE_ERROR;
+  }
+
+  /* touch all pages, so the packets do not page fault on first use */
+  memset(s_pbPackets, 0, s_tStride * ulPackets);
+
+  for(ulIdx = 0; ulIdx < ulPackets; ulIdx++)
+    s_pulNext[ulIdx] = ulIdx + 1;
+  s_pulNext[ulPackets - 1] = PKTPOOL_END;
+
+  s_ulPacketCount = ulPackets;
+  s_ullFreeHead   = 0;
+  s_ullExhausted  = 0;
+
+  /* keep most packets available to all threads on small pools */
+  s_ulCacheLimit  = ulPackets / 4;
+  if(s_ulCacheLimit > PKTPOOL_CACHE_SIZE)
+    s_ulCacheLimit = PKTPOOL_CACHE_SIZE;
+
+  __atomic_add_fetch(&s_ulGeneration, 1, __ATOMIC_RELEASE);
+
+  return CIFX_NO_ERROR;
+}
+
+/*****************************************************************************/
+/*! Frees the packet pool. All packets must have been returned.             */
+/*****************************************************************************/
+void cifXPacketPoolStop(void)
+{
+  if(NULL == s_pbPackets)
+    return;
+
+  if(s_ullExhausted > 0)
+  {
+    DBG("Packet pool was exhausted %llu times, consider a larger packet_pool\n", (unsigned long long)s_ullExhausted);
+  }
+
+  pthread_key_delete(s_tCacheKey);
+
+  free(s_pbPackets);
+  free(s_pulNext);
+  s_pbPackets     = NULL;
+  s_pulNext       = NULL;
+  s_ulPacketCount = 0;
+}
+
+/*****************************************************************************/
+/*! Allocates a packet from the packet pool (packet_pool of struct
+*   CIFX_LINUX_INIT), or from the heap if no pool is used
+*   \param hChannel   Channel or system device the packet is used for
+*                     (reserved, the pool is shared by all channels)
+*   \param pptPacket  Returned packet
+*   \return CIFX_NO_ERROR on success, CIFX_NO_MORE_ENTRIES if the pool is
+*           exhausted, CIFX_FUNCTION_FAILED if the heap allocation failed    */
+/*****************************************************************************/
+int32_t xChannelAllocPacket(CIFXHANDLE hChannel, CIFX_PACKET** pptPacket)
+{
+  PKTPOOL_CACHE_T* ptCache;
+  uint32_t         ulIdx;
+
+  UNREFERENCED_PARAMETER(hChannel);
+
+  if(NULL == pptPacket)
+    return CIFX_INVALID_POINTER;
+
+  if(NULL == s_pbPackets)
+  {
+    if(0 != posix_memalign((void**)pptPacket, PKTPOOL_ALIGN, sizeof(CIFX_PACKET)))
+    {
+      *pptPacket = NULL;
+      return CIFX_FUNCTION_FAILED;
+    }
+
+    return CIFX_NO_ERROR;
+  }
+
+  ptCache = cifXPktPoolGetCache();
+
+  if(ptCache->ulCount > 0)
+  {
+    ulIdx = ptCache->aulPackets[--ptCache->ulCount];
+  } else
+  {
+    if(PKTPOOL_END == (ulIdx = cifXPktPoolPop()))
+    {
+      __atomic_add_fetch(&s_ullExhausted, 1, __ATOMIC_RELAXED);
+      *pptPacket = NULL;
+      return CIFX_NO_MORE_ENTRIES;
+    }
+
+    /* refill half of the cache for the next calls */
+    while(ptCache->ulCount < s_ulCacheLimit / 2)
+    {
+      uint32_t ulCached = cifXPktPoolPop();
+
+      if(PKTPOOL_END == ulCached)
+        break;
+
+      ptCache->aulPackets[ptCache->ulCount++] = ulCached;
+    }
+  }
+
+  *pptPacket = (CIFX_PACKET*)(s_pbPackets + ulIdx * s_tStride);
+
+  return CIFX_NO_ERROR;
+}
+
+/*****************************************************************************/
+/*! Returns a packet allocated by xChannelAllocPacket()
+*   \param hChannel  Channel or system device the packet was used for
+*                    (reserved, the pool is shared by all channels)
+*   \param ptPacket  Packet to free
+*   \return CIFX_NO_ERROR on success                                         */
+/*****************************************************************************/
+int32_t xChannelFreePacket(CIFXHANDLE hChannel, CIFX_PACKET* ptPacket)
+{
+  uint8_t*         pbPacket = (uint8_t*)ptPacket;
+  PKTPOOL_CACHE_T* ptCache;
+  uint32_t         ulIdx;
+
+  UNREFERENCED_PARAMETER(hChannel);
+
+  if(NULL == ptPacket)
+    return CIFX_INVALID_POINTER;
+
+  if( (NULL == s_pbPackets)      ||
+      (pbPacket < s_pbPackets)   ||
+      (pbPacket >= s_pbPackets + s_tStride * s_ulPacketCount) )
+  {
+    /* packet was allocated from the heap */
+    free(ptPacket);
+    return CIFX_NO_ERROR;
+  }
+
+  if(0 != (size_t)(pbPacket - s_pbPackets) % s_tStride)
+    return CIFX_INVALID_POINTER;
+
+  ulIdx   = (uint32_t)((size_t)(pbPacket - s_pbPackets) / s_tStride);
+  ptCache = cifXPktPoolGetCache();
+
+  if(ptCache->ulCount >= s_ulCacheLimit)
+  {
+    /* cache is full, make half of it available to the other threads */
+    while(ptCache->ulCount > s_ulCacheLimit / 2)
+      cifXPktPoolPush(ptCache->aulPackets[--ptCache->ulCount]);
+
+    if(ptCache->ulCount >= s_ulCacheLimit)
+    {
+      cifXPktPoolPush(ulIdx);
+      return CIFX_NO_ERROR;
+    }
+  }
+
+  ptCache->aulPackets[ptCache->ulCount++] = ulIdx;
+
+  return CIFX_NO_ERROR;
+}
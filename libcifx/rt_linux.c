@@ -0,0 +1,162 @@
+// SPDX-License-Identifier: MIT
+/**************************************************************************************
+ *
+ * Copyright (c) 2025, Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserved.
+ *
+ * Description: Real-time mode (rt_mode of struct CIFX_LINUX_INIT). Locks the process
+ *              memory, prefaults the stacks of the driver threads and, in debug builds,
+ *              checks that the cyclic toolkit functions (IO, mailbox, DSR) do not
+ *              allocate memory.
+ *
+ **************************************************************************************/
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* pthread_getattr_np() */
+#endif
+
+#include "cifxlinux_internal.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <malloc.h>
+#include <alloca.h>
+#include <errno.h>
+#include <sys/mman.h>
+
+#define RT_STACK_PREFAULT_RESERVE  0x2000  /*!< Stack kept untouched below the caller of cifXRTPrefaultStack() */
+
+static int s_fRTMode = 0;
+
+#ifdef DEBUG
+static __thread int s_iNoAllocDepth = 0; /*!< >0 while the thread executes a CIFX_TKIT_NOALLOC_SCOPE() function */
+#endif
+
+/*****************************************************************************/
+/*! Enables the real-time mode. Locks all current and future pages of the
+*   process and keeps freed heap memory in the process, so later allocations
+*   and new thread stacks do not page fault.
+*   \return CIFX_NO_ERROR on success                                         */
+/*****************************************************************************/
+int32_t cifXRTStart(void)
+{
+  /* never give heap memory back to the kernel and don't use mmap() for large blocks */
+  mallopt(M_TRIM_THRESHOLD, -1);
+  mallopt(M_MMAP_MAX, 0);
+
+  if(0 != mlockall(MCL_CURRENT | MCL_FUTURE))
+  {
+    ERR("Failed to lock the process memory (mlockall, errno=%d). Check RLIMIT_MEMLOCK / CAP_IPC_LOCK.\n", errno);
+    return CIFX_DRV_INIT_STATE_ERROR;
+  }
+
+  s_fRTMode = 1;
+
+  return CIFX_NO_ERROR;
+}
+
+/*****************************************************************************/
+/*! Disables the checks of the real-time mode. The memory stays locked, as
+*   the application may rely on it.                                          */
+/*****************************************************************************/
+void cifXRTStop(void)
+{
+  s_fRTMode = 0;
+}
+
+/*****************************************************************************/
+/*! Returns the state of the real-time mode
+*   \return !=0 if the real-time mode is enabled                             */
+/*****************************************************************************/
+int cifXRTEnabled(void)
+{
+  return s_fRTMode;
+}
+
+/*****************************************************************************/
+/*! Sets the stack size of a driver thread, which would otherwise use the
+*   default stack size (usually 8MB, which would be locked completely)
+*   \param ptAttr  Thread attributes                                         */
+/*****************************************************************************/
+void cifXRTSetThreadStack(pthread_attr_t* ptAttr)
+{
+  int ret;
+
+  if(!s_fRTMode)
+    return;
+
+  if(0 != (ret = pthread_attr_setstacksize(ptAttr, PTHREAD_STACK_MIN + RT_THREAD_STACK_SIZE)))
+    ERR("Failed to set the stack size of a real-time thread (pthread_attr_setstacksize=%d)\n", ret);
+}
+
+/*****************************************************************************/
+/*! Touches the unused stack of the calling driver thread, so all pages are
+*   mapped before the thread starts its cyclic work. Must be called at the
+*   beginning of the thread function.                                        */
+/*****************************************************************************/
+void cifXRTPrefaultStack(void)
+{
+  pthread_attr_t tAttr;
+  void*          pvStack     = NULL;
+  size_t         tStackSize  = 0;
+
+  if(!s_fRTMode)
+    return;
+
+  if(0 != pthread_getattr_np(pthread_self(), &tAttr))
+    return;
+
+  if(0 == pthread_attr_getstack(&tAttr, &pvStack, &tStackSize))
+  {
+    char   bMarker;
+    size_t tUsed = (size_t)(((char*)pvStack + tStackSize) - &bMarker);
+
+    if(tStackSize > tUsed + RT_STACK_PREFAULT_RESERVE)
+    {
+      size_t         tLen     = tStackSize - tUsed - RT_STACK_PREFAULT_RESERVE;
+      long           lPage    = sysconf(_SC_PAGESIZE);
+      volatile char* pbStack  = (volatile char*)alloca(tLen);
+      size_t         tOffset;
+
+      for(tOffset = 0; tOffset < tLen; tOffset += (size_t)lPage)
+        pbStack[tOffset] = 0;
+    }
+  }
+  pthread_attr_destroy(&tAttr);
+}
+
+#ifdef DEBUG
+/*****************************************************************************/
+/*! Enters a function, which must not allocate memory (see
+*   CIFX_TKIT_NOALLOC_SCOPE())
+*   \return Actual nesting depth                                             */
+/*****************************************************************************/
+int OS_NoAllocEnter(void)
+{
+  return ++s_iNoAllocDepth;
+}
+
+/*****************************************************************************/
+/*! Leaves a function, which must not allocate memory (cleanup handler of
+*   CIFX_TKIT_NOALLOC_SCOPE())
+*   \param piScope  Scope variable (unused)                                  */
+/*****************************************************************************/
+void OS_NoAllocLeave(int* piScope)
+{
+  UNREFERENCED_PARAMETER(piScope);
+  --s_iNoAllocDepth;
+}
+
+/*****************************************************************************/
+/*! Aborts, if memory is allocated in a function, which must not allocate
+*   memory, while the real-time mode is enabled
+*   \param szFunction  Allocating function                                   */
+/*****************************************************************************/
+void cifXRTCheckAlloc(const char* szFunction)
+{
+  if(s_fRTMode && (s_iNoAllocDepth > 0))
+  {
+    ERR("%s() called in a real-time path (IO, mailbox or DSR)\n", szFunction);
+    abort();
+  }
+}
+#endif
@@ -7,6 +7,10 @@
  *
  **************************************************************************************/
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* CPU_SETSIZE */
+#endif
+
 #include "cifXToolkit.h"
 #include <sys/types.h>
 #include <sys/time.h>
@@ -19,6 +23,9 @@
 #include <errno.h>
 #include <sys/stat.h>
 #include <ctype.h>
+#include <limits.h>
+#include <sys/inotify.h>
+#include <sched.h>
 #include "WarmstartFile.h"
 #include "cifxlinux_internal.h"
 
@@ -28,6 +35,11 @@ static const char* DEVICE_CONF_ALIAS_KEY    = "alias=";
 static const char* DEVICE_CONF_IRQ_KEY      = "irq=";
 static const char* DEVICE_CONF_IRQPRIO_KEY  = "irqprio=";
 static const char* DEVICE_CONF_IRQSCHED_KEY = "irqsched=";
+static const char* DEVICE_CONF_POLLINT_KEY  = "pollinterval=";
+static const char* DEVICE_CONF_POLLCPU_KEY  = "pollcpu=";
+static const char* DEVICE_CONF_IODELTA_KEY  = "iodelta=";
+
+#define IO_DELTA_WRITE_MERGE_GAP  32 /*!< Default unchanged bytes written along to join two changed runs (iodelta=yes) */
 #ifdef CIFX_TOOLKIT_DMA
 static const char* DEVICE_CONF_DMA          = "dma=";
 #endif
@@ -108,67 +120,6 @@ char* ToLowerCase( char* str, int len) {
   return str;
 }
 
-/*****************************************************************************/
-/*! Reads a value from an config file (ini-file style)
-*     \param szFile   Path to the ini file
-*     \param szKey    Key to search for (including trailing '=')
-*     \param szValue  Pointer to returned value (needs to be free'd by caller)
-*     \return !=0 on success                                                 */
-/*****************************************************************************/
-static int GetDeviceConfigString(const char* szFile, const char* szKey, char** szValue)
-{
-  int   ret = 0;
-  FILE* fd  = fopen(szFile, "r");
-
-  if(NULL != fd)
-  {
-    /* File is open */
-    char* buffer = malloc(PARSER_BUFFER_SIZE);
-
-    /* Read file line by line */
-    while(NULL != fgets(buffer, PARSER_BUFFER_SIZE, fd))
-    {
-      char* key;
-
-      /* '#' marks a comment line in the device.conf file */
-      if(buffer[0] == '#')
-        continue;
-
-      /* Search for key in the input buffer */
-      key = strstr(ToLowerCase(buffer, strlen(szKey)), szKey);
-
-      if(NULL != key)
-      {
-        /* We've found the key */
-        int   allocsize  = strlen(key + strlen(szKey)) + 1;
-        int   valuelen;
-        char* tempstring = (char*)malloc(allocsize);
-
-        strcpy(tempstring, key + strlen(szKey));
-        valuelen = strlen(tempstring);
-
-        /* strip all trailing whitespaces */
-        while( (tempstring[valuelen - 1] == '\n') ||
-               (tempstring[valuelen - 1] == '\r') ||
-               (tempstring[valuelen - 1] == ' ') )
-        {
-          tempstring[valuelen - 1] = '\0';
-          --valuelen;
-        }
-
-        *szValue = tempstring;
-        ret = 1;
-        break;
-      }
-    }
-
-    free(buffer);
-    fclose(fd);
-  }
-
-  return ret;
-}
-
 int path_exists(char* szPath)
 {
   struct stat s;
@@ -271,6 +222,387 @@ exit:
   return;
 }
 
+/*****************************************************************************/
+/*! Cached directory listing                                                 */
+/*****************************************************************************/
+typedef struct CIFX_DIR_CACHE_Ttag
+{
+  int      valid;                              /*!< !=0 if path and files are set */
+  char     path[CIFX_MAX_FILE_NAME_LENGTH];    /*!< Resolved directory */
+  char**   files;                              /*!< Entries with a file extension, in readdir() order */
+  uint32_t file_cnt;
+
+} CIFX_DIR_CACHE_T;
+
+/*****************************************************************************/
+/*! Per device configuration cache. device.conf and the directory listings
+*   are read once and kept until a change is reported via inotify or the
+*   cache is invalidated explicitly (cifXDriverReloadDeviceConfig()).       */
+/*****************************************************************************/
+struct CIFX_CONFIG_CACHE_T
+{
+  pthread_mutex_t  lock;
+  int              valid;          /*!< !=0 if the cache belongs to the identification below */
+  int              inotify_fd;     /*!< Change notification, -1 if not available (cache is rebuilt on every access) */
+  uint32_t         device_number;  /*!< Identification the paths were resolved for */
+  uint32_t         serial_number;
+  uint32_t         slot_number;
+
+  int              conf_valid;     /*!< !=0 if device.conf was read */
+  char**           conf_lines;     /*!< Lines of device.conf (without comments) */
+  uint32_t         conf_line_cnt;
+
+  CIFX_DIR_CACHE_T device_dir;
+  CIFX_DIR_CACHE_T channel_dir[CIFX_MAX_NUMBER_OF_CHANNELS];
+};
+
+#define CONFIG_WATCH_MASK (IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_CLOSE_WRITE | \
+                           IN_MODIFY | IN_ATTRIB | IN_DELETE_SELF | IN_MOVE_SELF)
+
+static void FreeStringList(char** list, uint32_t cnt)
+{
+  uint32_t idx;
+
+  for(idx = 0; idx < cnt; idx++)
+    free(list[idx]);
+  free(list);
+}
+
+static int AppendString(char*** list, uint32_t* cnt, const char* str)
+{
+  char** newlist = realloc(*list, (*cnt + 1) * sizeof(char*));
+
+  if(NULL == newlist)
+    return 0;
+
+  *list = newlist;
+  if(NULL == (newlist[*cnt] = strdup(str)))
+    return 0;
+
+  ++(*cnt);
+  return 1;
+}
+
+static void FreeDirCache(CIFX_DIR_CACHE_T* dir)
+{
+  FreeStringList(dir->files, dir->file_cnt);
+  dir->files    = NULL;
+  dir->file_cnt = 0;
+  dir->valid    = 0;
+}
+
+/*****************************************************************************/
+/*! Reads the directory listing into the cache
+*     \param dir    Cache entry (path must be set)                           */
+/*****************************************************************************/
+static void LoadDirCache(CIFX_DIR_CACHE_T* dir)
+{
+  DIR* dirp;
+
+  dir->files    = NULL;
+  dir->file_cnt = 0;
+
+  if(NULL != (dirp = opendir(dir->path)))
+  {
+    struct dirent* dirent;
+
+    while(NULL != (dirent = readdir(dirp)))
+    {
+      /* only files with an extension are of interest */
+      if(NULL != strstr(dirent->d_name, "."))
+        AppendString(&dir->files, &dir->file_cnt, dirent->d_name);
+    }
+    closedir(dirp);
+  }
+  dir->valid = 1;
+}
+
+/*****************************************************************************/
+/*! Drops all cached data of a device                                       */
+/*****************************************************************************/
+static void ClearConfigCache(struct CIFX_CONFIG_CACHE_T* cache)
+{
+  int idx;
+
+  if(cache->inotify_fd >= 0)
+    close(cache->inotify_fd);
+  cache->inotify_fd = -1;
+
+  FreeStringList(cache->conf_lines, cache->conf_line_cnt);
+  cache->conf_lines    = NULL;
+  cache->conf_line_cnt = 0;
+  cache->conf_valid    = 0;
+
+  FreeDirCache(&cache->device_dir);
+  for(idx = 0; idx < CIFX_MAX_NUMBER_OF_CHANNELS; idx++)
+    FreeDirCache(&cache->channel_dir[idx]);
+
+  cache->valid = 0;
+}
+
+static void WatchConfigDir(struct CIFX_CONFIG_CACHE_T* cache, const char* szPath)
+{
+  /* non existing directories are watched via their parent (IN_CREATE) */
+  if(cache->inotify_fd >= 0)
+    (void)inotify_add_watch(cache->inotify_fd, szPath, CONFIG_WATCH_MASK);
+}
+
+/*****************************************************************************/
+/*! Locks and validates the configuration cache of a device. The cache is
+*   dropped, if the device identification changed or inotify reported a
+*   change of the watched directories.
+*     \param ptDevInfo  Device information
+*     \return Locked cache, release with UnlockConfigCache()                 */
+/*****************************************************************************/
+static struct CIFX_CONFIG_CACHE_T* LockConfigCache(PCIFX_DEVICE_INFORMATION ptDevInfo)
+{
+  PCIFX_DEVICE_INTERNAL_T     internaldev = (PCIFX_DEVICE_INTERNAL_T)ptDevInfo->ptDeviceInstance->pvOSDependent;
+  struct CIFX_CONFIG_CACHE_T* cache       = internaldev->config_cache;
+  uint32_t                    ulSlotNr    = ptDevInfo->ptDeviceInstance->ulSlotNumber;
+
+  pthread_mutex_lock(&cache->lock);
+
+  if(cache->valid)
+  {
+    if( (cache->inotify_fd < 0)                            ||
+        (cache->device_number != ptDevInfo->ulDeviceNumber) ||
+        (cache->serial_number != ptDevInfo->ulSerialNumber) ||
+        (cache->slot_number   != ulSlotNr) )
+    {
+      ClearConfigCache(cache);
+    } else
+    {
+      char buffer[sizeof(struct inotify_event) + NAME_MAX + 1];
+
+      /* any event invalidates the complete cache */
+      if(read(cache->inotify_fd, buffer, sizeof(buffer)) > 0)
+        ClearConfigCache(cache);
+    }
+  }
+
+  if(!cache->valid)
+  {
+    char szPath[CIFX_MAX_FILE_NAME_LENGTH];
+
+    cache->valid         = 1;
+    cache->device_number = ptDevInfo->ulDeviceNumber;
+    cache->serial_number = ptDevInfo->ulSerialNumber;
+    cache->slot_number   = ulSlotNr;
+    cache->inotify_fd    = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+    /* watch all directories taking part in the path lookup of GetDeviceDir() / GetChannelDir() */
+    snprintf(szPath, sizeof(szPath), "%s/deviceconfig/", g_szDriverBaseDir);
+    WatchConfigDir(cache, szPath);
+    snprintf(szPath, sizeof(szPath), "%s/deviceconfig/%d/", g_szDriverBaseDir, (unsigned int)ptDevInfo->ulDeviceNumber);
+    WatchConfigDir(cache, szPath);
+    if(ulSlotNr)
+    {
+      snprintf(szPath, sizeof(szPath), "%s/deviceconfig/Slot_%d/", g_szDriverBaseDir, (unsigned int)ulSlotNr);
+      WatchConfigDir(cache, szPath);
+    }
+    snprintf(szPath, sizeof(szPath), "%s/deviceconfig/%d/%d/", g_szDriverBaseDir,
+             (unsigned int)ptDevInfo->ulDeviceNumber, (unsigned int)ptDevInfo->ulSerialNumber);
+    WatchConfigDir(cache, szPath);
+    snprintf(szPath, sizeof(szPath), "%s/deviceconfig/%s/", g_szDriverBaseDir, ptDevInfo->ptDeviceInstance->szName);
+    WatchConfigDir(cache, szPath);
+    snprintf(szPath, sizeof(szPath), "%s/deviceconfig/FW/", g_szDriverBaseDir);
+    WatchConfigDir(cache, szPath);
+  }
+
+  return cache;
+}
+
+static void UnlockConfigCache(struct CIFX_CONFIG_CACHE_T* cache)
+{
+  pthread_mutex_unlock(&cache->lock);
+}
+
+/*****************************************************************************/
+/*! Returns the cached device directory (cache must be locked)
+*     \param cache      Device configuration cache
+*     \param ptDevInfo  Device information
+*     \return Device directory listing                                       */
+/*****************************************************************************/
+static CIFX_DIR_CACHE_T* GetDeviceDirCache(struct CIFX_CONFIG_CACHE_T* cache, PCIFX_DEVICE_INFORMATION ptDevInfo)
+{
+  if(!cache->device_dir.valid)
+  {
+    GetDeviceDir(cache->device_dir.path, sizeof(cache->device_dir.path), ptDevInfo);
+    LoadDirCache(&cache->device_dir);
+  }
+  return &cache->device_dir;
+}
+
+/*****************************************************************************/
+/*! Returns the cached channel directory (cache must be locked). Channels
+*   outside of the cache are read into ptTemp, which must be released via
+*   FreeDirCache() by the caller.
+*     \param cache      Device configuration cache
+*     \param ptDevInfo  Device information
+*     \param ptTemp     Temporary listing for uncached channels
+*     \return Channel directory listing                                      */
+/*****************************************************************************/
+static CIFX_DIR_CACHE_T* GetChannelDirCache(struct CIFX_CONFIG_CACHE_T* cache, PCIFX_DEVICE_INFORMATION ptDevInfo, CIFX_DIR_CACHE_T* ptTemp)
+{
+  CIFX_DIR_CACHE_T* dir = ptTemp;
+
+  if(ptDevInfo->ulChannel < CIFX_MAX_NUMBER_OF_CHANNELS)
+    dir = &cache->channel_dir[ptDevInfo->ulChannel];
+
+  if(!dir->valid)
+  {
+    GetChannelDir(dir->path, sizeof(dir->path), ptDevInfo);
+    LoadDirCache(dir);
+    if(dir != ptTemp)
+      WatchConfigDir(cache, dir->path);
+  }
+  return dir;
+}
+
+/*****************************************************************************/
+/*! Reads the device.conf of a device into the cache (cache must be locked)
+*     \param cache      Device configuration cache
+*     \param ptDevInfo  Device information                                   */
+/*****************************************************************************/
+static void LoadDeviceConfig(struct CIFX_CONFIG_CACHE_T* cache, PCIFX_DEVICE_INFORMATION ptDevInfo)
+{
+  char  szFile[CIFX_MAX_FILE_NAME_LENGTH + 16];
+  FILE* fd;
+
+  snprintf(szFile, sizeof(szFile), "%s/device.conf", GetDeviceDirCache(cache, ptDevInfo)->path);
+
+  if(NULL != (fd = fopen(szFile, "r")))
+  {
+    char* buffer = malloc(PARSER_BUFFER_SIZE);
+
+    /* Read file line by line */
+    while( (NULL != buffer) && (NULL != fgets(buffer, PARSER_BUFFER_SIZE, fd)) )
+    {
+      /* '#' marks a comment line in the device.conf file */
+      if(buffer[0] == '#')
+        continue;
+
+      AppendString(&cache->conf_lines, &cache->conf_line_cnt, buffer);
+    }
+
+    free(buffer);
+    fclose(fd);
+  }
+  cache->conf_valid = 1;
+}
+
+/*****************************************************************************/
+/*! Reads a value from the device.conf of a device (ini-file style)
+*     \param ptDevInfo  Device information
+*     \param szKey      Key to search for (including trailing '=')
+*     \param szValue    Pointer to returned value (needs to be free'd by caller)
+*     \return !=0 on success                                                 */
+/*****************************************************************************/
+static int GetDeviceConfigString(PCIFX_DEVICE_INFORMATION ptDevInfo, const char* szKey, char** szValue)
+{
+  struct CIFX_CONFIG_CACHE_T* cache = LockConfigCache(ptDevInfo);
+  int                         ret   = 0;
+  uint32_t                    line;
+
+  if(!cache->conf_valid)
+    LoadDeviceConfig(cache, ptDevInfo);
+
+  for(line = 0; line < cache->conf_line_cnt; line++)
+  {
+    char  buffer[PARSER_BUFFER_SIZE];
+    char* key;
+
+    snprintf(buffer, sizeof(buffer), "%s", cache->conf_lines[line]);
+
+    /* Search for key in the input buffer */
+    key = strstr(ToLowerCase(buffer, strlen(szKey)), szKey);
+
+    if(NULL != key)
+    {
+      /* We've found the key */
+      char* tempstring = strdup(key + strlen(szKey));
+      int   valuelen;
+
+      if(NULL == tempstring)
+        break;
+
+      valuelen = strlen(tempstring);
+
+      /* strip all trailing whitespaces */
+      while( (valuelen > 0) &&
+             ((tempstring[valuelen - 1] == '\n') ||
+              (tempstring[valuelen - 1] == '\r') ||
+              (tempstring[valuelen - 1] == ' ')) )
+      {
+        tempstring[valuelen - 1] = '\0';
+        --valuelen;
+      }
+
+      *szValue = tempstring;
+      ret = 1;
+      break;
+    }
+  }
+
+  UnlockConfigCache(cache);
+
+  return ret;
+}
+
+/*****************************************************************************/
+/*! Creates the (empty) configuration cache of a device
+*     \param internaldev  Device
+*     \return CIFX_NO_ERROR on success                                       */
+/*****************************************************************************/
+int32_t cifXConfigCacheCreate(PCIFX_DEVICE_INTERNAL_T internaldev)
+{
+  struct CIFX_CONFIG_CACHE_T* cache = calloc(1, sizeof(*cache));
+
+  if(NULL == cache)
+    return CIFX_INVALID_POINTER;
+
+  pthread_mutex_init(&cache->lock, NULL);
+  cache->inotify_fd = -1;
+
+  internaldev->config_cache = cache;
+
+  return CIFX_NO_ERROR;
+}
+
+/*****************************************************************************/
+/*! Drops the cached configuration of a device, it will be read again on the
+*   next access
+*     \param internaldev  Device                                             */
+/*****************************************************************************/
+void cifXConfigCacheInvalidate(PCIFX_DEVICE_INTERNAL_T internaldev)
+{
+  struct CIFX_CONFIG_CACHE_T* cache = internaldev->config_cache;
+
+  if(NULL != cache)
+  {
+    pthread_mutex_lock(&cache->lock);
+    ClearConfigCache(cache);
+    pthread_mutex_unlock(&cache->lock);
+  }
+}
+
+/*****************************************************************************/
+/*! Frees the configuration cache of a device
+*     \param internaldev  Device                                             */
+/*****************************************************************************/
+void cifXConfigCacheFree(PCIFX_DEVICE_INTERNAL_T internaldev)
+{
+  struct CIFX_CONFIG_CACHE_T* cache = internaldev->config_cache;
+
+  if(NULL != cache)
+  {
+    ClearConfigCache(cache);
+    pthread_mutex_destroy(&cache->lock);
+    free(cache);
+    internaldev->config_cache = NULL;
+  }
+}
+
 /*****************************************************************************/
 /*! Returns the number of firmware files to be downloaded on the given
 *   device/channel
@@ -279,31 +611,26 @@ exit:
 /*****************************************************************************/
 uint32_t USER_GetFirmwareFileCount(PCIFX_DEVICE_INFORMATION ptDevInfo)
 {
-  char          szPath[CIFX_MAX_FILE_NAME_LENGTH];
-  unsigned long ulRet = 0;
-  DIR*          dir;
-
-  GetChannelDir(szPath, sizeof(szPath), ptDevInfo);
+  struct CIFX_CONFIG_CACHE_T* cache = LockConfigCache(ptDevInfo);
+  CIFX_DIR_CACHE_T            tTemp = {0};
+  CIFX_DIR_CACHE_T*           dir   = GetChannelDirCache(cache, ptDevInfo, &tTemp);
+  unsigned long               ulRet = 0;
+  uint32_t                    ulEntry;
 
-  if(NULL != (dir = opendir(szPath)))
+  for(ulEntry = 0; ulEntry < dir->file_cnt; ulEntry++)
   {
-    struct dirent* dirent;
+    char* szExt = strstr(dir->files[ulEntry], ".");
 
-    while(NULL != (dirent = readdir(dir)))
+    if( (0 == strncasecmp(szExt, HIL_FILE_EXTENSION_FIRMWARE, 4)) ||
+        (0 == strncasecmp(szExt, HIL_FILE_EXTENSION_OPTION, 4)) )
     {
-      char* szExt = strstr(dirent->d_name, ".");
-      if(NULL != szExt)
-      {
-        if( (0 == strncasecmp(szExt, HIL_FILE_EXTENSION_FIRMWARE, 4)) ||
-            (0 == strncasecmp(szExt, HIL_FILE_EXTENSION_OPTION, 4)) )
-        {
-          ++ulRet;
-        }
-      }
+      ++ulRet;
     }
-    closedir(dir);
   }
 
+  FreeDirCache(&tTemp);
+  UnlockConfigCache(cache);
+
   return ulRet;
 }
 
@@ -316,40 +643,35 @@ uint32_t USER_GetFirmwareFileCount(PCIFX_DEVICE_INFORMATION ptDevInfo)
 /*****************************************************************************/
 int USER_GetFirmwareFile(PCIFX_DEVICE_INFORMATION ptDevInfo, uint32_t ulIdx,  PCIFX_FILE_INFORMATION ptFileInfo)
 {
-  char          szPath[CIFX_MAX_FILE_NAME_LENGTH];
-  int           ret   = 0;
-  DIR*          dir;
-
-  GetChannelDir(szPath, sizeof(szPath), ptDevInfo);
-
-  if(NULL != (dir = opendir(szPath)))
+  struct CIFX_CONFIG_CACHE_T* cache  = LockConfigCache(ptDevInfo);
+  CIFX_DIR_CACHE_T            tTemp  = {0};
+  CIFX_DIR_CACHE_T*           dir    = GetChannelDirCache(cache, ptDevInfo, &tTemp);
+  int                         ret    = 0;
+  unsigned long               ulFile = 0;
+  uint32_t                    ulEntry;
+
+  for(ulEntry = 0; ulEntry < dir->file_cnt; ulEntry++)
   {
-    struct dirent* dirent;
-    unsigned long  ulFile = 0;
+    char* szExt = strstr(dir->files[ulEntry], ".");
 
-    while(NULL != (dirent = readdir(dir)))
+    if( (0 == strncasecmp(szExt, HIL_FILE_EXTENSION_FIRMWARE, 4)) ||
+        (0 == strncasecmp(szExt, HIL_FILE_EXTENSION_OPTION, 4)) )
     {
-      char* szExt = strstr(dirent->d_name, ".");
-      if(NULL != szExt)
+      if(ulFile++ == ulIdx)
       {
-        if( (0 == strncasecmp(szExt, HIL_FILE_EXTENSION_FIRMWARE, 4)) ||
-            (0 == strncasecmp(szExt, HIL_FILE_EXTENSION_OPTION, 4)) )
-        {
-          if(ulFile++ == ulIdx)
-          {
-            snprintf(ptFileInfo->szFullFileName, sizeof(ptFileInfo->szFullFileName),
-                     "%s/%s", szPath, dirent->d_name);
-            strncpy(ptFileInfo->szShortFileName, dirent->d_name,
-                    sizeof(ptFileInfo->szShortFileName));
-            ret = 1;
-            break;
-          }
-        }
+        snprintf(ptFileInfo->szFullFileName, sizeof(ptFileInfo->szFullFileName),
+                 "%s/%s", dir->path, dir->files[ulEntry]);
+        strncpy(ptFileInfo->szShortFileName, dir->files[ulEntry],
+                sizeof(ptFileInfo->szShortFileName));
+        ret = 1;
+        break;
       }
     }
-    closedir(dir);
   }
 
+  FreeDirCache(&tTemp);
+  UnlockConfigCache(cache);
+
   return ret;
 }
 
@@ -361,30 +683,25 @@ int USER_GetFirmwareFile(PCIFX_DEVICE_INFORMATION ptDevInfo, uint32_t ulIdx,  PC
 /*****************************************************************************/
 uint32_t USER_GetConfigurationFileCount(PCIFX_DEVICE_INFORMATION ptDevInfo)
 {
-  char          szPath[CIFX_MAX_FILE_NAME_LENGTH];
-  unsigned long ulRet = 0;
-  DIR*          dir;
-
-  GetChannelDir(szPath, sizeof(szPath), ptDevInfo);
+  struct CIFX_CONFIG_CACHE_T* cache = LockConfigCache(ptDevInfo);
+  CIFX_DIR_CACHE_T            tTemp = {0};
+  CIFX_DIR_CACHE_T*           dir   = GetChannelDirCache(cache, ptDevInfo, &tTemp);
+  unsigned long               ulRet = 0;
+  uint32_t                    ulEntry;
 
-  if(NULL != (dir = opendir(szPath)))
+  for(ulEntry = 0; ulEntry < dir->file_cnt; ulEntry++)
   {
-    struct dirent* dirent;
+    char* szExt = strstr(dir->files[ulEntry], ".");
 
-    while(NULL != (dirent = readdir(dir)))
+    if(0 == strncasecmp(szExt, HIL_FILE_EXTENSION_DATABASE, 4))
     {
-      char* szExt = strstr(dirent->d_name, ".");
-      if(NULL != szExt)
-      {
-        if(0 == strncasecmp(szExt, HIL_FILE_EXTENSION_DATABASE, 4))
-        {
-          ++ulRet;
-        }
-      }
+      ++ulRet;
     }
-    closedir(dir);
   }
 
+  FreeDirCache(&tTemp);
+  UnlockConfigCache(cache);
+
   return ulRet;
 }
 
@@ -397,39 +714,34 @@ uint32_t USER_GetConfigurationFileCount(PCIFX_DEVICE_INFORMATION ptDevInfo)
 /*****************************************************************************/
 int USER_GetConfigurationFile(PCIFX_DEVICE_INFORMATION ptDevInfo, uint32_t ulIdx, PCIFX_FILE_INFORMATION ptFileInfo)
 {
-  char          szPath[CIFX_MAX_FILE_NAME_LENGTH];
-  int           ret   = 0;
-  DIR*          dir;
-
-  GetChannelDir(szPath, sizeof(szPath), ptDevInfo);
-
-  if(NULL != (dir = opendir(szPath)))
+  struct CIFX_CONFIG_CACHE_T* cache  = LockConfigCache(ptDevInfo);
+  CIFX_DIR_CACHE_T            tTemp  = {0};
+  CIFX_DIR_CACHE_T*           dir    = GetChannelDirCache(cache, ptDevInfo, &tTemp);
+  int                         ret    = 0;
+  unsigned long               ulFile = 0;
+  uint32_t                    ulEntry;
+
+  for(ulEntry = 0; ulEntry < dir->file_cnt; ulEntry++)
   {
-    struct dirent* dirent;
-    unsigned long  ulFile = 0;
+    char* szExt = strstr(dir->files[ulEntry], ".");
 
-    while(NULL != (dirent = readdir(dir)))
+    if(0 == strncasecmp(szExt, HIL_FILE_EXTENSION_DATABASE, 4))
     {
-      char* szExt = strstr(dirent->d_name, ".");
-      if(NULL != szExt)
+      if(ulFile++ == ulIdx)
       {
-        if(0 == strncasecmp(szExt, HIL_FILE_EXTENSION_DATABASE, 4))
-        {
-          if(ulFile++ == ulIdx)
-          {
-            snprintf(ptFileInfo->szFullFileName, sizeof(ptFileInfo->szFullFileName),
-                     "%s/%s", szPath, dirent->d_name);
-            strncpy(ptFileInfo->szShortFileName, dirent->d_name,
-                    sizeof(ptFileInfo->szShortFileName));
-            ret = 1;
-            break;
-          }
-        }
+        snprintf(ptFileInfo->szFullFileName, sizeof(ptFileInfo->szFullFileName),
+                 "%s/%s", dir->path, dir->files[ulEntry]);
+        strncpy(ptFileInfo->szShortFileName, dir->files[ulEntry],
+                sizeof(ptFileInfo->szShortFileName));
+        ret = 1;
+        break;
       }
     }
-    closedir(dir);
   }
 
+  FreeDirCache(&tTemp);
+  UnlockConfigCache(cache);
+
   return ret;
 }
 
@@ -443,12 +755,15 @@ int USER_GetConfigurationFile(PCIFX_DEVICE_INFORMATION ptDevInfo, uint32_t ulIdx
 int USER_GetWarmstartParameters(PCIFX_DEVICE_INFORMATION ptDevInfo, CIFX_PACKET* ptPacket)
 {
   int           ret = 0;
-  char          szFile[CIFX_MAX_FILE_NAME_LENGTH];
+  char          szFile[CIFX_MAX_FILE_NAME_LENGTH + 16];
   void*         pvFile;
   uint32_t ulFileLen;
+  struct CIFX_CONFIG_CACHE_T* cache = LockConfigCache(ptDevInfo);
+  CIFX_DIR_CACHE_T            tTemp = {0};
 
-  GetChannelDir(szFile, sizeof(szFile), ptDevInfo);
-  strcat(szFile, "warmstart.dat");
+  snprintf(szFile, sizeof(szFile), "%swarmstart.dat", GetChannelDirCache(cache, ptDevInfo, &tTemp)->path);
+  FreeDirCache(&tTemp);
+  UnlockConfigCache(cache);
 
   pvFile = OS_FileOpen(szFile, &ulFileLen);
 
@@ -601,14 +916,10 @@ void USER_GetBootloaderFile(PDEVICEINSTANCE ptDevInstance, PCIFX_FILE_INFORMATIO
 /*****************************************************************************/
 void USER_GetAliasName(PCIFX_DEVICE_INFORMATION ptDevInfo, uint32_t ulMaxLen, char* szAlias)
 {
-  char  szFile[CIFX_MAX_FILE_NAME_LENGTH];
   char* szTempAlias = NULL;
 
-  GetDeviceDir(szFile, sizeof(szFile), ptDevInfo);
-  strcat(szFile, "/device.conf");
-
   /* Read alias from file */
-  if(GetDeviceConfigString(szFile, DEVICE_CONF_ALIAS_KEY, &szTempAlias))
+  if(GetDeviceConfigString(ptDevInfo, DEVICE_CONF_ALIAS_KEY, &szTempAlias))
   {
     strncpy(szAlias, szTempAlias, ulMaxLen);
     free(szTempAlias);
@@ -626,38 +937,99 @@ void USER_GetAliasName(PCIFX_DEVICE_INFORMATION ptDevInfo, uint32_t ulMaxLen, ch
 /*****************************************************************************/
 int USER_GetOSFile(PCIFX_DEVICE_INFORMATION ptDevInfo, PCIFX_FILE_INFORMATION ptFileInfo)
 {
-  char          szPath[CIFX_MAX_FILE_NAME_LENGTH];
-  int           ret   = 0;
-  DIR*          dir;
+  struct CIFX_CONFIG_CACHE_T* cache = LockConfigCache(ptDevInfo);
+  CIFX_DIR_CACHE_T*           dir   = GetDeviceDirCache(cache, ptDevInfo);
+  int                         ret   = 0;
+  uint32_t                    ulEntry;
+
+  for(ulEntry = 0; ulEntry < dir->file_cnt; ulEntry++)
+  {
+    char* szExt = strstr(dir->files[ulEntry], ".");
+
+    if(0 == strncasecmp(szExt, HIL_FILE_EXTENSION_FIRMWARE, 4))
+    {
+      snprintf(ptFileInfo->szFullFileName, sizeof(ptFileInfo->szFullFileName),
+              "%s/%s", dir->path, dir->files[ulEntry]);
+      strncpy(ptFileInfo->szShortFileName, dir->files[ulEntry],
+              sizeof(ptFileInfo->szShortFileName));
+      ret = 1;
+      break;
+    }
+  }
 
-  GetDeviceDir(szPath, sizeof(szPath), ptDevInfo);
+  UnlockConfigCache(cache);
 
-  if(NULL != (dir = opendir(szPath)))
+  return ret;
+}
+
+
+/*****************************************************************************/
+/*! Read the polling mode configuration of a device (poll period in ms and
+*   CPU of the polling thread)
+*     \param ptDevInfo  Device information                                   */
+/*****************************************************************************/
+static void GetPollingConfig(PCIFX_DEVICE_INFORMATION ptDevInfo)
+{
+  PCIFX_DEVICE_INTERNAL_T internaldev = (PCIFX_DEVICE_INTERNAL_T)ptDevInfo->ptDeviceInstance->pvOSDependent;
+  char*                   szTempData  = NULL;
+
+  internaldev->poll_interval_us = 0;
+  internaldev->set_poll_cpu     = 0;
+
+  if(GetDeviceConfigString(ptDevInfo, DEVICE_CONF_POLLINT_KEY, &szTempData))
   {
-    struct dirent* dirent;
+    /* poll interval in ms, fractions are allowed (e.g. 0.5) */
+    double dInterval = strtod(szTempData, NULL);
 
-    while(NULL != (dirent = readdir(dir)))
+    if(dInterval > 0)
     {
-      char* szExt = strstr(dirent->d_name, ".");
-      if(NULL != szExt)
+      internaldev->poll_interval_us = (unsigned long)(dInterval * 1000);
+
+      if(g_ulTraceLevel & TRACE_LEVEL_INFO)
       {
-        if(0 == strncasecmp(szExt, HIL_FILE_EXTENSION_FIRMWARE, 4))
-        {
-          snprintf(ptFileInfo->szFullFileName, sizeof(ptFileInfo->szFullFileName),
-                  "%s/%s", szPath, dirent->d_name);
-          strncpy(ptFileInfo->szShortFileName, dirent->d_name,
-                  sizeof(ptFileInfo->szShortFileName));
-          ret = 1;
-          break;
-        }
+        USER_Trace(ptDevInfo->ptDeviceInstance,
+                   TRACE_LEVEL_INFO,
+                   "Using custom poll interval (%lu us).",
+                   internaldev->poll_interval_us);
       }
     }
-    closedir(dir);
+    free(szTempData);
   }
 
-  return ret;
-}
+  if(GetDeviceConfigString(ptDevInfo, DEVICE_CONF_POLLCPU_KEY, &szTempData))
+  {
+    char* szEnd = NULL;
+    long  lCpu;
+
+    errno = 0;
+    lCpu  = strtol(szTempData, &szEnd, 10);
+
+    if( (szEnd == szTempData) || (0 != errno) ||
+        (lCpu < 0)            || (lCpu >= CPU_SETSIZE) )
+    {
+      if(g_ulTraceLevel & TRACE_LEVEL_WARNING)
+      {
+        USER_Trace(ptDevInfo->ptDeviceInstance,
+                   TRACE_LEVEL_WARNING,
+                   "Invalid polling thread CPU '%s' (0 <= x < %d), thread is not pinned.",
+                   szTempData, CPU_SETSIZE);
+      }
+    } else
+    {
+      internaldev->set_poll_cpu = 1;
+      internaldev->poll_cpu     = (int)lCpu;
 
+      if(g_ulTraceLevel & TRACE_LEVEL_INFO)
+      {
+        USER_Trace(ptDevInfo->ptDeviceInstance,
+                   TRACE_LEVEL_INFO,
+                   "Pinning polling thread to CPU %d.",
+                   internaldev->poll_cpu);
+      }
+    }
+    free(szTempData);
+  }
+}
 
 /*****************************************************************************/
 /*! Check if the interrupts are to be enabled on this device
@@ -666,15 +1038,11 @@ int USER_GetOSFile(PCIFX_DEVICE_INFORMATION ptDevInfo, PCIFX_FILE_INFORMATION pt
 /*****************************************************************************/
 int USER_GetInterruptEnable(PCIFX_DEVICE_INFORMATION ptDevInfo)
 {
-  char  szFile[CIFX_MAX_FILE_NAME_LENGTH];
   char* szTempIrq   = NULL;
   int   ret         = 0;
 
-  GetDeviceDir(szFile, sizeof(szFile), ptDevInfo);
-  strcat(szFile, "/device.conf");
-
   /* Read IRQ enable from file */
-  if(GetDeviceConfigString(szFile, DEVICE_CONF_IRQ_KEY, &szTempIrq))
+  if(GetDeviceConfigString(ptDevInfo, DEVICE_CONF_IRQ_KEY, &szTempIrq))
   {
     if(0 == strcasecmp("yes", szTempIrq))
     {
@@ -717,7 +1085,7 @@ int USER_GetInterruptEnable(PCIFX_DEVICE_INFORMATION ptDevInfo)
         } else
         {
           /* Check for custom priority and set them in CIFX_DEVICE_INTERNAL_T to use them in OS_EnableInterrupts() */
-          if(GetDeviceConfigString(szFile, DEVICE_CONF_IRQPRIO_KEY, &szTempData))
+          if(GetDeviceConfigString(ptDevInfo, DEVICE_CONF_IRQPRIO_KEY, &szTempData))
           {
             internaldev->set_irq_prio = 1;
             internaldev->irq_prio     = atoi(szTempData);
@@ -736,7 +1104,7 @@ int USER_GetInterruptEnable(PCIFX_DEVICE_INFORMATION ptDevInfo)
           }
 
           /* Check for custom scheduling policy */
-          if(GetDeviceConfigString(szFile, DEVICE_CONF_IRQSCHED_KEY, &szTempData))
+          if(GetDeviceConfigString(ptDevInfo, DEVICE_CONF_IRQSCHED_KEY, &szTempData))
           {
             internaldev->set_irq_scheduler_algo = 1;
 
@@ -788,6 +1156,9 @@ int USER_GetInterruptEnable(PCIFX_DEVICE_INFORMATION ptDevInfo)
     USER_Trace( ptDevInfo->ptDeviceInstance, TRACE_LEVEL_INFO, "%s", (ret)?"IRQ-Mode enabled!":"Polling Mode enabled!");
   }
 
+  if(!ret)
+    GetPollingConfig(ptDevInfo);
+
   return ret;
 }
 
@@ -800,13 +1171,9 @@ int USER_GetInterruptEnable(PCIFX_DEVICE_INFORMATION ptDevInfo)
 /*****************************************************************************/
 int USER_GetDMAMode(PCIFX_DEVICE_INFORMATION ptDevInfo)
 {
-  char  szFile[CIFX_MAX_FILE_NAME_LENGTH];
   char* szTempDMA = NULL;
 
-  GetDeviceDir(szFile, sizeof(szFile), ptDevInfo);
-  strcat(szFile, "/device.conf");
-
-  if(GetDeviceConfigString(szFile, DEVICE_CONF_DMA, &szTempDMA))
+  if(GetDeviceConfigString(ptDevInfo, DEVICE_CONF_DMA, &szTempDMA))
   {
     if(0 == strcasecmp("yes", szTempDMA))
     {
@@ -835,14 +1202,10 @@ int USER_GetDMAMode(PCIFX_DEVICE_INFORMATION ptDevInfo)
 /*****************************************************************************/
 int USER_GetEthernet(PCIFX_DEVICE_INFORMATION ptDevInfo)
 {
-  char  szFile[CIFX_MAX_FILE_NAME_LENGTH];
   char* szTempEth = NULL;
   int   ret       = 0;
 
-  GetDeviceDir(szFile, sizeof(szFile), ptDevInfo);
-  strcat(szFile, "/device.conf");
-
-  if(GetDeviceConfigString(szFile, DEVICE_CONF_ETH, &szTempEth))
+  if(GetDeviceConfigString(ptDevInfo, DEVICE_CONF_ETH, &szTempEth))
   {
     if(0 == strcasecmp("yes", szTempEth))
     {
@@ -874,3 +1237,38 @@ int USER_GetCachedIOBufferMode(PCIFX_DEVICE_INFORMATION ptDevInfo)
   (void)ptDevInfo;
   return eCACHED_MODE_OFF;
 }
+
+/*****************************************************************************/
+/*! Check if only changed output data is to be written on this device
+*   (device.conf "iodelta=yes" or "iodelta=<merge gap in bytes>")
+*   \param ptDevInfo    Device Information
+*   \param pulMergeGap  Returned number of unchanged bytes up to which two
+*                       changed runs are written in one access
+*   \return eIO_DELTA_WRITE_ON to enable delta writes                        */
+/*****************************************************************************/
+int USER_GetIODeltaWriteMode(PCIFX_DEVICE_INFORMATION ptDevInfo, uint32_t* pulMergeGap)
+{
+  char* szTempDelta = NULL;
+  int   ret         = eIO_DELTA_WRITE_OFF;
+
+  *pulMergeGap = IO_DELTA_WRITE_MERGE_GAP;
+
+  if(GetDeviceConfigString(ptDevInfo, DEVICE_CONF_IODELTA_KEY, &szTempDelta))
+  {
+    if(0 == strcasecmp("yes", szTempDelta))
+    {
+      ret = eIO_DELTA_WRITE_ON;
+    } else if(isdigit((unsigned char)szTempDelta[0]))
+    {
+      *pulMergeGap = (uint32_t)strtoul(szTempDelta, NULL, 0);
+      ret          = eIO_DELTA_WRITE_ON;
+    }
+    free(szTempDelta);
+  }
+
+  if((eIO_DELTA_WRITE_ON == ret) && (g_ulTraceLevel & TRACE_LEVEL_INFO))
+  {
+    USER_Trace(ptDevInfo->ptDeviceInstance, TRACE_LEVEL_INFO, "Delta writes of output areas enabled (merge gap %u bytes)!", *pulMergeGap);
+  }
+  return ret;
+}
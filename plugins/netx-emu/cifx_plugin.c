@@ -0,0 +1,200 @@
+// SPDX-License-Identifier: MIT
+/**************************************************************************************
+ *
+ * Copyright (c) 2025, Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserved.
+ *
+ * Description: cifX plugin exposing emulated netX devices (see libnetxemu.c). Each
+ *              configX file in the plugin's config directory describes one device.
+ *
+ **************************************************************************************/
+
+#include <malloc.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <dlfcn.h>
+#include <libgen.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "cifxlinux.h"
+#include "libnetxemu.h"
+
+#define MAX_STR              256
+
+#define DEVICE_NAME          "Device="
+#define DEVICE_CHANNELS      "Channels="
+#define DEVICE_CYCLE_TIME    "CycleTime="
+#define DEVICE_LATENCY       "Latency="
+#define DEVICE_IRQ           "Irq="
+#define DEVICE_DEVICE_NUMBER "DeviceNumber="
+#define DEVICE_SERIAL_NUMBER "SerialNumber="
+#define EMU_DEVICE           "netxemu"
+
+#define DEFAULT_CYCLE_TIME    1000    /* us */
+#define DEFAULT_DEVICE_NUMBER 1250100 /* emulated devices report a CIFX 50-RE device number */
+
+static int GetDeviceConfigString(const char* szFile, const char* szKey, char** szValue)
+{
+  int   ret = 0;
+  FILE* fd  = fopen(szFile, "r");
+
+  if(NULL != fd)
+  {
+    /* File is open */
+    char* buffer = malloc(MAX_STR);
+
+    /* Read file line by line */
+    while(NULL != fgets(buffer, MAX_STR, fd))
+    {
+      char* key;
+
+      /* '#' marks a comment line in the device.conf file */
+      if(buffer[0] == '#')
+        continue;
+
+      /* Search for key in the input buffer */
+      key = strcasestr(buffer, szKey);
+
+      if(NULL != key)
+      {
+        /* We've found the key */
+        int   allocsize  = strlen(key + strlen(szKey)) + 1;
+        int   valuelen;
+        char* tempstring = (char*)malloc(allocsize);
+
+        strcpy(tempstring, key + strlen(szKey));
+        valuelen = strlen(tempstring);
+
+        /* strip all trailing whitespaces */
+        while( (valuelen > 0) &&
+               ((tempstring[valuelen - 1] == '\n') ||
+                (tempstring[valuelen - 1] == '\r') ||
+                (tempstring[valuelen - 1] == ' ')))
+        {
+          tempstring[valuelen - 1] = '\0';
+          --valuelen;
+        }
+
+        *szValue = tempstring;
+        ret = 1;
+        break;
+      }
+    }
+
+    free(buffer);
+    fclose(fd);
+  }
+
+  return ret;
+}
+
+static int GetConfigNumber(uint32_t* value, const char* szKey, char* szFile)
+{
+  char* string = NULL;
+  int   ret    = 0;
+
+  if (GetDeviceConfigString( szFile, szKey, &string)) {
+    if (1 == sscanf(string, "%u", value))
+      ret = 1;
+    free(string);
+  }
+  return ret;
+}
+
+static int GetEventFdIrq(char* szFile)
+{
+  char* string = NULL;
+  int   ret    = 0;
+
+  if (GetDeviceConfigString( szFile, DEVICE_IRQ, &string)) {
+    if (0 == strcasecmp(string, "eventfd"))
+      ret = 1;
+    free(string);
+  }
+  return ret;
+}
+
+static int CheckIsEmuDevice(char* szFile)
+{
+  char* name = NULL;
+  int   ret  = 0;
+  if (GetDeviceConfigString( szFile, DEVICE_NAME, &name)) {
+    if (0 == strncmp(name, EMU_DEVICE, strlen(EMU_DEVICE))) {
+      ret = 1;
+    }
+    free(name);
+  }
+  return ret;
+}
+
+static int file_exist (char *filename)
+{
+  struct stat   buffer;
+  return (stat (filename, &buffer) == 0);
+}
+
+/* configs are searched next to the plugin (<plugin dir>/netx-emu/), then in the default install location */
+static void find_config_path(char* base_path)
+{
+  Dl_info tInfo;
+  char    config[2*MAX_STR+20];
+
+  if ((0 != dladdr((void*)find_config_path, &tInfo)) && (NULL != tInfo.dli_fname)) {
+    char path[MAX_STR];
+
+    snprintf(path, sizeof(path), "%s", tInfo.dli_fname);
+    snprintf(base_path, MAX_STR, "%s/netx-emu/", dirname(path));
+    snprintf(config, sizeof(config), "%sconfig0", base_path);
+    if (file_exist(config))
+      return;
+  }
+  sprintf(base_path,"/opt/cifx/plugins/netx-emu/");
+}
+
+uint32_t cifx_device_count(void)
+{
+  char config[2*MAX_STR+20] = {0};
+  char base_path[MAX_STR] = {0};
+  uint32_t emu_dev = 0;
+
+  /* read all configs or parser error or device is not an emulated device */
+  find_config_path(base_path);
+  sprintf(config, "%sconfig0", base_path);
+  while ((file_exist(config)) && (CheckIsEmuDevice(config))) {
+    sprintf(config, "%sconfig%d",base_path,++emu_dev);
+  }
+  return emu_dev;
+}
+
+struct CIFX_DEVICE_T* cifx_alloc_device(uint32_t num)
+{
+  char                    config[2*MAX_STR]  = {0};
+  char                    base_path[MAX_STR] = {0};
+  struct NETXEMU_CONFIG_T tConfig            = {0};
+
+  find_config_path(base_path);
+  sprintf(config, "%sconfig%d", base_path, num);
+  if (0 == CheckIsEmuDevice(config))
+    return NULL;
+
+  tConfig.ulChannels     = 1;
+  tConfig.ulCycleTime    = DEFAULT_CYCLE_TIME;
+  tConfig.ulLatency      = 0;
+  tConfig.ulDeviceNumber = DEFAULT_DEVICE_NUMBER;
+  tConfig.ulSerialNumber = 20000 + num; /* unique per device, so every device gets its own deviceconfig directory */
+
+  GetConfigNumber( &tConfig.ulChannels,     DEVICE_CHANNELS,      config);
+  GetConfigNumber( &tConfig.ulCycleTime,    DEVICE_CYCLE_TIME,    config);
+  GetConfigNumber( &tConfig.ulLatency,      DEVICE_LATENCY,       config);
+  GetConfigNumber( &tConfig.ulDeviceNumber, DEVICE_DEVICE_NUMBER, config);
+  GetConfigNumber( &tConfig.ulSerialNumber, DEVICE_SERIAL_NUMBER, config);
+  tConfig.fEventFd = GetEventFdIrq(config);
+
+  return NETXEMUInit(&tConfig);
+}
+
+void cifx_free_device(struct CIFX_DEVICE_T* device)
+{
+  NETXEMUDeInit(device);
+}
@@ -0,0 +1,703 @@
+// SPDX-License-Identifier: MIT
+/**************************************************************************************
+ *
+ * Copyright (c) 2025, Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserved.
+ *
+ * Description: This plugin library provides memory backed cifX devices. A firmware thread
+ *              emulates the DPM side of a netX (system channel, handshake cells, mailboxes,
+ *              COS and process data handshakes), so the driver and applications can be
+ *              exercised and benchmarked without any hardware.
+ *
+ **************************************************************************************/
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <errno.h>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
+#include "cifxlinux.h"
+#include "cifXEndianess.h"
+#include "Hil_SystemCmd.h"
+#include "Hil_Results.h"
+#include "Hil_Packet.h"
+#include "libnetxemu.h"
+
+#define NETXEMU_DPM_SIZE          0x10000                       /* size of the emulated DPM */
+#define NETXEMU_GLOBAL_REG_OFFSET (NETXEMU_DPM_SIZE - 0x200)    /* start of the NETX_GLOBAL_REG_BLOCK, preserved on reset */
+#define NETXEMU_CHANNEL_OFFSET    (HIL_DPM_SYSTEM_CHANNEL_SIZE + HIL_DPM_HANDSHAKE_CHANNEL_SIZE)
+#define NETXEMU_BLOCK_COUNT       9                             /* number of sub blocks of a communication channel */
+#define NETXEMU_RESET_TIME_NS     10000000ULL                   /* time the emulated netX stays in reset */
+#define NETXEMU_CHANNEL_INIT_NS   10000000ULL                   /* minimum time of a channel initialization */
+#define NETXEMU_FW_NAME           "netX emulator"
+#define NETXEMU_IRQ_CFG_OFFSET    0xfff0                        /* global IRQ status/control (IRQ_CFG0) in the DPM */
+#define NETXEMU_IRQ_EN0_INT_REQ   0x80000000UL                  /* global interrupt enable of IRQ_CFG0 */
+
+/* the plugin only uses the public libcifx headers, so it brings its own trace macros */
+#define ERR(fmt, ...)  fprintf( stderr, "ERR:%s: " fmt, __func__, ##__VA_ARGS__)
+#ifdef DEBUG
+  #define DBG(fmt, ...)  fprintf( stdout, "DBG:%s: " fmt, __func__, ##__VA_ARGS__)
+#else
+  #define DBG(fmt, ...)
+#endif
+
+/******************************************************************************/
+/*** STRUCTURE DEFINITIONS ****************************************************/
+/******************************************************************************/
+/* DPM endpoint (system or communication channel) with handshake cell and packet mailboxes */
+struct NETXEMU_ENDPOINT_T {
+  HIL_DPM_HANDSHAKE_CELL_T* ptCell;         /* handshake cell of this endpoint                    */
+  int                       f16Bit;         /* !=0 the cell uses 16bit flags                      */
+  uint16_t                  usNetxFlags;    /* netX flags, written to the cell once per cycle     */
+  uint16_t                  usCommitted;    /* netX flags last written to the cell                */
+  uint8_t*                  pbSendMbx;      /* host->netX mailbox (usPackagesAccepted + packet)   */
+  uint8_t*                  pbRecvMbx;      /* netX->host mailbox (usWaitingPackages + packet)    */
+  uint32_t                  ulMbxSize;      /* size of the packet buffer of each mailbox          */
+  int                       fAnswerPending; /* !=0 tAnswer waits for delivery                     */
+  uint64_t                  ullAnswerDue;   /* time (ns) the answer is delivered at the earliest  */
+  CIFX_PACKET               tRequest;       /* last received request                              */
+  CIFX_PACKET               tAnswer;        /* answer waiting for delivery                        */
+};
+
+/* communication channel state */
+struct NETXEMU_CHANNEL_T {
+  struct NETXEMU_ENDPOINT_T       tEndpoint;
+  HIL_DPM_DEFAULT_COMM_CHANNEL_T* ptDpm;             /* channel layout in the DPM                    */
+  uint32_t                        ulSignalledCOS;    /* communication COS last signalled to the host */
+  int                             fBusOn;            /* bus state requested by the host              */
+  int                             fConfigLocked;     /* configuration lock requested by the host     */
+  int                             fInit;             /* !=0 channel initialization in progress       */
+  uint64_t                        ullInitDone;       /* time (ns) the initialization ends earliest   */
+  uint8_t                         abPd0[HIL_DPM_IO_DATA_SIZE];    /* process data image 0 (loopback) */
+  uint8_t                         abPd1[HIL_DPM_HP_IO_DATA_SIZE]; /* process data image 1 (loopback) */
+};
+
+/* emulated netX device (passed as user parameter -> see ptDevice->userparam) */
+struct NETXEMU_T {
+  struct NETXEMU_CONFIG_T   tConfig;
+  uint8_t*                  pbDpm;           /* memory backing the DPM                        */
+  int                       iEventFd;        /* eventfd signalled on flag changes, -1 if none */
+  pthread_t                 hThread;         /* firmware thread                               */
+  int                       fThreadRunning;  /* !=0 hThread was created                       */
+  volatile int              fStop;           /* request firmware thread to terminate          */
+  int                       fIrqPending;     /* flag change not yet signalled to the host     */
+  uint64_t                  ullStartTime;    /* time (ns) of last power-on                    */
+  struct NETXEMU_ENDPOINT_T tSystem;
+  struct NETXEMU_CHANNEL_T  atChannel[NETXEMU_MAX_CHANNELS];
+};
+
+/* sub block description reported by HIL_DPM_GET_BLOCK_INFO_REQ */
+struct NETXEMU_BLOCK_T {
+  uint32_t ulType;
+  uint32_t ulOffset;
+  uint32_t ulSize;
+  uint16_t usFlags;
+  uint16_t usHandshakeMode;
+  uint16_t usHandshakeBit;
+};
+
+#define NETXEMU_BLOCK(type, member, dir, mode, bit) \
+  { type, offsetof(HIL_DPM_DEFAULT_COMM_CHANNEL_T, member), sizeof(((HIL_DPM_DEFAULT_COMM_CHANNEL_T*)0)->member), \
+    (dir) | HIL_TRANSMISSION_TYPE_DPM, mode, bit }
+
+static const struct NETXEMU_BLOCK_T s_atBlocks[NETXEMU_BLOCK_COUNT] = {
+  NETXEMU_BLOCK(HIL_BLOCK_CTRL_PARAM,         tControl,        HIL_DIRECTION_OUT, 0,                         0),
+  NETXEMU_BLOCK(HIL_BLOCK_COMMON_STATE,       tCommonStatus,   HIL_DIRECTION_IN,  0,                         0),
+  NETXEMU_BLOCK(HIL_BLOCK_EXTENDED_STATE,     tExtendedStatus, HIL_DIRECTION_IN,  0,                         0),
+  NETXEMU_BLOCK(HIL_BLOCK_MAILBOX,            tSendMbx,        HIL_DIRECTION_OUT, 0,                         HCF_SEND_MBX_CMD_BIT_NO),
+  NETXEMU_BLOCK(HIL_BLOCK_MAILBOX,            tRecvMbx,        HIL_DIRECTION_IN,  0,                         HCF_RECV_MBX_ACK_BIT_NO),
+  NETXEMU_BLOCK(HIL_BLOCK_DATA_IMAGE,         abPd0Output,     HIL_DIRECTION_OUT, HIL_IO_MODE_BUFF_HST_CTRL, HCF_PD0_OUT_CMD_BIT_NO),
+  NETXEMU_BLOCK(HIL_BLOCK_DATA_IMAGE,         abPd0Input,      HIL_DIRECTION_IN,  HIL_IO_MODE_BUFF_HST_CTRL, HCF_PD0_IN_ACK_BIT_NO),
+  NETXEMU_BLOCK(HIL_BLOCK_DATA_IMAGE_HI_PRIO, abPd1Output,     HIL_DIRECTION_OUT, HIL_IO_MODE_BUFF_HST_CTRL, HCF_PD1_OUT_CMD_BIT_NO),
+  NETXEMU_BLOCK(HIL_BLOCK_DATA_IMAGE_HI_PRIO, abPd1Input,      HIL_DIRECTION_IN,  HIL_IO_MODE_BUFF_HST_CTRL, HCF_PD1_IN_ACK_BIT_NO),
+};
+
+/******************************************************************************/
+/*** HELPER FUNCTIONS *********************************************************/
+/******************************************************************************/
+static uint64_t NetxEmuGetTime(void)
+{
+  struct timespec tNow;
+
+  clock_gettime(CLOCK_MONOTONIC, &tNow);
+  return (uint64_t)tNow.tv_sec * 1000000000ULL + (uint64_t)tNow.tv_nsec;
+}
+
+static uint16_t NetxEmuHostFlags(struct NETXEMU_ENDPOINT_T* ptEndpoint)
+{
+  uint16_t usHostFlags;
+
+  if (ptEndpoint->f16Bit)
+    usHostFlags = LE16_TO_HOST(ptEndpoint->ptCell->t16Bit.usHostFlags);
+  else
+    usHostFlags = ptEndpoint->ptCell->t8Bit.bHostFlags;
+
+  /* DPM content written by the host before toggling its flags must be visible from here on */
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  return usHostFlags;
+}
+
+/* writes the netX flags to the handshake cell, returns !=0 if they have changed */
+static int NetxEmuCommitFlags(struct NETXEMU_ENDPOINT_T* ptEndpoint)
+{
+  if (ptEndpoint->usNetxFlags == ptEndpoint->usCommitted)
+    return 0;
+
+  /* DPM content must be visible to the host before the flags are toggled */
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  if (ptEndpoint->f16Bit)
+    ptEndpoint->ptCell->t16Bit.usNetxFlags = HOST_TO_LE16(ptEndpoint->usNetxFlags);
+  else
+    ptEndpoint->ptCell->t8Bit.bNetxFlags = (uint8_t)ptEndpoint->usNetxFlags;
+
+  ptEndpoint->usCommitted = ptEndpoint->usNetxFlags;
+  return 1;
+}
+
+/* signals a pending "interrupt" via the eventfd, as long as the host has enabled interrupts */
+static void NetxEmuSignalIrq(struct NETXEMU_T* ptEmu)
+{
+  uint32_t ulIrqCfg;
+  uint64_t ullVal = 1;
+
+  if ((ptEmu->iEventFd < 0) || (0 == ptEmu->fIrqPending))
+    return;
+
+  memcpy(&ulIrqCfg, ptEmu->pbDpm + NETXEMU_IRQ_CFG_OFFSET, sizeof(ulIrqCfg));
+  if (0 == (LE32_TO_HOST(ulIrqCfg) & NETXEMU_IRQ_EN0_INT_REQ))
+    return;
+
+  if (sizeof(ullVal) == write(ptEmu->iEventFd, &ullVal, sizeof(ullVal)))
+    ptEmu->fIrqPending = 0;
+}
+
+/******************************************************************************/
+/*** DPM LAYOUT ***************************************************************/
+/******************************************************************************/
+static void NetxEmuSetupEndpoint(struct NETXEMU_ENDPOINT_T* ptEndpoint, HIL_DPM_HANDSHAKE_CELL_T* ptCell, int f16Bit,
+                                 uint8_t* pbSendMbx, uint8_t* pbRecvMbx, uint32_t ulMbxSize)
+{
+  uint16_t usPackagesAccepted = HOST_TO_LE16(1);
+
+  ptEndpoint->ptCell         = ptCell;
+  ptEndpoint->f16Bit         = f16Bit;
+  ptEndpoint->usNetxFlags    = 0;
+  ptEndpoint->usCommitted    = 0;
+  ptEndpoint->pbSendMbx      = pbSendMbx;
+  ptEndpoint->pbRecvMbx      = pbRecvMbx;
+  ptEndpoint->ulMbxSize      = ulMbxSize;
+  ptEndpoint->fAnswerPending = 0;
+
+  memcpy(pbSendMbx, &usPackagesAccepted, sizeof(usPackagesAccepted));
+}
+
+/* builds the DPM content of a freshly started firmware and signals READY */
+static void NetxEmuPowerOn(struct NETXEMU_T* ptEmu)
+{
+  HIL_DPM_SYSTEM_CHANNEL_T*  ptSys = (HIL_DPM_SYSTEM_CHANNEL_T*)ptEmu->pbDpm;
+  HIL_DPM_HANDSHAKE_ARRAY_T* ptHsk = (HIL_DPM_HANDSHAKE_ARRAY_T*)(ptEmu->pbDpm + HIL_DPM_SYSTEM_CHANNEL_SIZE);
+  uint32_t                   ulChannel;
+
+  /* the global register block stays untouched, it is owned by the host */
+  memset(ptEmu->pbDpm, 0, NETXEMU_GLOBAL_REG_OFFSET);
+
+  ptSys->tSystemInfo.ulDpmTotalSize = HOST_TO_LE32(NETXEMU_DPM_SIZE);
+  ptSys->tSystemInfo.ulDeviceNumber = HOST_TO_LE32(ptEmu->tConfig.ulDeviceNumber);
+  ptSys->tSystemInfo.ulSerialNumber = HOST_TO_LE32(ptEmu->tConfig.ulSerialNumber);
+
+  ptSys->atChannelInfo[HIL_DPM_SYSTEM_CHANNEL_INDEX].tSystem.bChannelType             = HIL_CHANNEL_TYPE_SYSTEM;
+  ptSys->atChannelInfo[HIL_DPM_SYSTEM_CHANNEL_INDEX].tSystem.bSizePositionOfHandshake = HIL_HANDSHAKE_POSITION_CHANNEL | HIL_HANDSHAKE_SIZE_8BIT;
+  ptSys->atChannelInfo[HIL_DPM_SYSTEM_CHANNEL_INDEX].tSystem.ulSizeOfChannel          = HOST_TO_LE32(HIL_DPM_SYSTEM_CHANNEL_SIZE);
+  ptSys->atChannelInfo[HIL_DPM_SYSTEM_CHANNEL_INDEX].tSystem.usSizeOfMailbox          = HOST_TO_LE16(sizeof(ptSys->tSystemSendMailbox) +
+                                                                                                      sizeof(ptSys->tSystemRecvMailbox));
+  ptSys->atChannelInfo[HIL_DPM_SYSTEM_CHANNEL_INDEX].tSystem.usMailboxStartOffset     = HOST_TO_LE16(offsetof(HIL_DPM_SYSTEM_CHANNEL_T, tSystemSendMailbox));
+
+  ptSys->atChannelInfo[HIL_DPM_HANDSHAKE_CHANNEL_INDEX].tHandshake.bChannelType    = HIL_CHANNEL_TYPE_HANDSHAKE;
+  ptSys->atChannelInfo[HIL_DPM_HANDSHAKE_CHANNEL_INDEX].tHandshake.ulSizeOfChannel = HOST_TO_LE32(HIL_DPM_HANDSHAKE_CHANNEL_SIZE);
+
+  ptSys->tSystemState.ulSystemStatus = HOST_TO_LE32(HIL_SYS_STATUS_OK);
+
+  NetxEmuSetupEndpoint(&ptEmu->tSystem, &ptHsk->atHsk[HIL_DPM_SYSTEM_CHANNEL_INDEX], 0,
+                       (uint8_t*)&ptSys->tSystemSendMailbox, (uint8_t*)&ptSys->tSystemRecvMailbox,
+                       sizeof(ptSys->tSystemSendMailbox.abSendMbx));
+
+  for (ulChannel = 0; ulChannel < ptEmu->tConfig.ulChannels; ulChannel++) {
+    struct NETXEMU_CHANNEL_T*             ptChannel = &ptEmu->atChannel[ulChannel];
+    uint32_t                              ulBlockID = HIL_DPM_COM_CHANNEL_START_INDEX + ulChannel;
+    HIL_DPM_COMMUNICATION_CHANNEL_INFO_T* ptInfo    = &ptSys->atChannelInfo[ulBlockID].tCom;
+
+    ptInfo->bChannelType             = HIL_CHANNEL_TYPE_COMMUNICATION;
+    ptInfo->bChannelId               = (uint8_t)ulChannel;
+    ptInfo->bSizePositionOfHandshake = HIL_HANDSHAKE_POSITION_CHANNEL | HIL_HANDSHAKE_SIZE_16BIT;
+    ptInfo->bNumberOfBlocks          = NETXEMU_BLOCK_COUNT;
+    ptInfo->ulSizeOfChannel          = HOST_TO_LE32(sizeof(HIL_DPM_DEFAULT_COMM_CHANNEL_T));
+
+    ptChannel->ptDpm = (HIL_DPM_DEFAULT_COMM_CHANNEL_T*)(ptEmu->pbDpm + NETXEMU_CHANNEL_OFFSET +
+                                                         ulChannel * sizeof(HIL_DPM_DEFAULT_COMM_CHANNEL_T));
+    ptChannel->ptDpm->tCommonStatus.usVersion     = HOST_TO_LE16(HIL_DPM_STATUS_BLOCK_VERSION);
+    ptChannel->ptDpm->tCommonStatus.bPDInHskMode  = HIL_IO_MODE_BUFF_HST_CTRL;
+    ptChannel->ptDpm->tCommonStatus.bPDOutHskMode = HIL_IO_MODE_BUFF_HST_CTRL;
+
+    ptChannel->ulSignalledCOS = 0;
+    ptChannel->fBusOn         = 1;
+    ptChannel->fConfigLocked  = 0;
+    ptChannel->fInit          = 0;
+    memset(ptChannel->abPd0, 0, sizeof(ptChannel->abPd0));
+    memset(ptChannel->abPd1, 0, sizeof(ptChannel->abPd1));
+
+    NetxEmuSetupEndpoint(&ptChannel->tEndpoint, &ptHsk->atHsk[ulBlockID], 1,
+                         (uint8_t*)&ptChannel->ptDpm->tSendMbx, (uint8_t*)&ptChannel->ptDpm->tRecvMbx,
+                         sizeof(ptChannel->ptDpm->tSendMbx.abSendMailbox));
+  }
+
+  /* the cookie marks a valid layout, so it is written last */
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  memcpy(ptSys->tSystemInfo.abCookie, CIFX_DPMSIGNATURE_FW_STR, sizeof(ptSys->tSystemInfo.abCookie));
+
+  ptEmu->ullStartTime          = NetxEmuGetTime();
+  ptEmu->tSystem.usNetxFlags   = NSF_READY;
+  if (NetxEmuCommitFlags(&ptEmu->tSystem))
+    ptEmu->fIrqPending = 1;
+}
+
+/* emulates a system reset: the DPM becomes invalid for a while and the firmware restarts */
+static void NetxEmuReset(struct NETXEMU_T* ptEmu)
+{
+  HIL_DPM_SYSTEM_CHANNEL_T* ptSys      = (HIL_DPM_SYSTEM_CHANNEL_T*)ptEmu->pbDpm;
+  uint64_t                  ullRunning = NetxEmuGetTime() + NETXEMU_RESET_TIME_NS;
+  uint32_t                  ulChannel;
+
+  memset(ptSys->tSystemInfo.abCookie, 0, sizeof(ptSys->tSystemInfo.abCookie));
+  ptEmu->tSystem.usNetxFlags = 0;
+  if (NetxEmuCommitFlags(&ptEmu->tSystem))
+    ptEmu->fIrqPending = 1;
+  for (ulChannel = 0; ulChannel < ptEmu->tConfig.ulChannels; ulChannel++) {
+    ptEmu->atChannel[ulChannel].tEndpoint.usNetxFlags = 0;
+    if (NetxEmuCommitFlags(&ptEmu->atChannel[ulChannel].tEndpoint))
+      ptEmu->fIrqPending = 1;
+  }
+  NetxEmuSignalIrq(ptEmu);
+
+  while ((0 == ptEmu->fStop) && (NetxEmuGetTime() < ullRunning)) {
+    struct timespec tSleep = { 0, 1000000 };
+    nanosleep(&tSleep, NULL);
+  }
+  if (0 == ptEmu->fStop)
+    NetxEmuPowerOn(ptEmu);
+}
+
+/******************************************************************************/
+/*** PACKET HANDLING **********************************************************/
+/******************************************************************************/
+static void NetxEmuFirmwareIdentify(CIFX_PACKET* ptCnf)
+{
+  HIL_FIRMWARE_IDENTIFY_CNF_DATA_T* ptData = (HIL_FIRMWARE_IDENTIFY_CNF_DATA_T*)ptCnf->abData;
+
+  memset(ptData, 0, sizeof(*ptData));
+  ptData->tFirmwareIdentification.tFwVersion.usMajor = HOST_TO_LE16(1);
+  ptData->tFirmwareIdentification.tFwName.bNameLength = (uint8_t)strlen(NETXEMU_FW_NAME);
+  memcpy(ptData->tFirmwareIdentification.tFwName.abName, NETXEMU_FW_NAME, strlen(NETXEMU_FW_NAME));
+  ptData->tFirmwareIdentification.tFwDate.usYear = HOST_TO_LE16(2025);
+  ptData->tFirmwareIdentification.tFwDate.bMonth = 1;
+  ptData->tFirmwareIdentification.tFwDate.bDay   = 1;
+  ptCnf->tHeader.ulLen = HOST_TO_LE32(sizeof(*ptData));
+}
+
+static void NetxEmuSystemPacket(struct NETXEMU_T* ptEmu, CIFX_PACKET* ptReq, CIFX_PACKET* ptCnf)
+{
+  switch (LE32_TO_HOST(ptReq->tHeader.ulCmd)) {
+    case HIL_DPM_GET_BLOCK_INFO_REQ:
+    {
+      HIL_DPM_GET_BLOCK_INFO_REQ_DATA_T* ptReqData = (HIL_DPM_GET_BLOCK_INFO_REQ_DATA_T*)ptReq->abData;
+      HIL_DPM_GET_BLOCK_INFO_CNF_DATA_T* ptCnfData = (HIL_DPM_GET_BLOCK_INFO_CNF_DATA_T*)ptCnf->abData;
+      uint32_t                           ulArea    = LE32_TO_HOST(ptReqData->ulAreaIndex);
+      uint32_t                           ulBlock   = LE32_TO_HOST(ptReqData->ulSubblockIndex);
+
+      if ((LE32_TO_HOST(ptReq->tHeader.ulLen) < sizeof(*ptReqData))                                     ||
+          (ulArea < HIL_DPM_COM_CHANNEL_START_INDEX)                                                   ||
+          (ulArea >= HIL_DPM_COM_CHANNEL_START_INDEX + ptEmu->tConfig.ulChannels)                      ||
+          (ulBlock >= NETXEMU_BLOCK_COUNT)) {
+        ptCnf->tHeader.ulState = HOST_TO_LE32(ERR_HIL_INVALID_PARAMETER);
+        break;
+      }
+      memset(ptCnfData, 0, sizeof(*ptCnfData));
+      ptCnfData->ulAreaIndex     = HOST_TO_LE32(ulArea);
+      ptCnfData->ulSubblockIndex = HOST_TO_LE32(ulBlock);
+      ptCnfData->ulType          = HOST_TO_LE32(s_atBlocks[ulBlock].ulType);
+      ptCnfData->ulOffset        = HOST_TO_LE32(s_atBlocks[ulBlock].ulOffset);
+      ptCnfData->ulSize          = HOST_TO_LE32(s_atBlocks[ulBlock].ulSize);
+      ptCnfData->usFlags         = HOST_TO_LE16(s_atBlocks[ulBlock].usFlags);
+      ptCnfData->usHandshakeMode = HOST_TO_LE16(s_atBlocks[ulBlock].usHandshakeMode);
+      ptCnfData->usHandshakeBit  = HOST_TO_LE16(s_atBlocks[ulBlock].usHandshakeBit);
+      ptCnf->tHeader.ulLen       = HOST_TO_LE32(sizeof(*ptCnfData));
+    }
+    break;
+
+    case HIL_HW_IDENTIFY_REQ:
+    {
+      HIL_HW_IDENTIFY_CNF_DATA_T* ptCnfData = (HIL_HW_IDENTIFY_CNF_DATA_T*)ptCnf->abData;
+
+      memset(ptCnfData, 0, sizeof(*ptCnfData));
+      ptCnfData->ulDeviceNumber = HOST_TO_LE32(ptEmu->tConfig.ulDeviceNumber);
+      ptCnfData->ulSerialNumber = HOST_TO_LE32(ptEmu->tConfig.ulSerialNumber);
+      ptCnf->tHeader.ulLen      = HOST_TO_LE32(sizeof(*ptCnfData));
+    }
+    break;
+
+    case HIL_FIRMWARE_IDENTIFY_REQ:
+      NetxEmuFirmwareIdentify(ptCnf);
+    break;
+
+    default:
+      ptCnf->tHeader.ulState = HOST_TO_LE32(ERR_HIL_UNKNOWN_COMMAND);
+    break;
+  }
+}
+
+static void NetxEmuChannelPacket(CIFX_PACKET* ptReq, CIFX_PACKET* ptCnf)
+{
+  if (HIL_FIRMWARE_IDENTIFY_REQ == LE32_TO_HOST(ptReq->tHeader.ulCmd)) {
+    NetxEmuFirmwareIdentify(ptCnf);
+  } else {
+    /* every other request is echoed, which allows measuring the packet round trip */
+    memcpy(ptCnf->abData, ptReq->abData, LE32_TO_HOST(ptReq->tHeader.ulLen));
+    ptCnf->tHeader.ulLen = ptReq->tHeader.ulLen;
+  }
+}
+
+/* accepts requests from the send mailbox and delivers answers to the receive mailbox */
+static void NetxEmuMailbox(struct NETXEMU_T* ptEmu, struct NETXEMU_ENDPOINT_T* ptEndpoint,
+                           struct NETXEMU_CHANNEL_T* ptChannel, uint16_t usHostFlags, uint64_t ullNow)
+{
+  uint16_t usWaiting;
+
+  if ((0 == ptEndpoint->fAnswerPending) &&
+      ((usHostFlags ^ ptEndpoint->usNetxFlags) & NCF_SEND_MBX_ACK)) {
+    CIFX_PACKET* ptReq = &ptEndpoint->tRequest;
+    uint32_t     ulLen;
+
+    memcpy(&ptReq->tHeader, ptEndpoint->pbSendMbx + 4, sizeof(ptReq->tHeader));
+    ulLen = LE32_TO_HOST(ptReq->tHeader.ulLen);
+    if (ulLen > ptEndpoint->ulMbxSize - sizeof(ptReq->tHeader)) {
+      ulLen = ptEndpoint->ulMbxSize - sizeof(ptReq->tHeader);
+      ptReq->tHeader.ulLen = HOST_TO_LE32(ulLen);
+    }
+    memcpy(ptReq->abData, ptEndpoint->pbSendMbx + 4 + sizeof(ptReq->tHeader), ulLen);
+    ptEndpoint->usNetxFlags ^= NCF_SEND_MBX_ACK;
+
+    /* answers to indications sent by the emulator are not expected, so they are dropped */
+    if (0 == (LE32_TO_HOST(ptReq->tHeader.ulCmd) & HIL_MSK_PACKET_ANSWER)) {
+      CIFX_PACKET* ptCnf = &ptEndpoint->tAnswer;
+
+      ptCnf->tHeader         = ptReq->tHeader;
+      ptCnf->tHeader.ulCmd   = HOST_TO_LE32(LE32_TO_HOST(ptReq->tHeader.ulCmd) | HIL_MSK_PACKET_ANSWER);
+      ptCnf->tHeader.ulState = HOST_TO_LE32(SUCCESS_HIL_OK);
+      ptCnf->tHeader.ulLen   = 0;
+
+      if (NULL == ptChannel)
+        NetxEmuSystemPacket(ptEmu, ptReq, ptCnf);
+      else
+        NetxEmuChannelPacket(ptReq, ptCnf);
+
+      ptEndpoint->fAnswerPending = 1;
+      ptEndpoint->ullAnswerDue   = ullNow + (uint64_t)ptEmu->tConfig.ulLatency * 1000ULL;
+    }
+  }
+
+  if ((ptEndpoint->fAnswerPending) && (ullNow >= ptEndpoint->ullAnswerDue) &&
+      (0 == ((usHostFlags ^ ptEndpoint->usNetxFlags) & NCF_RECV_MBX_CMD))) {
+    CIFX_PACKET* ptCnf = &ptEndpoint->tAnswer;
+
+    memcpy(ptEndpoint->pbRecvMbx + 4, ptCnf, sizeof(ptCnf->tHeader) + LE32_TO_HOST(ptCnf->tHeader.ulLen));
+    ptEndpoint->usNetxFlags   ^= NCF_RECV_MBX_CMD;
+    ptEndpoint->fAnswerPending = 0;
+  }
+
+  usWaiting = HOST_TO_LE16((uint16_t)(((usHostFlags ^ ptEndpoint->usNetxFlags) & NCF_RECV_MBX_CMD) ? 1 : 0) +
+                           (uint16_t)ptEndpoint->fAnswerPending);
+  memcpy(ptEndpoint->pbRecvMbx, &usWaiting, sizeof(usWaiting));
+}
+
+/******************************************************************************/
+/*** FIRMWARE CYCLE ***********************************************************/
+/******************************************************************************/
+static void NetxEmuChannelCycle(struct NETXEMU_T* ptEmu, struct NETXEMU_CHANNEL_T* ptChannel, uint64_t ullNow)
+{
+  struct NETXEMU_ENDPOINT_T*      ptEndpoint  = &ptChannel->tEndpoint;
+  HIL_DPM_DEFAULT_COMM_CHANNEL_T* ptDpm       = ptChannel->ptDpm;
+  uint16_t                        usHostFlags = NetxEmuHostFlags(ptEndpoint);
+  uint32_t                        ulCOS       = 0;
+  uint32_t                        ulWatchdog;
+
+  /* application change of state */
+  if ((usHostFlags ^ ptEndpoint->usNetxFlags) & NCF_HOST_COS_ACK) {
+    uint32_t ulAppCOS = LE32_TO_HOST(ptDpm->tControl.ulApplicationCOS);
+
+    if ((ulAppCOS & HIL_APP_COS_INITIALIZATION_ENABLE) && (ulAppCOS & HIL_APP_COS_INITIALIZATION)) {
+      ptChannel->fInit       = 1;
+      ptChannel->ullInitDone = ullNow + NETXEMU_CHANNEL_INIT_NS;
+    }
+    if (ulAppCOS & HIL_APP_COS_BUS_ON_ENABLE)
+      ptChannel->fBusOn = (ulAppCOS & HIL_APP_COS_BUS_ON) ? 1 : 0;
+    if (ulAppCOS & HIL_APP_COS_LOCK_CONFIGURATION_ENABLE)
+      ptChannel->fConfigLocked = (ulAppCOS & HIL_APP_COS_LOCK_CONFIGURATION) ? 1 : 0;
+
+    ptEndpoint->usNetxFlags ^= NCF_HOST_COS_ACK;
+  }
+
+  /* an initialization ends, after the host has seen the channel going down */
+  if ((ptChannel->fInit) && (ullNow >= ptChannel->ullInitDone) && (0 == ptChannel->ulSignalledCOS) &&
+      (0 == ((usHostFlags ^ ptEndpoint->usNetxFlags) & NCF_NETX_COS_CMD)))
+    ptChannel->fInit = 0;
+
+  if (0 == ptChannel->fInit) {
+    ulCOS = HIL_COMM_COS_READY | HIL_COMM_COS_RUN;
+    if (ptChannel->fBusOn)
+      ulCOS |= HIL_COMM_COS_BUS_ON;
+    if (ptChannel->fConfigLocked)
+      ulCOS |= HIL_COMM_COS_CONFIG_LOCKED;
+  }
+  ptDpm->tCommonStatus.ulCommunicationCOS   = HOST_TO_LE32(ulCOS);
+  ptDpm->tCommonStatus.ulCommunicationState = HOST_TO_LE32((ulCOS & HIL_COMM_COS_BUS_ON) ? HIL_COMM_STATE_OPERATE : HIL_COMM_STATE_STOP);
+
+  /* signal a new communication state, once the host has acknowledged the previous one */
+  if ((ulCOS != ptChannel->ulSignalledCOS) &&
+      (0 == ((usHostFlags ^ ptEndpoint->usNetxFlags) & NCF_NETX_COS_CMD))) {
+    ptEndpoint->usNetxFlags  ^= NCF_NETX_COS_CMD;
+    ptChannel->ulSignalledCOS = ulCOS;
+  }
+
+  if (ulCOS & HIL_COMM_COS_BUS_ON)
+    ptEndpoint->usNetxFlags |= NCF_COMMUNICATING;
+  else
+    ptEndpoint->usNetxFlags &= ~NCF_COMMUNICATING;
+
+  /* host watchdog */
+  ulWatchdog = LE32_TO_HOST(ptDpm->tCommonStatus.ulHostWatchdog);
+  if (LE32_TO_HOST(ptDpm->tControl.ulDeviceWatchdog) == ulWatchdog) {
+    if (0 == ++ulWatchdog)
+      ulWatchdog = 1;
+    ptDpm->tCommonStatus.ulHostWatchdog = HOST_TO_LE32(ulWatchdog);
+  }
+
+  NetxEmuMailbox(ptEmu, ptEndpoint, ptChannel, usHostFlags, ullNow);
+
+  /* process data: outputs are looped back to the inputs */
+  if (ulCOS & HIL_COMM_COS_READY) {
+    if ((usHostFlags ^ ptEndpoint->usNetxFlags) & NCF_PD0_OUT_ACK) {
+      memcpy(ptChannel->abPd0, ptDpm->abPd0Output, sizeof(ptChannel->abPd0));
+      ptEndpoint->usNetxFlags ^= NCF_PD0_OUT_ACK;
+    }
+    if ((usHostFlags ^ ptEndpoint->usNetxFlags) & NCF_PD0_IN_CMD) {
+      memcpy(ptDpm->abPd0Input, ptChannel->abPd0, sizeof(ptChannel->abPd0));
+      ptEndpoint->usNetxFlags ^= NCF_PD0_IN_CMD;
+    }
+    if ((usHostFlags ^ ptEndpoint->usNetxFlags) & NCF_PD1_OUT_ACK) {
+      memcpy(ptChannel->abPd1, ptDpm->abPd1Output, sizeof(ptChannel->abPd1));
+      ptEndpoint->usNetxFlags ^= NCF_PD1_OUT_ACK;
+    }
+    if ((usHostFlags ^ ptEndpoint->usNetxFlags) & NCF_PD1_IN_CMD) {
+      memcpy(ptDpm->abPd1Input, ptChannel->abPd1, sizeof(ptChannel->abPd1));
+      ptEndpoint->usNetxFlags ^= NCF_PD1_IN_CMD;
+    }
+  }
+}
+
+static void NetxEmuCycle(struct NETXEMU_T* ptEmu)
+{
+  HIL_DPM_SYSTEM_CHANNEL_T* ptSys       = (HIL_DPM_SYSTEM_CHANNEL_T*)ptEmu->pbDpm;
+  uint64_t                  ullNow      = NetxEmuGetTime();
+  uint16_t                  usHostFlags = NetxEmuHostFlags(&ptEmu->tSystem);
+  uint32_t                  ulChannel;
+
+  if ((usHostFlags & HSF_RESET) &&
+      (HIL_SYS_RESET_COOKIE == LE32_TO_HOST(ptSys->tSystemControl.ulSystemCommandCOS))) {
+    NetxEmuReset(ptEmu);
+    return;
+  }
+
+  /* system channel */
+  if ((usHostFlags ^ ptEmu->tSystem.usNetxFlags) & NSF_HOST_COS_ACK)
+    ptEmu->tSystem.usNetxFlags ^= NSF_HOST_COS_ACK;
+  NetxEmuMailbox(ptEmu, &ptEmu->tSystem, NULL, usHostFlags, ullNow);
+  ptSys->tSystemState.ulTimeSinceStart = HOST_TO_LE32((uint32_t)((ullNow - ptEmu->ullStartTime) / 1000000000ULL));
+
+  for (ulChannel = 0; ulChannel < ptEmu->tConfig.ulChannels; ulChannel++)
+    NetxEmuChannelCycle(ptEmu, &ptEmu->atChannel[ulChannel], ullNow);
+
+  /* publish all flag changes of this cycle at once */
+  if (NetxEmuCommitFlags(&ptEmu->tSystem))
+    ptEmu->fIrqPending = 1;
+  for (ulChannel = 0; ulChannel < ptEmu->tConfig.ulChannels; ulChannel++) {
+    if (NetxEmuCommitFlags(&ptEmu->atChannel[ulChannel].tEndpoint))
+      ptEmu->fIrqPending = 1;
+  }
+  NetxEmuSignalIrq(ptEmu);
+}
+
+/* firmware thread, runs one cycle per configured cycle time on absolute deadlines */
+static void* NetxEmuThread(void* pvParam)
+{
+  struct NETXEMU_T* ptEmu       = (struct NETXEMU_T*)pvParam;
+  uint64_t          ullCycle    = (uint64_t)ptEmu->tConfig.ulCycleTime * 1000ULL;
+  uint64_t          ullDeadline = NetxEmuGetTime();
+
+  while (0 == ptEmu->fStop) {
+    NetxEmuCycle(ptEmu);
+
+    if (0 == ullCycle) {
+      /* free running */
+      sched_yield();
+    } else {
+      struct timespec tDeadline;
+      uint64_t        ullNow = NetxEmuGetTime();
+
+      /* do not try to catch up missed cycles */
+      ullDeadline += ullCycle;
+      if (ullDeadline < ullNow)
+        ullDeadline = ullNow;
+
+      tDeadline.tv_sec  = (time_t)(ullDeadline / 1000000000ULL);
+      tDeadline.tv_nsec = (long)(ullDeadline % 1000000000ULL);
+      while ((EINTR == clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &tDeadline, NULL)) && (0 == ptEmu->fStop))
+        ;
+    }
+  }
+  return NULL;
+}
+
+/******************************************************************************/
+/*** HW FUNCTION INTERFACE ****************************************************/
+/******************************************************************************/
+static int32_t NetxEmuHWIFInit(struct CIFX_DEVICE_T* ptDevice)
+{
+  struct NETXEMU_T* ptEmu = (struct NETXEMU_T*)ptDevice->userparam;
+  int               iRet;
+
+  if (ptEmu->fThreadRunning)
+    return CIFX_NO_ERROR;
+
+  NetxEmuPowerOn(ptEmu);
+
+  ptEmu->fStop = 0;
+  if (0 != (iRet = pthread_create(&ptEmu->hThread, NULL, NetxEmuThread, ptEmu))) {
+    ERR( "NETXEMU: Error creating firmware thread (ret=%d)\n", iRet);
+    return CIFX_DRV_INIT_STATE_ERROR;
+  }
+  ptEmu->fThreadRunning = 1;
+
+  return CIFX_NO_ERROR;
+}
+
+static void NetxEmuHWIFDeInit(struct CIFX_DEVICE_T* ptDevice)
+{
+  struct NETXEMU_T* ptEmu = (struct NETXEMU_T*)ptDevice->userparam;
+
+  if (ptEmu->fThreadRunning) {
+    ptEmu->fStop = 1;
+    pthread_join(ptEmu->hThread, NULL);
+    ptEmu->fThreadRunning = 0;
+  }
+}
+
+void NETXEMUDeInit(struct CIFX_DEVICE_T* ptDevice)
+{
+  struct NETXEMU_T* ptEmu = ptDevice->userparam;
+
+  NetxEmuHWIFDeInit(ptDevice);
+  if (ptEmu->iEventFd >= 0)
+    close(ptEmu->iEventFd);
+  free(ptEmu->pbDpm);
+  free(ptEmu);
+  free(ptDevice);
+}
+
+/******************************************************************************/
+/*! Creates a memory backed cifX device, emulating a netX firmware.
+ *   \param ptConfig  Emulator configuration
+ *   \return  Pointer to initialized cifX device on success
+ *            NULL on error                                                   */
+/******************************************************************************/
+struct CIFX_DEVICE_T* NETXEMUInit(const struct NETXEMU_CONFIG_T* ptConfig)
+{
+  struct CIFX_DEVICE_T* ptEmuDev = NULL;
+  struct NETXEMU_T*     ptEmu    = NULL;
+
+  DBG("Running netX emulator (channels=%u,cycle=%uus,latency=%uus,irq=%s)!\n", ptConfig->ulChannels,
+      ptConfig->ulCycleTime, ptConfig->ulLatency, ptConfig->fEventFd ? "eventfd" : "none");
+
+  if ((ptConfig->ulChannels < 1) || (ptConfig->ulChannels > NETXEMU_MAX_CHANNELS)) {
+    ERR( "NETXEMUInit: Invalid number of channels (1 <= x <= %d)\n", NETXEMU_MAX_CHANNELS);
+    goto error_out;
+  }
+
+  /* Allocate memory for the cifX device */
+  ptEmuDev = calloc( 1, sizeof(*ptEmuDev));
+  if(ptEmuDev == NULL) {
+    ERR( "NETXEMUInit: Allocate memory for the cifX device\n");
+    goto error_out;
+  }
+
+  /* Allocate zero initialized memory for the emulator */
+  ptEmu = calloc(1, sizeof(*ptEmu));
+  if(ptEmu == NULL) {
+    ERR( "NETXEMUInit: Allocate memory for the emulator\n");
+    goto error_out;
+  }
+  ptEmu->tConfig  = *ptConfig;
+  ptEmu->iEventFd = -1;
+
+  ptEmu->pbDpm = calloc(1, NETXEMU_DPM_SIZE);
+  if(ptEmu->pbDpm == NULL) {
+    ERR( "NETXEMUInit: Allocate memory for the DPM\n");
+    goto error_out;
+  }
+
+  if (ptConfig->fEventFd) {
+    if ((ptEmu->iEventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0) {
+      ERR( "NETXEMUInit: Error creating eventfd (%d). Fallback to polling!\n", errno);
+    }
+  }
+
+  /* Configuration of an emulated device */
+  ptEmuDev->dpm         = ptEmu->pbDpm;     /*!< DPM is plain memory, accessed by the toolkit via memcpy */
+  ptEmuDev->dpmaddr     = 0x0;              /*!< set to '0x00' since there is no physical DPM */
+  ptEmuDev->dpmlen      = NETXEMU_DPM_SIZE; /*!< set to length of dpm */
+
+  /* Since device is not a uio device and no pci card invalidate all parameter */
+  ptEmuDev->uio_num     = UIO_NUM_EVENTFD_DEVICE; /*!< interrupts are signalled via an eventfd */
+  ptEmuDev->uio_fd      = ptEmu->iEventFd;        /*!< eventfd or '-1' to poll the device */
+  ptEmuDev->pci_card    = 0;       /*!< set to 0 since it is no pci card */
+  ptEmuDev->force_ram   = 0;       /*!< the emulated firmware is always running */
+
+  ptEmuDev->notify      = NULL;    /*!< no notifications required */
+  ptEmuDev->userparam   = ptEmu;   /*!< emulator state */
+
+  /* There is no extra memory */
+  ptEmuDev->extmem      = NULL;   /*!< virtual pointer to extended memory  */
+  ptEmuDev->extmemaddr  = 0x00;   /*!< physical address to extended memory */
+  ptEmuDev->extmemlen   = 0;      /*!< Length of extended memory in bytes  */
+
+  /* The firmware thread is started and stopped together with the hardware function interface.
+     The DPM is plain memory, so no read/write functions are required */
+  ptEmuDev->hwif_init   = NetxEmuHWIFInit;
+  ptEmuDev->hwif_deinit = NetxEmuHWIFDeInit;
+  ptEmuDev->hwif_read   = NULL;
+  ptEmuDev->hwif_write  = NULL;
+
+  return ptEmuDev;
+
+error_out:
+  if (ptEmu) {
+    if (ptEmu->iEventFd >= 0)
+      close(ptEmu->iEventFd);
+    free(ptEmu->pbDpm);
+  }
+  free(ptEmu);
+  free(ptEmuDev);
+  return NULL;
+}
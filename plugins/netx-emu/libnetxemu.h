@@ -0,0 +1,42 @@
+// SPDX-License-Identifier: MIT
+/**************************************************************************************
+ *
+ * Copyright (c) 2025, Hilscher Gesellschaft fuer Systemautomation mbH. All Rights Reserved.
+ *
+ **************************************************************************************/
+
+#ifndef __LIBNETXEMU__H
+#define __LIBNETXEMU__H
+
+#include <stdint.h>
+#include "cifxlinux.h"
+
+#define NETXEMU_MAX_CHANNELS  4   /*!< Maximum number of communication channels fitting into the 64KB DPM */
+
+/******************************************************************************/
+/*! Configuration of an emulated netX device                                   */
+/******************************************************************************/
+struct NETXEMU_CONFIG_T {
+  uint32_t ulChannels;      /*!< Number of communication channels (1..NETXEMU_MAX_CHANNELS) */
+  uint32_t ulCycleTime;     /*!< Firmware cycle time in us (handshake, mailbox and process data handling) */
+  uint32_t ulLatency;       /*!< Additional delay in us before a mailbox answer is delivered */
+  uint32_t ulDeviceNumber;  /*!< Device number reported in the system channel */
+  uint32_t ulSerialNumber;  /*!< Serial number reported in the system channel */
+  int      fEventFd;        /*!< !=0 signal handshake changes ("interrupts") via an eventfd */
+};
+
+/******************************************************************************/
+/*! Creates a memory backed cifX device, emulating a netX firmware.
+ *   \param ptConfig  Emulator configuration
+ *   \return  Pointer to initialized cifX device on success
+ *            NULL on error                                                   */
+/******************************************************************************/
+struct CIFX_DEVICE_T* NETXEMUInit(const struct NETXEMU_CONFIG_T* ptConfig);
+
+/******************************************************************************/
+/*! Frees a device created by NETXEMUInit()
+ *   \param ptDevice  Device to free                                          */
+/******************************************************************************/
+void                  NETXEMUDeInit(struct CIFX_DEVICE_T* ptDevice);
+
+#endif /* __LIBNETXEMU__H */